@@ -50,3 +50,20 @@ void Camera_SetProjectionMatrix(Camera *camera, Mat4 matrix)
 {
     camera->m_projMatrix = matrix;
 }
+
+void Camera_GetRay(Camera *camera, float x, float y, Vec3 *origin, Vec3 *direction)
+{
+    Mat4 proj = camera->m_projMatrix;
+
+    // Point du plan z = -1 (repère caméra) projeté en (x, y)
+    Vec4 viewDirection = Vec4_Set(
+        (proj.data[0][2] - x) / proj.data[0][0],
+        (proj.data[1][2] - y) / proj.data[1][1],
+        -1.0f, 0.0f);
+
+    Mat4 model = Object_GetModelMatrix((Object *)camera);
+    Vec4 worldDirection = Mat4_MulMV(model, viewDirection);
+
+    *origin = Vec3_Set(model.data[0][3], model.data[1][3], model.data[2][3]);
+    *direction = Vec3_Normalize(Vec3_Set(worldDirection.x, worldDirection.y, worldDirection.z));
+}
@@ -22,6 +22,14 @@ int Camera_Init(Camera *camera, Scene *scene, Mat4 localTransform, Object* paren
 /// @param[in] matrix la matrice de projection.
 void Camera_SetProjectionMatrix(Camera *camera, Mat4 matrix);
 
+/// @brief Calcule le rayon partant de la caméra et passant par un point de l'écran.
+/// @param[in] camera la caméra.
+/// @param[in] x l'abscisse du point dans [-1,1] (de gauche à droite).
+/// @param[in] y l'ordonnée du point dans [-1,1] (de bas en haut).
+/// @param[out] origin l'origine du rayon dans le référentiel monde.
+/// @param[out] direction la direction normalisée du rayon dans le référentiel monde.
+void Camera_GetRay(Camera *camera, float x, float y, Vec3 *origin, Vec3 *direction);
+
 /// @}
 
 #endif
\ No newline at end of file
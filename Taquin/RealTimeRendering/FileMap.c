@@ -0,0 +1,319 @@
+﻿#include "FileMap.h"
+#include "Tools.h"
+
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#  include <direct.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+/// @brief Lit tout le fichier dans un buffer alloué (si la projection échoue).
+static bool FileMap_ReadCopy(FileMap *map, HANDLE file)
+{
+    if (map->m_size > (Uint64)SIZE_MAX) return false;
+
+    Uint8 *data = (Uint8 *)malloc((size_t)map->m_size);
+    if (!data) return false;
+
+    Uint64 offset = 0;
+    while (offset < map->m_size)
+    {
+        DWORD chunk = (DWORD)SDL_min(map->m_size - offset, (Uint64)(1u << 30));
+        DWORD numRead = 0;
+        if (!ReadFile(file, data + offset, chunk, &numRead, NULL) || numRead == 0)
+        {
+            free(data);
+            return false;
+        }
+        offset += numRead;
+    }
+
+    map->m_data = data;
+    map->m_isCopy = true;
+    return true;
+}
+
+FileMap *FileMap_Open(char *path, FileMapAccess access)
+{
+    FileMap *map = (FileMap *)calloc(1, sizeof(FileMap));
+    if (!map) goto ERROR_LABEL;
+
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if (access == FILEMAP_ACCESS_SEQUENTIAL) flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+
+    HANDLE file = CreateFileA(
+        path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags, NULL);
+    if (file == INVALID_HANDLE_VALUE) goto ERROR_LABEL;
+    map->m_file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) goto ERROR_LABEL;
+    map->m_size = (Uint64)size.QuadPart;
+
+    bool copyOnWrite = (access == FILEMAP_ACCESS_PRIVATE);
+    HANDLE mapping = CreateFileMappingA(
+        file, NULL, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+    if (mapping)
+    {
+        map->m_mapping = mapping;
+        map->m_data = MapViewOfFile(
+            mapping, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+    }
+
+    // Lecture classique si la projection est impossible
+    if (!map->m_data && !FileMap_ReadCopy(map, file)) goto ERROR_LABEL;
+
+    return map;
+
+ERROR_LABEL:
+    // L'absence du fichier n'est pas une erreur (cache vide)
+    FileMap_Close(map);
+    return NULL;
+}
+
+void FileMap_Close(FileMap *map)
+{
+    if (!map) return;
+
+    if (map->m_isCopy) free(map->m_data);
+    else if (map->m_data) UnmapViewOfFile(map->m_data);
+    if (map->m_mapping) CloseHandle((HANDLE)map->m_mapping);
+    if (map->m_file && map->m_file != INVALID_HANDLE_VALUE) CloseHandle((HANDLE)map->m_file);
+
+    free(map);
+}
+
+void FileMap_Prefetch(FileMap *map)
+{
+    // Pas d'équivalent portable de MADV_WILLNEED avant Windows 8 :
+    // FILE_FLAG_SEQUENTIAL_SCAN assure déjà une lecture anticipée agressive
+    (void)map;
+}
+
+void FileMap_Discard(FileMap *map, void *data, Uint64 size)
+{
+    if (map->m_isCopy || size == 0) return;
+
+    // VirtualUnlock sur des pages non verrouillées les retire de la mémoire du processus
+    // (l'appel signale une erreur ERROR_NOT_LOCKED, attendue)
+    VirtualUnlock(data, (SIZE_T)size);
+}
+
+#else
+
+/// @brief Lit tout le fichier dans un buffer alloué (si la projection échoue).
+static bool FileMap_ReadCopy(FileMap *map, int file)
+{
+    if (map->m_size > (Uint64)SIZE_MAX) return false;
+
+    Uint8 *data = (Uint8 *)malloc((size_t)map->m_size);
+    if (!data) return false;
+
+    Uint64 offset = 0;
+    while (offset < map->m_size)
+    {
+        ssize_t numRead = read(file, data + offset, (size_t)(map->m_size - offset));
+        if (numRead <= 0)
+        {
+            if (numRead < 0 && errno == EINTR) continue;
+            free(data);
+            return false;
+        }
+        offset += (Uint64)numRead;
+    }
+
+    map->m_data = data;
+    map->m_isCopy = true;
+    return true;
+}
+
+FileMap *FileMap_Open(char *path, FileMapAccess access)
+{
+    int file = -1;
+
+    FileMap *map = (FileMap *)calloc(1, sizeof(FileMap));
+    if (!map) goto ERROR_LABEL;
+
+    file = open(path, O_RDONLY);
+    if (file < 0) goto ERROR_LABEL;
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0) goto ERROR_LABEL;
+    map->m_size = (Uint64)info.st_size;
+
+    int protection = PROT_READ;
+    if (access == FILEMAP_ACCESS_PRIVATE) protection |= PROT_WRITE;
+
+    void *data = mmap(NULL, (size_t)map->m_size, protection, MAP_PRIVATE, file, 0);
+    if (data != MAP_FAILED)
+    {
+        map->m_data = data;
+        if (access == FILEMAP_ACCESS_SEQUENTIAL)
+        {
+            madvise(data, (size_t)map->m_size, MADV_SEQUENTIAL);
+        }
+    }
+    else if (!FileMap_ReadCopy(map, file))
+    {
+        // Lecture classique si la projection est impossible
+        goto ERROR_LABEL;
+    }
+
+    close(file);
+
+    return map;
+
+ERROR_LABEL:
+    // L'absence du fichier n'est pas une erreur (cache vide)
+    if (file >= 0) close(file);
+    FileMap_Close(map);
+    return NULL;
+}
+
+void FileMap_Close(FileMap *map)
+{
+    if (!map) return;
+
+    if (map->m_isCopy) free(map->m_data);
+    else if (map->m_data) munmap(map->m_data, (size_t)map->m_size);
+
+    free(map);
+}
+
+void FileMap_Prefetch(FileMap *map)
+{
+    if (!map->m_isCopy)
+    {
+        madvise(map->m_data, (size_t)map->m_size, MADV_WILLNEED);
+    }
+}
+
+void FileMap_Discard(FileMap *map, void *data, Uint64 size)
+{
+    if (map->m_isCopy) return;
+
+    // madvise n'accepte que des pages entières
+    uintptr_t pageSize = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t first = ((uintptr_t)data + pageSize - 1) & ~(pageSize - 1);
+    uintptr_t last = ((uintptr_t)data + (uintptr_t)size) & ~(pageSize - 1);
+    if (last > first)
+    {
+        madvise((void *)first, (size_t)(last - first), MADV_DONTNEED);
+    }
+}
+
+#endif
+
+int FileMap_GetInfo(char *path, FileInfo *info)
+{
+#ifdef _WIN32
+    struct _stat64 fileStat;
+    if (_stat64(path, &fileStat) != 0) return EXIT_FAILURE;
+#else
+    struct stat fileStat;
+    if (stat(path, &fileStat) != 0) return EXIT_FAILURE;
+#endif
+
+    info->m_size = (Uint64)fileStat.st_size;
+    info->m_modifiedTime = (Sint64)fileStat.st_mtime;
+
+    return EXIT_SUCCESS;
+}
+
+int FileMap_HashFile(char *path, Uint64 *hash)
+{
+    FileMap *map = FileMap_Open(path, FILEMAP_ACCESS_SEQUENTIAL);
+    if (!map) return EXIT_FAILURE;
+
+    *hash = Hash_FNV1a(FileMap_GetData(map), (size_t)FileMap_GetSize(map), HASH_FNV1A_SEED);
+    FileMap_Close(map);
+
+    return EXIT_SUCCESS;
+}
+
+/// @brief Crée un unique dossier. Renvoie EXIT_SUCCESS s'il existe déjà.
+static int FileMap_MakeDirectory(char *path)
+{
+#ifdef _WIN32
+    int result = _mkdir(path);
+#else
+    int result = mkdir(path, 0755);
+#endif
+    return (result == 0 || errno == EEXIST) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int FileMap_CreateDirectory(char *path)
+{
+    char buffer[1024] = { 0 };
+
+    size_t length = strlen(path);
+    if (length == 0 || length >= sizeof(buffer)) goto ERROR_LABEL;
+    memcpy(buffer, path, length);
+
+    // Crée les dossiers parents un par un
+    for (size_t i = 1; i < length; ++i)
+    {
+        if (buffer[i] != '/' && buffer[i] != '\\') continue;
+        if (buffer[i - 1] == '.' || buffer[i - 1] == ':') continue;
+
+        char separator = buffer[i];
+        buffer[i] = '\0';
+        int exitStatus = FileMap_MakeDirectory(buffer);
+        buffer[i] = separator;
+        if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    }
+
+    int exitStatus = FileMap_MakeDirectory(buffer);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - FileMap_CreateDirectory() %s\n", path);
+    return EXIT_FAILURE;
+}
+
+/// @brief Compteur des fichiers temporaires créés par le processus.
+static SDL_atomic_t g_fileMapTempCounter = { 0 };
+
+void FileMap_GetTempPath(char *path, char *tmpPath, int size)
+{
+#ifdef _WIN32
+    unsigned long processId = (unsigned long)GetCurrentProcessId();
+#else
+    unsigned long processId = (unsigned long)getpid();
+#endif
+    int counter = SDL_AtomicAdd(&g_fileMapTempCounter, 1);
+
+    snprintf(tmpPath, size, "%s.%lu.%d.tmp", path, processId, counter);
+}
+
+int FileMap_Replace(char *tmpPath, char *path)
+{
+#ifdef _WIN32
+    bool replaced = (MoveFileExA(tmpPath, path, MOVEFILE_REPLACE_EXISTING) != 0);
+#else
+    bool replaced = (rename(tmpPath, path) == 0);
+#endif
+    if (replaced) return EXIT_SUCCESS;
+
+    // Le fichier vient d'être remplacé par une autre écriture, ou il est ouvert par un
+    // lecteur (Windows) : le fichier en place est de toute façon vérifié à sa lecture
+    remove(tmpPath);
+
+    FileInfo info = { 0 };
+    if (FileMap_GetInfo(path, &info) == EXIT_SUCCESS) return EXIT_SUCCESS;
+
+    printf("ERROR - FileMap_Replace() %s\n", path);
+    return EXIT_FAILURE;
+}
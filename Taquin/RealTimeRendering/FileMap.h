@@ -0,0 +1,127 @@
+﻿#ifndef _FILE_MAP_H_
+#define _FILE_MAP_H_
+
+/// @file FileMap.h
+/// @defgroup FileMap
+/// @{
+
+#include "Settings.h"
+
+/// @brief Manière dont le contenu d'un fichier projeté sera lu.
+/// Permet au système d'adapter la lecture anticipée des pages.
+typedef enum FileMapAccess_e
+{
+    /// @brief Accès quelconque (pas d'indication).
+    FILEMAP_ACCESS_DEFAULT,
+
+    /// @brief Lecture du début à la fin (analyse d'un fichier texte).
+    /// Les pages suivantes sont lues en avance pendant l'analyse des premières.
+    FILEMAP_ACCESS_SEQUENTIAL,
+
+    /// @brief Accès quelconque, les données peuvent être modifiées (copie sur écriture).
+    /// Seules les pages modifiées sont copiées, le fichier n'est jamais modifié.
+    FILEMAP_ACCESS_PRIVATE
+} FileMapAccess;
+
+/// @brief Fichier projeté en mémoire.
+/// Si la projection est impossible, le fichier est lu dans un buffer alloué.
+typedef struct FileMap_s
+{
+    /// @brief Contenu du fichier.
+    void *m_data;
+
+    /// @brief Taille du fichier en octets.
+    Uint64 m_size;
+
+    /// @brief Vaut true si m_data a été alloué (lecture classique) au lieu d'être projeté.
+    bool m_isCopy;
+
+#ifdef _WIN32
+    void *m_file;
+    void *m_mapping;
+#endif
+} FileMap;
+
+/// @brief Informations sur un fichier utilisées pour invalider les caches.
+typedef struct FileInfo_s
+{
+    Uint64 m_size;
+
+    /// @brief Date de dernière modification (secondes depuis l'epoch).
+    Sint64 m_modifiedTime;
+} FileInfo;
+
+/// @brief Projette un fichier en mémoire.
+/// Le contenu est en lecture seule sauf avec FILEMAP_ACCESS_PRIVATE.
+/// @param[in] path le chemin du fichier.
+/// @param[in] access la manière dont le fichier sera lu.
+/// @return La projection ou NULL si le fichier n'existe pas, est vide ou ne peut pas être lu.
+FileMap *FileMap_Open(char *path, FileMapAccess access);
+
+/// @brief Demande au système de charger dès maintenant tout le fichier en arrière-plan.
+/// Utile avant une lecture en parallèle de plusieurs parties du fichier.
+/// @param[in] map la projection.
+void FileMap_Prefetch(FileMap *map);
+
+/// @brief Rend au système les pages d'une partie de la projection qui ne sera plus lue.
+/// Seules les pages entièrement comprises dans la zone sont rendues ; elles seraient relues
+/// depuis le fichier si la zone était lue de nouveau. Sans effet si le fichier a été copié.
+/// @param[in] map la projection.
+/// @param[in] data le début de la zone.
+/// @param[in] size la taille de la zone en octets.
+void FileMap_Discard(FileMap *map, void *data, Uint64 size);
+
+/// @brief Libère une projection créée avec FileMap_Open().
+/// @param[in,out] map la projection (peut valoir NULL).
+void FileMap_Close(FileMap *map);
+
+/// @brief Renvoie le début du fichier projeté.
+INLINE void *FileMap_GetData(FileMap *map)
+{
+    return map->m_data;
+}
+
+/// @brief Renvoie la taille du fichier projeté en octets.
+INLINE Uint64 FileMap_GetSize(FileMap *map)
+{
+    return map->m_size;
+}
+
+/// @brief Lit la taille et la date de modification d'un fichier.
+/// @param[in] path le chemin du fichier.
+/// @param[out] info les informations sur le fichier.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE si le fichier n'existe pas.
+int FileMap_GetInfo(char *path, FileInfo *info);
+
+/// @brief Calcule le hachage (FNV-1a) du contenu d'un fichier.
+/// Utilisé par les caches pour reconnaître un fichier source dont seule la date a changé.
+/// @param[in] path le chemin du fichier.
+/// @param[out] hash le hachage du contenu.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE si le fichier n'existe pas, est vide ou ne peut pas être lu.
+int FileMap_HashFile(char *path, Uint64 *hash);
+
+/// @brief Crée un dossier ainsi que ses dossiers parents si nécessaire.
+/// @param[in] path le chemin du dossier.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int FileMap_CreateDirectory(char *path);
+
+/// @brief Construit le nom d'un fichier temporaire placé à côté d'un fichier.
+/// Le nom contient l'identifiant du processus et un compteur : deux écritures
+/// simultanées du même fichier n'utilisent jamais le même fichier temporaire.
+/// @param[in] path le chemin du fichier final.
+/// @param[out] tmpPath le chemin du fichier temporaire.
+/// @param[in] size la taille du buffer tmpPath.
+void FileMap_GetTempPath(char *path, char *tmpPath, int size);
+
+/// @brief Remplace un fichier par un fichier temporaire complet (voir FileMap_GetTempPath()).
+/// Le remplacement est atomique : un lecteur voit l'ancien ou le nouveau fichier, jamais
+/// un mélange des deux. S'il échoue alors que le fichier existe, une écriture concurrente
+/// l'a emporté : le fichier temporaire est supprimé et la fonction réussit.
+/// @param[in] tmpPath le chemin du fichier temporaire.
+/// @param[in] path le chemin du fichier final.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int FileMap_Replace(char *tmpPath, char *path);
+
+/// @}
+
+#endif
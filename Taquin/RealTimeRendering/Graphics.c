@@ -1,6 +1,7 @@
 #include "Graphics.h"
 #include "Tools.h"
 #include "Shader.h"
+#include "Meshlet.h"
 
 /// @brief Indique si la clipPos d'un point appartient au frustum reprsentant
 /// les objects visibles par la camra.
@@ -14,23 +15,340 @@ bool Graphics_Clip(Vec3 clipPos)
         (clipPos.z < -1.0f) || (clipPos.z > 1.0f);
 }
 
+float Graphics_GetMaxScale(Mat4 matrix)
+{
+    float scale = 0.0f;
+    for (int j = 0; j < 3; ++j)
+    {
+        Vec3 axis = Vec3_Set(matrix.data[0][j], matrix.data[1][j], matrix.data[2][j]);
+        scale = fmaxf(scale, Vec3_Length(axis));
+    }
+    return scale;
+}
+
+/// @brief Choisit le niveau de dtail d'un mesh.
+/// Renvoie le niveau le plus simplifi dont l'erreur gomtrique, projete  l'cran
+/// au point de la sphre englobante le plus proche de la camra, ne dpasse pas pixelError.
+/// @param renderer le moteur de rendu.
+/// @param camera la camra.
+/// @param mesh le mesh.
+/// @param objToView la matrice de passage du repre objet au repre camra.
+/// @param pixelError l'erreur maximale en pixels.
+/// @return Le niveau de dtail (0 pour le mesh complet).
+static int Graphics_SelectLod(
+    Renderer *renderer, Camera *camera, Mesh *mesh, Mat4 objToView, float pixelError)
+{
+    if (mesh->m_lodCount == 0 || pixelError <= 0.0f)
+        return 0;
+
+    float scale = Graphics_GetMaxScale(objToView);
+
+    Vec3 center = Vec3_From4(Mat4_MulMV(objToView, Vec4_From3(mesh->m_center, 1.0f)));
+    float radius = scale * Vec3_Length(Vec3_Sub(mesh->m_max, mesh->m_center));
+    float distance = fabsf(center.z) - radius;
+    if (distance <= 0.0f)
+    {
+        // La camra est dans la sphre englobante
+        return 0;
+    }
+
+    // Taille  l'cran (en pixels) d'une unit du repre camra  cette distance
+    float pixelsPerUnit =
+        fabsf(camera->m_projMatrix.data[1][1]) * 0.5f * (float)Renderer_GetHeight(renderer) / distance;
+
+    for (int level = mesh->m_lodCount; level > 0; --level)
+    {
+        if (mesh->m_lods[level - 1].m_error * scale * pixelsPerUnit <= pixelError)
+            return level;
+    }
+    return 0;
+}
+
+GraphicsFrustum Graphics_GetFrustum(Camera *camera)
+{
+    GraphicsFrustum frustum = { 0 };
+    Mat4 proj = camera->m_projMatrix;
+
+    frustum.m_scaleX = fabsf(proj.data[0][0]);
+    frustum.m_scaleY = fabsf(proj.data[1][1]);
+    frustum.m_normX = sqrtf(frustum.m_scaleX * frustum.m_scaleX + 1.0f);
+    frustum.m_normY = sqrtf(frustum.m_scaleY * frustum.m_scaleY + 1.0f);
+    frustum.m_near = proj.data[2][3] / (proj.data[2][2] + 1.0f);
+    frustum.m_far = proj.data[2][3] / (proj.data[2][2] - 1.0f);
+
+    return frustum;
+}
+
+bool Graphics_IsSphereVisible(const GraphicsFrustum *frustum, Vec3 center, float radius)
+{
+    // La camra regarde vers les z ngatifs
+    if (center.z - radius > -frustum->m_near || center.z + radius < -frustum->m_far)
+        return false;
+    if (frustum->m_scaleX * fabsf(center.x) + center.z > radius * frustum->m_normX)
+        return false;
+    if (frustum->m_scaleY * fabsf(center.y) + center.z > radius * frustum->m_normY)
+        return false;
+    return true;
+}
+
+void Graphics_GetWorldFrustumPlanes(Camera *camera, Vec4 *planes)
+{
+    GraphicsFrustum frustum = Graphics_GetFrustum(camera);
+    float sx = frustum.m_scaleX / frustum.m_normX;
+    float sy = frustum.m_scaleY / frustum.m_normY;
+
+    // Plans dans le repre camra (la camra regarde vers les z ngatifs)
+    Vec4 viewPlanes[GRAPHICS_FRUSTUM_PLANE_COUNT] = {
+        Vec4_Set(0.0f, 0.0f, -1.0f, -frustum.m_near),
+        Vec4_Set(0.0f, 0.0f, 1.0f, frustum.m_far),
+        Vec4_Set(-sx, 0.0f, -1.0f / frustum.m_normX, 0.0f),
+        Vec4_Set(sx, 0.0f, -1.0f / frustum.m_normX, 0.0f),
+        Vec4_Set(0.0f, -sy, -1.0f / frustum.m_normY, 0.0f),
+        Vec4_Set(0.0f, sy, -1.0f / frustum.m_normY, 0.0f)
+    };
+
+    // Un plan se transforme par la transpose de la matrice monde -> camra
+    Mat4 worldToView = Mat4_Inv(Object_GetModelMatrix((Object *)camera));
+    Mat4 planeMatrix = Mat4_Transpose(worldToView);
+
+    for (int i = 0; i < GRAPHICS_FRUSTUM_PLANE_COUNT; ++i)
+    {
+        Vec4 plane = Mat4_MulMV(planeMatrix, viewPlanes[i]);
+        float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        planes[i] = Vec4_Set(plane.x / length, plane.y / length, plane.z / length, plane.w / length);
+    }
+}
+
+/// @brief Renvoie le meshlet plac  une position donne d'un ordre de rendu.
+/// @param mesh le mesh.
+/// @param order l'ordre de rendu (NULL pour l'ordre de la table).
+/// @param position la position dans l'ordre.
+/// @return Le meshlet.
+static Meshlet *Graphics_GetOrderedMeshlet(Mesh *mesh, const int *order, int position)
+{
+    return &mesh->m_meshlets[order ? order[position] : position];
+}
+
+/// @brief Slectionne les meshlets d'un mesh pouvant tre visibles.
+/// Un meshlet est rejet si sa sphre englobante est hors du frustum de la camra
+/// ou si, avec backFaceCulling, tous ses triangles sont vus de dos (test du cne des normales).
+/// @param camera la camra.
+/// @param mesh le mesh.
+/// @param objToView la matrice de passage du repre objet au repre camra.
+/// @param backFaceCulling indique si les meshlets vus de dos sont rejets.
+/// @param[out] order l'ordre de rendu prcalcul choisi pour la position de la camra
+/// (voir Meshlet_GetOrder()), ou NULL pour l'ordre de la table.
+/// @param[out] visible les positions dans cet ordre des meshlets conservs (m_meshletCount lments),
+/// croissantes (voir Graphics_GetOrderedMeshlet()).
+/// @return Le nombre de meshlets conservs.
+static int Graphics_CullMeshlets(
+    Camera *camera, Mesh *mesh, Mat4 objToView, bool backFaceCulling,
+    const int **order, int *visible)
+{
+    GraphicsFrustum frustum = Graphics_GetFrustum(camera);
+    float scale = Graphics_GetMaxScale(objToView);
+
+    // Position de la camra dans le repre objet
+    Vec3 cameraPos = Vec3_From4(Mat4_MulMV(Mat4_Inv(objToView), Vec4_ZeroH));
+
+    // Ordre prcalcul pour la direction de la camra vers l'objet
+    *order = Meshlet_GetOrder(mesh, Vec3_Sub(mesh->m_center, cameraPos));
+
+    int count = 0;
+    for (int i = 0; i < mesh->m_meshletCount; ++i)
+    {
+        Meshlet *meshlet = Graphics_GetOrderedMeshlet(mesh, *order, i);
+
+        if (backFaceCulling && Meshlet_IsBackFacing(meshlet, cameraPos))
+            continue;
+
+        Vec3 center = Vec3_From4(Mat4_MulMV(objToView, Vec4_From3(meshlet->m_center, 1.0f)));
+        if (!Graphics_IsSphereVisible(&frustum, center, scale * meshlet->m_radius))
+            continue;
+
+        visible[count++] = i;
+    }
+    return count;
+}
+
+/// @brief Renvoie la position du premier lment d'un tableau tri suprieur ou gal  value.
+static int Graphics_LowerBound(const int *values, int count, int value)
+{
+    int first = 0;
+    while (count > 0)
+    {
+        int half = count >> 1;
+        if (values[first + half] < value)
+        {
+            first += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+    return first;
+}
+
+/// @brief Lit un sommet soud, ventuellement dans sa version compresse.
+static MeshVertex Graphics_FetchVertex(
+    MeshVertex *weldedVertices, MeshPackedVertex *packedVertices,
+    Vec3 packOrigin, Vec3 packStep, int vertexId)
+{
+    if (packedVertices)
+    {
+        return Mesh_UnpackVertex(packedVertices + vertexId, packOrigin, packStep);
+    }
+    return weldedVertices[vertexId];
+}
+
+/// @brief Nombre maximal de sous-meshes tris par distance  la camra.
+/// Au-del, les sous-meshes sont dessins dans l'ordre de leur table.
+#define GRAPHICS_MAX_SORTED_SUBMESHES 256
+
+/// @brief Distance  la camra d'un sous-mesh, pour Graphics_SortSubmeshes().
+typedef struct GraphicsSubmeshDepth_s
+{
+    float m_depth;
+    int   m_index;
+} GraphicsSubmeshDepth;
+
+/// @brief Calcule l'ordre de rendu des sous-meshes d'un mesh.
+/// Si la scne le demande (voir Scene_SetSubmeshSorting()), les sous-meshes sont rangs
+/// du plus proche au plus loign de la camra : les pixels des suivants sont alors
+/// souvent rejets par le z-buffer avant le fragment shader.
+/// @param scene la scne.
+/// @param submeshes les sous-meshes.
+/// @param count le nombre de sous-meshes.
+/// @param objToView la matrice de passage du repre objet au repre camra.
+/// @param order l'ordre de rendu (GRAPHICS_MAX_SORTED_SUBMESHES lments).
+/// @return true si order est rempli, false si les sous-meshes gardent l'ordre de leur table.
+static bool Graphics_SortSubmeshes(
+    Scene *scene, const MeshSubmesh *submeshes, int count, Mat4 objToView, int *order)
+{
+    GraphicsSubmeshDepth depths[GRAPHICS_MAX_SORTED_SUBMESHES];
+
+    if (!Scene_GetSubmeshSorting(scene) || count < 2 || count > GRAPHICS_MAX_SORTED_SUBMESHES)
+        return false;
+
+    // La camra regarde vers -z : la distance est celle du point le plus proche de la sphre
+    float scale = Graphics_GetMaxScale(objToView);
+    for (int i = 0; i < count; ++i)
+    {
+        Vec3 center = Vec3_From4(Mat4_MulMV(objToView, Vec4_From3(submeshes[i].m_center, 1.0f)));
+        GraphicsSubmeshDepth entry;
+        entry.m_depth = -center.z - scale * submeshes[i].m_radius;
+        entry.m_index = i;
+
+        // Tri par insertion (peu de matriaux par mesh)
+        int j = i;
+        while (j > 0 && depths[j - 1].m_depth > entry.m_depth)
+        {
+            depths[j] = depths[j - 1];
+            j--;
+        }
+        depths[j] = entry;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        order[i] = depths[i].m_index;
+    }
+    return true;
+}
+
+/// @brief Calcule les variables globales du fragment shader communes aux triangles
+/// d'un mme matriau. Elles sont prpares une fois par sous-mesh, et non par triangle.
+/// @param scene la scne.
+/// @param mesh le mesh.
+/// @param materialIndex l'indice du matriau (-1 si aucun).
+/// @param cameraPos la position de la camra dans le repre monde.
+/// @param tint la teinte multiplie  l'albedo.
+/// @return Les variables globales du fragment shader.
+static FShaderGlobals Graphics_GetFragGlobals(
+    Scene *scene, Mesh *mesh, int materialIndex, Vec3 cameraPos, Vec3 tint)
+{
+    Material *material = NULL;
+    if (materialIndex >= 0)
+    {
+        material = mesh->m_materials + materialIndex;
+    }
+
+    FShaderGlobals fragGlobals = { 0 };
+    fragGlobals.material = material;
+    if (material)
+    {
+        fragGlobals.albedoMap = Material_GetAlbedo(material);
+        fragGlobals.normalMap = Material_GetNormalMap(material);
+    }
+    fragGlobals.cameraPos = cameraPos;
+    fragGlobals.tint = tint;
+    fragGlobals.scene = scene;
+    fragGlobals.filter = Scene_GetTextureFilter(scene);
+
+    return fragGlobals;
+}
+
+/// @brief Dessine un triangle  partir des sorties du vertex shader de ses sommets.
+/// @param renderer le moteur de rendu.
+/// @param scene la scne.
+/// @param out les sorties du vertex shader (modifies pour l'interpolation).
+/// @param submeshGlobals les variables globales du fragment shader du sous-mesh
+/// contenant le triangle (voir Graphics_GetFragGlobals()).
+/// @param fragShader le fragment shader.
+static void Graphics_DrawTriangle(
+    Renderer *renderer, Scene *scene, VShaderOut *out,
+    const FShaderGlobals *submeshGlobals, FragmentShader *fragShader)
+{
+    // Clipping
+    if (Graphics_Clip(out[0].clipPos) && Graphics_Clip(out[1].clipPos) && Graphics_Clip(out[2].clipPos))
+    {
+        return;
+    }
+
+    if (!Scene_GetWireframe(scene))
+    {
+        // Copie locale : le rasteriseur y crit des valeurs propres au triangle
+        FShaderGlobals fragGlobals = *submeshGlobals;
+
+        // Calcule le rendu du triangle
+        Graphics_RenderTriangle(renderer, out, fragShader, &fragGlobals);
+    }
+    else
+    {
+        // Dessine en fil de fer
+        Vec4 lineColor = Vec4_Set(1.0f, 1.0f, 1.0f, 1.0f);
+        Renderer_DrawLine(renderer, out[0].clipPos, out[1].clipPos, lineColor);
+        Renderer_DrawLine(renderer, out[1].clipPos, out[2].clipPos, lineColor);
+        Renderer_DrawLine(renderer, out[2].clipPos, out[0].clipPos, lineColor);
+    }
+}
+
 void Graphics_RenderObject(
     Renderer *renderer, Object *object,
     VertexShader *vertShader, FragmentShader *fragShader)
 {
-    if (!object->m_mesh)
+    Graphics_RenderObjectTransformed(
+        renderer, object, Object_GetModelMatrix(object), vertShader, fragShader);
+}
+
+void Graphics_RenderObjectTransformed(
+    Renderer *renderer, Object *object, Mat4 objToWorld,
+    VertexShader *vertShader, FragmentShader *fragShader)
+{
+    Mesh *mesh = Object_GetMesh(object);
+    if (!mesh)
         return;
 
     Scene *scene = Object_getScene(object);
     Camera *camera = Scene_GetCamera(scene);
-    Mesh *mesh = object->m_mesh;
     bool wireframe = Scene_GetWireframe(scene);
 
     VShaderGlobals vertGlobals = { 0 };
 
     Mat4 viewToWorld = Object_GetModelMatrix((Object *)camera);
     Mat4 worldToView = Mat4_Inv(viewToWorld);
-    Mat4 objToWorld = Object_GetModelMatrix(object);
     Mat4 objToView = Mat4_MulMM(worldToView, objToWorld);
     
     vertGlobals.cameraPos = Vec3_From4(Mat4_MulMV(viewToWorld, Vec4_ZeroH));
@@ -40,65 +358,319 @@ void Graphics_RenderObject(
     vertGlobals.objToClip = Mat4_MulMM(camera->m_projMatrix, objToView);
 
     int i;
-    int triangleCount = mesh->m_triangleCount;
+    MeshVertex *weldedVertices = mesh->m_weldedVertices;
 
-#pragma omp parallel for num_threads(4)
-    for (i = 0; i < triangleCount; ++i)
+    // Niveau de dtail : les sommets souds sont partags par tous les niveaux
+    int lodLevel = Graphics_SelectLod(
+        renderer, camera, mesh, objToView, Scene_GetLodPixelError(scene));
+    MeshLod *lod = (lodLevel > 0) ? &mesh->m_lods[lodLevel - 1] : NULL;
+    object->m_lodLevel = lodLevel;
+
+    // Sommets compresss (voir Mesh_Quantize()), dcompresss  la lecture
+    MeshPackedVertex *packedVertices = mesh->m_packedVertices;
+    Vec3 packOrigin = mesh->m_min;
+    Vec3 packStep = Mesh_GetQuantizationStep(mesh);
+
+    // Occlusion ambiante prcalcule, si le mesh en a une et si la scne l'utilise
+    float *occlusion = Scene_GetAmbientOcclusion(scene) ? mesh->m_occlusion : NULL;
+
+    // Sous-meshes du niveau rendu, un par matriau, ventuellement du plus proche au plus loign
+    MeshSubmesh *submeshes = lod ? lod->m_submeshes : mesh->m_submeshes;
+    int submeshCount = lod ? lod->m_submeshCount : mesh->m_submeshCount;
+    int order[GRAPHICS_MAX_SORTED_SUBMESHES];
+    bool sorted = Graphics_SortSubmeshes(scene, submeshes, submeshCount, objToView, order);
+
+    if (!lod && mesh->m_meshletCount > 0 && Scene_GetMeshletCulling(scene))
     {
-        Triangle *triangle = mesh->m_triangles + i;
-        VShaderIn in[3] = { 0 };
-        VShaderOut out[3] = { 0 };
-        bool clip = true;
+        // Meshlets : les groupes de triangles vus de dos ou hors du frustum
+        // sont rejets avant le vertex shader
+        int meshletCount = mesh->m_meshletCount;
+        int *visible = Renderer_GetMeshletBuffer(renderer, 2 * meshletCount);
+        if (!visible)
+            return;
+
+        // Dans chaque sous-mesh, les meshlets sont parcourus du plus proche au plus loign
+        // selon l'ordre prcalcul le plus proche de la direction de vue
+        int *vertexOffsets = visible + meshletCount;
+        const int *meshletOrder = NULL;
+        int visibleCount = Graphics_CullMeshlets(
+            camera, mesh, objToView, !wireframe, &meshletOrder, visible);
 
-        for (int j = 0; j < 3; ++j)
+        // Position des sommets de chaque meshlet conserv dans vertexOut
+        int vertexCount = 0;
+        for (i = 0; i < visibleCount; ++i)
         {
-            // Calcule l'entre du vertex shader
-            in[j].vertex = mesh->m_vertices[triangle->m_vertexIndices[j]];
-            in[j].normal = mesh->m_normals[triangle->m_normalIndices[j]];
-            in[j].tangent = mesh->m_tangents[triangle->m_vertexIndices[j]];
-            if (mesh->m_textUVs)
+            vertexOffsets[i] = vertexCount;
+            vertexCount += Graphics_GetOrderedMeshlet(mesh, meshletOrder, visible[i])->m_vertexCount;
+        }
+
+        VShaderOut *vertexOut = Renderer_GetVertexBuffer(renderer, vertexCount);
+        if (!vertexOut)
+            return;
+
+        // VERTEX SHADER
+        // Les sommets partags par plusieurs meshlets sont transforms une fois par meshlet
+#pragma omp parallel for num_threads(4)
+        for (i = 0; i < visibleCount; ++i)
+        {
+            Meshlet *meshlet = Graphics_GetOrderedMeshlet(mesh, meshletOrder, visible[i]);
+            int *vertexIds = mesh->m_meshletVertices + meshlet->m_vertexOffset;
+
+            for (int j = 0; j < meshlet->m_vertexCount; ++j)
             {
-                in[j].textUV = mesh->m_textUVs[triangle->m_textUVIndices[j]];
-            }
+                MeshVertex vertex = Graphics_FetchVertex(
+                    weldedVertices, packedVertices, packOrigin, packStep, vertexIds[j]);
+                VShaderIn in = { 0 };
 
-            // VERTEX SHADER
-            out[j] = vertShader(&in[j], &vertGlobals);
+                in.vertex = vertex.m_position;
+                in.normal = vertex.m_normal;
+                in.tangent = vertex.m_tangent;
+                in.textUV = vertex.m_textUV;
+                in.occlusion = occlusion ? occlusion[vertexIds[j]] : 1.0f;
 
-            // Clipping
-            clip = clip && Graphics_Clip(out[j].clipPos);
+                vertexOut[vertexOffsets[i] + j] = vertShader(&in, &vertGlobals);
+            }
         }
-        if (clip)
+
+        // Les meshlets d'un sous-mesh occupent les mmes positions dans tous les ordres :
+        // ceux conservs sont conscutifs
+        for (int k = 0; k < submeshCount; ++k)
         {
-            continue;
+            MeshSubmesh *submesh = &submeshes[sorted ? order[k] : k];
+            FShaderGlobals fragGlobals = Graphics_GetFragGlobals(
+                scene, mesh, submesh->m_materialIndex, vertGlobals.cameraPos, Vec3_One);
+
+            int first = Graphics_LowerBound(visible, visibleCount, submesh->m_meshletOffset);
+            int last = Graphics_LowerBound(
+                visible, visibleCount, submesh->m_meshletOffset + submesh->m_meshletCount);
+
+            // Rpartition dynamique : les threads avancent ensemble de l'avant vers l'arrire
+#pragma omp parallel for schedule(dynamic) num_threads(4)
+            for (i = first; i < last; ++i)
+            {
+                Meshlet *meshlet = Graphics_GetOrderedMeshlet(mesh, meshletOrder, visible[i]);
+                VShaderOut *meshletOut = vertexOut + vertexOffsets[i];
+
+                for (int j = 0; j < meshlet->m_triangleCount; ++j)
+                {
+                    int triangle = meshlet->m_triangleOffset + j;
+                    Uint8 *localIndices = mesh->m_meshletIndices + 3 * triangle;
+                    VShaderOut out[3];
+
+                    // Copie les sorties du vertex shader (modifies pour l'interpolation)
+                    out[0] = meshletOut[localIndices[0]];
+                    out[1] = meshletOut[localIndices[1]];
+                    out[2] = meshletOut[localIndices[2]];
+
+                    Graphics_DrawTriangle(renderer, scene, out, &fragGlobals, fragShader);
+                }
+            }
         }
+        return;
+    }
+
+    int vertexCount = lod ? lod->m_vertexCount : mesh->m_weldedCount;
+    int *vertexIds = lod ? lod->m_vertices : NULL;
+    int *indices = lod ? lod->m_indices : mesh->m_indices;
+
+    assert((weldedVertices || packedVertices) && indices);
+
+    VShaderOut *vertexOut = Renderer_GetVertexBuffer(renderer, vertexCount);
+    if (!vertexOut)
+        return;
+
+    // VERTEX SHADER
+    // Chaque sommet soud n'est transform qu'une seule fois,
+    // quel que soit le nombre de triangles qui le partagent
+#pragma omp parallel for num_threads(4)
+    for (i = 0; i < vertexCount; ++i)
+    {
+        int vertexId = vertexIds ? vertexIds[i] : i;
+        MeshVertex vertex = Graphics_FetchVertex(
+            weldedVertices, packedVertices, packOrigin, packStep, vertexId);
+        VShaderIn in = { 0 };
+
+        in.vertex = vertex.m_position;
+        in.normal = vertex.m_normal;
+        in.tangent = vertex.m_tangent;
+        in.textUV = vertex.m_textUV;
+        in.occlusion = occlusion ? occlusion[vertexId] : 1.0f;
 
-        if (!wireframe)
+        vertexOut[i] = vertShader(&in, &vertGlobals);
+    }
+
+    // Les triangles d'un sous-mesh partagent leur matriau et leurs textures
+    for (int k = 0; k < submeshCount; ++k)
+    {
+        MeshSubmesh *submesh = &submeshes[sorted ? order[k] : k];
+        FShaderGlobals fragGlobals = Graphics_GetFragGlobals(
+            scene, mesh, submesh->m_materialIndex, vertGlobals.cameraPos, Vec3_One);
+
+        int first = submesh->m_triangleOffset;
+        int last = first + submesh->m_triangleCount;
+
+#pragma omp parallel for num_threads(4)
+        for (i = first; i < last; ++i)
         {
-            // Calcule des variables globales du fragment shader
-            int materialIndex = triangle->m_materialIndex;
-            Material *material = NULL;
-            if (materialIndex >= 0)
+            VShaderOut out[3];
+
+            // Copie les sorties du vertex shader (modifies pour l'interpolation)
+            for (int j = 0; j < 3; ++j)
             {
-                material = mesh->m_materials + materialIndex;
+                out[j] = vertexOut[indices[3 * i + j]];
             }
 
-            FShaderGlobals fragGlobals = { 0 };
-            fragGlobals.material = material;
-            fragGlobals.cameraPos = vertGlobals.cameraPos;
-            fragGlobals.scene = scene;
+            Graphics_DrawTriangle(renderer, scene, out, &fragGlobals, fragShader);
+        }
+    }
+}
+
+/// @brief Donnes d'une instance visible pour Graphics_RenderInstances().
+typedef struct GraphicsInstance_s
+{
+    VShaderGlobals m_vertGlobals;
+    Vec3           m_tint;
 
-            // Calcule le rendu du triangle
-            Graphics_RenderTriangle(renderer, out, fragShader, &fragGlobals);
+    /// @brief Niveau de dtail de l'instance (NULL pour le mesh complet).
+    MeshLod       *m_lod;
+
+    /// @brief Position des sommets de l'instance dans le tableau des sorties du vertex shader.
+    int            m_vertexOffset;
+} GraphicsInstance;
+
+void Graphics_RenderInstances(
+    Renderer *renderer, Scene *scene, Mesh *mesh,
+    const Mat4 *transforms, const Vec3 *tints, int instanceCount,
+    VertexShader *vertShader, FragmentShader *fragShader)
+{
+    GraphicsInstance *instances = NULL;
+    int i;
+
+    if (!mesh || instanceCount <= 0)
+        return;
+
+    Camera *camera = Scene_GetCamera(scene);
+    GraphicsFrustum frustum = Graphics_GetFrustum(camera);
+    float pixelError = Scene_GetLodPixelError(scene);
+
+    // Matrices de la camra, communes  toutes les instances
+    Mat4 viewToWorld = Object_GetModelMatrix((Object *)camera);
+    Mat4 worldToView = Mat4_Inv(viewToWorld);
+    Vec3 cameraPos = Vec3_From4(Mat4_MulMV(viewToWorld, Vec4_ZeroH));
+    float meshRadius = Vec3_Length(Vec3_Sub(mesh->m_max, mesh->m_center));
+
+    MeshVertex *weldedVertices = mesh->m_weldedVertices;
+    MeshPackedVertex *packedVertices = mesh->m_packedVertices;
+    Vec3 packOrigin = mesh->m_min;
+    Vec3 packStep = Mesh_GetQuantizationStep(mesh);
+
+    // Occlusion ambiante prcalcule, si le mesh en a une et si la scne l'utilise
+    float *occlusion = Scene_GetAmbientOcclusion(scene) ? mesh->m_occlusion : NULL;
+
+    instances = (GraphicsInstance *)calloc(instanceCount, sizeof(GraphicsInstance));
+    if (!instances) goto ERROR_LABEL;
+
+    // Rejette les instances hors du frustum et choisit le niveau de dtail des autres
+    int visibleCount = 0;
+    int vertexCount = 0;
+    for (i = 0; i < instanceCount; ++i)
+    {
+        Mat4 objToView = Mat4_MulMM(worldToView, transforms[i]);
+        Vec3 center = Vec3_From4(Mat4_MulMV(objToView, Vec4_From3(mesh->m_center, 1.0f)));
+        if (!Graphics_IsSphereVisible(&frustum, center, Graphics_GetMaxScale(objToView) * meshRadius))
+            continue;
+
+        GraphicsInstance *instance = &instances[visibleCount++];
+        instance->m_vertGlobals.cameraPos = cameraPos;
+        instance->m_vertGlobals.viewToWorld = viewToWorld;
+        instance->m_vertGlobals.objToWorld = transforms[i];
+        instance->m_vertGlobals.objToView = objToView;
+        instance->m_vertGlobals.objToClip = Mat4_MulMM(camera->m_projMatrix, objToView);
+        instance->m_tint = tints ? tints[i] : Vec3_One;
+
+        int lodLevel = Graphics_SelectLod(renderer, camera, mesh, objToView, pixelError);
+        instance->m_lod = (lodLevel > 0) ? &mesh->m_lods[lodLevel - 1] : NULL;
+        instance->m_vertexOffset = vertexCount;
+        vertexCount += instance->m_lod ? instance->m_lod->m_vertexCount : mesh->m_weldedCount;
+    }
+
+    // Toutes les instances sont hors du frustum : rien  dessiner
+    if (visibleCount == 0)
+    {
+        free(instances);
+        return;
+    }
+
+    VShaderOut *vertexOut = Renderer_GetVertexBuffer(renderer, vertexCount);
+    if (!vertexOut) goto ERROR_LABEL;
+
+    // VERTEX SHADER
+    // Les donnes du mesh sont partages : seules les matrices changent d'une instance  l'autre
+#pragma omp parallel for schedule(dynamic) num_threads(4)
+    for (i = 0; i < visibleCount; ++i)
+    {
+        GraphicsInstance *instance = &instances[i];
+        MeshLod *lod = instance->m_lod;
+        int count = lod ? lod->m_vertexCount : mesh->m_weldedCount;
+        VShaderOut *instanceOut = vertexOut + instance->m_vertexOffset;
+
+        for (int j = 0; j < count; ++j)
+        {
+            int vertexId = lod ? lod->m_vertices[j] : j;
+            MeshVertex vertex = Graphics_FetchVertex(
+                weldedVertices, packedVertices, packOrigin, packStep, vertexId);
+            VShaderIn in = { 0 };
+
+            in.vertex = vertex.m_position;
+            in.normal = vertex.m_normal;
+            in.tangent = vertex.m_tangent;
+            in.textUV = vertex.m_textUV;
+            in.occlusion = occlusion ? occlusion[vertexId] : 1.0f;
+
+            instanceOut[j] = vertShader(&in, &instance->m_vertGlobals);
         }
-        else
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(4)
+    for (i = 0; i < visibleCount; ++i)
+    {
+        GraphicsInstance *instance = &instances[i];
+        MeshLod *lod = instance->m_lod;
+        MeshSubmesh *submeshes = lod ? lod->m_submeshes : mesh->m_submeshes;
+        int submeshCount = lod ? lod->m_submeshCount : mesh->m_submeshCount;
+        int *indices = lod ? lod->m_indices : mesh->m_indices;
+        VShaderOut *instanceOut = vertexOut + instance->m_vertexOffset;
+
+        // Chaque thread dessine une instance sous-mesh par sous-mesh,
+        // dans l'ordre de la table (les instances sont petites  l'cran)
+        for (int k = 0; k < submeshCount; ++k)
         {
-            // Dessine en fil de fer
-            Vec4 lineColor = Vec4_Set(1.0f, 1.0f, 1.0f, 1.0f);
-            Renderer_DrawLine(renderer, out[0].clipPos, out[1].clipPos, lineColor);
-            Renderer_DrawLine(renderer, out[1].clipPos, out[2].clipPos, lineColor);
-            Renderer_DrawLine(renderer, out[2].clipPos, out[0].clipPos, lineColor);
+            MeshSubmesh *submesh = &submeshes[k];
+            FShaderGlobals fragGlobals = Graphics_GetFragGlobals(
+                scene, mesh, submesh->m_materialIndex, cameraPos, instance->m_tint);
+
+            int last = submesh->m_triangleOffset + submesh->m_triangleCount;
+            for (int j = submesh->m_triangleOffset; j < last; ++j)
+            {
+                VShaderOut out[3];
+
+                // Copie les sorties du vertex shader (modifies pour l'interpolation)
+                out[0] = instanceOut[indices[3 * j + 0]];
+                out[1] = instanceOut[indices[3 * j + 1]];
+                out[2] = instanceOut[indices[3 * j + 2]];
+
+                Graphics_DrawTriangle(renderer, scene, out, &fragGlobals, fragShader);
+            }
         }
     }
+
+    free(instances);
+    return;
+
+ERROR_LABEL:
+    printf("ERROR - Graphics_RenderInstances()\n");
+    assert(false);
+    free(instances);
 }
 
 #define VEC2_INIT_INTERPOLATION(vShaderO, member) \
@@ -118,6 +690,12 @@ for (int i = 0; i < 3; ++i) \
     vShaderO[i].member.z *= invDepth; \
 }
 
+#define FLOAT_INIT_INTERPOLATION(vShaderO, member) \
+for (int i = 0; i < 3; ++i) \
+{ \
+    vShaderO[i].member *= vShaderO[i].invDepth; \
+}
+
 #define VEC2_INTERPOLATE(vShaderO, member, result) \
 for (int i = 0; i < 2; ++i) \
 { \
@@ -128,6 +706,12 @@ for (int i = 0; i < 2; ++i) \
     result.data[i] *= z; \
 }
 
+#define FLOAT_INTERPOLATE(vShaderO, member, result) \
+result = z * ( \
+    w[0] * vShaderO[0].member + \
+    w[1] * vShaderO[1].member + \
+    w[2] * vShaderO[2].member);
+
 #define VEC3_INTERPOLATE(vShaderO, member, result) \
 for (int i = 0; i < 3; ++i) \
 { \
@@ -138,6 +722,68 @@ for (int i = 0; i < 3; ++i) \
     result.data[i] *= z; \
 }
 
+/// @brief Excute le fragment shader sur un lot de fragments puis crit les pixels.
+/// Les textures du matriau sont lues en une seule fois pour tout le lot (Sampler_Sample8()).
+/// @param renderer le moteur de rendu 2D.
+/// @param fragShader le fragment shader.
+/// @param fragGlobals les donnes globales au triangle utilises par le fragment shader.
+/// @param fragments les entres du fragment shader.
+/// @param coords les coordonnes (x,y) des pixels.
+/// @param zValues les profondeurs des pixels.
+/// @param count le nombre de fragments du lot (au plus SAMPLER_BATCH_SIZE).
+static void Graphics_ShadeFragments(
+    Renderer *renderer, FragmentShader *fragShader, FShaderGlobals *fragGlobals,
+    FShaderIn *fragments, int (*coords)[2], float *zValues, int count)
+{
+    Material *material = fragGlobals->material;
+    if (material)
+    {
+        float u[SAMPLER_BATCH_SIZE];
+        float v[SAMPLER_BATCH_SIZE];
+        float res[3][SAMPLER_BATCH_SIZE];
+
+        // Les emplacements inutiliss du lot reprennent le premier fragment
+        for (int i = 0; i < SAMPLER_BATCH_SIZE; ++i)
+        {
+            int j = (i < count) ? i : 0;
+            u[i] = fragments[j].textUV.x;
+            v[i] = fragments[j].textUV.y;
+        }
+
+        MeshTexture *albedoTex = fragGlobals->albedoMap;
+        if (albedoTex)
+        {
+            float lod = Sampler_GetLod(albedoTex, fragGlobals->uvLod);
+            Sampler_Sample8(albedoTex, fragGlobals->filter, SAMPLER_ALBEDO, u, v, lod, res);
+            for (int i = 0; i < count; ++i)
+            {
+                fragments[i].albedo = Vec3_Set(res[0][i], res[1][i], res[2][i]);
+            }
+        }
+
+        MeshTexture *normalTex = fragGlobals->normalMap;
+        if (normalTex && fragGlobals->scene->m_normalMapOnOff)
+        {
+            float lod = Sampler_GetLod(normalTex, fragGlobals->uvLod);
+            Sampler_Sample8(normalTex, fragGlobals->filter, SAMPLER_NORMAL, u, v, lod, res);
+            for (int i = 0; i < count; ++i)
+            {
+                fragments[i].normalSample = Vec3_Set(res[0][i], res[1][i], res[2][i]);
+            }
+        }
+        fragGlobals->texturesSampled = true;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        // FRAGMENT SHADER
+        Vec4 color = fragShader(&fragments[i], fragGlobals);
+
+        // Dfinit le pixel si sa zValue est infrieure  celle du z-buffer
+        Renderer_SetPixel(renderer, coords[i][0], coords[i][1], zValues[i], color, true);
+    }
+}
+
 void Graphics_RenderTriangle(
     Renderer *renderer, VShaderOut *vShaderO,
     FragmentShader *fragShader, FShaderGlobals *fragGlobals)
@@ -162,11 +808,24 @@ void Graphics_RenderTriangle(
         return;
     }
 
-    // Interpolation correcte en perspective
-    VEC2_INIT_INTERPOLATION(vShaderO, textUV);
-    VEC3_INIT_INTERPOLATION(vShaderO, normal);
-    VEC3_INIT_INTERPOLATION(vShaderO, worldPos);
-    VEC3_INIT_INTERPOLATION(vShaderO, tangent);
+    // Pr-passe de profondeur : seule la profondeur est interpole
+    bool depthOnly = Renderer_GetDepthOnly(renderer);
+
+    if (!depthOnly)
+    {
+        // Taille (dans l'espace uv) couverte par un pixel, pour le choix du niveau de mipmap
+        float uvArea = fabsf(Vec2_SignedArea(
+            vShaderO[0].textUV, vShaderO[1].textUV, vShaderO[2].textUV));
+        fragGlobals->uvLod = (uvArea > 0.0f && area > 0.0f) ? 0.5f * log2f(uvArea / area) : 0.0f;
+        fragGlobals->texturesSampled = false;
+
+        // Interpolation correcte en perspective
+        VEC2_INIT_INTERPOLATION(vShaderO, textUV);
+        VEC3_INIT_INTERPOLATION(vShaderO, normal);
+        VEC3_INIT_INTERPOLATION(vShaderO, worldPos);
+        VEC3_INIT_INTERPOLATION(vShaderO, tangent);
+        FLOAT_INIT_INTERPOLATION(vShaderO, occlusion);
+    }
 
     // Calcule la bote englobante du triangle
     Vec2 lower = rasterVertices[0];
@@ -185,6 +844,12 @@ void Graphics_RenderTriangle(
     float z1 = vShaderO[1].clipPos.z;
     float z2 = vShaderO[2].clipPos.z;
 
+    // Lot de fragments en attente d'excution du fragment shader
+    FShaderIn fragments[SAMPLER_BATCH_SIZE];
+    int coords[SAMPLER_BATCH_SIZE][2];
+    float zValues[SAMPLER_BATCH_SIZE];
+    int fragmentCount = 0;
+
     for (int x = xmin; x <= xmax; ++x)
     {
         for (int y = ymin; y <= ymax; ++y)
@@ -197,6 +862,22 @@ void Graphics_RenderTriangle(
                 // Le pixel n'appartient pas au triangle
                 continue;
             }
+
+            // La profondeur est calcule par le mme code dans les deux passes :
+            // le test d'galit de la passe d'ombrage retrouve exactement la mme valeur
+            float zValue = w[0] * z0 + w[1] * z1 + w[2] * z2;
+            if (depthOnly)
+            {
+                Renderer_WriteDepth(renderer, x, y, zValue);
+                continue;
+            }
+
+            // Test de profondeur anticip : un fragment dj cach n'est ni interpol ni shad
+            if (!Renderer_TestDepth(renderer, x, y, zValue))
+            {
+                continue;
+            }
+
             float z = 1.0f / (
                 w[0] * vShaderO[0].invDepth +
                 w[1] * vShaderO[1].invDepth +
@@ -208,13 +889,27 @@ void Graphics_RenderTriangle(
             VEC2_INTERPOLATE(vShaderO, textUV,   fShaderI.textUV);
             VEC3_INTERPOLATE(vShaderO, worldPos, fShaderI.worldPos);
             VEC3_INTERPOLATE(vShaderO, tangent, fShaderI.tangent);
+            FLOAT_INTERPOLATE(vShaderO, occlusion, fShaderI.occlusion);
 
-            // FRAGMENT SHADER
-            Vec4 color = fragShader(&fShaderI, fragGlobals);
-
-            // Dfinit le pixel si sa zValue est infrieure  celle du z-buffer
-            float zValue = w[0] * z0 + w[1] * z1 + w[2] * z2;
-            Renderer_SetPixel(renderer, x, y, zValue, color, true);
+            // Ajoute le fragment au lot
+            fragments[fragmentCount] = fShaderI;
+            coords[fragmentCount][0] = x;
+            coords[fragmentCount][1] = y;
+            zValues[fragmentCount] = zValue;
+            if (++fragmentCount == SAMPLER_BATCH_SIZE)
+            {
+                Graphics_ShadeFragments(
+                    renderer, fragShader, fragGlobals,
+                    fragments, coords, zValues, fragmentCount);
+                fragmentCount = 0;
+            }
         }
     }
+
+    if (fragmentCount > 0)
+    {
+        Graphics_ShadeFragments(
+            renderer, fragShader, fragGlobals,
+            fragments, coords, zValues, fragmentCount);
+    }
 }
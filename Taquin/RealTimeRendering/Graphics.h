@@ -20,6 +20,47 @@ typedef struct FShaderIn_s      FShaderIn;
 typedef VShaderOut VertexShader(VShaderIn *in, VShaderGlobals *globals);
 typedef Vec4     FragmentShader(FShaderIn *in, FShaderGlobals *globals);
 
+/// @brief Plans du frustum de la camra, dans le repre camra.
+/// Le frustum est suppos symtrique (Camera_Init()).
+typedef struct GraphicsFrustum_s
+{
+    /// @brief Facteurs d'chelle horizontal et vertical de la projection.
+    float m_scaleX, m_scaleY;
+
+    /// @brief Normes des normales des plans latraux (scale, 0, 1).
+    float m_normX, m_normY;
+
+    /// @brief Distances des plans proche et loign.
+    float m_near, m_far;
+} GraphicsFrustum;
+
+/// @brief Extrait les plans du frustum d'une camra.
+/// @param camera la camra.
+/// @return Le frustum dans le repre camra.
+GraphicsFrustum Graphics_GetFrustum(Camera *camera);
+
+/// @brief Indique si une sphre (dans le repre camra) coupe le frustum.
+/// @param frustum le frustum.
+/// @param center le centre de la sphre dans le repre camra.
+/// @param radius le rayon de la sphre.
+/// @return false si la sphre est entirement hors du frustum, true sinon.
+bool Graphics_IsSphereVisible(const GraphicsFrustum *frustum, Vec3 center, float radius);
+
+/// @brief Nombre de plans dlimitant le frustum d'une camra.
+#define GRAPHICS_FRUSTUM_PLANE_COUNT 6
+
+/// @brief Exprime les plans du frustum d'une camra dans le rfrentiel monde.
+/// Un point p est dans le frustum si dot(plane.xyz, p) + plane.w >= 0 pour chaque plan ;
+/// les normales sont unitaires.
+/// @param camera la camra.
+/// @param planes les plans (GRAPHICS_FRUSTUM_PLANE_COUNT lments).
+void Graphics_GetWorldFrustumPlanes(Camera *camera, Vec4 *planes);
+
+/// @brief Renvoie le plus grand facteur d'chelle d'une transformation.
+/// @param matrix la matrice de la transformation.
+/// @return Le plus grand facteur d'chelle des trois axes.
+float Graphics_GetMaxScale(Mat4 matrix);
+
 /// @brief Calcule le rendu d'un objet.
 /// @param renderer le moteur de rendu 2D.
 /// @param object l'objet  rendre.
@@ -29,7 +70,37 @@ void Graphics_RenderObject(
     Renderer *renderer, Object *object,
     VertexShader *vertShader, FragmentShader *fragShader);
 
+/// @brief Calcule le rendu d'un objet dont la matrice de transformation dans le rfrentiel
+/// monde est dj connue (voir RenderList), sans parcourir ses parents.
+/// @param renderer le moteur de rendu 2D.
+/// @param object l'objet  rendre.
+/// @param objToWorld la matrice de transformation de l'objet dans le rfrentiel monde.
+/// @param vertShader le vertex shader.
+/// @param fragShader le fragement shader.
+void Graphics_RenderObjectTransformed(
+    Renderer *renderer, Object *object, Mat4 objToWorld,
+    VertexShader *vertShader, FragmentShader *fragShader);
+
+/// @brief Calcule le rendu de plusieurs copies d'un mesh.
+/// Les sommets et les matriaux du mesh sont partags par toutes les instances :
+/// les instances hors du frustum sont rejetes, chacune choisit son niveau de dtail,
+/// puis les sommets de toutes les instances sont transforms en un seul passage.
+/// @param renderer le moteur de rendu 2D.
+/// @param scene la scne (camra et options de rendu).
+/// @param mesh le mesh commun aux instances.
+/// @param transforms les matrices de transformation des instances dans le rfrentiel monde.
+/// @param tints les teintes des instances (multiplies  l'albedo), ou NULL.
+/// @param instanceCount le nombre d'instances.
+/// @param vertShader le vertex shader.
+/// @param fragShader le fragement shader.
+void Graphics_RenderInstances(
+    Renderer *renderer, Scene *scene, Mesh *mesh,
+    const Mat4 *transforms, const Vec3 *tints, int instanceCount,
+    VertexShader *vertShader, FragmentShader *fragShader);
+
 /// @brief Calcule le rendu d'un triangle.
+/// Pendant une pr-passe de profondeur (voir Renderer_SetDepthOnly()), seule la profondeur
+/// est crite : les attributs ne sont pas interpols et le fragment shader n'est pas excut.
 /// @param renderer le moteur de rendu 2D.
 /// @param vertices tableau contenant les trois sommets du triangle.
 /// @param fragShader le fragement shader.
@@ -0,0 +1,130 @@
+﻿#include "InstanceGroup.h"
+#include "Graphics.h"
+#include "Tools.h"
+
+void InstanceGroup_VM_Destroy(Object *object);
+void InstanceGroup_VM_Render(
+    Object *object, Renderer *renderer,
+    VertexShader *vertShader, FragmentShader *fragShader);
+bool InstanceGroup_VM_GetBounds(Object *object, Vec3 *min, Vec3 *max);
+
+static ObjectVMT ObjectVMT_InstanceGroup = {
+    .Destroy = InstanceGroup_VM_Destroy,
+    .Render = InstanceGroup_VM_Render,
+    .GetBounds = InstanceGroup_VM_GetBounds
+};
+
+int InstanceGroup_Init(InstanceGroup *group, Scene *scene, Mat4 localTransform, Object *parent)
+{
+    assert(group && scene);
+
+    int exitStatus = Object_Init(
+        (Object *)group, scene, localTransform, parent);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    ((Object *)group)->m_vptr = &ObjectVMT_InstanceGroup;
+
+    group->m_instanceCount = 0;
+    group->m_instanceCapacity = 0;
+    group->m_transforms = NULL;
+    group->m_tints = NULL;
+    group->m_worldTransforms = NULL;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - InstanceGroup_Init()\n");
+    assert(false);
+    return EXIT_FAILURE;
+}
+
+void InstanceGroup_VM_Destroy(Object *object)
+{
+    InstanceGroup *group = (InstanceGroup *)object;
+
+    free(group->m_transforms);
+    free(group->m_tints);
+    free(group->m_worldTransforms);
+
+    group->m_transforms = NULL;
+    group->m_tints = NULL;
+    group->m_worldTransforms = NULL;
+    group->m_instanceCount = 0;
+    group->m_instanceCapacity = 0;
+}
+
+void InstanceGroup_VM_Render(
+    Object *object, Renderer *renderer,
+    VertexShader *vertShader, FragmentShader *fragShader)
+{
+    InstanceGroup *group = (InstanceGroup *)object;
+    Mesh *mesh = Object_GetMesh(object);
+    if (!mesh || group->m_instanceCount == 0)
+        return;
+
+    // La matrice du groupe n'est calculée qu'une fois pour toutes les instances
+    Mat4 groupToWorld = Object_GetModelMatrix(object);
+    for (int i = 0; i < group->m_instanceCount; ++i)
+    {
+        group->m_worldTransforms[i] = Mat4_MulMM(groupToWorld, group->m_transforms[i]);
+    }
+
+    Graphics_RenderInstances(
+        renderer, Object_getScene(object), mesh,
+        group->m_worldTransforms, group->m_tints, group->m_instanceCount,
+        vertShader, fragShader);
+}
+
+bool InstanceGroup_VM_GetBounds(Object *object, Vec3 *min, Vec3 *max)
+{
+    InstanceGroup *group = (InstanceGroup *)object;
+    Mesh *mesh = Object_GetMesh(object);
+    if (!mesh || group->m_instanceCount == 0)
+        return false;
+
+    // Union des boîtes du mesh placées par chaque instance
+    for (int i = 0; i < group->m_instanceCount; ++i)
+    {
+        Vec3 instanceMin = mesh->m_min;
+        Vec3 instanceMax = mesh->m_max;
+        Mat4_TransformBox(group->m_transforms[i], &instanceMin, &instanceMax);
+
+        *min = (i == 0) ? instanceMin : Vec3_Min(*min, instanceMin);
+        *max = (i == 0) ? instanceMax : Vec3_Max(*max, instanceMax);
+    }
+    return true;
+}
+
+int InstanceGroup_AddInstance(InstanceGroup *group, Mat4 transform, Vec3 tint)
+{
+    if (group->m_instanceCount >= group->m_instanceCapacity)
+    {
+        int capacity = Int_Max(group->m_instanceCapacity << 1, 16);
+
+        Mat4 *newTransforms = (Mat4 *)realloc(group->m_transforms, capacity * sizeof(Mat4));
+        if (!newTransforms) goto ERROR_LABEL;
+        group->m_transforms = newTransforms;
+
+        Vec3 *newTints = (Vec3 *)realloc(group->m_tints, capacity * sizeof(Vec3));
+        if (!newTints) goto ERROR_LABEL;
+        group->m_tints = newTints;
+
+        Mat4 *newWorldTransforms = (Mat4 *)realloc(group->m_worldTransforms, capacity * sizeof(Mat4));
+        if (!newWorldTransforms) goto ERROR_LABEL;
+        group->m_worldTransforms = newWorldTransforms;
+
+        group->m_instanceCapacity = capacity;
+    }
+
+    int index = group->m_instanceCount++;
+    group->m_transforms[index] = transform;
+    group->m_tints[index] = tint;
+    Object_Invalidate((Object *)group);
+
+    return index;
+
+ERROR_LABEL:
+    printf("ERROR - InstanceGroup_AddInstance()\n");
+    assert(false);
+    return -1;
+}
@@ -0,0 +1,90 @@
+﻿#ifndef _INSTANCE_GROUP_H_
+#define _INSTANCE_GROUP_H_
+
+/// @file InstanceGroup.h
+/// @defgroup InstanceGroup
+/// @{
+
+#include "Settings.h"
+#include "Object.h"
+
+/// @brief Objet affichant plusieurs copies de son mesh (foule de personnages...).
+/// Les copies partagent le mesh et ses matériaux, et sont rendues en une seule fois
+/// par Graphics_RenderInstances() : la matrice du groupe n'est calculée qu'une fois par image.
+typedef struct InstanceGroup_s
+{
+    Object m_base;
+
+    /// @brief Nombre d'instances.
+    int    m_instanceCount;
+
+    /// @brief Nombre maximal d'instances avant une réallocation.
+    int    m_instanceCapacity;
+
+    /// @brief Transformations des instances par rapport au groupe.
+    Mat4  *m_transforms;
+
+    /// @brief Teintes des instances, multipliées à l'albedo.
+    Vec3  *m_tints;
+
+    /// @protected
+    /// @brief Transformations des instances dans le référentiel monde (calculées au rendu).
+    Mat4  *m_worldTransforms;
+} InstanceGroup;
+
+/// @brief Initialise un groupe d'instances alloué par Scene_CreateObject().
+/// Le mesh commun aux instances est défini avec Object_SetMesh().
+/// @param[in,out] group le groupe à initialiser.
+/// @param[in] scene la scène.
+/// @param[in] localTransform matrice de transformation locale du groupe.
+/// @param[in,out] parent Objet parent auquel le groupe sera attaché.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int InstanceGroup_Init(InstanceGroup *group, Scene *scene, Mat4 localTransform, Object *parent);
+
+/// @brief Ajoute une instance au groupe.
+/// @param[in,out] group le groupe.
+/// @param[in] transform la transformation de l'instance par rapport au groupe.
+/// @param[in] tint la teinte de l'instance (Vec3_One pour les couleurs d'origine).
+/// @return L'indice de l'instance ou -1 en cas d'erreur.
+int InstanceGroup_AddInstance(InstanceGroup *group, Mat4 transform, Vec3 tint);
+
+/// @brief Supprime toutes les instances du groupe.
+/// @param[in,out] group le groupe.
+INLINE void InstanceGroup_Clear(InstanceGroup *group)
+{
+    group->m_instanceCount = 0;
+    Object_Invalidate((Object *)group);
+}
+
+/// @brief Renvoie le nombre d'instances d'un groupe.
+/// @param[in] group le groupe.
+/// @return Le nombre d'instances.
+INLINE int InstanceGroup_GetInstanceCount(InstanceGroup *group)
+{
+    return group->m_instanceCount;
+}
+
+/// @brief Modifie la transformation d'une instance.
+/// @param[in,out] group le groupe.
+/// @param[in] index l'indice de l'instance.
+/// @param[in] transform la transformation de l'instance par rapport au groupe.
+INLINE void InstanceGroup_SetTransform(InstanceGroup *group, int index, Mat4 transform)
+{
+    assert(0 <= index && index < group->m_instanceCount);
+    group->m_transforms[index] = transform;
+    Object_Invalidate((Object *)group);
+}
+
+/// @brief Modifie la teinte d'une instance.
+/// @param[in,out] group le groupe.
+/// @param[in] index l'indice de l'instance.
+/// @param[in] tint la teinte de l'instance.
+INLINE void InstanceGroup_SetTint(InstanceGroup *group, int index, Vec3 tint)
+{
+    assert(0 <= index && index < group->m_instanceCount);
+    group->m_tints[index] = tint;
+}
+
+/// @}
+
+#endif
@@ -2,24 +2,106 @@
 #include "Material.h"
 #include "Vector.h"
 #include "Tools.h"
+#include "Sampler.h"
+#include "TextureRegistry.h"
+#include "TextureCache.h"
+#include "TextureBlock.h"
+#include "FileMap.h"
+
+/// @brief Image  dcoder lors du chargement d'un fichier MTL.
+typedef struct MaterialTextureJob_s
+{
+    char m_path[TEXTURE_PATH_SIZE];
+    int m_flags;
+    MeshTexture *m_texture;
+
+    /// @brief Nombre de matriaux ayant dj reu la texture.
+    int m_useCount;
+} MaterialTextureJob;
+
+/// @brief Ajoute une image  la liste des textures  dcoder.
+/// Une image dj prsente (mme chemin normalis, mmes options) n'est ajoute qu'une fois.
+/// @return L'indice de la tche ou -1 en cas d'erreur.
+static int Material_AddTextureJob(
+    MaterialTextureJob **jobs, int *jobCount, int *jobCapacity, char *path, int flags)
+{
+    char canonicalPath[TEXTURE_PATH_SIZE] = { 0 };
+
+    int exitStatus = TextureRegistry_GetCanonicalPath(path, canonicalPath);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    for (int i = 0; i < *jobCount; ++i)
+    {
+        MaterialTextureJob *job = &(*jobs)[i];
+        if (job->m_flags == flags && strcmp(job->m_path, canonicalPath) == 0)
+            return i;
+    }
+
+    if (*jobCount >= *jobCapacity)
+    {
+        int capacity = Int_Max(*jobCapacity << 1, 16);
+        MaterialTextureJob *newJobs = (MaterialTextureJob *)realloc(
+            *jobs, capacity * sizeof(MaterialTextureJob));
+        if (!newJobs) goto ERROR_LABEL;
+
+        *jobs = newJobs;
+        *jobCapacity = capacity;
+    }
+
+    MaterialTextureJob *job = &(*jobs)[*jobCount];
+    memset(job, 0, sizeof(MaterialTextureJob));
+    strcpy_s(job->m_path, TEXTURE_PATH_SIZE, canonicalPath);
+    job->m_flags = flags;
+
+    return (*jobCount)++;
+
+ERROR_LABEL:
+    printf("ERROR - Material_AddTextureJob()\n");
+    assert(false);
+    return -1;
+}
+
+/// @brief Donne  un matriau la texture dcode par une tche.
+/// Chaque matriau possde sa propre rfrence dans le registre.
+static MeshTexture *Material_TakeTexture(MaterialTextureJob *job)
+{
+    if (job->m_useCount++ > 0)
+    {
+        TextureRegistry_Retain(job->m_texture);
+    }
+    return job->m_texture;
+}
+
+/// @brief Lit le chemin d'une image dans une ligne d'un fichier mtl.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+static int Material_ReadTexturePath(char *folderPath, char *word, char *texturePath)
+{
+    char filePathBuffer[MATERIAL_PATH_SIZE] = { 0 };
+
+    strcpy_s(filePathBuffer, MATERIAL_PATH_SIZE, folderPath);
+    strcat_s(filePathBuffer, MATERIAL_PATH_SIZE, "/");
+    strcat_s(filePathBuffer, MATERIAL_PATH_SIZE, word);
+
+    return TextureRegistry_GetCanonicalPath(filePathBuffer, texturePath);
+}
 
 Material *Material_LoadMTL(Mesh *mesh, char *path, char *fileName, int *count)
 {
-    char *fileBuffer = NULL;
+    FileMap *file = NULL;
     char *curLine = NULL;
     int lineCapacity = 64;
     Material *materials = NULL;
     int materialCount = 0;
     int materialCapacity = 64;
-    char filePathBuffer[1024] = { 0 };
 
     // Dfinit le nombre de matriaux  0 par scurit
     *count = 0;
 
-    // Charge le fichier dans un buffer
+    // Projette le fichier en mmoire
     long size = 0;
-    fileBuffer = Buffer_GetFromFile(path, fileName, &size);
-    if (!fileBuffer) { assert(false); goto ERROR_LABEL; }
+    file = Buffer_MapFile(path, fileName, &size);
+    if (!file) { assert(false); goto ERROR_LABEL; }
+    const char *fileBuffer = (const char *)FileMap_GetData(file);
 
     // Alloue la ligne
     curLine = (char *)calloc(lineCapacity, sizeof(char));
@@ -28,7 +110,8 @@ Material *Material_LoadMTL(Mesh *mesh, char *path, char *fileName, int *count)
     materials = (Material *)calloc(materialCapacity, sizeof(Material));
     if (!materials) goto ERROR_LABEL;
 
-    // Parse le buffer
+    // Parse le buffer.
+    // Les images ne sont pas dcodes ici mais seulement listes.
     int offset = 0;
     int lineNb = 0;
     int index = -1;
@@ -50,6 +133,7 @@ Material *Material_LoadMTL(Mesh *mesh, char *path, char *fileName, int *count)
         {
             word = strtok_s(NULL, " ", &context);
             if (!word) continue;
+            if (materialCount >= materialCapacity) goto ERROR_LABEL;
 
             materialCount++;
             index++;
@@ -59,36 +143,27 @@ Material *Material_LoadMTL(Mesh *mesh, char *path, char *fileName, int *count)
         else if (strcmp(word, "map_Ka") == 0 || strcmp(word, "map_Kd") == 0)
         {
             word = strtok_s(NULL, " ", &context);
-            if (!word) continue;
+            if (!word || index < 0) continue;
+            if (materials[index].m_albedoPath[0] != '\0') continue;
 
-            strcpy_s(filePathBuffer, 1024, path);
-            strcat_s(filePathBuffer, 1024, "/");
-            strcat_s(filePathBuffer, 1024, word);
-            if (materials[index].m_albedoMap != NULL) continue;
-
-            MeshTexture *texture = MeshTexture_Load(filePathBuffer);
-            if (!texture) goto ERROR_LABEL;
-            
-            materials[index].m_albedoMap = texture;
+            exitStatus = Material_ReadTexturePath(path, word, materials[index].m_albedoPath);
+            if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
         }
         else if (strcmp(word, "map_Nrm") == 0)
         {
             word = strtok_s(NULL, " ", &context);
-            if (!word) continue;
+            if (!word || index < 0) continue;
+            if (materials[index].m_normalPath[0] != '\0') continue;
 
-            strcpy_s(filePathBuffer, 1024, path);
-            strcat_s(filePathBuffer, 1024, "/");
-            strcat_s(filePathBuffer, 1024, word);
-            if (materials[index].m_normalMap != NULL) continue;
-
-            MeshTexture *texture = MeshTexture_Load(filePathBuffer);
-            if (!texture) goto ERROR_LABEL;
-
-            materials[index].m_normalMap = texture;
+            exitStatus = Material_ReadTexturePath(path, word, materials[index].m_normalPath);
+            if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
         }
 
     } while (offset < size);
 
+    FileMap_Close(file);
+    free(curLine);
+
     *count = materialCount;
 
     return materials;
@@ -96,27 +171,171 @@ Material *Material_LoadMTL(Mesh *mesh, char *path, char *fileName, int *count)
 ERROR_LABEL:
     printf("ERROR - Material_LoadMTL()\n");
     assert(false);
+    FileMap_Close(file);
+    free(curLine);
+    Material_Free(materials, materialCount);
     return NULL;
 }
 
+int Material_LoadTextures(Material *materials, int count)
+{
+    MaterialTextureJob *jobs = NULL;
+    int jobCount = 0;
+    int jobCapacity = 0;
+    int *albedoJobs = NULL;
+    int *normalJobs = NULL;
+
+    // Indices des textures  dcoder pour chaque matriau
+    albedoJobs = (int *)calloc(Int_Max(count, 1), sizeof(int));
+    normalJobs = (int *)calloc(Int_Max(count, 1), sizeof(int));
+    if (!albedoJobs || !normalJobs) goto ERROR_LABEL;
+
+    // Liste les images distinctes
+    for (int i = 0; i < count; ++i)
+    {
+        Material *material = &materials[i];
+        albedoJobs[i] = -1;
+        normalJobs[i] = -1;
+
+        if (material->m_albedoPath[0] != '\0' && !Material_GetAlbedo(material))
+        {
+            albedoJobs[i] = Material_AddTextureJob(
+                &jobs, &jobCount, &jobCapacity, material->m_albedoPath, MESH_TEXTURE_DEFAULT);
+            if (albedoJobs[i] < 0) goto ERROR_LABEL;
+        }
+        if (material->m_normalPath[0] != '\0' && !Material_GetNormalMap(material))
+        {
+            normalJobs[i] = Material_AddTextureJob(
+                &jobs, &jobCount, &jobCapacity, material->m_normalPath, MESH_TEXTURE_NORMAL_MAP);
+            if (normalJobs[i] < 0) goto ERROR_LABEL;
+        }
+    }
+
+    // Dcode les images en parallle.
+    // Les tches sont de dures trs ingales (taille des images), d'o l'ordonnancement dynamique.
+    // Chaque texture est attache  ses matriaux ds qu'elle est prte, par le thread
+    // qui l'a dcode.
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < jobCount; ++i)
+    {
+        MaterialTextureJob *job = &jobs[i];
+        job->m_texture = TextureRegistry_Acquire(job->m_path, job->m_flags);
+        if (!job->m_texture) continue;
+
+        for (int j = 0; j < count; ++j)
+        {
+            if (albedoJobs[j] == i)
+            {
+                SDL_AtomicSetPtr((void **)&materials[j].m_albedoMap, Material_TakeTexture(job));
+            }
+            if (normalJobs[j] == i)
+            {
+                SDL_AtomicSetPtr((void **)&materials[j].m_normalMap, Material_TakeTexture(job));
+            }
+        }
+    }
+
+    bool success = true;
+    for (int i = 0; i < jobCount; ++i)
+    {
+        success = success && (jobs[i].m_texture != NULL);
+    }
+    if (!success) goto ERROR_LABEL;
+
+    free(jobs);
+    free(albedoJobs);
+    free(normalJobs);
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - Material_LoadTextures()\n");
+    assert(false);
+    free(jobs);
+    free(albedoJobs);
+    free(normalJobs);
+    return EXIT_FAILURE;
+}
+
 void Material_Free(Material *materials, int count)
 {
     if (!materials) return;
 
     for (int i = 0; i < count; ++i)
     {
-        MeshTexture_Free(materials[i].m_albedoMap);
-        MeshTexture_Free(materials[i].m_normalMap);
+        TextureRegistry_Release(materials[i].m_albedoMap);
+        TextureRegistry_Release(materials[i].m_normalMap);
     }
 
     free(materials);
 }
 
-MeshTexture *MeshTexture_Load(char *path)
+/// @brief Calcule les niveaux de mipmap d'une texture dont le niveau 0 est dj rempli.
+/// Chaque niveau est obtenu par une moyenne 2x2 du niveau prcdent.
+/// @param[in,out] texture la texture.
+static void MeshTexture_BuildLevels(MeshTexture *texture)
+{
+    for (int level = 1; level < texture->m_levelCount; ++level)
+    {
+        MeshTextureLevel *src = &texture->m_levels[level - 1];
+        MeshTextureLevel *dst = &texture->m_levels[level];
+        Color *srcPixels = texture->m_pixels + src->m_offset;
+        Color *dstPixels = texture->m_pixels + dst->m_offset;
+
+        for (int y = 0; y < dst->m_height; ++y)
+        {
+            int y0 = Int_Min(2 * y, src->m_height - 1);
+            int y1 = Int_Min(2 * y + 1, src->m_height - 1);
+            for (int x = 0; x < dst->m_width; ++x)
+            {
+                int x0 = Int_Min(2 * x, src->m_width - 1);
+                int x1 = Int_Min(2 * x + 1, src->m_width - 1);
+                Color c00 = srcPixels[y0 * src->m_width + x0];
+                Color c01 = srcPixels[y0 * src->m_width + x1];
+                Color c10 = srcPixels[y1 * src->m_width + x0];
+                Color c11 = srcPixels[y1 * src->m_width + x1];
+                Color res;
+                for (int c = 0; c < 4; ++c)
+                {
+                    int sum = c00.data[c] + c01.data[c] + c10.data[c] + c11.data[c];
+                    res.data[c] = (Uint8)((sum + 2) >> 2);
+                }
+                dstPixels[y * dst->m_width + x] = res;
+            }
+        }
+    }
+}
+
+/// @brief Dernier identifiant attribu  une texture.
+static SDL_atomic_t g_meshTextureUid = { 0 };
+
+/// @brief Choisit le format compress adapt au contenu d'une texture RGBA8.
+static MeshTextureFormat MeshTexture_GetCompressedFormat(MeshTexture *texture, int flags)
+{
+    if (flags & MESH_TEXTURE_NORMAL_MAP)
+        return MESH_TEXTURE_BC5;
+
+    int texelCount = texture->m_width * texture->m_height;
+    for (int i = 0; i < texelCount; ++i)
+    {
+        if (texture->m_pixels[i].a != 255)
+            return MESH_TEXTURE_BC3;
+    }
+    return MESH_TEXTURE_BC1;
+}
+
+MeshTexture *MeshTexture_Load(char *path, int flags)
 {
     MeshTexture *texture = NULL;
     SDL_Surface *surface = NULL;
 
+    texture = TextureCache_Load(path, flags);
+    if (texture)
+    {
+        texture->m_uid = (Uint32)SDL_AtomicAdd(&g_meshTextureUid, 1) + 1;
+        return texture;
+    }
+
     texture = (MeshTexture *)calloc(1, sizeof(MeshTexture));
     if (!texture) goto ERROR_LABEL;
 
@@ -140,26 +359,61 @@ MeshTexture *MeshTexture_Load(char *path)
     int width = surface->w;
     int height = surface->h;
 
+    // Calcule la taille de la chane de mipmaps
+    int levelCount = 0;
+    int texelCount = 0;
+    int levelW = width;
+    int levelH = height;
+    while (levelCount < MESH_TEXTURE_MAX_LEVELS)
+    {
+        MeshTextureLevel *level = &texture->m_levels[levelCount++];
+        level->m_offset = texelCount;
+        level->m_width = levelW;
+        level->m_height = levelH;
+        texelCount += levelW * levelH;
+
+        if (levelW == 1 && levelH == 1)
+            break;
+
+        levelW = Int_Max(levelW >> 1, 1);
+        levelH = Int_Max(levelH >> 1, 1);
+    }
+
+    texture->m_format = MESH_TEXTURE_RGBA8;
     texture->m_width = width;
     texture->m_height = height;
-    texture->m_pixels = (Color **)calloc(width, sizeof(Color *));
+    texture->m_levelCount = levelCount;
+    texture->m_lodBias = 0.5f * log2f((float)width * (float)height);
+    texture->m_pixels = (Color *)calloc(texelCount, sizeof(Color));
     if (!texture->m_pixels) goto ERROR_LABEL;
 
-    for (int x = 0; x < width; ++x)
+    for (int y = 0; y < height; ++y)
     {
-        texture->m_pixels[x] = (Color *)calloc(height, sizeof(Color));
-        if (!texture->m_pixels[x]) goto ERROR_LABEL;
-
-        for (int y = 0; y < height; ++y)
-        {
-            uint32_t *pixelRow = (uint32_t *)&((uint8_t *)surface->pixels)[y * pitch];
-            texture->m_pixels[x][y] = ((Color *)pixelRow)[x];
-        }
+        Uint8 *pixelRow = &((Uint8 *)surface->pixels)[y * pitch];
+        memcpy(texture->m_pixels + y * width, pixelRow, width * sizeof(Color));
     }
 
     SDL_FreeSurface(surface);
     surface = NULL;
 
+    MeshTexture_BuildLevels(texture);
+    texture->m_uid = (Uint32)SDL_AtomicAdd(&g_meshTextureUid, 1) + 1;
+
+    if (flags & MESH_TEXTURE_COMPRESSED)
+    {
+        static const char *formatNames[] = { "RGBA8", "BC1", "BC3", "BC5" };
+        MeshTextureFormat compressedFormat = MeshTexture_GetCompressedFormat(texture, flags);
+        float psnr = 0.0f;
+
+        int exitStatus = TextureBlock_Compress(texture, compressedFormat, &psnr);
+        if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+        printf("texture %s %s : PSNR = %.2f dB\n", formatNames[compressedFormat], path, psnr);
+    }
+
+    // Une erreur d'criture dans le cache n'empche pas d'utiliser la texture
+    TextureCache_Store(path, flags, texture);
+
     return texture;
 
 ERROR_LABEL:
@@ -169,6 +423,7 @@ ERROR_LABEL:
     {
         SDL_FreeSurface(surface);
     }
+    MeshTexture_Free(texture);
     return NULL;
 }
 
@@ -176,34 +431,18 @@ void MeshTexture_Free(MeshTexture *meshTexture)
 {
     if (!meshTexture) return;
 
-    if (meshTexture->m_pixels)
+    if (meshTexture->m_fileMap)
+    {
+        FileMap_Close(meshTexture->m_fileMap);
+    }
+    else
     {
-        for (int x = 0; x < meshTexture->m_width; ++x)
-        {
-            free(meshTexture->m_pixels[x]);
-        }
         free(meshTexture->m_pixels);
     }
-
     free(meshTexture);
 }
 
 Vec3 MeshTexture_GetColorVec3(MeshTexture *texture, Vec2 textUV)
 {
-    int textureW = texture->m_width;
-    int textureH = texture->m_height;
-
-    float u = textUV.x - floorf(textUV.x);
-    float v = textUV.y - floorf(textUV.y);
-    v = 1.0f - v;
-
-    int x = (int)(u * textureW);
-    int y = (int)(v * textureH);
-
-    x = Int_Clamp(x, 0, textureW - 1);
-    y = Int_Clamp(y, 0, textureH - 1);
-
-    Color color = texture->m_pixels[x][y];
-    return Vec3_Set(color.r / 255.f, color.g / 255.f, color.b / 255.f);
+    return Sampler_Sample(texture, SAMPLER_NEAREST, SAMPLER_ALBEDO, textUV, 0.0f);
 }
-
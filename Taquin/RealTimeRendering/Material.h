@@ -1,11 +1,15 @@
-#ifndef _MATERIAL_H_
+﻿#ifndef _MATERIAL_H_
 #define _MATERIAL_H_
 
 #include "Settings.h"
 #include "Mesh.h"
+#include "FileMap.h"
 
 #define MATERIAL_NAME_SIZE 128
 
+/// @brief Taille maximale du chemin d'une image référencée par un matériau.
+#define MATERIAL_PATH_SIZE 1024
+
 typedef union Color_s
 {
     struct {
@@ -14,36 +18,173 @@ typedef union Color_s
     Uint8 data[4];
 } Color;
 
+/// @brief Options de décodage d'une texture.
+/// Deux références à une même image avec des options différentes donnent deux textures distinctes.
+typedef enum MeshTextureFlags_e
+{
+    MESH_TEXTURE_DEFAULT    = 0,
+
+    /// @brief L'image est une "normal map" (map_Nrm).
+    MESH_TEXTURE_NORMAL_MAP = 1 << 0,
+
+    /// @brief La texture est compressée par blocs (BC1/BC3, ou BC5 pour une normal map).
+    MESH_TEXTURE_COMPRESSED = 1 << 1
+} MeshTextureFlags;
+
+/// @brief Format des texels d'une texture.
+typedef enum MeshTextureFormat_e
+{
+    /// @brief Quatre octets par texel (Color).
+    MESH_TEXTURE_RGBA8 = 0,
+
+    /// @brief Blocs de 4x4 texels sur 8 octets, couleur sans alpha.
+    MESH_TEXTURE_BC1 = 1,
+
+    /// @brief Blocs de 4x4 texels sur 16 octets, couleur avec alpha.
+    MESH_TEXTURE_BC3 = 2,
+
+    /// @brief Blocs de 4x4 texels sur 16 octets, deux canaux (x et y d'une normale).
+    MESH_TEXTURE_BC5 = 3
+} MeshTextureFormat;
+
+/// @brief Indique si un format est compressé par blocs de 4x4 texels.
+INLINE bool MeshTextureFormat_IsCompressed(MeshTextureFormat format)
+{
+    return format != MESH_TEXTURE_RGBA8;
+}
+
+/// @brief Renvoie la taille en octets d'un texel (format RGBA8) ou d'un bloc (formats compressés).
+INLINE int MeshTextureFormat_GetUnitSize(MeshTextureFormat format)
+{
+    switch (format)
+    {
+    case MESH_TEXTURE_BC1: return 8;
+    case MESH_TEXTURE_BC3: return 16;
+    case MESH_TEXTURE_BC5: return 16;
+    case MESH_TEXTURE_RGBA8:
+    default: return 4;
+    }
+}
+
+/// @brief Nombre maximal de niveaux de mipmap d'une texture.
+#define MESH_TEXTURE_MAX_LEVELS 16
+
+/// @brief Description d'un niveau de mipmap.
+typedef struct MeshTextureLevel_s
+{
+    /// @brief Position du niveau dans les données de la texture,
+    /// en texels (format RGBA8) ou en blocs (formats compressés).
+    int m_offset;
+    int m_width;
+    int m_height;
+} MeshTextureLevel;
+
 typedef struct MeshTexture_s
 {
-    Color **m_pixels;
+    union
+    {
+        /// @brief Texels de tous les niveaux de mipmap, rangés ligne par ligne
+        /// puis niveau par niveau. La ligne 0 correspond au haut de l'image.
+        Color *m_pixels;
+
+        /// @brief Blocs de tous les niveaux (formats compressés), rangés de la même manière.
+        Uint8 *m_blocks;
+    };
+    MeshTextureFormat m_format;
+
+    /// @brief Identifiant unique de la texture (voir TextureBlock_Fetch()).
+    Uint32 m_uid;
     int m_width;
     int m_height;
+
+    int m_levelCount;
+    MeshTextureLevel m_levels[MESH_TEXTURE_MAX_LEVELS];
+
+    /// @brief Vaut log2(sqrt(m_width * m_height)), voir Sampler_GetLod().
+    float m_lodBias;
+
+    /// @brief Fichier du cache contenant les texels (voir TextureCache_Load()).
+    /// Vaut NULL si m_pixels a été alloué.
+    FileMap *m_fileMap;
 } MeshTexture;
 
-MeshTexture *MeshTexture_Load(char *path);
+/// @brief Crée la texture associée à une image (avec ses mipmaps).
+/// La texture est lue dans le cache si elle y est à jour, sinon l'image est décodée
+/// puis ajoutée au cache.
+/// Pour partager les textures entre matériaux, utiliser TextureRegistry_Acquire().
+/// @param[in] path le chemin de l'image.
+/// @param[in] flags les options de décodage (MeshTextureFlags).
+/// @return La texture créée ou NULL en cas d'erreur.
+MeshTexture *MeshTexture_Load(char *path, int flags);
+
+/// @brief Détruit une texture créée par MeshTexture_Load().
+/// @param[in,out] meshTexture la texture à détruire.
 void MeshTexture_Free(MeshTexture *meshTexture);
 
+/// @brief Calcule la taille en octets des données (tous niveaux confondus) d'une texture.
+/// @param[in] format le format de la texture.
+/// @param[in] levels les niveaux de mipmap.
+/// @param[in] levelCount le nombre de niveaux.
+/// @return La taille des données.
+INLINE Uint64 MeshTexture_GetDataSize(
+    MeshTextureFormat format, MeshTextureLevel *levels, int levelCount)
+{
+    MeshTextureLevel *last = &levels[levelCount - 1];
+    Uint64 lastCount = (Uint64)last->m_width * (Uint64)last->m_height;
+    if (MeshTextureFormat_IsCompressed(format))
+    {
+        lastCount = (Uint64)((last->m_width + 3) >> 2) * (Uint64)((last->m_height + 3) >> 2);
+    }
+    return ((Uint64)last->m_offset + lastCount) * MeshTextureFormat_GetUnitSize(format);
+}
+
 Vec3 MeshTexture_GetColorVec3(MeshTexture *meshTexture, Vec2 textUV);
 
 typedef struct Material_s
 {
     char m_name[MATERIAL_NAME_SIZE];
+
+    /// @brief Textures du matériau (NULL tant qu'elles ne sont pas chargées).
+    /// Elles sont publiées de façon atomique et peuvent apparaître pendant le rendu.
     MeshTexture *m_albedoMap;
     MeshTexture *m_normalMap;
+
+    /// @brief Chemins normalisés des images (vides si le matériau n'en utilise pas).
+    char m_albedoPath[MATERIAL_PATH_SIZE];
+    char m_normalPath[MATERIAL_PATH_SIZE];
 } Material;
 
+/// @brief Lit les matériaux d'un fichier mtl.
+/// Les images ne sont pas décodées : voir Material_LoadTextures().
+/// @param[in] mesh le mesh utilisant les matériaux.
+/// @param[in] path le dossier du fichier mtl.
+/// @param[in] fileName le nom du fichier mtl.
+/// @param[out] count le nombre de matériaux.
+/// @return Le tableau des matériaux ou NULL en cas d'erreur.
 Material *Material_LoadMTL(Mesh *mesh, char *path, char *fileName, int *count);
+
+/// @brief Décode (en parallèle) les images des matériaux et leur attribue les textures.
+/// Chaque texture est attachée dès que son image est décodée : cette fonction peut être
+/// appelée depuis un autre thread pendant que les matériaux sont utilisés pour le rendu.
+/// @param[in,out] materials les matériaux.
+/// @param[in] count le nombre de matériaux.
+/// @return EXIT_SUCCESS, ou EXIT_FAILURE si une image n'a pas pu être chargée.
+int Material_LoadTextures(Material *materials, int count);
+
+/// @brief Détruit un tableau de matériaux.
+/// Les textures sont rendues au registre (TextureRegistry_Release()).
+/// @param[in,out] materials les matériaux.
+/// @param[in] count le nombre de matériaux.
 void Material_Free(Material *materials, int count);
 
 INLINE MeshTexture *Material_GetAlbedo(Material *material)
 {
-    return material->m_albedoMap;
+    return (MeshTexture *)SDL_AtomicGetPtr((void **)&material->m_albedoMap);
 }
 
 INLINE MeshTexture *Material_GetNormalMap(Material *material)
 {
-    return material->m_normalMap;
+    return (MeshTexture *)SDL_AtomicGetPtr((void **)&material->m_normalMap);
 }
 
 #endif
@@ -103,6 +103,28 @@ Vec4 Mat4_MulMV(Mat4 mat, Vec4 v)
 }
 
 // TODO
+void Mat4_TransformBox(Mat4 mat, Vec3 *min, Vec3 *max)
+{
+    Vec3 newMin, newMax;
+
+    // Le centre est transformé, les demi-côtés sont projetés sur chaque axe
+    for (int i = 0; i < 3; i++)
+    {
+        float center = mat.data[i][3];
+        float extent = 0.0f;
+        for (int j = 0; j < 3; j++)
+        {
+            center += mat.data[i][j] * 0.5f * (min->data[j] + max->data[j]);
+            extent += fabsf(mat.data[i][j]) * 0.5f * (max->data[j] - min->data[j]);
+        }
+        newMin.data[i] = center - extent;
+        newMax.data[i] = center + extent;
+    }
+
+    *min = newMin;
+    *max = newMax;
+}
+
 Mat4 Mat4_Scale(Mat4 mat, float s)
 {
     Mat4 res = { 0 };
@@ -67,6 +67,13 @@ Mat4 Mat4_MulMM(Mat4 mat1, Mat4 mat2);
 /// @return Le produit matrice-vecteur de mat par v.
 Vec4 Mat4_MulMV(Mat4 mat, Vec4 v);
 
+/// @brief Calcule la boîte alignée sur les axes englobant l'image d'une boîte
+/// par une transformation affine.
+/// @param mat la matrice de la transformation.
+/// @param[in,out] min le coin minimal de la boîte.
+/// @param[in,out] max le coin maximal de la boîte.
+void Mat4_TransformBox(Mat4 mat, Vec3 *min, Vec3 *max);
+
 /// @brief Multiplie les coefficients d'une matrice 4x4 par un scalaire.
 /// Cette fonction ne renvoie pas la matrice de transformation homogène correspondant à une homothétie.
 /// @param mat la matrice.
@@ -0,0 +1,112 @@
+﻿#include "MemoryPool.h"
+#include "Tools.h"
+
+/// @brief En-tête d'un emplacement.
+typedef union MemoryPoolHeader_u
+{
+    /// @brief Pool de l'élément alloué.
+    MemoryPool *m_pool;
+
+    /// @brief Emplacement libre suivant.
+    union MemoryPoolHeader_u *m_next;
+
+    char m_padding[MEMORY_POOL_HEADER_SIZE];
+} MemoryPoolHeader;
+
+void MemoryPool_Init(MemoryPool *pool, int elementSize, int slotsPerSlab)
+{
+    assert(elementSize > 0 && slotsPerSlab > 0);
+
+    memset(pool, 0, sizeof(MemoryPool));
+    pool->m_elementSize = elementSize;
+    pool->m_slotSize = MEMORY_POOL_HEADER_SIZE
+        + (elementSize + MEMORY_POOL_HEADER_SIZE - 1) / MEMORY_POOL_HEADER_SIZE * MEMORY_POOL_HEADER_SIZE;
+    pool->m_slotsPerSlab = slotsPerSlab;
+}
+
+void MemoryPool_Free(MemoryPool *pool)
+{
+    for (int i = 0; i < pool->m_slabCount; ++i)
+    {
+        free(pool->m_slabs[i]);
+    }
+    free(pool->m_slabs);
+
+    pool->m_slabs = NULL;
+    pool->m_slabCount = 0;
+    pool->m_slabCapacity = 0;
+    pool->m_freeList = NULL;
+    pool->m_usedCount = 0;
+}
+
+/// @brief Ajoute un bloc au pool et chaîne ses emplacements libres.
+static int MemoryPool_AddSlab(MemoryPool *pool)
+{
+    char *slab = NULL;
+
+    if (pool->m_slabCount >= pool->m_slabCapacity)
+    {
+        int capacity = Int_Max(pool->m_slabCapacity << 1, 8);
+        char **newSlabs = (char **)realloc(pool->m_slabs, capacity * sizeof(char *));
+        if (!newSlabs) goto ERROR_LABEL;
+
+        pool->m_slabs = newSlabs;
+        pool->m_slabCapacity = capacity;
+    }
+
+    slab = (char *)calloc(pool->m_slotsPerSlab, pool->m_slotSize);
+    if (!slab) goto ERROR_LABEL;
+
+    // Chaînés à l'envers : les emplacements sont ensuite distribués dans l'ordre du bloc
+    for (int i = pool->m_slotsPerSlab - 1; i >= 0; --i)
+    {
+        MemoryPoolHeader *header = (MemoryPoolHeader *)(slab + (size_t)i * pool->m_slotSize);
+        header->m_next = (MemoryPoolHeader *)pool->m_freeList;
+        pool->m_freeList = header;
+    }
+    pool->m_slabs[pool->m_slabCount++] = slab;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - MemoryPool_AddSlab()\n");
+    assert(false);
+    return EXIT_FAILURE;
+}
+
+void *MemoryPool_Alloc(MemoryPool *pool)
+{
+    if (!pool->m_freeList)
+    {
+        int exitStatus = MemoryPool_AddSlab(pool);
+        if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    }
+
+    MemoryPoolHeader *header = (MemoryPoolHeader *)pool->m_freeList;
+    pool->m_freeList = header->m_next;
+    pool->m_usedCount++;
+
+    header->m_pool = pool;
+    char *element = (char *)header + MEMORY_POOL_HEADER_SIZE;
+    memset(element, 0, pool->m_slotSize - MEMORY_POOL_HEADER_SIZE);
+
+    return element;
+
+ERROR_LABEL:
+    printf("ERROR - MemoryPool_Alloc()\n");
+    assert(false);
+    return NULL;
+}
+
+void MemoryPool_Release(void *element)
+{
+    if (!element) return;
+
+    MemoryPoolHeader *header = (MemoryPoolHeader *)((char *)element - MEMORY_POOL_HEADER_SIZE);
+    MemoryPool *pool = header->m_pool;
+    assert(pool && pool->m_usedCount > 0);
+
+    header->m_next = (MemoryPoolHeader *)pool->m_freeList;
+    pool->m_freeList = header;
+    pool->m_usedCount--;
+}
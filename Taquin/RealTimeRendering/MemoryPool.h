@@ -0,0 +1,71 @@
+﻿#ifndef _MEMORY_POOL_H_
+#define _MEMORY_POOL_H_
+
+/// @file MemoryPool.h
+/// @defgroup MemoryPool
+/// @{
+
+#include "Settings.h"
+
+/// @brief Taille de l'en-tête placé devant chaque élément.
+/// Il mémorise le pool de l'élément et conserve l'alignement sur 16 octets.
+#define MEMORY_POOL_HEADER_SIZE 16
+
+/// @brief Allocateur d'éléments de taille fixe.
+/// Les éléments sont pris dans de grands blocs alloués à la demande et jamais rendus
+/// au système avant MemoryPool_Free() : créer et détruire de nombreux éléments
+/// ne fait qu'ajouter ou retirer un élément d'une liste.
+typedef struct MemoryPool_s
+{
+    /// @brief Taille maximale d'un élément (sans l'en-tête).
+    int    m_elementSize;
+
+    /// @brief Taille d'un emplacement (en-tête compris), multiple de MEMORY_POOL_HEADER_SIZE.
+    int    m_slotSize;
+
+    /// @brief Nombre d'emplacements par bloc.
+    int    m_slotsPerSlab;
+
+    /// @brief Blocs alloués.
+    char **m_slabs;
+    int    m_slabCount;
+    int    m_slabCapacity;
+
+    /// @brief Premier emplacement libre. Les emplacements libres sont chaînés par leur en-tête.
+    void  *m_freeList;
+
+    /// @brief Nombre d'éléments alloués.
+    int    m_usedCount;
+} MemoryPool;
+
+/// @brief Initialise un pool vide.
+/// @param[out] pool le pool.
+/// @param[in] elementSize la taille maximale d'un élément en octets.
+/// @param[in] slotsPerSlab le nombre d'éléments de chaque bloc.
+void MemoryPool_Init(MemoryPool *pool, int elementSize, int slotsPerSlab);
+
+/// @brief Détruit les blocs d'un pool.
+/// Les éléments encore alloués deviennent invalides.
+/// @param[in,out] pool le pool.
+void MemoryPool_Free(MemoryPool *pool);
+
+/// @brief Alloue un élément mis à zéro.
+/// @param[in,out] pool le pool.
+/// @return L'élément ou NULL en cas d'erreur.
+void *MemoryPool_Alloc(MemoryPool *pool);
+
+/// @brief Rend un élément au pool qui l'a alloué.
+/// @param[in] element l'élément (peut valoir NULL).
+void MemoryPool_Release(void *element);
+
+/// @brief Renvoie le nombre d'éléments alloués par un pool.
+/// @param[in] pool le pool.
+/// @return Le nombre d'éléments alloués.
+INLINE int MemoryPool_GetUsedCount(MemoryPool *pool)
+{
+    return pool->m_usedCount;
+}
+
+/// @}
+
+#endif
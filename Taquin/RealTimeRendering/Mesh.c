@@ -2,20 +2,16 @@
 #include "Material.h"
 #include "Vector.h"
 #include "Tools.h"
+#include "ObjParser.h"
+#include "FileMap.h"
+#include "MeshLod.h"
+#include "Meshlet.h"
+#include "MeshBvh.h"
+#include "MeshOcclusion.h"
 
-#define MAX_NB_POINTS 32
+#include <limits.h>
 
-static void Mesh_FillVec3(Vec3 *v, int n)
-{
-    switch (n)
-    {
-    case 0: v->x = 0.f;
-    case 1: v->y = 0.f;
-    case 2: v->z = 0.f;
-    }
-}
-
-int Buffer_ReadLine(char *buffer, int *offset, int bufferSize, char **line, int *capacity)
+int Buffer_ReadLine(const char *buffer, int *offset, int bufferSize, char **line, int *capacity)
 {
     int i = *offset;
     int lineSize = 0;
@@ -79,422 +75,512 @@ ERROR_LABEL:
     return EXIT_FAILURE;
 }
 
-char *Buffer_GetFromFile(char *folderPath, char *fileName, long *bufferSize)
+FileMap *Buffer_MapFile(char *folderPath, char *fileName, long *bufferSize)
 {
     char path[1024] = { 0 };
-    FILE* file = NULL;
-    char *buffer = NULL;
+    FileMap *map = NULL;
 
-    // Charge le fichier dans un buffer puis ferme le fichier
     strcpy_s(path, 1024, folderPath);
     strcat_s(path, 1024, "/");
     strcat_s(path, 1024, fileName);
-    fopen_s(&file, path, "rb");
-    if (!file) goto ERROR_LABEL;
-
-    fseek(file, 0, SEEK_END);
-    long size = ftell(file);
-    rewind(file);
 
-    buffer = (char *)calloc(size, sizeof(char));
-    if (!buffer) goto ERROR_LABEL;
+    map = FileMap_Open(path, FILEMAP_ACCESS_SEQUENTIAL);
+    if (!map) goto ERROR_LABEL;
 
-    size_t numRead = fread(buffer, 1, size, file);
-    if (numRead != size) goto ERROR_LABEL;
+    // Les analyseurs utilisent des positions de type int/long
+    if (FileMap_GetSize(map) > (Uint64)INT_MAX) goto ERROR_LABEL;
 
-    fclose(file);
-    file = NULL;
+    *bufferSize = (long)FileMap_GetSize(map);
 
-    *bufferSize = size;
-
-    return buffer;
+    return map;
 
 ERROR_LABEL:
-    printf("Buffer_GetFromFile()\n");
+    printf("ERROR - Buffer_MapFile() %s\n", path);
     assert(false);
-    if (file)
-    {
-        fclose(file);
-    }
-    free(buffer);
+    FileMap_Close(map);
     return NULL;
 }
 
-Mesh *Mesh_LoadOBJ(char *folderPath, char *fileName)
+/// @brief Indique si un fichier existe et est vide.
+/// Un fichier vide ne peut pas être projeté en mémoire (voir FileMap_Open()).
+static bool Mesh_IsEmptyFile(char *folderPath, char *fileName)
 {
-    Mesh* mesh       = NULL;
-    char *objContent = NULL;
-    char *curLine    = NULL;
-
-    int lineCapacity     = 64;
-    int vertexCapacity   = 1 << 12;
-    int normalCapacity   = 1 << 12;
-    int textUVCapacity   = 1 << 12;
-    int triangleCapacity = 1 << 12;
-    int vertexCount = 0;
-    int normalCount = 0;
-    int textUVCount = 0;
-    int triangleCount = 0;
-    int vertexIndices[MAX_NB_POINTS];
-    int normalIndices[MAX_NB_POINTS];
-    int textUVIndices[MAX_NB_POINTS];
-    char pathBuffer[1024] = { 0 };
-    int materialIndex = -1;
-
-    // Charge le fichier dans un buffer
-    long size = 0;
-    objContent = Buffer_GetFromFile(folderPath, fileName, &size);
-    if (!objContent) { assert(false); goto ERROR_LABEL; }
+    char path[1024] = { 0 };
+    FileInfo info = { 0 };
 
-    // Alloue la mémoire
-    mesh = (Mesh *)calloc(1, sizeof(Mesh));
-    if (!mesh) { assert(false); goto ERROR_LABEL; }
+    strcpy_s(path, 1024, folderPath);
+    strcat_s(path, 1024, "/");
+    strcat_s(path, 1024, fileName);
 
-    mesh->m_vertices = (Vec3*)calloc(vertexCapacity, sizeof(Vec3));
-    if (!mesh->m_vertices) { assert(false); goto ERROR_LABEL; }
+    return FileMap_GetInfo(path, &info) == EXIT_SUCCESS && info.m_size == 0;
+}
 
-    mesh->m_normals = (Vec3 *)calloc(normalCapacity, sizeof(Vec3));
-    if (!mesh->m_normals) { assert(false); goto ERROR_LABEL; }
+/// @brief Nombre de tranches de sommets utilisées pour le calcul parallèle des bornes.
+#define MESH_BOUNDS_SLICES 64
 
-    mesh->m_textUVs = (Vec2 *)calloc(textUVCapacity, sizeof(Vec2));
-    if (!mesh->m_textUVs) { assert(false); goto ERROR_LABEL; }
+/// @brief Durées (en millisecondes) des étapes du chargement d'un fichier obj.
+typedef struct MeshLoadTimes_s
+{
+    double m_parse;
+    double m_materials;
+    double m_validation;
+    double m_normals;
+    double m_bounds;
+    double m_sort;
+    double m_tangents;
+    double m_weld;
+    double m_lods;
+    double m_meshlets;
+    double m_bvh;
+    double m_occlusion;
+} MeshLoadTimes;
+
+/// @brief Renvoie le temps écoulé (en millisecondes) depuis start puis remet start à l'instant présent.
+static double Mesh_GetElapsedMs(Uint64 *start)
+{
+    Uint64 now = SDL_GetPerformanceCounter();
+    double elapsed = 1000.0 * (double)(now - *start) / (double)SDL_GetPerformanceFrequency();
+    *start = now;
+    return elapsed;
+}
 
-    mesh->m_triangles = (Triangle *)calloc(triangleCapacity, sizeof(Triangle));
-    if (!mesh->m_triangles) { assert(false); goto ERROR_LABEL; }
+/// @brief Calcule la boîte englobante et le centre du mesh.
+/// Chaque tranche de sommets est traitée en parallèle puis les résultats sont réduits.
+static void Mesh_ComputeBounds(Mesh *mesh)
+{
+    Vec3 sliceMin[MESH_BOUNDS_SLICES];
+    Vec3 sliceMax[MESH_BOUNDS_SLICES];
+    int vertexCount = mesh->m_vertexCount;
+    int i;
 
-    mesh->m_min = Vec3_Set(+INFINITY, +INFINITY, +INFINITY);
-    mesh->m_max = Vec3_Set(-INFINITY, -INFINITY, -INFINITY);
+    #pragma omp parallel for
+    for (i = 0; i < MESH_BOUNDS_SLICES; ++i)
+    {
+        int first = (int)((Sint64)vertexCount * i / MESH_BOUNDS_SLICES);
+        int last = (int)((Sint64)vertexCount * (i + 1) / MESH_BOUNDS_SLICES);
+        Vec3 vMin = Vec3_Set(+INFINITY, +INFINITY, +INFINITY);
+        Vec3 vMax = Vec3_Set(-INFINITY, -INFINITY, -INFINITY);
 
-    curLine = (char *)calloc(lineCapacity, sizeof(char));
-    if (!curLine) { assert(false); goto ERROR_LABEL; }
+        for (int j = first; j < last; ++j)
+        {
+            vMin = Vec3_Min(vMin, mesh->m_vertices[j]);
+            vMax = Vec3_Max(vMax, mesh->m_vertices[j]);
+        }
+        sliceMin[i] = vMin;
+        sliceMax[i] = vMax;
+    }
 
-    // Parse le buffer
-    int offset = 0;
-    int lineNb = 0;
-    do
+    mesh->m_min = Vec3_Set(+INFINITY, +INFINITY, +INFINITY);
+    mesh->m_max = Vec3_Set(-INFINITY, -INFINITY, -INFINITY);
+    for (i = 0; i < MESH_BOUNDS_SLICES; ++i)
     {
-        int exitStatus = Buffer_ReadLine(objContent, &offset, size, &curLine, &lineCapacity);
-        if (exitStatus == EXIT_FAILURE) { assert(false); goto ERROR_LABEL; }
-        if (curLine[0] == '\0') continue;
+        mesh->m_min = Vec3_Min(mesh->m_min, sliceMin[i]);
+        mesh->m_max = Vec3_Max(mesh->m_max, sliceMax[i]);
+    }
+    mesh->m_center = Vec3_Scale(Vec3_Add(mesh->m_min, mesh->m_max), 0.5f);
+}
 
-        lineNb++;
+/// @brief Calcule le hachage des bits d'une position.
+static Uint32 Mesh_HashPosition(Vec3 position)
+{
+    Uint32 bits[3];
+    memcpy(bits, position.data, sizeof(bits));
 
-        char* context = NULL;
-        char* word = strtok_s(curLine, " ", &context);
-        Vec3 vec;
+    // -0.0f et +0.0f désignent la même position
+    for (int i = 0; i < 3; ++i)
+    {
+        if (bits[i] == 0x80000000u) bits[i] = 0;
+    }
 
-        if (!word || strlen(word) < 1) continue;
+    Uint32 hash = bits[0] * 0x9E3779B1u;
+    hash ^= bits[1] * 0x85EBCA77u + (hash << 6) + (hash >> 2);
+    hash ^= bits[2] * 0xC2B2AE3Du + (hash << 6) + (hash >> 2);
+    return hash;
+}
 
-        if (word[0] == 'v')
-        {
-            if (word[1] == '\0')
-            {
-                //---------------------------------------------------------------------------------
-                // Vertex
+/// @brief Calcule les normales des coins de triangles sans normale (indice -1).
+/// Les faces adjacentes à une même position (comparée par valeur : un fichier obj peut
+/// répéter une position sous plusieurs indices) sont moyennées, avec une pondération
+/// par l'angle du coin. Une face dont la normale s'écarte de plus de MESH_CREASE_ANGLE
+/// de celle du coin n'est pas prise en compte (arête vive).
+/// Les coins d'une même position obtenant la même normale partagent son indice,
+/// comme avec des normales lues dans le fichier.
+/// @param[in,out] mesh le mesh (positions et triangles vérifiés).
+/// @param[in] vertexCount le nombre de positions.
+/// @param[in] triangleCount le nombre de triangles.
+/// @param[in,out] normalCount le nombre de normales du mesh.
+/// @param[in,out] normalCapacity la capacité du tableau des normales.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+static int Mesh_GenerateNormals(
+    Mesh *mesh, int vertexCount, int triangleCount, int *normalCount, int *normalCapacity)
+{
+    Triangle *triangles = mesh->m_triangles;
+    Vec3 *vertices = mesh->m_vertices;
+    int *table = NULL;
+    int *positionIds = NULL;
+    int *cornerOffsets = NULL;
+    int *corners = NULL;
+    int *normalOffsets = NULL;
+    int *cornerLocals = NULL;
+    Vec3 *faceNormals = NULL;
+    float *cornerAngles = NULL;
+    Vec3 *cornerNormals = NULL;
+    int i;
+
+    // Triangles ayant au moins un coin sans normale
+    bool needed = false;
+    for (i = 0; i < triangleCount && !needed; ++i)
+    {
+        Triangle *triangle = &triangles[i];
+        needed =
+            triangle->m_normalIndices[0] < 0 ||
+            triangle->m_normalIndices[1] < 0 ||
+            triangle->m_normalIndices[2] < 0;
+    }
+    if (!needed) return EXIT_SUCCESS;
+
+    int cornerCount = 3 * triangleCount;
+    positionIds = (int *)malloc(Int_Max(vertexCount, 1) * sizeof(int));
+    cornerOffsets = (int *)calloc(vertexCount + 1, sizeof(int));
+    corners = (int *)malloc(cornerCount * sizeof(int));
+    normalOffsets = (int *)calloc(vertexCount + 1, sizeof(int));
+    cornerLocals = (int *)malloc(cornerCount * sizeof(int));
+    faceNormals = (Vec3 *)calloc(triangleCount, sizeof(Vec3));
+    cornerAngles = (float *)calloc(cornerCount, sizeof(float));
+    cornerNormals = (Vec3 *)calloc(cornerCount, sizeof(Vec3));
+    if (!positionIds || !cornerOffsets || !corners || !normalOffsets || !cornerLocals ||
+        !faceNormals || !cornerAngles || !cornerNormals)
+        goto ERROR_LABEL;
 
-                int i = 0;
-                while ((word = strtok_s(NULL, " ", &context)) && i < 3)
-                {
-                    vec.data[i++] = (float)atof(word);
-                }
-                Mesh_FillVec3(&vec, i);
+    //---------------------------------------------------------------------------------------------
+    // Identifie les positions égales (table de hachage à adressage ouvert)
 
-                // Double la capacité si nécesaire
-                if (vertexCount >= vertexCapacity)
-                {
-                    vertexCapacity = vertexCapacity << 1;
-                    Vec3 *newVertices = (Vec3 *)realloc(
-                        mesh->m_vertices, vertexCapacity * sizeof(Vec3));
-                    if (!newVertices) { assert(false); goto ERROR_LABEL; }
+    int tableSize = 1;
+    while (tableSize < 2 * vertexCount) tableSize <<= 1;
 
-                    mesh->m_vertices = newVertices;
-                }
-                mesh->m_vertices[vertexCount++] = vec;
-                mesh->m_min = Vec3_Min(mesh->m_min, vec);
-                mesh->m_max = Vec3_Max(mesh->m_max, vec);
-            }
-            else if (word[1] == 'n')
-            {
-                if (word[2] != '\0') break;
+    table = (int *)malloc(tableSize * sizeof(int));
+    if (!table) goto ERROR_LABEL;
+    memset(table, -1, tableSize * sizeof(int));
 
-                //---------------------------------------------------------------------------------
-                // Normale
+    for (i = 0; i < vertexCount; ++i)
+    {
+        Vec3 position = vertices[i];
+        Uint32 slot = Mesh_HashPosition(position) & (tableSize - 1);
+        while (table[slot] >= 0)
+        {
+            Vec3 other = vertices[table[slot]];
+            if (other.x == position.x && other.y == position.y && other.z == position.z)
+                break;
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        if (table[slot] < 0) table[slot] = i;
+        positionIds[i] = table[slot];
+    }
 
-                int i = 0;
-                while ((word = strtok_s(NULL, " ", &context)) && i < 3)
-                {
-                    vec.data[i++] = (float)atof(word);
-                }
-                Mesh_FillVec3(&vec, i);
+    free(table);
+    table = NULL;
 
-                // Double la capacité si nécessaire
-                if (normalCount >= normalCapacity)
-                {
-                    normalCapacity = normalCapacity << 1;
-                    Vec3 *newNormals = (Vec3 *)realloc(
-                        mesh->m_normals, normalCapacity * sizeof(Vec3));
-                    if (!newNormals) { assert(false); goto ERROR_LABEL; }
+    //---------------------------------------------------------------------------------------------
+    // Normales des faces et angles des coins
 
-                    mesh->m_normals = newNormals;
-                }
+    #pragma omp parallel for
+    for (i = 0; i < triangleCount; ++i)
+    {
+        Triangle *triangle = &triangles[i];
+        Vec3 v[3];
+        for (int j = 0; j < 3; ++j)
+        {
+            v[j] = vertices[triangle->m_vertexIndices[j]];
+        }
 
-                mesh->m_normals[normalCount++] = vec;
-            }
-            else if (word[1] == 't')
-            {
-                if (word[2] != '\0') break;
+        Vec3 normal = Vec3_Cross(Vec3_Sub(v[2], v[0]), Vec3_Sub(v[1], v[0]));
+        float length = Vec3_Length(normal);
+        if (length < 1e-20f) continue;
 
-                //---------------------------------------------------------------------------------
-                // Coordonnée de texture
-                Vec2 textUV = { 0 };
+        faceNormals[i] = Vec3_Scale(normal, 1.0f / length);
 
-                if (word = strtok_s(NULL, " ", &context))
-                {
-                    textUV.x = (float)atof(word);
-                }
-                if (word = strtok_s(NULL, " ", &context))
-                {
-                    textUV.y = (float)atof(word);
-                }
+        for (int j = 0; j < 3; ++j)
+        {
+            Vec3 edge1 = Vec3_Normalize(Vec3_Sub(v[(j + 1) % 3], v[j]));
+            Vec3 edge2 = Vec3_Normalize(Vec3_Sub(v[(j + 2) % 3], v[j]));
+            cornerAngles[3 * i + j] = acosf(Float_Clamp(Vec3_Dot(edge1, edge2), -1.0f, 1.0f));
+        }
+    }
 
-                // Double la capacité si nécessaire
-                if (textUVCount >= textUVCapacity)
-                {
-                    textUVCapacity = textUVCapacity << 1;
-                    Vec2 *newTexCoords = (Vec2 *)realloc(
-                        mesh->m_textUVs, textUVCapacity * sizeof(Vec2));
-                    if (!newTexCoords) { assert(false); goto ERROR_LABEL; }
+    //---------------------------------------------------------------------------------------------
+    // Liste des coins adjacents à chaque position (seulement les triangles à compléter)
 
-                    mesh->m_textUVs = newTexCoords;
-                }
+    for (i = 0; i < triangleCount; ++i)
+    {
+        Triangle *triangle = &triangles[i];
+        if (triangle->m_normalIndices[0] >= 0 &&
+            triangle->m_normalIndices[1] >= 0 &&
+            triangle->m_normalIndices[2] >= 0)
+            continue;
 
-                mesh->m_textUVs[textUVCount++] = textUV;
-            }
+        for (int j = 0; j < 3; ++j)
+        {
+            cornerOffsets[positionIds[triangle->m_vertexIndices[j]] + 1]++;
         }
-        else if (word[0] == 'f')
+    }
+    for (i = 0; i < vertexCount; ++i)
+    {
+        cornerOffsets[i + 1] += cornerOffsets[i];
+    }
+    for (i = 0; i < triangleCount; ++i)
+    {
+        Triangle *triangle = &triangles[i];
+        if (triangle->m_normalIndices[0] >= 0 &&
+            triangle->m_normalIndices[1] >= 0 &&
+            triangle->m_normalIndices[2] >= 0)
+            continue;
+
+        for (int j = 0; j < 3; ++j)
         {
-            if (word[1] != '\0') break;
+            // normalOffsets sert temporairement de curseur d'écriture
+            int positionId = positionIds[triangle->m_vertexIndices[j]];
+            corners[cornerOffsets[positionId] + normalOffsets[positionId]++] = 3 * i + j;
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    // Normale de chaque coin, puis regroupement des normales identiques d'une même position
 
-            //-------------------------------------------------------------------------------------
-            // Faces
+    float creaseCos = cosf(MESH_CREASE_ANGLE * (float)M_PI / 180.0f);
 
-            // Parse la face
-            int nbPoints = 0;
-            while (word = strtok_s(NULL, " ", &context))
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (i = 0; i < vertexCount; ++i)
+    {
+        int first = cornerOffsets[i];
+        int last = cornerOffsets[i + 1];
+        int localCount = 0;
+
+        for (int k = first; k < last; ++k)
+        {
+            int corner = corners[k];
+            Vec3 faceNormal = faceNormals[corner / 3];
+
+            // Les coins ayant déjà une normale comptent seulement comme voisins
+            cornerLocals[corner] = -1;
+            if (triangles[corner / 3].m_normalIndices[corner % 3] >= 0)
+                continue;
+
+            // Les coins sont toujours parcourus dans le même ordre : deux coins ayant
+            // les mêmes faces voisines obtiennent exactement la même normale
+            Vec3 normal = Vec3_Zero;
+            for (int l = first; l < last; ++l)
             {
-                int indices[3] = { 0 };
-                if (strstr(word, "//"))
-                {
-                    // Vertex normal (sans texture)
-                    char *contextSlash = NULL;
-                    char* data = strtok_s(word, "/", &contextSlash);
-                    int i = 0;
-                    while (data)
-                    {
-                        if (i < 3)
-                        {
-                            indices[i] = atoi(data) - 1;
-                        }
-                        data = strtok_s(NULL, "/", &contextSlash);
-                        i++;
-                    }
-                    switch (i)
-                    {
-                    case 2:
-                        // [Vertex, normal]
-                        if (nbPoints < MAX_NB_POINTS)
-                        {
-                            vertexIndices[nbPoints] = indices[0];
-                            normalIndices[nbPoints] = indices[1];
-                            textUVIndices[nbPoints] = -1;
-                        }
-                        break;
-                    default:
-                        assert(false);
-                        goto ERROR_LABEL;
-                        break;
-                    }
-                }
-                else
+                int other = corners[l];
+                Vec3 otherNormal = faceNormals[other / 3];
+                if (Vec3_Dot(faceNormal, otherNormal) >= creaseCos)
                 {
-                    if (strstr(word, "/"))
-                    {
-                        char *contextSlash = NULL;
-                        char* data = strtok_s(word, "/", &contextSlash);
-                        int i = 0;
-                        while (data)
-                        {
-                            if (i < 3)
-                            {
-                                indices[i] = atoi(data) - 1;
-                            }
-                            data = strtok_s(NULL, "/", &contextSlash);
-                            i++;
-                        }
-                        switch (i)
-                        {
-                        case 2:
-                            // [Vertex, texture]
-                            if (nbPoints < MAX_NB_POINTS)
-                            {
-                                vertexIndices[nbPoints] = indices[0];
-                                textUVIndices[nbPoints] = indices[1];
-                                normalIndices[nbPoints] = -1;
-                            }
-                            break;
-                        case 3:
-                            // [Vertex, texture, normal]
-                            if (nbPoints < MAX_NB_POINTS)
-                            {
-                                vertexIndices[nbPoints] = indices[0];
-                                textUVIndices[nbPoints] = indices[1];
-                                normalIndices[nbPoints] = indices[2];
-                            }
-                            break;
-                        default:
-                            assert(false);
-                            goto ERROR_LABEL;
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        // [Vertex]
-                        if (nbPoints < MAX_NB_POINTS)
-                        {
-                            vertexIndices[nbPoints] = atoi(word) - 1;
-                            textUVIndices[nbPoints] = -1;
-                            normalIndices[nbPoints] = -1;
-                        }
-                    }
+                    normal = Vec3_Add(normal, Vec3_Scale(otherNormal, cornerAngles[other]));
                 }
-                nbPoints++;
             }
 
-            if (nbPoints > MAX_NB_POINTS)
-            {
-                printf("WARNING - Mesh_loadObj()\n");
-                printf("          Too much points in one face\n");
-                nbPoints = MAX_NB_POINTS;
-            }
+            float length = Vec3_Length(normal);
+            if (length > 1e-20f)
+                normal = Vec3_Scale(normal, 1.0f / length);
+            else if (Vec3_Length(faceNormal) > 0.0f)
+                normal = faceNormal;
+            else
+                normal = Vec3_Up;
 
-            // Crée les triangles
-            for (int i = 1; i < nbPoints - 1; i++)
+            cornerNormals[corner] = normal;
+
+            // Cherche la même normale parmi les coins précédents de la position
+            for (int l = first; l < k; ++l)
             {
-                // Double la capacité si nécesaire
-                if (triangleCount >= triangleCapacity)
+                int other = corners[l];
+                if (cornerLocals[other] >= 0 &&
+                    memcmp(&cornerNormals[other], &normal, sizeof(Vec3)) == 0)
                 {
-                    triangleCapacity = triangleCapacity << 1;
-                    Triangle *newTriangles = (Triangle *)realloc(
-                        mesh->m_triangles, triangleCapacity * sizeof(Triangle));
-                    if (!newTriangles) { assert(false); goto ERROR_LABEL; }
-
-                    mesh->m_triangles = newTriangles;
+                    cornerLocals[corner] = cornerLocals[other];
+                    break;
                 }
-                Triangle *triangle = &mesh->m_triangles[triangleCount++];
+            }
+            if (cornerLocals[corner] < 0)
+            {
+                cornerLocals[corner] = localCount++;
+            }
+        }
+        normalOffsets[i + 1] = localCount;
+    }
 
-                triangle->m_vertexIndices[0] = vertexIndices[0];
-                triangle->m_vertexIndices[1] = vertexIndices[i];
-                triangle->m_vertexIndices[2] = vertexIndices[i + 1];
+    normalOffsets[0] = *normalCount;
+    for (i = 0; i < vertexCount; ++i)
+    {
+        normalOffsets[i + 1] += normalOffsets[i];
+    }
 
-                triangle->m_normalIndices[0] = normalIndices[0];
-                triangle->m_normalIndices[1] = normalIndices[i];
-                triangle->m_normalIndices[2] = normalIndices[i + 1];
+    //---------------------------------------------------------------------------------------------
+    // Ajoute les normales et les associe aux coins
 
-                triangle->m_textUVIndices[0] = textUVIndices[0];
-                triangle->m_textUVIndices[1] = textUVIndices[i];
-                triangle->m_textUVIndices[2] = textUVIndices[i + 1];
+    int newNormalCount = normalOffsets[vertexCount];
+    if (newNormalCount > *normalCapacity)
+    {
+        Vec3 *newNormals = (Vec3 *)realloc(mesh->m_normals, newNormalCount * sizeof(Vec3));
+        if (!newNormals) goto ERROR_LABEL;
 
-                triangle->m_materialIndex = materialIndex;
-            }
-        }
-        else if (strcmp(word, "mtllib") == 0)
-        {
-            word = strtok_s(NULL, " ", &context);
-            if (!word) continue;
+        mesh->m_normals = newNormals;
+        *normalCapacity = newNormalCount;
+    }
 
-            int materialCount = 0;
-            Material *materials = Material_LoadMTL(mesh, folderPath, word, &materialCount);
-            if (!materials) { assert(false); goto ERROR_LABEL; }
+    Vec3 *normals = mesh->m_normals;
 
-            mesh->m_materials = materials;
-            mesh->m_materialCount = materialCount;
-        }
-        else if (strcmp(word, "usemtl") == 0)
+    #pragma omp parallel for
+    for (i = 0; i < vertexCount; ++i)
+    {
+        for (int k = cornerOffsets[i]; k < cornerOffsets[i + 1]; ++k)
         {
-            word = strtok_s(NULL, " ", &context);
-            if (!word) continue;
+            int corner = corners[k];
+            if (cornerLocals[corner] < 0)
+                continue;
 
-            materialIndex = -1;
-            int materialCount = mesh->m_materialCount;
-            for (int i = 0; i < materialCount; ++i)
-            {
-                char *materialName = mesh->m_materials[i].m_name;
-                if (strcmp(materialName, word) == 0)
-                {
-                    materialIndex = i;
-                    break;
-                }
-            }
+            int normalIndex = normalOffsets[i] + cornerLocals[corner];
+            normals[normalIndex] = cornerNormals[corner];
+            triangles[corner / 3].m_normalIndices[corner % 3] = normalIndex;
         }
-    } while (offset < size);
+    }
+
+    *normalCount = newNormalCount;
+
+    free(positionIds);
+    free(cornerOffsets);
+    free(corners);
+    free(normalOffsets);
+    free(cornerLocals);
+    free(faceNormals);
+    free(cornerAngles);
+    free(cornerNormals);
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - Mesh_GenerateNormals()\n");
+    assert(false);
+    free(table);
+    free(positionIds);
+    free(cornerOffsets);
+    free(corners);
+    free(normalOffsets);
+    free(cornerLocals);
+    free(faceNormals);
+    free(cornerAngles);
+    free(cornerNormals);
+    return EXIT_FAILURE;
+}
+
+/// @brief Crée un mesh à partir du contenu d'un fichier obj.
+/// Charge les matériaux, calcule les normales manquantes et vérifie les indices.
+/// Les tableaux de data sont transférés au mesh (ou libérés en cas d'erreur).
+/// @param[in] folderPath le dossier du fichier obj (et du fichier mtl).
+/// @param[in,out] data le contenu du fichier obj.
+/// @param[out] times les durées des étapes.
+/// @return Le mesh créé ou NULL en cas d'erreur.
+static Mesh *Mesh_CreateFromOBJData(char *folderPath, ObjData *data, MeshLoadTimes *times)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    Mesh *mesh = NULL;
+    int *materialIndices = NULL;
+
+    int vertexCount = data->m_vertexCount;
+    int normalCount = data->m_normalCount;
+    int textUVCount = data->m_textUVCount;
+    int triangleCount = data->m_triangleCount;
+    int normalCapacity = data->m_normalCapacity;
+
+    mesh = (Mesh *)calloc(1, sizeof(Mesh));
+    if (!mesh) { assert(false); goto ERROR_LABEL; }
+
+    mesh->m_vertices = data->m_vertices;
+    mesh->m_normals = data->m_normals;
+    mesh->m_textUVs = data->m_textUVs;
+    mesh->m_triangles = data->m_triangles;
+    data->m_vertices = NULL;
+    data->m_normals = NULL;
+    data->m_textUVs = NULL;
+    data->m_triangles = NULL;
 
     //---------------------------------------------------------------------------------------------
-    // Calcule les normales manquante
+    // Charge les matériaux
 
-    int autoNormalCount = 0;
-    for (int i = 0; i < triangleCount; i++)
+    strcpy_s(mesh->m_materialLib, MESH_NAME_SIZE, data->m_materialLib);
+
+    if (data->m_materialLib[0] != '\0')
     {
-        Triangle *triangle = &mesh->m_triangles[i];
-        for (int j = 0; j < 3; j++)
-        {
-            if (triangle->m_normalIndices[j] == -1)
-            {
-                Vec3 *vertices = mesh->m_vertices;
-                Vec3 vertex0, vertex1, vertex2, vecA, vecB, normal;
-                vertex0 = vertices[triangle->m_vertexIndices[j]];
-                vertex1 = vertices[triangle->m_vertexIndices[(j + 1) % 3]];
-                vertex2 = vertices[triangle->m_vertexIndices[(j + 2) % 3]];
-                vecA    = Vec3_Sub(vertex2, vertex0);
-                vecB    = Vec3_Sub(vertex1, vertex0);
-                normal  = Vec3_Normalize(Vec3_Cross(vecA, vecB));
-
-                // Double la capacité si nécesaire
-                if (normalCount >= normalCapacity)
-                {
-                    normalCapacity = normalCapacity << 1;
-                    Vec3 *newNormals = (Vec3 *)realloc(
-                        mesh->m_normals, normalCapacity * sizeof(Vec3));
-                    if (!newNormals) { assert(false); goto ERROR_LABEL; }
+        int materialCount = 0;
+        Material *materials = Material_LoadMTL(mesh, folderPath, data->m_materialLib, &materialCount);
+        if (!materials) { assert(false); goto ERROR_LABEL; }
 
-                    mesh->m_normals = newNormals;
-                }
+        mesh->m_materials = materials;
+        mesh->m_materialCount = materialCount;
+    }
 
-                triangle->m_normalIndices[j] = normalCount;
-                mesh->m_normals[normalCount++] = normal;
-                ++autoNormalCount;
+    // Remplace les noms des matériaux par leur indice dans le mesh
+    materialIndices = (int *)calloc(Int_Max(data->m_materialNameCount, 1), sizeof(int));
+    if (!materialIndices) { assert(false); goto ERROR_LABEL; }
+
+    for (int i = 0; i < data->m_materialNameCount; i++)
+    {
+        materialIndices[i] = -1;
+        for (int j = 0; j < mesh->m_materialCount; ++j)
+        {
+            if (strcmp(mesh->m_materials[j].m_name, data->m_materialNames[i]) == 0)
+            {
+                materialIndices[i] = j;
+                break;
             }
         }
     }
+    for (int i = 0; i < triangleCount; i++)
+    {
+        Triangle *triangle = &mesh->m_triangles[i];
+        if (triangle->m_materialIndex >= 0)
+        {
+            triangle->m_materialIndex = materialIndices[triangle->m_materialIndex];
+        }
+    }
+
+    free(materialIndices);
+    materialIndices = NULL;
+
+    times->m_materials = Mesh_GetElapsedMs(&start);
 
     //---------------------------------------------------------------------------------------------
     // Vérifie les triangles
 
+    int invalidCount = 0;
+
+    #pragma omp parallel for reduction(+:invalidCount)
     for (int i = 0; i < triangleCount; i++)
     {
         Triangle *triangle = &mesh->m_triangles[i];
         for (int j = 0; j < 3; j++)
         {
             int index = triangle->m_vertexIndices[j];
-            if (index < 0 || index >= vertexCount) { assert(false); goto ERROR_LABEL; }
+            if (index < 0 || index >= vertexCount) invalidCount++;
 
+            // -1 : normale calculée ci-dessous
             index = triangle->m_normalIndices[j];
-            if (index < 0 || index >= normalCount) { assert(false); goto ERROR_LABEL; }
+            if (index < -1 || index >= normalCount) invalidCount++;
 
             index = triangle->m_textUVIndices[j];
-            if (index < -1 || index >= textUVCount) { assert(false); goto ERROR_LABEL; }
+            if (index < -1 || index >= textUVCount) invalidCount++;
         }
     }
+    if (invalidCount > 0) { assert(false); goto ERROR_LABEL; }
+
+    times->m_validation = Mesh_GetElapsedMs(&start);
+
+    //---------------------------------------------------------------------------------------------
+    // Calcule les normales manquantes
+
+    int exitStatus = Mesh_GenerateNormals(
+        mesh, vertexCount, triangleCount, &normalCount, &normalCapacity);
+    if (exitStatus != EXIT_SUCCESS) { assert(false); goto ERROR_LABEL; }
+
+    times->m_normals = Mesh_GetElapsedMs(&start);
 
     //---------------------------------------------------------------------------------------------
     // Réalloue la mémoire
@@ -558,32 +644,284 @@ Mesh *Mesh_LoadOBJ(char *folderPath, char *fileName)
     mesh->m_textUVs = newTextUVs;
     mesh->m_triangles = newTriangles;
 
-    mesh->m_center = Vec3_Scale(Vec3_Add(mesh->m_min, mesh->m_max), 0.5f);
+    Mesh_ComputeBounds(mesh);
+    times->m_bounds = Mesh_GetElapsedMs(&start);
+
+    ObjData_Free(data);
+
+    return mesh;
+
+ERROR_LABEL:
+    printf("ERROR - Mesh_CreateFromOBJData()\n");
+    assert(false);
+    free(materialIndices);
+    ObjData_Free(data);
+    Mesh_Free(mesh);
+    return NULL;
+}
+
+/// @brief Trie les triangles du mesh par matériau (tri par dénombrement stable) :
+/// les triangles sans matériau d'abord, puis ceux de chaque matériau dans l'ordre du fichier.
+/// Les tangentes et les sommets soudés ne doivent pas encore avoir été calculés.
+/// @param[in,out] mesh le mesh.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+static int Mesh_SortByMaterial(Mesh *mesh)
+{
+    int triangleCount = mesh->m_triangleCount;
+    int bucketCount = mesh->m_materialCount + 1;
+    int *offsets = NULL;
+    Triangle *sorted = NULL;
+    int i;
+
+    assert(!mesh->m_weldedVertices && !mesh->m_tangents);
+
+    if (triangleCount == 0)
+        return EXIT_SUCCESS;
+
+    offsets = (int *)calloc(bucketCount + 1, sizeof(int));
+    sorted = (Triangle *)calloc(triangleCount, sizeof(Triangle));
+    if (!offsets || !sorted) goto ERROR_LABEL;
+
+    // Le matériau -1 occupe le premier paquet
+    bool isSorted = true;
+    for (i = 0; i < triangleCount; ++i)
+    {
+        int bucket = mesh->m_triangles[i].m_materialIndex + 1;
+        assert(bucket >= 0 && bucket < bucketCount);
+        offsets[bucket + 1]++;
 
-    free(curLine);
-    free(objContent);
+        if (i > 0 && bucket < mesh->m_triangles[i - 1].m_materialIndex + 1)
+            isSorted = false;
+    }
+
+    if (!isSorted)
+    {
+        for (i = 0; i < bucketCount; ++i)
+        {
+            offsets[i + 1] += offsets[i];
+        }
+        for (i = 0; i < triangleCount; ++i)
+        {
+            int bucket = mesh->m_triangles[i].m_materialIndex + 1;
+            sorted[offsets[bucket]++] = mesh->m_triangles[i];
+        }
+        memcpy(mesh->m_triangles, sorted, triangleCount * sizeof(Triangle));
+    }
+
+    free(offsets);
+    free(sorted);
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - Mesh_SortByMaterial()\n");
+    assert(false);
+    free(offsets);
+    free(sorted);
+    return EXIT_FAILURE;
+}
+
+Mesh *Mesh_LoadOBJ(char *folderPath, char *fileName)
+{
+    FileMap *objFile = NULL;
+    Mesh *mesh = NULL;
+    ObjData data = { 0 };
+    MeshLoadTimes times = { 0 };
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    // Un fichier vide ne contient aucun mesh : l'échec est signalé sans assertion
+    if (Mesh_IsEmptyFile(folderPath, fileName))
+    {
+        printf("%s : fichier vide, aucun mesh charge\n", fileName);
+        return NULL;
+    }
+
+    // Projette le fichier en mémoire (sans copie)
+    long size = 0;
+    objFile = Buffer_MapFile(folderPath, fileName, &size);
+    if (!objFile) { assert(false); goto ERROR_LABEL; }
+
+    // Les threads lisent des parties éloignées du fichier :
+    // toutes les pages sont demandées dès maintenant
+    FileMap_Prefetch(objFile);
+
+    // Parse le fichier
+    const char *objContent = (const char *)FileMap_GetData(objFile);
+    int exitStatus = ObjParser_ParseParallel(objContent, size, &data);
+    if (exitStatus != EXIT_SUCCESS) { assert(false); goto ERROR_LABEL; }
+
+    FileMap_Close(objFile);
+    objFile = NULL;
+
+    times.m_parse = Mesh_GetElapsedMs(&start);
+
+    // Post-traitement : chaque passe est parallèle
+    mesh = Mesh_CreateFromOBJData(folderPath, &data, &times);
+    if (!mesh) goto ERROR_LABEL;
+
+    // Les triangles de chaque matériau sont rangés ensemble :
+    // les meshlets et les niveaux de détail conservent cet ordre
+    start = SDL_GetPerformanceCounter();
+    exitStatus = Mesh_SortByMaterial(mesh);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    times.m_sort = Mesh_GetElapsedMs(&start);
+
+    exitStatus = Mesh_ComputeTangents(mesh);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    times.m_tangents = Mesh_GetElapsedMs(&start);
+
+    exitStatus = Mesh_Weld(mesh);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    times.m_weld = Mesh_GetElapsedMs(&start);
+
+    exitStatus = MeshLod_Build(mesh);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    times.m_lods = Mesh_GetElapsedMs(&start);
+
+    exitStatus = Meshlet_Build(mesh);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    exitStatus = Mesh_BuildSubmeshes(mesh);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    exitStatus = Meshlet_BuildOrders(mesh);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    times.m_meshlets = Mesh_GetElapsedMs(&start);
+
+    exitStatus = MeshBvh_Build(mesh);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    times.m_bvh = Mesh_GetElapsedMs(&start);
+
+    int occlusionRayCount = MeshOcclusion_GetRayCount();
+    if (occlusionRayCount > 0)
+    {
+        exitStatus = MeshOcclusion_Bake(mesh, occlusionRayCount);
+        if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    }
+    times.m_occlusion = Mesh_GetElapsedMs(&start);
+
+    printf("%s : analyse %.2f ms, materiaux %.2f ms, validation %.2f ms, normales %.2f ms,"
+        " bornes %.2f ms, tri %.2f ms, tangentes %.2f ms, soudure %.2f ms, lod %.2f ms,"
+        " meshlets %.2f ms, bvh %.2f ms, occlusion %.2f ms\n",
+        fileName, times.m_parse, times.m_materials, times.m_validation, times.m_normals,
+        times.m_bounds, times.m_sort, times.m_tangents, times.m_weld, times.m_lods, times.m_meshlets,
+        times.m_bvh, times.m_occlusion);
 
     return mesh;
 
 ERROR_LABEL:
-    printf("ERROR - Mesh_loadFormFile()\n");
+    printf("ERROR - Mesh_LoadOBJ()\n");
     assert(false);
-    free(objContent);
-    free(curLine);
+    FileMap_Close(objFile);
+    ObjData_Free(&data);
     Mesh_Free(mesh);
     return NULL;
 }
 
+int Mesh_BenchmarkOBJ(char *folderPath, char *fileName)
+{
+    FileMap *objFile = NULL;
+    ObjData reference = { 0 };
+    ObjData data = { 0 };
+    ObjData chunkData = { 0 };
+
+    if (Mesh_IsEmptyFile(folderPath, fileName))
+    {
+        printf("%-20s fichier vide\n", fileName);
+        return EXIT_SUCCESS;
+    }
+
+    long size = 0;
+    objFile = Buffer_MapFile(folderPath, fileName, &size);
+    if (!objFile) goto ERROR_LABEL;
+
+    const char *objContent = (const char *)FileMap_GetData(objFile);
+    double frequency = (double)SDL_GetPerformanceFrequency();
+
+    // Le premier analyseur charge les pages du fichier : elles sont lues une fois
+    // avant les mesures pour ne pas avantager les suivants
+    volatile char checksum = 0;
+    for (long i = 0; i < size; i += 4096) checksum ^= objContent[i];
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    int exitStatus = ObjParser_Parse(objContent, size, &data);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    double fastTime = (double)(SDL_GetPerformanceCounter() - start) / frequency;
+
+    // Force le découpage, même pour un petit fichier, pour vérifier la fusion des morceaux
+    int chunkCount = Int_Max(omp_get_max_threads(), 4);
+    start = SDL_GetPerformanceCounter();
+    exitStatus = ObjParser_ParseChunks(objContent, size, chunkCount, &chunkData);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    double chunkTime = (double)(SDL_GetPerformanceCounter() - start) / frequency;
+
+    start = SDL_GetPerformanceCounter();
+    exitStatus = ObjParser_ParseReference(objContent, size, &reference);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    double referenceTime = (double)(SDL_GetPerformanceCounter() - start) / frequency;
+
+    bool identical = ObjData_Equals(&reference, &data) && ObjData_Equals(&data, &chunkData);
+    double megaBytes = (double)size / (1024.0 * 1024.0);
+
+    printf("%-20s %6.2f Mo | reference %7.2f ms (%6.1f Mo/s) | rapide %7.2f ms (%6.1f Mo/s)"
+        " | %2d morceaux %7.2f ms (%6.1f Mo/s) | %s\n",
+        fileName, megaBytes,
+        1000.0 * referenceTime, megaBytes / referenceTime,
+        1000.0 * fastTime, megaBytes / fastTime,
+        chunkCount, 1000.0 * chunkTime, megaBytes / chunkTime,
+        identical ? "identique" : "DIFFERENT");
+
+    FileMap_Close(objFile);
+    ObjData_Free(&reference);
+    ObjData_Free(&data);
+    ObjData_Free(&chunkData);
+
+    return identical ? EXIT_SUCCESS : EXIT_FAILURE;
+
+ERROR_LABEL:
+    printf("ERROR - Mesh_BenchmarkOBJ()\n");
+    FileMap_Close(objFile);
+    ObjData_Free(&reference);
+    ObjData_Free(&data);
+    ObjData_Free(&chunkData);
+    return EXIT_FAILURE;
+}
+
 void Mesh_Free(Mesh *mesh)
 {
     if (!mesh) return;
 
-    Material_Free(mesh->m_materials, mesh->m_materialCount);
+    if (!mesh->m_materialSource)
+    {
+        Material_Free(mesh->m_materials, mesh->m_materialCount);
+    }
 
-    free(mesh->m_vertices);
-    free(mesh->m_normals);
-    free(mesh->m_textUVs);
-    free(mesh->m_triangles);
+    if (mesh->m_fileMap)
+    {
+        // Les tableaux appartiennent à la projection du fichier .rtmesh
+        FileMap_Close(mesh->m_fileMap);
+    }
+    else
+    {
+        free(mesh->m_vertices);
+        free(mesh->m_normals);
+        free(mesh->m_textUVs);
+        free(mesh->m_triangles);
+        free(mesh->m_tangents);
+        free(mesh->m_weldedVertices);
+        free(mesh->m_indices);
+        free(mesh->m_meshlets);
+        free(mesh->m_meshletVertices);
+        free(mesh->m_meshletTriangles);
+        free(mesh->m_meshletIndices);
+        free(mesh->m_bvhNodes);
+        free(mesh->m_bvhTriangles);
+        free(mesh->m_occlusion);
+    }
+    free(mesh->m_packedVertices);
+    free(mesh->m_submeshes);
+    free(mesh->m_meshletOrders);
+    Mesh_FreeLods(mesh);
 
     // Met à zéro la mémoire (sécurité)
     memset(mesh, 0, sizeof(Mesh));
@@ -591,6 +929,306 @@ void Mesh_Free(Mesh *mesh)
     free(mesh);
 }
 
+void Mesh_FreeLods(Mesh *mesh)
+{
+    for (int i = 0; i < mesh->m_lodCount; ++i)
+    {
+        free(mesh->m_lods[i].m_submeshes);
+
+        // Les autres tableaux des niveaux appartiennent à la projection du fichier .rtmesh
+        if (mesh->m_fileMap)
+            continue;
+
+        free(mesh->m_lods[i].m_vertices);
+        free(mesh->m_lods[i].m_indices);
+        free(mesh->m_lods[i].m_materialIndices);
+    }
+    free(mesh->m_lods);
+
+    mesh->m_lods = NULL;
+    mesh->m_lodCount = 0;
+}
+
+/// @brief Transforme une direction (sans translation) puis la normalise.
+static Vec3 Mesh_TransformDirection(Mat4 transform, Vec3 direction)
+{
+    Vec4 result = Mat4_MulMV(transform, Vec4_From3(direction, 0.0f));
+    return Vec3_Normalize(Vec3_Set(result.x, result.y, result.z));
+}
+
+Mesh *Mesh_CreateMerged(Mesh *source, const Mat4 *transforms, int count)
+{
+    Mesh *mesh = NULL;
+    int vertexCount = source->m_vertexCount;
+    int weldedCount = source->m_weldedCount;
+    int triangleCount = source->m_triangleCount;
+    int i;
+
+    assert((source->m_weldedVertices || source->m_packedVertices) && source->m_indices && count > 0);
+    assert(source->m_submeshes || triangleCount == 0);
+
+    mesh = (Mesh *)calloc(1, sizeof(Mesh));
+    if (!mesh) goto ERROR_LABEL;
+
+    mesh->m_vertexCount = vertexCount * count;
+    mesh->m_triangleCount = triangleCount * count;
+    mesh->m_weldedCount = weldedCount * count;
+
+    mesh->m_vertices = (Vec3 *)calloc(Int_Max(mesh->m_vertexCount, 1), sizeof(Vec3));
+    mesh->m_triangles = (Triangle *)calloc(Int_Max(mesh->m_triangleCount, 1), sizeof(Triangle));
+    mesh->m_weldedVertices = (MeshVertex *)calloc(
+        Int_Max(mesh->m_weldedCount, 1), sizeof(MeshVertex));
+    mesh->m_indices = (int *)calloc(Int_Max(3 * mesh->m_triangleCount, 1), sizeof(int));
+    if (!mesh->m_vertices || !mesh->m_triangles || !mesh->m_weldedVertices || !mesh->m_indices)
+        goto ERROR_LABEL;
+
+    if (source->m_occlusion)
+    {
+        mesh->m_occlusion = (float *)calloc(Int_Max(mesh->m_weldedCount, 1), sizeof(float));
+        if (!mesh->m_occlusion) goto ERROR_LABEL;
+        mesh->m_occlusionRayCount = source->m_occlusionRayCount;
+    }
+
+    // Les matériaux restent ceux du mesh source
+    mesh->m_materialCount = source->m_materialCount;
+    mesh->m_materials = source->m_materials;
+    mesh->m_materialSource = source;
+    strcpy_s(mesh->m_materialLib, MESH_NAME_SIZE, source->m_materialLib);
+
+    #pragma omp parallel for
+    for (i = 0; i < count; ++i)
+    {
+        Mat4 transform = transforms[i];
+
+        // Les normales sont transformées par l'inverse de la transposée
+        Mat4 normalTransform = Mat4_Transpose(Mat4_Inv(transform));
+
+        Vec3 *vertices = mesh->m_vertices + i * vertexCount;
+        for (int j = 0; j < vertexCount; ++j)
+        {
+            vertices[j] = Vec3_From4(Mat4_MulMV(transform, Vec4_From3(source->m_vertices[j], 1.0f)));
+        }
+
+        MeshVertex *weldedVertices = mesh->m_weldedVertices + i * weldedCount;
+        for (int j = 0; j < weldedCount; ++j)
+        {
+            MeshVertex vertex = Mesh_GetWeldedVertex(source, j);
+            vertex.m_position = Vec3_From4(Mat4_MulMV(transform, Vec4_From3(vertex.m_position, 1.0f)));
+            vertex.m_normal = Mesh_TransformDirection(normalTransform, vertex.m_normal);
+            vertex.m_tangent = Mesh_TransformDirection(transform, vertex.m_tangent);
+            weldedVertices[j] = vertex;
+        }
+
+        if (source->m_occlusion)
+        {
+            memcpy(mesh->m_occlusion + i * weldedCount, source->m_occlusion, weldedCount * sizeof(float));
+        }
+
+        // Seuls les sommets soudés sont utilisés : les triangles ne gardent que
+        // les indices des positions (pour les meshlets) et leur matériau.
+        // Les copies d'un même sous-mesh sont rangées ensemble pour garder le tri par matériau
+        for (int s = 0; s < source->m_submeshCount; ++s)
+        {
+            MeshSubmesh *submesh = &source->m_submeshes[s];
+            int first = count * submesh->m_triangleOffset + i * submesh->m_triangleCount;
+
+            for (int j = 0; j < submesh->m_triangleCount; ++j)
+            {
+                int srcId = submesh->m_triangleOffset + j;
+                Triangle *triangle = mesh->m_triangles + first + j;
+                int *indices = mesh->m_indices + 3 * (first + j);
+
+                triangle->m_materialIndex = source->m_triangles[srcId].m_materialIndex;
+                for (int k = 0; k < 3; ++k)
+                {
+                    triangle->m_vertexIndices[k] = source->m_triangles[srcId].m_vertexIndices[k] + i * vertexCount;
+                    triangle->m_normalIndices[k] = -1;
+                    triangle->m_textUVIndices[k] = -1;
+                    indices[k] = source->m_indices[3 * srcId + k] + i * weldedCount;
+                }
+            }
+        }
+    }
+
+    Mesh_ComputeBounds(mesh);
+
+    int exitStatus = Meshlet_Build(mesh);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    exitStatus = Mesh_BuildSubmeshes(mesh);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    exitStatus = Meshlet_BuildOrders(mesh);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    exitStatus = MeshBvh_Build(mesh);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    // Le lot est compressé comme son mesh source
+    if (source->m_packedVertices)
+    {
+        exitStatus = Mesh_Quantize(mesh);
+        if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    }
+
+    return mesh;
+
+ERROR_LABEL:
+    printf("ERROR - Mesh_CreateMerged()\n");
+    assert(false);
+    Mesh_Free(mesh);
+    return NULL;
+}
+
+/// @brief Construit les sous-meshes d'une liste de triangles.
+/// @param[in] mesh le mesh (pour les positions des sommets soudés).
+/// @param[in] triangleCount le nombre de triangles.
+/// @param[in] indices les indices des sommets des triangles (trois par triangle).
+/// @param[in] vertexIds les sommets soudés désignés par indices (NULL pour l'identité).
+/// @param[in] triangles les triangles du mesh complet, ou NULL pour un niveau de détail.
+/// @param[in] materialIndices le matériau de chaque triangle (si triangles vaut NULL).
+/// @param[out] submeshes les sous-meshes alloués.
+/// @return Le nombre de sous-meshes ou -1 en cas d'erreur.
+static int Mesh_BuildSubmeshTable(
+    Mesh *mesh, int triangleCount, const int *indices, const int *vertexIds,
+    const Triangle *triangles, const int *materialIndices, MeshSubmesh **submeshes)
+{
+    int submeshCount = 0;
+    int i;
+
+    // Compte les suites de triangles de même matériau
+    int previous = INT_MIN;
+    for (i = 0; i < triangleCount; ++i)
+    {
+        int material = triangles ? triangles[i].m_materialIndex : materialIndices[i];
+        if (material != previous)
+        {
+            submeshCount++;
+            previous = material;
+        }
+    }
+
+    MeshSubmesh *table = (MeshSubmesh *)calloc(Int_Max(submeshCount, 1), sizeof(MeshSubmesh));
+    if (!table) goto ERROR_LABEL;
+
+    int s = -1;
+    previous = INT_MIN;
+    for (i = 0; i < triangleCount; ++i)
+    {
+        int material = triangles ? triangles[i].m_materialIndex : materialIndices[i];
+        if (material != previous)
+        {
+            s++;
+            table[s].m_materialIndex = material;
+            table[s].m_triangleOffset = i;
+            previous = material;
+        }
+        table[s].m_triangleCount++;
+    }
+
+    // Sphère englobante : centre de la boîte englobante des sommets
+    for (s = 0; s < submeshCount; ++s)
+    {
+        MeshSubmesh *submesh = &table[s];
+        Vec3 vMin = Vec3_Set(+INFINITY, +INFINITY, +INFINITY);
+        Vec3 vMax = Vec3_Set(-INFINITY, -INFINITY, -INFINITY);
+
+        int first = 3 * submesh->m_triangleOffset;
+        int last = 3 * (submesh->m_triangleOffset + submesh->m_triangleCount);
+        for (i = first; i < last; ++i)
+        {
+            int vertexId = vertexIds ? vertexIds[indices[i]] : indices[i];
+            Vec3 position = mesh->m_weldedVertices[vertexId].m_position;
+            vMin = Vec3_Min(vMin, position);
+            vMax = Vec3_Max(vMax, position);
+        }
+
+        submesh->m_center = Vec3_Scale(Vec3_Add(vMin, vMax), 0.5f);
+        submesh->m_radius = Vec3_Length(Vec3_Sub(vMax, submesh->m_center));
+    }
+
+    *submeshes = table;
+    return submeshCount;
+
+ERROR_LABEL:
+    printf("ERROR - Mesh_BuildSubmeshTable()\n");
+    assert(false);
+    return -1;
+}
+
+int Mesh_BuildSubmeshes(Mesh *mesh)
+{
+    MeshSubmesh *submeshes = NULL;
+
+    assert(mesh->m_weldedVertices && mesh->m_indices);
+
+    int submeshCount = Mesh_BuildSubmeshTable(
+        mesh, mesh->m_triangleCount, mesh->m_indices, NULL, mesh->m_triangles, NULL, &submeshes);
+    if (submeshCount < 0) goto ERROR_LABEL;
+
+    free(mesh->m_submeshes);
+    mesh->m_submeshes = submeshes;
+    mesh->m_submeshCount = submeshCount;
+
+    // Les meshlets sont construits dans l'ordre des triangles sans mélanger les matériaux :
+    // ceux d'un sous-mesh sont consécutifs
+    int s = 0;
+    for (int i = 0; i < mesh->m_meshletCount; ++i)
+    {
+        Meshlet *meshlet = &mesh->m_meshlets[i];
+        int *meshletTriangles = mesh->m_meshletTriangles + meshlet->m_triangleOffset;
+
+        while (s < submeshCount &&
+            meshletTriangles[0] >= submeshes[s].m_triangleOffset + submeshes[s].m_triangleCount)
+        {
+            s++;
+        }
+        if (s >= submeshCount)
+            goto ERROR_LABEL;
+
+        for (int j = 0; j < meshlet->m_triangleCount; ++j)
+        {
+            int triangle = meshletTriangles[j];
+            if (triangle < submeshes[s].m_triangleOffset ||
+                triangle >= submeshes[s].m_triangleOffset + submeshes[s].m_triangleCount)
+            {
+                // Le meshlet mélange des sous-meshes
+                goto ERROR_LABEL;
+            }
+        }
+
+        if (submeshes[s].m_meshletCount == 0)
+        {
+            submeshes[s].m_meshletOffset = i;
+        }
+        submeshes[s].m_meshletCount++;
+    }
+
+    for (int i = 0; i < mesh->m_lodCount; ++i)
+    {
+        MeshLod *lod = &mesh->m_lods[i];
+
+        submeshes = NULL;
+        submeshCount = Mesh_BuildSubmeshTable(
+            mesh, lod->m_triangleCount, lod->m_indices, lod->m_vertices,
+            NULL, lod->m_materialIndices, &submeshes);
+        if (submeshCount < 0) goto ERROR_LABEL;
+
+        free(lod->m_submeshes);
+        lod->m_submeshes = submeshes;
+        lod->m_submeshCount = submeshCount;
+    }
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    // Pas d'assertion : l'échec peut venir d'un fichier .rtmesh incohérent, que
+    // MeshCache_Load() ignore (les erreurs d'allocation sont signalées par
+    // Mesh_BuildSubmeshTable())
+    printf("ERROR - Mesh_BuildSubmeshes()\n");
+    return EXIT_FAILURE;
+}
+
 int Mesh_ComputeTangents(Mesh *mesh)
 {
     int vertexCount = mesh->m_vertexCount;
@@ -598,38 +1236,41 @@ int Mesh_ComputeTangents(Mesh *mesh)
 
     int tangentCount = vertexCount;
     Vec3 *tangents = NULL;
+    Vec3 *triangleTangents = NULL;
+    int *cornerOffsets = NULL;
+    int *cornerTriangles = NULL;
 
     int textUVCount = mesh->m_textUVCount;
     Vec2 *textUVs = mesh->m_textUVs;
 
-    tangents = (Vec3 *)calloc(tangentCount, sizeof(Vec3));
-    if (!tangents) goto ERROR_LABEL;
-
     int triangleCount = mesh->m_triangleCount;
     Triangle *triangles = mesh->m_triangles;
 
-    for (int i = 0; i < triangleCount; ++i)
+    tangents = (Vec3 *)calloc(Int_Max(tangentCount, 1), sizeof(Vec3));
+    triangleTangents = (Vec3 *)malloc(Int_Max(triangleCount, 1) * sizeof(Vec3));
+    cornerOffsets = (int *)calloc(tangentCount + 1, sizeof(int));
+    cornerTriangles = (int *)malloc(Int_Max(3 * triangleCount, 1) * sizeof(int));
+    if (!tangents || !triangleTangents || !cornerOffsets || !cornerTriangles) goto ERROR_LABEL;
+
+    // Tangente unitaire de chaque triangle (nulle si le triangle n'a pas de coordonnées uv) :
+    // comme dans la version séquentielle d'origine, chaque triangle a le même poids
+    // dans la tangente de ses sommets, quelle que soit son aire
+    int i;
+    #pragma omp parallel for
+    for (i = 0; i < triangleCount; ++i)
     {
         Triangle *triangle = triangles + i;
-        int vertexIndices[3] = {
-            triangle->m_vertexIndices[0],
-            triangle->m_vertexIndices[1],
-            triangle->m_vertexIndices[2]
-        };
-        int textUVIndices[3] = {
-            triangle->m_textUVIndices[0],
-            triangle->m_textUVIndices[1],
-            triangle->m_textUVIndices[2]
-        };
+        int *vertexIndices = triangle->m_vertexIndices;
+        int *textUVIndices = triangle->m_textUVIndices;
 
         if (textUVIndices[0] == -1 ||
             textUVIndices[1] == -1 ||
             textUVIndices[2] == -1)
         {
+            triangleTangents[i] = Vec3_Zero;
             continue;
         }
 
-        int j = 0;
         Vec3 v0 = vertices[vertexIndices[0]];
         Vec3 v1 = vertices[vertexIndices[1]];
         Vec3 v2 = vertices[vertexIndices[2]];
@@ -657,30 +1298,61 @@ int Mesh_ComputeTangents(Mesh *mesh)
             Vec3_Scale(deltaP2, -deltaV1)
         );
         tangent = Vec3_Scale(tangent, 1.0f / det);
-        tangent = Vec3_Normalize(tangent);
+        triangleTangents[i] = Vec3_Normalize(tangent);
+    }
 
+    // Liste des triangles de chaque sommet, dans l'ordre des triangles :
+    // la somme ne dépend pas du nombre de threads
+    for (i = 0; i < triangleCount; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            cornerOffsets[triangles[i].m_vertexIndices[j] + 1]++;
+        }
+    }
+    for (i = 0; i < tangentCount; ++i)
+    {
+        cornerOffsets[i + 1] += cornerOffsets[i];
+    }
+    for (i = 0; i < triangleCount; ++i)
+    {
         for (int j = 0; j < 3; ++j)
         {
-            tangents[vertexIndices[j]] = Vec3_Add(
-                tangents[vertexIndices[j]],
-                tangent);
+            // cornerOffsets[v] avance jusqu'au début de la liste de v + 1
+            cornerTriangles[cornerOffsets[triangles[i].m_vertexIndices[j]]++] = i;
         }
     }
 
-    for (int i = 0; i < tangentCount; ++i)
+    // Somme des tangentes des triangles adjacents, dans l'ordre des triangles comme
+    // la version séquentielle (résultat identique), puis normalisation
+    #pragma omp parallel for
+    for (i = 0; i < tangentCount; ++i)
     {
-        // Normalise la tangente
-        float length = Vec3_Length(tangents[i]);
+        int first = (i > 0) ? cornerOffsets[i - 1] : 0;
+        int last = cornerOffsets[i];
+
+        Vec3 tangent = Vec3_Zero;
+        for (int k = first; k < last; ++k)
+        {
+            tangent = Vec3_Add(tangent, triangleTangents[cornerTriangles[k]]);
+        }
+
+        float length = Vec3_Length(tangent);
         if (length < 1E-5f)
         {
             tangents[i] = Vec3_Zero;
         }
         else
         {
-            tangents[i] = Vec3_Scale(tangents[i], 1.0f / length);
+            tangents[i] = Vec3_Scale(tangent, 1.0f / length);
         }
     }
 
+    free(triangleTangents);
+    free(cornerOffsets);
+    free(cornerTriangles);
+
+    free(mesh->m_tangents);
     mesh->m_tangents = tangents;
     mesh->m_tangentCount = tangentCount;
 
@@ -689,9 +1361,239 @@ int Mesh_ComputeTangents(Mesh *mesh)
 ERROR_LABEL:
     printf("ERROR - Mesh_ComputeTangents()\n");
     assert(false);
+    free(tangents);
+    free(triangleTangents);
+    free(cornerOffsets);
+    free(cornerTriangles);
+    return EXIT_FAILURE;
+}
+
+/// @brief Calcule le hachage d'un sommet (indices de position, de normale et d'uv).
+static Uint32 Mesh_HashVertex(int vertexIndex, int normalIndex, int textUVIndex)
+{
+    Uint32 hash = (Uint32)vertexIndex * 0x9E3779B1u;
+    hash ^= (Uint32)normalIndex * 0x85EBCA77u + (hash << 6) + (hash >> 2);
+    hash ^= (Uint32)textUVIndex * 0xC2B2AE3Du + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+int Mesh_Weld(Mesh *mesh)
+{
+    int triangleCount = mesh->m_triangleCount;
+    int indexCount = 3 * triangleCount;
+    int *table = NULL;
+    int *keys = NULL;
+    MeshVertex *weldedVertices = NULL;
+    int *indices = NULL;
+
+    // Table de hachage (adressage ouvert) des triplets d'indices déjà rencontrés
+    int tableSize = 1;
+    while (tableSize < 2 * indexCount) tableSize <<= 1;
+
+    table = (int *)malloc(tableSize * sizeof(int));
+    keys = (int *)malloc(Int_Max(indexCount, 1) * 3 * sizeof(int));
+    indices = (int *)malloc(Int_Max(indexCount, 1) * sizeof(int));
+    if (!table || !keys || !indices) goto ERROR_LABEL;
+
+    memset(table, -1, tableSize * sizeof(int));
+
+    int weldedCount = 0;
+    for (int i = 0; i < triangleCount; ++i)
+    {
+        Triangle *triangle = &mesh->m_triangles[i];
+        for (int j = 0; j < 3; ++j)
+        {
+            int vertexIndex = triangle->m_vertexIndices[j];
+            int normalIndex = triangle->m_normalIndices[j];
+            int textUVIndex = triangle->m_textUVIndices[j];
+
+            Uint32 slot = Mesh_HashVertex(vertexIndex, normalIndex, textUVIndex) & (tableSize - 1);
+            while (table[slot] >= 0)
+            {
+                int *key = keys + 3 * table[slot];
+                if (key[0] == vertexIndex && key[1] == normalIndex && key[2] == textUVIndex)
+                    break;
+                slot = (slot + 1) & (tableSize - 1);
+            }
+
+            if (table[slot] < 0)
+            {
+                int *key = keys + 3 * weldedCount;
+                key[0] = vertexIndex;
+                key[1] = normalIndex;
+                key[2] = textUVIndex;
+                table[slot] = weldedCount++;
+            }
+            indices[3 * i + j] = table[slot];
+        }
+    }
+
+    free(table);
+    table = NULL;
+
+    weldedVertices = (MeshVertex *)calloc(Int_Max(weldedCount, 1), sizeof(MeshVertex));
+    if (!weldedVertices) goto ERROR_LABEL;
+
+    for (int i = 0; i < weldedCount; ++i)
+    {
+        int *key = keys + 3 * i;
+        MeshVertex *vertex = &weldedVertices[i];
+
+        vertex->m_position = mesh->m_vertices[key[0]];
+        vertex->m_normal = mesh->m_normals[key[1]];
+        if (mesh->m_tangents)
+        {
+            vertex->m_tangent = mesh->m_tangents[key[0]];
+        }
+        if (key[2] >= 0)
+        {
+            vertex->m_textUV = mesh->m_textUVs[key[2]];
+        }
+    }
+
+    free(keys);
+    keys = NULL;
+
+    free(mesh->m_weldedVertices);
+    free(mesh->m_indices);
+    mesh->m_weldedCount = weldedCount;
+    mesh->m_weldedVertices = weldedVertices;
+    mesh->m_indices = indices;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - Mesh_Weld()\n");
+    assert(false);
+    free(table);
+    free(keys);
+    free(indices);
+    free(weldedVertices);
     return EXIT_FAILURE;
 }
 
+/// @brief Renvoie l'angle (en degrés) entre deux directions unitaires.
+static float Mesh_GetAngle(Vec3 v1, Vec3 v2)
+{
+    return acosf(Float_Clamp(Vec3_Dot(v1, v2), -1.0f, 1.0f)) * (float)(180.0 / M_PI);
+}
+
+/// @brief Indique si les meshs sont compressés à leur chargement.
+static bool g_meshQuantization = false;
+
+void Mesh_SetQuantization(bool enabled)
+{
+    g_meshQuantization = enabled;
+}
+
+bool Mesh_GetQuantization()
+{
+    return g_meshQuantization;
+}
+
+int Mesh_Quantize(Mesh *mesh)
+{
+    int weldedCount = mesh->m_weldedCount;
+    MeshVertex *weldedVertices = mesh->m_weldedVertices;
+    MeshPackedVertex *packedVertices = NULL;
+    int i;
+
+    assert(weldedVertices);
+
+    packedVertices = (MeshPackedVertex *)calloc(
+        Int_Max(weldedCount, 1), sizeof(MeshPackedVertex));
+    if (!packedVertices) goto ERROR_LABEL;
+
+    Vec3 origin = mesh->m_min;
+    Vec3 extent = Vec3_Sub(mesh->m_max, mesh->m_min);
+
+    #pragma omp parallel for
+    for (i = 0; i < weldedCount; ++i)
+    {
+        MeshVertex *vertex = weldedVertices + i;
+        MeshPackedVertex *packed = packedVertices + i;
+
+        for (int j = 0; j < 3; ++j)
+        {
+            // Un axe plat est quantifié à 0
+            float t = 0.0f;
+            if (extent.data[j] > 0.0f)
+            {
+                t = (vertex->m_position.data[j] - origin.data[j]) / extent.data[j];
+            }
+            packed->m_position[j] = (Uint16)lrintf(Float_Clamp01(t) * 65535.0f);
+        }
+        Vec3_EncodeOctahedral(vertex->m_normal, packed->m_normal);
+        Vec3_EncodeOctahedral(vertex->m_tangent, packed->m_tangent);
+        packed->m_textUV[0] = Float_ToHalf(vertex->m_textUV.x);
+        packed->m_textUV[1] = Float_ToHalf(vertex->m_textUV.y);
+    }
+
+    // Erreur par rapport aux sommets en flottants 32 bits
+    Vec3 step = Mesh_GetQuantizationStep(mesh);
+    float positionError = 0.0f;
+    float normalError = 0.0f;
+    float tangentError = 0.0f;
+    float textUVError = 0.0f;
+    double normalErrorSum = 0.0;
+
+    for (i = 0; i < weldedCount; ++i)
+    {
+        MeshVertex *vertex = weldedVertices + i;
+        MeshVertex unpacked = Mesh_UnpackVertex(packedVertices + i, origin, step);
+
+        Vec3 delta = Vec3_Abs(Vec3_Sub(unpacked.m_position, vertex->m_position));
+        positionError = fmaxf(positionError, fmaxf(delta.x, fmaxf(delta.y, delta.z)));
+
+        float angle = Mesh_GetAngle(unpacked.m_normal, Vec3_Normalize(vertex->m_normal));
+        normalError = fmaxf(normalError, angle);
+        normalErrorSum += angle;
+
+        // Les tangentes nulles (triangles sans uv) ne sont pas utilisées
+        if (Vec3_Length(vertex->m_tangent) > 0.5f)
+        {
+            angle = Mesh_GetAngle(unpacked.m_tangent, Vec3_Normalize(vertex->m_tangent));
+            tangentError = fmaxf(tangentError, angle);
+        }
+
+        textUVError = fmaxf(textUVError, fabsf(unpacked.m_textUV.x - vertex->m_textUV.x));
+        textUVError = fmaxf(textUVError, fabsf(unpacked.m_textUV.y - vertex->m_textUV.y));
+    }
+
+    float diagonal = Vec3_Length(extent);
+    size_t fullSize = (size_t)weldedCount * sizeof(MeshVertex);
+    size_t packedSize = (size_t)weldedCount * sizeof(MeshPackedVertex);
+
+    // Les sommets en flottants 32 bits ne sont plus lus
+    if (mesh->m_fileMap)
+    {
+        FileMap_Discard(mesh->m_fileMap, weldedVertices, fullSize);
+    }
+    else
+    {
+        free(weldedVertices);
+    }
+    mesh->m_weldedVertices = NULL;
+
+    free(mesh->m_packedVertices);
+    mesh->m_packedVertices = packedVertices;
+
+    printf("Sommets compresses : %zu Ko conserves, %zu Ko en flottants 32 bits liberes,"
+        " erreurs max : position %.2e (%.4f%% de la diagonale),"
+        " normale %.4f deg (moyenne %.4f), tangente %.4f deg, uv %.2e\n",
+        packedSize / 1024, fullSize / 1024,
+        positionError, diagonal > 0.0f ? 100.0f * positionError / diagonal : 0.0f,
+        normalError, weldedCount > 0 ? normalErrorSum / weldedCount : 0.0,
+        tangentError, textUVError);
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - Mesh_Quantize()\n");
+    assert(false);
+    free(packedVertices);
+    return EXIT_FAILURE;
+}
 
 void Mesh_ReverseNormals(Mesh *mesh)
 {
@@ -703,6 +1605,19 @@ void Mesh_ReverseNormals(Mesh *mesh)
             mesh->m_normals[i].data[j] *= -1.0f;
         }
     }
+
+    for (int i = 0; i < mesh->m_weldedCount; i++)
+    {
+        if (mesh->m_weldedVertices)
+        {
+            mesh->m_weldedVertices[i].m_normal = Vec3_Neg(mesh->m_weldedVertices[i].m_normal);
+        }
+        else
+        {
+            Vec3 normal = Vec3_DecodeOctahedral(mesh->m_packedVertices[i].m_normal);
+            Vec3_EncodeOctahedral(Vec3_Neg(normal), mesh->m_packedVertices[i].m_normal);
+        }
+    }
 }
 
 void Mesh_ReverseOrientation(Mesh *mesh)
@@ -724,5 +1639,38 @@ void Mesh_ReverseOrientation(Mesh *mesh)
         index = triangle->m_textUVIndices[1];
         triangle->m_textUVIndices[1] = triangle->m_textUVIndices[2];
         triangle->m_textUVIndices[2] = index;
+
+        if (mesh->m_indices)
+        {
+            index = mesh->m_indices[3 * i + 1];
+            mesh->m_indices[3 * i + 1] = mesh->m_indices[3 * i + 2];
+            mesh->m_indices[3 * i + 2] = index;
+        }
+    }
+
+    for (int i = 0; i < mesh->m_lodCount; i++)
+    {
+        MeshLod *lod = &mesh->m_lods[i];
+        for (int j = 0; j < lod->m_triangleCount; j++)
+        {
+            int index = lod->m_indices[3 * j + 1];
+            lod->m_indices[3 * j + 1] = lod->m_indices[3 * j + 2];
+            lod->m_indices[3 * j + 2] = index;
+        }
+    }
+
+    if (mesh->m_meshletIndices)
+    {
+        for (int i = 0; i < nbTriangles; i++)
+        {
+            Uint8 index = mesh->m_meshletIndices[3 * i + 1];
+            mesh->m_meshletIndices[3 * i + 1] = mesh->m_meshletIndices[3 * i + 2];
+            mesh->m_meshletIndices[3 * i + 2] = index;
+        }
+    }
+    for (int i = 0; i < mesh->m_meshletCount; i++)
+    {
+        Meshlet *meshlet = &mesh->m_meshlets[i];
+        meshlet->m_coneAxis = Vec3_Neg(meshlet->m_coneAxis);
     }
 }
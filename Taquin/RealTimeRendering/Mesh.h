@@ -7,9 +7,34 @@
 
 #include "Settings.h"
 #include "Vector.h"
+#include "Matrix.h"
 #include "Timer.h"
+#include "Tools.h"
 
 typedef struct Material_s Material;
+typedef struct FileMap_s FileMap;
+
+/// @brief Taille maximale du nom d'un fichier référencé par un mesh.
+#define MESH_NAME_SIZE 256
+
+/// @brief Angle (en degrés) entre deux faces au-delà duquel leur arête commune est vive
+/// lors du calcul des normales manquantes : les normales n'y sont pas lissées.
+#define MESH_CREASE_ANGLE 60.0f
+
+/// @brief Nombre maximal de niveaux de détail simplifiés d'un mesh (voir MeshLod_Build()).
+#define MESH_MAX_LODS 4
+
+/// @brief Nombre maximal de sommets d'un meshlet (voir Meshlet_Build()).
+#define MESH_MESHLET_MAX_VERTICES 64
+
+/// @brief Nombre maximal de triangles d'un meshlet.
+#define MESH_MESHLET_MAX_TRIANGLES 124
+
+/// @brief Nombre maximal de triangles d'une feuille de la BVH d'un mesh (voir MeshBvh_Build()).
+#define MESH_BVH_MAX_LEAF_TRIANGLES 4
+
+/// @brief Profondeur maximale de la BVH d'un mesh (taille des piles de parcours).
+#define MESH_BVH_MAX_DEPTH 64
 
 /// @brief Structure représentant un triangle dans un mesh.
 typedef struct Triangle_s
@@ -20,6 +45,120 @@ typedef struct Triangle_s
     int m_materialIndex;
 } Triangle;
 
+/// @brief Sommet soudé : combinaison distincte d'une position, d'une normale
+/// et de coordonnées uv utilisée par au moins un triangle.
+typedef struct MeshVertex_s
+{
+    Vec3 m_position;
+    Vec3 m_normal;
+    Vec3 m_tangent;
+    Vec2 m_textUV;
+} MeshVertex;
+
+/// @brief Sommet soudé compressé : 18 octets au lieu des 44 d'un MeshVertex.
+/// Voir Mesh_Quantize() et Mesh_UnpackVertex().
+typedef struct MeshPackedVertex_s
+{
+    /// @brief Position quantifiée sur 16 bits par axe dans la boîte englobante du mesh.
+    Uint16 m_position[3];
+
+    /// @brief Normale en coordonnées octaédriques (voir Vec3_EncodeOctahedral()).
+    Sint16 m_normal[2];
+
+    /// @brief Tangente en coordonnées octaédriques.
+    Sint16 m_tangent[2];
+
+    /// @brief Coordonnées uv en demi-flottants.
+    Uint16 m_textUV[2];
+} MeshPackedVertex;
+
+/// @brief Suite de triangles consécutifs utilisant le même matériau.
+/// Les triangles d'un mesh sont triés par matériau au chargement : le rendu d'un sous-mesh
+/// ne lit qu'un seul jeu de textures (voir Mesh_BuildSubmeshes()).
+typedef struct MeshSubmesh_s
+{
+    /// @brief Indice du matériau des triangles (-1 si aucun).
+    int   m_materialIndex;
+
+    /// @brief Premier triangle du sous-mesh et nombre de triangles.
+    int   m_triangleOffset;
+    int   m_triangleCount;
+
+    /// @brief Premier meshlet du sous-mesh dans Mesh::m_meshlets et nombre de meshlets
+    /// (mesh complet uniquement, 0 pour un niveau de détail).
+    int   m_meshletOffset;
+    int   m_meshletCount;
+
+    /// @brief Sphère englobante des triangles, dans le repère de l'objet.
+    Vec3  m_center;
+    float m_radius;
+} MeshSubmesh;
+
+/// @brief Niveau de détail simplifié d'un mesh.
+/// Il réutilise les sommets soudés du mesh complet.
+typedef struct MeshLod_s
+{
+    /// @brief Sommets soudés utilisés par le niveau (indices dans m_weldedVertices).
+    int    m_vertexCount;
+    int   *m_vertices;
+
+    /// @brief Indices des triangles (trois par triangle) dans m_vertices.
+    int    m_triangleCount;
+    int   *m_indices;
+
+    /// @brief Indice du matériau de chaque triangle.
+    int   *m_materialIndices;
+
+    /// @brief Sous-meshes du niveau (toujours alloués, même si le mesh provient
+    /// d'un fichier .rtmesh).
+    int          m_submeshCount;
+    MeshSubmesh *m_submeshes;
+
+    /// @brief Erreur géométrique du niveau, dans le repère de l'objet : distance moyenne
+    /// (quadratique) à la surface d'origine des sommets les plus déplacés.
+    float  m_error;
+} MeshLod;
+
+/// @brief Groupe de triangles voisins du mesh complet, rejeté en bloc lors du rendu
+/// s'il est hors du champ de la caméra ou vu de dos.
+typedef struct Meshlet_s
+{
+    /// @brief Premier sommet dans Mesh::m_meshletVertices et nombre de sommets.
+    int   m_vertexOffset;
+    int   m_vertexCount;
+
+    /// @brief Premier triangle dans Mesh::m_meshletTriangles et nombre de triangles.
+    int   m_triangleOffset;
+    int   m_triangleCount;
+
+    /// @brief Sphère englobante, dans le repère de l'objet.
+    Vec3  m_center;
+    float m_radius;
+
+    /// @brief Axe du cône contenant les normales des triangles et sinus de son
+    /// demi-angle (1 si le cône ne permet aucun rejet).
+    Vec3  m_coneAxis;
+    float m_coneCutoff;
+} Meshlet;
+
+/// @brief Noeud de la hiérarchie de boîtes englobantes des triangles d'un mesh (32 octets).
+/// Les deux enfants d'un noeud interne sont rangés l'un après l'autre.
+typedef struct MeshBvhNode_s
+{
+    /// @brief Coin minimal de la boîte, dans le repère de l'objet.
+    Vec3 m_min;
+
+    /// @brief Noeud interne : indice du premier enfant.
+    /// Feuille : indice du premier triangle dans Mesh::m_bvhTriangles.
+    int  m_offset;
+
+    /// @brief Coin maximal de la boîte, dans le repère de l'objet.
+    Vec3 m_max;
+
+    /// @brief Nombre de triangles d'une feuille (0 pour un noeud interne).
+    int  m_count;
+} MeshBvhNode;
+
 /// @brief Structure représentant un mesh.
 typedef struct Mesh_s
 {
@@ -35,28 +174,228 @@ typedef struct Mesh_s
     int       m_triangleCount;
     Triangle *m_triangles;
 
+    /// @brief Sous-meshes du mesh complet, dans l'ordre des triangles (voir Mesh_BuildSubmeshes()).
+    /// Ce tableau est toujours alloué, même si le mesh provient d'un fichier .rtmesh.
+    int          m_submeshCount;
+    MeshSubmesh *m_submeshes;
+
     int       m_tangentCount;
     Vec3     *m_tangents;
 
+    /// @brief Sommets soudés (voir Mesh_Weld()).
+    /// Chaque sommet n'est transformé qu'une seule fois par le vertex shader.
+    /// m_weldedVertices vaut NULL si le mesh a été compressé : seuls m_packedVertices
+    /// sont alors conservés (voir Mesh_GetWeldedVertex()).
+    int         m_weldedCount;
+    MeshVertex *m_weldedVertices;
+
+    /// @brief Indices des sommets soudés de chaque triangle (trois par triangle).
+    int        *m_indices;
+
+    /// @brief Occlusion ambiante de chaque sommet soudé dans [0,1] (1 : sommet non occulté),
+    /// ou NULL si elle n'a pas été calculée (voir MeshOcclusion_Bake()).
+    float      *m_occlusion;
+
+    /// @brief Nombre de rayons par sommet utilisés pour calculer m_occlusion (0 si NULL).
+    int         m_occlusionRayCount;
+
+    /// @brief Sommets soudés compressés (voir Mesh_Quantize()), ou NULL si les meshs ne sont pas
+    /// compressés au chargement (voir Mesh_SetQuantization()). Ils remplacent m_weldedVertices.
+    MeshPackedVertex *m_packedVertices;
+
+    /// @brief Meshlets du mesh complet (voir Meshlet_Build()).
+    int       m_meshletCount;
+    Meshlet  *m_meshlets;
+
+    /// @brief Sommets soudés des meshlets, mis bout à bout.
+    int       m_meshletVertexCount;
+    int      *m_meshletVertices;
+
+    /// @brief Indice dans m_triangles de chaque triangle des meshlets.
+    int      *m_meshletTriangles;
+
+    /// @brief Sommets des triangles des meshlets (trois par triangle),
+    /// numérotés à partir du premier sommet de leur meshlet.
+    Uint8    *m_meshletIndices;
+
+    /// @brief Ordres de rendu des meshlets précalculés pour MESHLET_ORDER_COUNT directions
+    /// de vue, m_meshletCount indices par direction (voir Meshlet_BuildOrders()), ou NULL.
+    /// Ce tableau est toujours alloué, même si le mesh provient d'un fichier .rtmesh.
+    int      *m_meshletOrders;
+
+    /// @brief Hiérarchie de boîtes englobantes des triangles (voir MeshBvh_Build()),
+    /// la racine est le noeud 0.
+    int          m_bvhNodeCount;
+    MeshBvhNode *m_bvhNodes;
+
+    /// @brief Triangles des feuilles de la BVH, rangés feuille par feuille
+    /// (indices dans m_triangles).
+    int         *m_bvhTriangles;
+
+    /// @brief Niveaux de détail simplifiés, du plus détaillé au plus grossier.
+    /// Le mesh complet (niveau 0) n'en fait pas partie.
+    int       m_lodCount;
+    MeshLod  *m_lods;
+
     Vec3      m_min;
     Vec3      m_max;
     Vec3      m_center;
 
     int       m_materialCount;
     Material *m_materials;
+
+    /// @brief Mesh auquel appartiennent les matériaux (voir Mesh_CreateMerged()),
+    /// ou NULL si les matériaux appartiennent à ce mesh.
+    struct Mesh_s *m_materialSource;
+
+    /// @brief Nom du fichier mtl (vide si le mesh n'a pas de matériau).
+    char      m_materialLib[MESH_NAME_SIZE];
+
+    /// @brief Projection du fichier .rtmesh dont proviennent les tableaux du mesh,
+    /// ou NULL si les tableaux ont été alloués (voir MeshCache_Load()).
+    FileMap  *m_fileMap;
 } Mesh;
 
 /// @brief Crée un mesh et l'initialise à partir d'un fichier objet 3D (d'extension .obj).
+/// Les triangles sont triés par matériau.
+/// Calcule aussi les normales manquantes, les tangentes, les sommets soudés,
+/// les niveaux de détail, les meshlets, la BVH des triangles et, si elle est activée
+/// (voir MeshOcclusion_SetRayCount()), l'occlusion ambiante des sommets,
+/// puis affiche la durée de chaque étape.
+/// Les textures des matériaux ne sont pas chargées (voir Material_LoadTextures()).
 /// @param[in] path le chemin vers le ficher obj.
-/// @return Le mesh spécifié dans le fichier obj.
+/// @return Le mesh spécifié dans le fichier obj, ou NULL si le fichier est vide
+/// (sans assertion) ou en cas d'erreur.
 Mesh *Mesh_LoadOBJ(char *folderPath, char *fileName);
 
 /// @brief Détruit un mesh préalablement alloué dynamiquement (comme avec Mesh_loadObj).
 /// @param[in,out] mesh le mesh à détruire.
 void Mesh_Free(Mesh *mesh);
 
+/// @brief Détruit les niveaux de détail simplifiés d'un mesh.
+/// @param[in,out] mesh le mesh.
+void Mesh_FreeLods(Mesh *mesh);
+
+/// @brief Crée un mesh regroupant plusieurs copies transformées d'un mesh.
+/// Les sommets sont exprimés dans le référentiel des transformations (le monde pour
+/// un lot d'objets statiques). Les triangles restent triés par matériau : ceux d'un même
+/// sous-mesh de toutes les copies sont consécutifs.
+/// La boîte englobante, les meshlets, les sous-meshes et la BVH sont recalculés,
+/// mais pas les niveaux de détail ni les sommets compressés.
+/// L'occlusion ambiante des sommets est celle du mesh source.
+/// Les matériaux ne sont pas copiés : le mesh source doit être détruit après le mesh créé.
+/// @param[in] source le mesh à copier (avec ses sommets soudés).
+/// @param[in] transforms les transformations de chaque copie.
+/// @param[in] count le nombre de copies.
+/// @return Le mesh créé ou NULL en cas d'erreur.
+Mesh *Mesh_CreateMerged(Mesh *source, const Mat4 *transforms, int count);
+
+/// @brief Compare les analyseurs obj (rapide, par morceaux et de référence) sur un fichier.
+/// Affiche les temps d'analyse et vérifie que les trois résultats sont identiques.
+/// @param[in] folderPath le dossier du fichier obj.
+/// @param[in] fileName le nom du fichier obj.
+/// @return EXIT_SUCCESS si les résultats sont identiques, EXIT_FAILURE sinon.
+int Mesh_BenchmarkOBJ(char *folderPath, char *fileName);
+
 int Mesh_ComputeTangents(Mesh *mesh);
 
+/// @brief Construit les sommets soudés du mesh et les indices des triangles.
+/// Les sommets des triangles partageant la même position, la même normale et
+/// les mêmes coordonnées uv sont fusionnés.
+/// Les tangentes doivent avoir été calculées avec Mesh_ComputeTangents().
+/// @param[in,out] mesh le mesh.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int Mesh_Weld(Mesh *mesh);
+
+/// @brief Construit les sous-meshes du mesh complet et de ses niveaux de détail :
+/// chaque suite de triangles consécutifs de même matériau forme un sous-mesh.
+/// Les meshlets, s'il y en a, ne doivent pas mélanger les matériaux (voir Meshlet_Build()).
+/// Les sommets soudés doivent avoir été calculés.
+/// Un meshlet qui ne correspond à aucun sous-mesh n'est pas une erreur du programme mais
+/// un fichier .rtmesh incohérent : l'échec est renvoyé sans assertion, MeshCache_Load()
+/// ignore alors le fichier et les autres appelants traitent l'échec comme une erreur.
+/// @param[in,out] mesh le mesh.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE si un meshlet ne correspond à aucun sous-mesh.
+int Mesh_BuildSubmeshes(Mesh *mesh);
+
+/// @brief Définit si les meshs sont compressés à leur chargement (voir Mesh_Quantize()).
+/// @param[in] enabled booléen indiquant si les sommets soudés sont compressés.
+void Mesh_SetQuantization(bool enabled);
+
+/// @brief Renvoie un booléen indiquant si les meshs sont compressés à leur chargement.
+/// @return Un booléen indiquant si les sommets soudés sont compressés.
+bool Mesh_GetQuantization();
+
+/// @brief Remplace les sommets soudés du mesh par des sommets compressés (m_packedVertices).
+/// Les sommets en flottants 32 bits sont libérés (ou, s'ils appartiennent à la projection
+/// du fichier .rtmesh, rendus au système) : les étapes qui les lisent (niveaux de détail,
+/// meshlets, BVH, écriture du cache...) doivent avoir été effectuées avant.
+/// Affiche la mémoire occupée par les sommets et l'erreur commise.
+/// Les sommets soudés et la boîte englobante doivent avoir été calculés.
+/// @param[in,out] mesh le mesh.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int Mesh_Quantize(Mesh *mesh);
+
+/// @brief Renvoie l'écart entre deux valeurs successives des positions quantifiées.
+/// @param[in] mesh le mesh.
+/// @return Le pas de quantification sur chaque axe.
+INLINE Vec3 Mesh_GetQuantizationStep(const Mesh *mesh)
+{
+    return Vec3_Scale(Vec3_Sub(mesh->m_max, mesh->m_min), 1.0f / 65535.0f);
+}
+
+/// @brief Décompresse un sommet soudé.
+/// @param[in] packed le sommet compressé.
+/// @param[in] origin le coin minimal de la boîte englobante du mesh.
+/// @param[in] step le pas de quantification (voir Mesh_GetQuantizationStep()).
+/// @return Le sommet décompressé.
+INLINE MeshVertex Mesh_UnpackVertex(const MeshPackedVertex *packed, Vec3 origin, Vec3 step)
+{
+    MeshVertex vertex;
+
+    vertex.m_position.x = origin.x + (float)packed->m_position[0] * step.x;
+    vertex.m_position.y = origin.y + (float)packed->m_position[1] * step.y;
+    vertex.m_position.z = origin.z + (float)packed->m_position[2] * step.z;
+    vertex.m_normal = Vec3_DecodeOctahedral(packed->m_normal);
+    vertex.m_tangent = Vec3_DecodeOctahedral(packed->m_tangent);
+    vertex.m_textUV.x = Half_ToFloat(packed->m_textUV[0]);
+    vertex.m_textUV.y = Half_ToFloat(packed->m_textUV[1]);
+
+    return vertex;
+}
+
+/// @brief Renvoie un sommet soudé du mesh, décompressé si le mesh a été compressé.
+/// @param[in] mesh le mesh.
+/// @param[in] vertexId l'indice du sommet soudé.
+/// @return Le sommet.
+INLINE MeshVertex Mesh_GetWeldedVertex(const Mesh *mesh, int vertexId)
+{
+    if (mesh->m_weldedVertices)
+    {
+        return mesh->m_weldedVertices[vertexId];
+    }
+    Vec3 step = Mesh_GetQuantizationStep(mesh);
+    return Mesh_UnpackVertex(mesh->m_packedVertices + vertexId, mesh->m_min, step);
+}
+
+/// @brief Renvoie la position d'un sommet soudé du mesh, décompressée si le mesh a été compressé.
+/// @param[in] mesh le mesh.
+/// @param[in] vertexId l'indice du sommet soudé.
+/// @return La position du sommet.
+INLINE Vec3 Mesh_GetWeldedPosition(const Mesh *mesh, int vertexId)
+{
+    if (mesh->m_weldedVertices)
+    {
+        return mesh->m_weldedVertices[vertexId].m_position;
+    }
+    const Uint16 *position = mesh->m_packedVertices[vertexId].m_position;
+    Vec3 step = Mesh_GetQuantizationStep(mesh);
+    return Vec3_Set(
+        mesh->m_min.x + (float)position[0] * step.x,
+        mesh->m_min.y + (float)position[1] * step.y,
+        mesh->m_min.z + (float)position[2] * step.z);
+}
+
 /// @brief Multiplie les normales des sommets du mesh par -1.
 /// Cette fonction permet de corriger (éventuellement) les normales calculées automatiquement.
 /// @param[in,out] mesh un mesh correctement initialisé.
@@ -77,7 +416,15 @@ void Mesh_ReverseOrientation(Mesh *mesh);
 /// @param[in,out] capacity en entrée, la taille allouée du tableau de char.
 /// En sortie, la nouvelle taille.
 /// @return EXIT_SUCCESS ou EXIT_FAILURE.
-int Buffer_ReadLine(char *buffer, int *offset, int bufferSize, char **line, int *capacity);
-char *Buffer_GetFromFile(char *folderPath, char *fileName, long *bufferSize);
+int Buffer_ReadLine(const char *buffer, int *offset, int bufferSize, char **line, int *capacity);
+
+/// @brief Projette en mémoire un fichier texte (obj/mtl) pour qu'il soit lu sans copie.
+/// Le système est prévenu que le fichier sera lu séquentiellement :
+/// l'analyse commence pendant que les pages suivantes sont chargées.
+/// @param[in] folderPath le dossier contenant le fichier.
+/// @param[in] fileName le nom du fichier.
+/// @param[out] bufferSize la taille du fichier.
+/// @return La projection, à fermer avec FileMap_Close(), ou NULL en cas d'erreur.
+FileMap *Buffer_MapFile(char *folderPath, char *fileName, long *bufferSize);
 
 #endif
\ No newline at end of file
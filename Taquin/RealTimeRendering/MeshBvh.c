@@ -0,0 +1,615 @@
+﻿#include "MeshBvh.h"
+#include "Tools.h"
+
+/// @brief Noeud restant à découper lors de la construction.
+typedef struct MeshBvhTask_s
+{
+    int m_node;
+    int m_begin;
+    int m_end;
+    int m_depth;
+} MeshBvhTask;
+
+/// @brief Sous-arbre construit par un thread.
+/// Ses noeuds sont pris dans une plage réservée du tableau des noeuds :
+/// un sous-arbre de n triangles n'utilise jamais plus de 2n - 1 noeuds.
+typedef struct MeshBvhJob_s
+{
+    MeshBvhTask m_task;
+
+    /// @brief Premier noeud réservé et premier noeud non utilisé après la construction.
+    int m_firstNode;
+    int m_lastNode;
+} MeshBvhJob;
+
+/// @brief Intervalle d'un axe lors de l'évaluation des découpes d'un noeud.
+typedef struct MeshBvhBin_s
+{
+    Vec3 m_min;
+    Vec3 m_max;
+    int  m_count;
+} MeshBvhBin;
+
+/// @brief État de la construction de la BVH d'un mesh.
+typedef struct MeshBvhBuilder_s
+{
+    /// @brief Boîte englobante et centre de cette boîte pour chaque triangle.
+    Vec3        *m_triangleMin;
+    Vec3        *m_triangleMax;
+    Vec3        *m_centroids;
+
+    /// @brief Triangles, réordonnés pour que chaque noeud couvre une plage contiguë.
+    int         *m_triangles;
+
+    /// @brief Noeuds (2n - 1 au plus pour n triangles), compactés à la fin de la construction.
+    MeshBvhNode *m_nodes;
+
+    /// @brief Sous-arbres confiés aux threads.
+    MeshBvhJob  *m_jobs;
+    int          m_jobCount;
+    int          m_jobCapacity;
+} MeshBvhBuilder;
+
+/// @brief Renvoie la demi-surface d'une boîte (coût d'un noeud).
+static float MeshBvh_GetArea(Vec3 min, Vec3 max)
+{
+    float dx = max.x - min.x;
+    float dy = max.y - min.y;
+    float dz = max.z - min.z;
+    return dx * dy + dy * dz + dz * dx;
+}
+
+/// @brief Agrandit une boîte pour qu'elle contienne une autre boîte.
+/// Les comparaisons sont écrites explicitement : fminf() et fmaxf() ne sont pas
+/// toujours remplacées par une instruction.
+static void MeshBvh_Grow(Vec3 *min, Vec3 *max, Vec3 boxMin, Vec3 boxMax)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        min->data[i] = (boxMin.data[i] < min->data[i]) ? boxMin.data[i] : min->data[i];
+        max->data[i] = (boxMax.data[i] > max->data[i]) ? boxMax.data[i] : max->data[i];
+    }
+}
+
+/// @brief Renvoie l'intervalle contenant le centre d'un triangle sur un axe.
+static int MeshBvh_GetBin(float value, float origin, float scale)
+{
+    return Int_Clamp((int)((value - origin) * scale), 0, MESH_BVH_BIN_COUNT - 1);
+}
+
+/// @brief Calcule la boîte d'un noeud, choisit sa découpe et répartit ses triangles
+/// de part et d'autre de celle-ci.
+/// @return La position de la découpe dans la plage du noeud,
+/// ou -1 si le noeud doit rester une feuille.
+static int MeshBvh_Partition(MeshBvhBuilder *builder, MeshBvhTask *task)
+{
+    MeshBvhNode *node = &builder->m_nodes[task->m_node];
+    int *triangles = builder->m_triangles;
+    Vec3 *centroids = builder->m_centroids;
+    int begin = task->m_begin;
+    int end = task->m_end;
+    int count = end - begin;
+
+    // Boîte du noeud et boîte des centres de ses triangles
+    Vec3 min = builder->m_triangleMin[triangles[begin]];
+    Vec3 max = builder->m_triangleMax[triangles[begin]];
+    Vec3 centroidMin = centroids[triangles[begin]];
+    Vec3 centroidMax = centroidMin;
+    for (int i = begin + 1; i < end; ++i)
+    {
+        int triangle = triangles[i];
+        MeshBvh_Grow(&min, &max, builder->m_triangleMin[triangle], builder->m_triangleMax[triangle]);
+        MeshBvh_Grow(&centroidMin, &centroidMax, centroids[triangle], centroids[triangle]);
+    }
+    node->m_min = min;
+    node->m_max = max;
+
+    if (count <= 1)
+        return -1;
+
+    // Découpe de coût minimal parmi les limites des intervalles de chaque axe
+    int bestAxis = -1;
+    int bestBin = 0;
+    float bestCost = INFINITY;
+    for (int axis = 0; axis < 3 && task->m_depth < MESH_BVH_MEDIAN_DEPTH; ++axis)
+    {
+        float origin = centroidMin.data[axis];
+        float extent = centroidMax.data[axis] - origin;
+        if (extent <= 0.0f)
+            continue;
+
+        MeshBvhBin bins[MESH_BVH_BIN_COUNT];
+        for (int b = 0; b < MESH_BVH_BIN_COUNT; ++b)
+        {
+            bins[b].m_min = Vec3_Set(INFINITY, INFINITY, INFINITY);
+            bins[b].m_max = Vec3_Set(-INFINITY, -INFINITY, -INFINITY);
+            bins[b].m_count = 0;
+        }
+
+        float scale = (float)MESH_BVH_BIN_COUNT / extent;
+        for (int i = begin; i < end; ++i)
+        {
+            int triangle = triangles[i];
+            MeshBvhBin *bin = &bins[MeshBvh_GetBin(centroids[triangle].data[axis], origin, scale)];
+            MeshBvh_Grow(&bin->m_min, &bin->m_max,
+                builder->m_triangleMin[triangle], builder->m_triangleMax[triangle]);
+            bin->m_count++;
+        }
+
+        // Coût des triangles situés à droite de chaque limite
+        float rightCosts[MESH_BVH_BIN_COUNT - 1];
+        Vec3 rightMin = bins[MESH_BVH_BIN_COUNT - 1].m_min;
+        Vec3 rightMax = bins[MESH_BVH_BIN_COUNT - 1].m_max;
+        int rightCount = 0;
+        for (int b = MESH_BVH_BIN_COUNT - 1; b > 0; --b)
+        {
+            MeshBvh_Grow(&rightMin, &rightMax, bins[b].m_min, bins[b].m_max);
+            rightCount += bins[b].m_count;
+            rightCosts[b - 1] = (rightCount > 0) ? rightCount * MeshBvh_GetArea(rightMin, rightMax) : 0.0f;
+        }
+
+        Vec3 leftMin = bins[0].m_min;
+        Vec3 leftMax = bins[0].m_max;
+        int leftCount = 0;
+        for (int b = 0; b < MESH_BVH_BIN_COUNT - 1; ++b)
+        {
+            MeshBvh_Grow(&leftMin, &leftMax, bins[b].m_min, bins[b].m_max);
+            leftCount += bins[b].m_count;
+
+            // Les deux enfants doivent contenir au moins un triangle
+            if (leftCount == 0 || leftCount == count)
+                continue;
+
+            float cost = leftCount * MeshBvh_GetArea(leftMin, leftMax) + rightCosts[b];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = b;
+            }
+        }
+    }
+
+    // Une feuille est conservée si elle coûte moins cher que la meilleure découpe
+    float area = MeshBvh_GetArea(min, max);
+    float leafCost = count * area;
+    float splitCost = MESH_BVH_TRAVERSAL_COST * area + bestCost;
+    if (count <= MESH_BVH_MAX_LEAF_TRIANGLES && (bestAxis < 0 || leafCost <= splitCost))
+        return -1;
+
+    if (bestAxis < 0)
+    {
+        // Centres confondus ou noeud trop profond : deux moitiés égales
+        return begin + count / 2;
+    }
+
+    float origin = centroidMin.data[bestAxis];
+    float scale = (float)MESH_BVH_BIN_COUNT / (centroidMax.data[bestAxis] - origin);
+    int i = begin;
+    int j = end;
+    while (i < j)
+    {
+        int triangle = triangles[i];
+        if (MeshBvh_GetBin(centroids[triangle].data[bestAxis], origin, scale) <= bestBin)
+        {
+            i++;
+        }
+        else
+        {
+            triangles[i] = triangles[--j];
+            triangles[j] = triangle;
+        }
+    }
+    return i;
+}
+
+/// @brief Ajoute un sous-arbre à la liste des sous-arbres construits en parallèle.
+static int MeshBvh_AddJob(MeshBvhBuilder *builder, MeshBvhTask *task)
+{
+    if (builder->m_jobCount >= builder->m_jobCapacity)
+    {
+        int capacity = Int_Max(builder->m_jobCapacity << 1, 2 * MESH_BVH_JOB_COUNT);
+        MeshBvhJob *newJobs = (MeshBvhJob *)realloc(builder->m_jobs, capacity * sizeof(MeshBvhJob));
+        if (!newJobs) goto ERROR_LABEL;
+
+        builder->m_jobs = newJobs;
+        builder->m_jobCapacity = capacity;
+    }
+
+    MeshBvhJob *job = &builder->m_jobs[builder->m_jobCount++];
+    job->m_task = *task;
+    job->m_firstNode = 0;
+    job->m_lastNode = 0;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - MeshBvh_AddJob()\n");
+    assert(false);
+    return EXIT_FAILURE;
+}
+
+/// @brief Construit un sous-arbre.
+/// @param[in,out] builder la construction.
+/// @param[in] root la racine du sous-arbre (déjà allouée) et sa plage de triangles.
+/// @param[in,out] nodeCount le premier noeud libre.
+/// @param[in] jobTriangles si non nul, les noeuds d'au plus jobTriangles triangles
+/// ne sont pas découpés mais confiés aux threads (voir MeshBvh_AddJob()).
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+static int MeshBvh_BuildSubtree(
+    MeshBvhBuilder *builder, MeshBvhTask root, int *nodeCount, int jobTriangles)
+{
+    // Chaque découpe empile deux noeuds et en dépile un
+    MeshBvhTask stack[MESH_BVH_MAX_DEPTH + 1];
+    int stackSize = 0;
+
+    stack[stackSize++] = root;
+    while (stackSize > 0)
+    {
+        MeshBvhTask task = stack[--stackSize];
+
+        if (task.m_end - task.m_begin <= jobTriangles)
+        {
+            int exitStatus = MeshBvh_AddJob(builder, &task);
+            if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+            continue;
+        }
+
+        MeshBvhNode *node = &builder->m_nodes[task.m_node];
+        int middle = MeshBvh_Partition(builder, &task);
+        if (middle < 0)
+        {
+            node->m_offset = task.m_begin;
+            node->m_count = task.m_end - task.m_begin;
+            continue;
+        }
+
+        int child = *nodeCount;
+        *nodeCount += 2;
+        node->m_offset = child;
+        node->m_count = 0;
+
+        assert(task.m_depth + 1 < MESH_BVH_MAX_DEPTH);
+        MeshBvhTask right = { child + 1, middle, task.m_end, task.m_depth + 1 };
+        MeshBvhTask left = { child, task.m_begin, middle, task.m_depth + 1 };
+        stack[stackSize++] = right;
+        stack[stackSize++] = left;
+    }
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - MeshBvh_BuildSubtree()\n");
+    assert(false);
+    return EXIT_FAILURE;
+}
+
+/// @brief Range les noeuds utilisés dans un tableau sans trou, dans l'ordre d'un parcours
+/// en profondeur (les deux enfants d'un noeud restent consécutifs).
+static MeshBvhNode *MeshBvh_Compact(MeshBvhNode *nodes, int nodeCount)
+{
+    MeshBvhNode *compact = (MeshBvhNode *)calloc(nodeCount, sizeof(MeshBvhNode));
+    if (!compact) goto ERROR_LABEL;
+
+    // Paires (ancien indice, nouvel indice) restant à copier
+    int stack[2 * (MESH_BVH_MAX_DEPTH + 1)];
+    int stackSize = 0;
+    int count = 1;
+
+    compact[0] = nodes[0];
+    stack[stackSize++] = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        int newIndex = stack[--stackSize];
+        int oldIndex = stack[--stackSize];
+        MeshBvhNode *node = &nodes[oldIndex];
+        if (node->m_count > 0)
+            continue;
+
+        int child = node->m_offset;
+        int newChild = count;
+        count += 2;
+        assert(count <= nodeCount);
+
+        compact[newChild] = nodes[child];
+        compact[newChild + 1] = nodes[child + 1];
+        compact[newIndex].m_offset = newChild;
+
+        stack[stackSize++] = child + 1;
+        stack[stackSize++] = newChild + 1;
+        stack[stackSize++] = child;
+        stack[stackSize++] = newChild;
+    }
+    assert(count == nodeCount);
+
+    return compact;
+
+ERROR_LABEL:
+    printf("ERROR - MeshBvh_Compact()\n");
+    assert(false);
+    return NULL;
+}
+
+int MeshBvh_Build(Mesh *mesh)
+{
+    MeshBvhBuilder builder = { 0 };
+    int triangleCount = mesh->m_triangleCount;
+    int i;
+
+    assert(mesh->m_weldedVertices && mesh->m_indices && !mesh->m_bvhNodes);
+
+    if (triangleCount == 0)
+        return EXIT_SUCCESS;
+
+    builder.m_triangleMin = (Vec3 *)calloc(triangleCount, sizeof(Vec3));
+    builder.m_triangleMax = (Vec3 *)calloc(triangleCount, sizeof(Vec3));
+    builder.m_centroids = (Vec3 *)calloc(triangleCount, sizeof(Vec3));
+    builder.m_triangles = (int *)calloc(triangleCount, sizeof(int));
+    builder.m_nodes = (MeshBvhNode *)calloc(2 * triangleCount - 1, sizeof(MeshBvhNode));
+    if (!builder.m_triangleMin || !builder.m_triangleMax || !builder.m_centroids ||
+        !builder.m_triangles || !builder.m_nodes)
+        goto ERROR_LABEL;
+
+    // Boîtes des triangles
+    #pragma omp parallel for
+    for (i = 0; i < triangleCount; ++i)
+    {
+        const int *indices = &mesh->m_indices[3 * i];
+        Vec3 p0 = mesh->m_weldedVertices[indices[0]].m_position;
+        Vec3 p1 = mesh->m_weldedVertices[indices[1]].m_position;
+        Vec3 p2 = mesh->m_weldedVertices[indices[2]].m_position;
+
+        Vec3 min = p0;
+        Vec3 max = p0;
+        MeshBvh_Grow(&min, &max, p1, p1);
+        MeshBvh_Grow(&min, &max, p2, p2);
+        builder.m_triangleMin[i] = min;
+        builder.m_triangleMax[i] = max;
+        builder.m_centroids[i] = Vec3_Scale(Vec3_Add(min, max), 0.5f);
+        builder.m_triangles[i] = i;
+    }
+
+    // Premiers niveaux : découpe séquentielle jusqu'à obtenir assez de sous-arbres
+    int jobTriangles = Int_Max(triangleCount / MESH_BVH_JOB_COUNT, 256);
+    int nodeCount = 1;
+    MeshBvhTask root = { 0, 0, triangleCount, 0 };
+    int exitStatus = MeshBvh_BuildSubtree(&builder, root, &nodeCount, jobTriangles);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    // Réserve les noeuds de chaque sous-arbre
+    for (i = 0; i < builder.m_jobCount; ++i)
+    {
+        MeshBvhTask *task = &builder.m_jobs[i].m_task;
+        builder.m_jobs[i].m_firstNode = nodeCount;
+        nodeCount += 2 * (task->m_end - task->m_begin) - 2;
+    }
+    assert(nodeCount <= 2 * triangleCount - 1);
+
+    // Sous-arbres en parallèle : leurs plages de triangles et de noeuds sont disjointes
+    int jobCount = builder.m_jobCount;
+    #pragma omp parallel for schedule(dynamic)
+    for (i = 0; i < jobCount; ++i)
+    {
+        MeshBvhJob *job = &builder.m_jobs[i];
+        int jobNodeCount = job->m_firstNode;
+        MeshBvh_BuildSubtree(&builder, job->m_task, &jobNodeCount, 0);
+        job->m_lastNode = jobNodeCount;
+    }
+
+    // Nombre de noeuds réellement utilisés
+    int usedCount = nodeCount;
+    for (i = 0; i < jobCount; ++i)
+    {
+        MeshBvhJob *job = &builder.m_jobs[i];
+        usedCount -= 2 * (job->m_task.m_end - job->m_task.m_begin) - 2;
+        usedCount += job->m_lastNode - job->m_firstNode;
+    }
+
+    MeshBvhNode *nodes = MeshBvh_Compact(builder.m_nodes, usedCount);
+    if (!nodes) goto ERROR_LABEL;
+
+    mesh->m_bvhNodes = nodes;
+    mesh->m_bvhNodeCount = usedCount;
+    mesh->m_bvhTriangles = builder.m_triangles;
+
+    free(builder.m_triangleMin);
+    free(builder.m_triangleMax);
+    free(builder.m_centroids);
+    free(builder.m_nodes);
+    free(builder.m_jobs);
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - MeshBvh_Build()\n");
+    assert(false);
+    free(builder.m_triangleMin);
+    free(builder.m_triangleMax);
+    free(builder.m_centroids);
+    free(builder.m_triangles);
+    free(builder.m_nodes);
+    free(builder.m_jobs);
+    return EXIT_FAILURE;
+}
+
+/// @brief Calcule la distance d'entrée d'un rayon dans la boîte d'un noeud
+/// (méthode des tranches).
+/// @return true si le rayon coupe la boîte avant maxDistance.
+static bool MeshBvh_IntersectNode(
+    const MeshBvhNode *node, Vec3 origin, Vec3 invDirection,
+    float maxDistance, float *distance)
+{
+    float tMin = 0.0f;
+    float tMax = maxDistance;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        float t1 = (node->m_min.data[i] - origin.data[i]) * invDirection.data[i];
+        float t2 = (node->m_max.data[i] - origin.data[i]) * invDirection.data[i];
+        float tNear = (t1 < t2) ? t1 : t2;
+        float tFar = (t1 < t2) ? t2 : t1;
+
+        tMin = (tNear > tMin) ? tNear : tMin;
+        tMax = (tFar < tMax) ? tFar : tMax;
+    }
+
+    *distance = tMin;
+    return tMin <= tMax;
+}
+
+/// @brief Calcule l'intersection d'un rayon avec un triangle (Möller-Trumbore).
+/// @return true si le rayon touche le triangle à une distance dans ]0, maxDistance[.
+static bool MeshBvh_IntersectTriangle(
+    const Mesh *mesh, int triangle, Vec3 origin, Vec3 direction,
+    float maxDistance, MeshRayHit *hit)
+{
+    const int *indices = &mesh->m_indices[3 * triangle];
+    Vec3 v0 = Mesh_GetWeldedPosition(mesh, indices[0]);
+    Vec3 v1 = Mesh_GetWeldedPosition(mesh, indices[1]);
+    Vec3 v2 = Mesh_GetWeldedPosition(mesh, indices[2]);
+    const float *p0 = v0.data;
+    const float *p1 = v1.data;
+    const float *p2 = v2.data;
+    const float *d = direction.data;
+
+    float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+    float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+
+    float p[3] = {
+        d[1] * e2[2] - d[2] * e2[1],
+        d[2] * e2[0] - d[0] * e2[2],
+        d[0] * e2[1] - d[1] * e2[0]
+    };
+    float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+    if (det == 0.0f)
+        return false;
+
+    float invDet = 1.0f / det;
+    float s[3] = { origin.x - p0[0], origin.y - p0[1], origin.z - p0[2] };
+    float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * invDet;
+    if (u < 0.0f || u > 1.0f)
+        return false;
+
+    float q[3] = {
+        s[1] * e1[2] - s[2] * e1[1],
+        s[2] * e1[0] - s[0] * e1[2],
+        s[0] * e1[1] - s[1] * e1[0]
+    };
+    float v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * invDet;
+    if (v < 0.0f || u + v > 1.0f)
+        return false;
+
+    float t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * invDet;
+    if (t <= 0.0f || t >= maxDistance)
+        return false;
+
+    hit->m_distance = t;
+    hit->m_triangle = triangle;
+    hit->m_u = u;
+    hit->m_v = v;
+    return true;
+}
+
+/// @brief Parcourt la BVH d'un mesh le long d'un rayon, l'enfant le plus proche en premier.
+/// @param anyHit indique si le parcours s'arrête à la première intersection trouvée.
+static bool MeshBvh_Traverse(
+    Mesh *mesh, Vec3 origin, Vec3 direction, float maxDistance,
+    bool anyHit, MeshRayHit *hit)
+{
+    MeshBvhNode *nodes = mesh->m_bvhNodes;
+    if (!nodes)
+        return false;
+
+    // Les composantes nulles sont remplacées par une valeur très petite :
+    // un inverse infini donnerait des NaN dans MeshBvh_IntersectNode()
+    Vec3 invDirection;
+    for (int i = 0; i < 3; ++i)
+    {
+        float d = direction.data[i];
+        if (fabsf(d) < MESH_BVH_MIN_DIRECTION)
+            d = copysignf(MESH_BVH_MIN_DIRECTION, d);
+        invDirection.data[i] = 1.0f / d;
+    }
+
+    float distance;
+    if (!MeshBvh_IntersectNode(&nodes[0], origin, invDirection, maxDistance, &distance))
+        return false;
+
+    // Enfants éloignés restant à parcourir et leur distance d'entrée
+    int stackNodes[MESH_BVH_MAX_DEPTH];
+    float stackDistances[MESH_BVH_MAX_DEPTH];
+    int stackSize = 0;
+    bool found = false;
+    int index = 0;
+
+    for (;;)
+    {
+        MeshBvhNode *node = &nodes[index];
+
+        if (node->m_count > 0)
+        {
+            for (int i = 0; i < node->m_count; ++i)
+            {
+                int triangle = mesh->m_bvhTriangles[node->m_offset + i];
+                if (MeshBvh_IntersectTriangle(mesh, triangle, origin, direction, maxDistance, hit))
+                {
+                    if (anyHit)
+                        return true;
+
+                    // Les boîtes plus éloignées que l'intersection ne sont plus parcourues
+                    found = true;
+                    maxDistance = hit->m_distance;
+                }
+            }
+        }
+        else
+        {
+            int child = node->m_offset;
+            float distance1, distance2;
+            bool hit1 = MeshBvh_IntersectNode(
+                &nodes[child], origin, invDirection, maxDistance, &distance1);
+            bool hit2 = MeshBvh_IntersectNode(
+                &nodes[child + 1], origin, invDirection, maxDistance, &distance2);
+
+            if (hit1 && hit2)
+            {
+                bool firstIsNear = (distance1 <= distance2);
+                assert(stackSize < MESH_BVH_MAX_DEPTH);
+                stackNodes[stackSize] = firstIsNear ? child + 1 : child;
+                stackDistances[stackSize] = firstIsNear ? distance2 : distance1;
+                stackSize++;
+
+                index = firstIsNear ? child : child + 1;
+                continue;
+            }
+            if (hit1 || hit2)
+            {
+                index = hit1 ? child : child + 1;
+                continue;
+            }
+        }
+
+        // Noeud suivant, en ignorant ceux qui commencent après l'intersection trouvée
+        do
+        {
+            if (stackSize == 0)
+                return found;
+            stackSize--;
+        } while (stackDistances[stackSize] > maxDistance);
+
+        index = stackNodes[stackSize];
+    }
+}
+
+bool MeshBvh_RayCast(
+    Mesh *mesh, Vec3 origin, Vec3 direction, float maxDistance, MeshRayHit *hit)
+{
+    return MeshBvh_Traverse(mesh, origin, direction, maxDistance, false, hit);
+}
+
+bool MeshBvh_IsOccluded(Mesh *mesh, Vec3 origin, Vec3 direction, float maxDistance)
+{
+    MeshRayHit hit;
+    return MeshBvh_Traverse(mesh, origin, direction, maxDistance, true, &hit);
+}
@@ -0,0 +1,75 @@
+﻿#ifndef _MESH_BVH_H_
+#define _MESH_BVH_H_
+
+/// @file MeshBvh.h
+/// @defgroup MeshBvh
+/// @{
+
+#include "Settings.h"
+#include "Mesh.h"
+
+/// @brief Nombre d'intervalles utilisés sur chaque axe pour évaluer les découpes d'un noeud.
+#define MESH_BVH_BIN_COUNT 16
+
+/// @brief Coût du parcours d'un noeud interne, relativement au test d'un triangle.
+#define MESH_BVH_TRAVERSAL_COST 1.0f
+
+/// @brief Profondeur à partir de laquelle les noeuds sont coupés en deux moitiés égales
+/// plutôt que selon leur coût, pour ne jamais dépasser MESH_BVH_MAX_DEPTH.
+#define MESH_BVH_MEDIAN_DEPTH 32
+
+/// @brief Nombre de sous-arbres construits en parallèle visé pour un mesh.
+#define MESH_BVH_JOB_COUNT 64
+
+/// @brief Valeur absolue minimale des composantes de la direction d'un rayon lors du parcours.
+#define MESH_BVH_MIN_DIRECTION 1e-20f
+
+/// @brief Intersection d'un rayon avec un triangle d'un mesh.
+typedef struct MeshRayHit_s
+{
+    /// @brief Distance de l'intersection, en multiples de la direction du rayon.
+    float m_distance;
+
+    /// @brief Indice du triangle dans Mesh::m_triangles.
+    int   m_triangle;
+
+    /// @brief Coordonnées barycentriques de l'intersection relativement
+    /// au deuxième et au troisième sommet du triangle.
+    float m_u, m_v;
+} MeshRayHit;
+
+/// @brief Construit la hiérarchie de boîtes englobantes des triangles du mesh
+/// (m_bvhNodes et m_bvhTriangles).
+/// Chaque noeud est coupé selon l'heuristique de surface (SAH), évaluée sur
+/// MESH_BVH_BIN_COUNT intervalles par axe, jusqu'à ce qu'une feuille de
+/// MESH_BVH_MAX_LEAF_TRIANGLES triangles au plus soit moins coûteuse qu'une découpe.
+/// Les premiers niveaux sont construits séquentiellement,
+/// puis les sous-arbres restants en parallèle.
+/// Les sommets soudés doivent avoir été calculés (voir Mesh_Weld()).
+/// @param[in,out] mesh le mesh.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int MeshBvh_Build(Mesh *mesh);
+
+/// @brief Recherche l'intersection la plus proche d'un rayon avec les triangles d'un mesh.
+/// Les triangles sont touchés quelle que soit leur orientation.
+/// @param[in] mesh le mesh.
+/// @param[in] origin l'origine du rayon dans le repère de l'objet.
+/// @param[in] direction la direction du rayon (pas nécessairement normalisée).
+/// @param[in] maxDistance la distance maximale, en multiples de direction.
+/// @param[out] hit l'intersection la plus proche.
+/// @return true si le rayon touche un triangle avant maxDistance.
+bool MeshBvh_RayCast(
+    Mesh *mesh, Vec3 origin, Vec3 direction, float maxDistance, MeshRayHit *hit);
+
+/// @brief Indique si un rayon touche un triangle d'un mesh.
+/// Le parcours s'arrête à la première intersection trouvée (test d'occlusion).
+/// @param[in] mesh le mesh.
+/// @param[in] origin l'origine du rayon dans le repère de l'objet.
+/// @param[in] direction la direction du rayon (pas nécessairement normalisée).
+/// @param[in] maxDistance la distance maximale, en multiples de direction.
+/// @return true si le rayon touche un triangle avant maxDistance.
+bool MeshBvh_IsOccluded(Mesh *mesh, Vec3 origin, Vec3 direction, float maxDistance);
+
+/// @}
+
+#endif
@@ -0,0 +1,519 @@
+﻿#include "MeshCache.h"
+#include "FileMap.h"
+#include "MeshOcclusion.h"
+#include "Meshlet.h"
+#include "Tools.h"
+
+#include <limits.h>
+
+/// @brief Taille maximale d'un chemin de fichier.
+#define MESH_CACHE_PATH_SIZE 1024
+
+/// @brief Taille d'un élément de chaque section.
+static const Uint32 g_meshCacheElementSizes[MESH_CACHE_SECTION_COUNT] = {
+    sizeof(Vec3),
+    sizeof(Vec3),
+    sizeof(Vec2),
+    sizeof(Vec3),
+    sizeof(Triangle),
+    sizeof(MeshVertex),
+    sizeof(int),
+    MATERIAL_NAME_SIZE,
+    sizeof(MeshCacheLod),
+    sizeof(int),
+    sizeof(int),
+    sizeof(int),
+    sizeof(Meshlet),
+    sizeof(int),
+    sizeof(int),
+    sizeof(Uint8),
+    sizeof(MeshBvhNode),
+    sizeof(int),
+    sizeof(float)
+};
+
+/// @brief Construit les chemins du fichier obj et du fichier du cache associé.
+static void MeshCache_GetPaths(
+    char *folderPath, char *fileName, char *objPath, char *cachePath)
+{
+    snprintf(objPath, MESH_CACHE_PATH_SIZE, "%s/%s", folderPath, fileName);
+
+    // Remplace l'extension du fichier obj
+    size_t length = strlen(fileName);
+    char *extension = strrchr(fileName, '.');
+    if (extension) length = (size_t)(extension - fileName);
+
+    snprintf(
+        cachePath, MESH_CACHE_PATH_SIZE, "%s/%.*s%s",
+        folderPath, (int)length, fileName, MESH_CACHE_EXTENSION);
+}
+
+/// @brief Vérifie la cohérence d'un en-tête lu dans le cache.
+/// Le contenu des sections (indices...) n'est pas vérifié : il a été validé
+/// lors du chargement du fichier obj et le fichier du cache est écrit de façon atomique.
+static bool MeshCache_IsValid(MeshCacheHeader *header, Uint64 fileSize)
+{
+    if (header->m_magic != MESH_CACHE_MAGIC) return false;
+    if (header->m_version != MESH_CACHE_VERSION) return false;
+    if (header->m_headerSize != sizeof(MeshCacheHeader)) return false;
+    if (header->m_sectionCount != MESH_CACHE_SECTION_COUNT) return false;
+    if (memchr(header->m_materialLib, '\0', MESH_NAME_SIZE) == NULL) return false;
+
+    for (int i = 0; i < MESH_CACHE_SECTION_COUNT; ++i)
+    {
+        MeshCacheSection *section = &header->m_sections[i];
+
+        if (section->m_elementSize != g_meshCacheElementSizes[i]) return false;
+        if (section->m_count > INT_MAX) return false;
+        if (section->m_size != (Uint64)section->m_count * section->m_elementSize) return false;
+        if (section->m_offset % MESH_CACHE_ALIGNMENT != 0) return false;
+        if (section->m_offset < sizeof(MeshCacheHeader)) return false;
+        if (section->m_offset + section->m_size > fileSize) return false;
+    }
+
+    MeshCacheSection *sections = header->m_sections;
+    Uint32 triangleCount = sections[MESH_CACHE_TRIANGLES].m_count;
+    if (sections[MESH_CACHE_TANGENTS].m_count != sections[MESH_CACHE_VERTICES].m_count) return false;
+    if (sections[MESH_CACHE_INDICES].m_count != 3 * triangleCount) return false;
+    if (triangleCount > 0 && sections[MESH_CACHE_WELDED_VERTICES].m_count == 0) return false;
+    if (sections[MESH_CACHE_LODS].m_count > MESH_MAX_LODS) return false;
+
+    Uint32 occlusionCount = (header->m_occlusionRayCount > 0) ? sections[MESH_CACHE_WELDED_VERTICES].m_count : 0;
+    if (sections[MESH_CACHE_OCCLUSION].m_count != occlusionCount) return false;
+
+    return true;
+}
+
+/// @brief Vérifie que les tailles des niveaux de détail correspondent à leurs sections.
+static bool MeshCache_AreLodsValid(FileMap *map, MeshCacheHeader *header)
+{
+    MeshCacheSection *sections = header->m_sections;
+    MeshCacheLod *lods = (MeshCacheLod *)((Uint8 *)FileMap_GetData(map) + sections[MESH_CACHE_LODS].m_offset);
+    Uint64 vertexCount = 0;
+    Uint64 triangleCount = 0;
+
+    for (Uint32 i = 0; i < sections[MESH_CACHE_LODS].m_count; ++i)
+    {
+        vertexCount += lods[i].m_vertexCount;
+        triangleCount += lods[i].m_triangleCount;
+    }
+
+    return
+        vertexCount == sections[MESH_CACHE_LOD_VERTICES].m_count &&
+        3 * triangleCount == sections[MESH_CACHE_LOD_INDICES].m_count &&
+        triangleCount == sections[MESH_CACHE_LOD_MATERIALS].m_count;
+}
+
+/// @brief Vérifie que les meshlets ne débordent pas de leurs sections.
+static bool MeshCache_AreMeshletsValid(FileMap *map, MeshCacheHeader *header)
+{
+    MeshCacheSection *sections = header->m_sections;
+    Meshlet *meshlets = (Meshlet *)((Uint8 *)FileMap_GetData(map) + sections[MESH_CACHE_MESHLETS].m_offset);
+    Uint32 vertexCount = sections[MESH_CACHE_MESHLET_VERTICES].m_count;
+    Uint32 triangleCount = sections[MESH_CACHE_MESHLET_TRIANGLES].m_count;
+
+    if (triangleCount != sections[MESH_CACHE_TRIANGLES].m_count) return false;
+    if (sections[MESH_CACHE_MESHLET_INDICES].m_count != 3 * triangleCount) return false;
+
+    for (Uint32 i = 0; i < sections[MESH_CACHE_MESHLETS].m_count; ++i)
+    {
+        Meshlet *meshlet = &meshlets[i];
+        if (meshlet->m_vertexOffset < 0 || meshlet->m_triangleOffset < 0) return false;
+        if (meshlet->m_vertexCount < 0 || meshlet->m_vertexCount > MESH_MESHLET_MAX_VERTICES) return false;
+        if (meshlet->m_triangleCount < 0 || meshlet->m_triangleCount > MESH_MESHLET_MAX_TRIANGLES) return false;
+        if ((Uint64)meshlet->m_vertexOffset + meshlet->m_vertexCount > vertexCount) return false;
+        if ((Uint64)meshlet->m_triangleOffset + meshlet->m_triangleCount > triangleCount) return false;
+    }
+
+    return true;
+}
+
+/// @brief Vérifie que la BVH des triangles ne contient que des indices valides.
+static bool MeshCache_IsBvhValid(FileMap *map, MeshCacheHeader *header)
+{
+    MeshCacheSection *sections = header->m_sections;
+    MeshBvhNode *nodes = (MeshBvhNode *)((Uint8 *)FileMap_GetData(map) + sections[MESH_CACHE_BVH_NODES].m_offset);
+    int *triangles = (int *)((Uint8 *)FileMap_GetData(map) + sections[MESH_CACHE_BVH_TRIANGLES].m_offset);
+    Uint32 nodeCount = sections[MESH_CACHE_BVH_NODES].m_count;
+    Uint32 triangleCount = sections[MESH_CACHE_TRIANGLES].m_count;
+
+    if (sections[MESH_CACHE_BVH_TRIANGLES].m_count != triangleCount) return false;
+    if ((nodeCount == 0) != (triangleCount == 0)) return false;
+
+    for (Uint32 i = 0; i < triangleCount; ++i)
+    {
+        if (triangles[i] < 0 || (Uint32)triangles[i] >= triangleCount) return false;
+    }
+
+    for (Uint32 i = 0; i < nodeCount; ++i)
+    {
+        MeshBvhNode *node = &nodes[i];
+        if (node->m_offset < 0 || node->m_count < 0) return false;
+        if (node->m_count > 0)
+        {
+            if ((Uint64)node->m_offset + node->m_count > triangleCount) return false;
+        }
+        else
+        {
+            // Les enfants suivent leur parent : le parcours ne peut pas boucler
+            if ((Uint32)node->m_offset <= i || (Uint64)node->m_offset + 1 >= nodeCount) return false;
+        }
+    }
+
+    return true;
+}
+
+/// @brief Renvoie l'adresse du contenu d'une section (NULL si elle est vide).
+static void *MeshCache_GetSection(FileMap *map, MeshCacheHeader *header, int type)
+{
+    MeshCacheSection *section = &header->m_sections[type];
+    if (section->m_count == 0) return NULL;
+
+    return (Uint8 *)FileMap_GetData(map) + section->m_offset;
+}
+
+Mesh *MeshCache_Load(char *folderPath, char *fileName)
+{
+    char objPath[MESH_CACHE_PATH_SIZE] = { 0 };
+    char cachePath[MESH_CACHE_PATH_SIZE] = { 0 };
+    FileInfo sourceInfo = { 0 };
+    FileMap *map = NULL;
+    Mesh *mesh = NULL;
+
+    MeshCache_GetPaths(folderPath, fileName, objPath, cachePath);
+
+    int exitStatus = FileMap_GetInfo(objPath, &sourceInfo);
+    if (exitStatus != EXIT_SUCCESS) return NULL;
+
+    // Copie sur écriture : le mesh peut être modifié (Mesh_ReverseNormals()...)
+    // sans modifier le fichier
+    map = FileMap_Open(cachePath, FILEMAP_ACCESS_PRIVATE);
+    if (!map) return NULL;
+
+    Uint64 fileSize = FileMap_GetSize(map);
+    MeshCacheHeader *header = (MeshCacheHeader *)FileMap_GetData(map);
+    if (fileSize < sizeof(MeshCacheHeader) ||
+        !MeshCache_IsValid(header, fileSize) ||
+        !MeshCache_AreLodsValid(map, header) ||
+        !MeshCache_AreMeshletsValid(map, header) ||
+        !MeshCache_IsBvhValid(map, header) ||
+        header->m_occlusionRayCount != (Uint32)MeshOcclusion_GetRayCount() ||
+        header->m_sourceSize != sourceInfo.m_size)
+    {
+        FileMap_Close(map);
+        return NULL;
+    }
+
+    if (header->m_sourceTime != sourceInfo.m_modifiedTime)
+    {
+        // Fichier obj modifié, copié ou extrait de nouveau : compare son contenu
+        Uint64 sourceHash = 0;
+        exitStatus = FileMap_HashFile(objPath, &sourceHash);
+        if (exitStatus != EXIT_SUCCESS || sourceHash != header->m_sourceHash)
+        {
+            FileMap_Close(map);
+            return NULL;
+        }
+    }
+
+    mesh = (Mesh *)calloc(1, sizeof(Mesh));
+    if (!mesh) goto ERROR_LABEL;
+
+    MeshCacheSection *sections = header->m_sections;
+
+    mesh->m_fileMap = map;
+    map = NULL;
+
+    mesh->m_vertexCount = (int)sections[MESH_CACHE_VERTICES].m_count;
+    mesh->m_normalCount = (int)sections[MESH_CACHE_NORMALS].m_count;
+    mesh->m_textUVCount = (int)sections[MESH_CACHE_TEXT_UVS].m_count;
+    mesh->m_tangentCount = (int)sections[MESH_CACHE_TANGENTS].m_count;
+    mesh->m_triangleCount = (int)sections[MESH_CACHE_TRIANGLES].m_count;
+    mesh->m_weldedCount = (int)sections[MESH_CACHE_WELDED_VERTICES].m_count;
+
+    mesh->m_vertices = (Vec3 *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_VERTICES);
+    mesh->m_normals = (Vec3 *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_NORMALS);
+    mesh->m_textUVs = (Vec2 *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_TEXT_UVS);
+    mesh->m_tangents = (Vec3 *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_TANGENTS);
+    mesh->m_triangles = (Triangle *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_TRIANGLES);
+    mesh->m_weldedVertices = (MeshVertex *)MeshCache_GetSection(
+        mesh->m_fileMap, header, MESH_CACHE_WELDED_VERTICES);
+    mesh->m_indices = (int *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_INDICES);
+
+    // Niveaux de détail : seul le tableau qui les décrit est alloué
+    int lodCount = (int)sections[MESH_CACHE_LODS].m_count;
+    if (lodCount > 0)
+    {
+        mesh->m_lods = (MeshLod *)calloc(lodCount, sizeof(MeshLod));
+        if (!mesh->m_lods) goto ERROR_LABEL;
+        mesh->m_lodCount = lodCount;
+
+        MeshCacheLod *cacheLods = (MeshCacheLod *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_LODS);
+        int *lodVertices = (int *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_LOD_VERTICES);
+        int *lodIndices = (int *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_LOD_INDICES);
+        int *lodMaterials = (int *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_LOD_MATERIALS);
+
+        for (int i = 0; i < lodCount; ++i)
+        {
+            MeshLod *lod = &mesh->m_lods[i];
+            lod->m_vertexCount = (int)cacheLods[i].m_vertexCount;
+            lod->m_triangleCount = (int)cacheLods[i].m_triangleCount;
+            lod->m_error = cacheLods[i].m_error;
+            lod->m_vertices = lodVertices;
+            lod->m_indices = lodIndices;
+            lod->m_materialIndices = lodMaterials;
+
+            lodVertices += lod->m_vertexCount;
+            lodIndices += 3 * lod->m_triangleCount;
+            lodMaterials += lod->m_triangleCount;
+        }
+    }
+
+    mesh->m_meshletCount = (int)sections[MESH_CACHE_MESHLETS].m_count;
+    mesh->m_meshletVertexCount = (int)sections[MESH_CACHE_MESHLET_VERTICES].m_count;
+    mesh->m_meshlets = (Meshlet *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_MESHLETS);
+    mesh->m_meshletVertices = (int *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_MESHLET_VERTICES);
+    mesh->m_meshletTriangles = (int *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_MESHLET_TRIANGLES);
+    mesh->m_meshletIndices = (Uint8 *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_MESHLET_INDICES);
+
+    mesh->m_bvhNodeCount = (int)sections[MESH_CACHE_BVH_NODES].m_count;
+    mesh->m_bvhNodes = (MeshBvhNode *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_BVH_NODES);
+    mesh->m_bvhTriangles = (int *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_BVH_TRIANGLES);
+
+    mesh->m_occlusion = (float *)MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_OCCLUSION);
+    mesh->m_occlusionRayCount = (int)header->m_occlusionRayCount;
+
+    mesh->m_min = header->m_min;
+    mesh->m_max = header->m_max;
+    mesh->m_center = header->m_center;
+    strcpy_s(mesh->m_materialLib, MESH_NAME_SIZE, header->m_materialLib);
+
+    // Recharge les matériaux (les textures ont leur propre cache)
+    if (mesh->m_materialLib[0] != '\0')
+    {
+        int materialCount = 0;
+        Material *materials = Material_LoadMTL(mesh, folderPath, mesh->m_materialLib, &materialCount);
+        if (!materials) goto ERROR_LABEL;
+
+        mesh->m_materials = materials;
+        mesh->m_materialCount = materialCount;
+    }
+
+    // Les indices des matériaux des triangles sont ceux du fichier mtl au moment
+    // de l'écriture du cache
+    char (*materialNames)[MATERIAL_NAME_SIZE] = (char (*)[MATERIAL_NAME_SIZE])
+        MeshCache_GetSection(mesh->m_fileMap, header, MESH_CACHE_MATERIALS);
+    bool sameMaterials = (sections[MESH_CACHE_MATERIALS].m_count == (Uint32)mesh->m_materialCount);
+    for (int i = 0; sameMaterials && i < mesh->m_materialCount; ++i)
+    {
+        sameMaterials = (strncmp(materialNames[i], mesh->m_materials[i].m_name, MATERIAL_NAME_SIZE) == 0);
+    }
+    if (!sameMaterials)
+    {
+        Mesh_Free(mesh);
+        return NULL;
+    }
+
+    // Les sous-meshes ne sont pas stockés : ils se déduisent de l'ordre des triangles
+    if (Mesh_BuildSubmeshes(mesh) != EXIT_SUCCESS)
+    {
+        Mesh_Free(mesh);
+        return NULL;
+    }
+
+    // Ordres des meshlets selon la direction de vue, rapides à recalculer
+    if (Meshlet_BuildOrders(mesh) != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    return mesh;
+
+ERROR_LABEL:
+    printf("ERROR - MeshCache_Load()\n");
+    assert(false);
+    FileMap_Close(map);
+    Mesh_Free(mesh);
+    return NULL;
+}
+
+/// @brief Écrit une section et complète le fichier jusqu'à l'alignement suivant.
+static bool MeshCache_WriteSection(FILE *file, const void *data, Uint64 size)
+{
+    Uint8 padding[MESH_CACHE_ALIGNMENT] = { 0 };
+    size_t paddingSize = (size_t)((MESH_CACHE_ALIGNMENT - size % MESH_CACHE_ALIGNMENT) % MESH_CACHE_ALIGNMENT);
+
+    if (size > 0 && fwrite(data, 1, (size_t)size, file) != size) return false;
+    return fwrite(padding, 1, paddingSize, file) == paddingSize;
+}
+
+int MeshCache_Store(Mesh *mesh, char *folderPath, char *fileName)
+{
+    char objPath[MESH_CACHE_PATH_SIZE] = { 0 };
+    char cachePath[MESH_CACHE_PATH_SIZE] = { 0 };
+    char tmpPath[MESH_CACHE_PATH_SIZE] = { 0 };
+    FileInfo sourceInfo = { 0 };
+    char (*materialNames)[MATERIAL_NAME_SIZE] = NULL;
+    MeshCacheLod *cacheLods = NULL;
+    int *lodVertices = NULL;
+    int *lodIndices = NULL;
+    int *lodMaterials = NULL;
+    FILE *file = NULL;
+
+    assert(mesh->m_weldedVertices && mesh->m_tangents);
+
+    MeshCache_GetPaths(folderPath, fileName, objPath, cachePath);
+    FileMap_GetTempPath(cachePath, tmpPath, MESH_CACHE_PATH_SIZE);
+
+    int exitStatus = FileMap_GetInfo(objPath, &sourceInfo);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    MeshCacheHeader header = { 0 };
+    header.m_magic = MESH_CACHE_MAGIC;
+    header.m_version = MESH_CACHE_VERSION;
+    header.m_headerSize = sizeof(MeshCacheHeader);
+    header.m_sectionCount = MESH_CACHE_SECTION_COUNT;
+    header.m_min = mesh->m_min;
+    header.m_max = mesh->m_max;
+    header.m_center = mesh->m_center;
+    strcpy_s(header.m_materialLib, MESH_NAME_SIZE, mesh->m_materialLib);
+    header.m_sourceSize = sourceInfo.m_size;
+    header.m_sourceTime = sourceInfo.m_modifiedTime;
+    header.m_occlusionRayCount = mesh->m_occlusion ? (Uint32)mesh->m_occlusionRayCount : 0;
+
+    exitStatus = FileMap_HashFile(objPath, &header.m_sourceHash);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    materialNames = (char (*)[MATERIAL_NAME_SIZE])calloc(
+        Int_Max(mesh->m_materialCount, 1), MATERIAL_NAME_SIZE);
+    if (!materialNames) goto ERROR_LABEL;
+
+    for (int i = 0; i < mesh->m_materialCount; ++i)
+    {
+        strcpy_s(materialNames[i], MATERIAL_NAME_SIZE, mesh->m_materials[i].m_name);
+    }
+
+    // Met bout à bout les tableaux des niveaux de détail
+    int lodVertexCount = 0;
+    int lodTriangleCount = 0;
+    for (int i = 0; i < mesh->m_lodCount; ++i)
+    {
+        lodVertexCount += mesh->m_lods[i].m_vertexCount;
+        lodTriangleCount += mesh->m_lods[i].m_triangleCount;
+    }
+
+    cacheLods = (MeshCacheLod *)calloc(Int_Max(mesh->m_lodCount, 1), sizeof(MeshCacheLod));
+    lodVertices = (int *)calloc(Int_Max(lodVertexCount, 1), sizeof(int));
+    lodIndices = (int *)calloc(Int_Max(3 * lodTriangleCount, 1), sizeof(int));
+    lodMaterials = (int *)calloc(Int_Max(lodTriangleCount, 1), sizeof(int));
+    if (!cacheLods || !lodVertices || !lodIndices || !lodMaterials) goto ERROR_LABEL;
+
+    int vertexOffset = 0;
+    int triangleOffset = 0;
+    for (int i = 0; i < mesh->m_lodCount; ++i)
+    {
+        MeshLod *lod = &mesh->m_lods[i];
+        cacheLods[i].m_vertexCount = (Uint32)lod->m_vertexCount;
+        cacheLods[i].m_triangleCount = (Uint32)lod->m_triangleCount;
+        cacheLods[i].m_error = lod->m_error;
+
+        memcpy(lodVertices + vertexOffset, lod->m_vertices, lod->m_vertexCount * sizeof(int));
+        memcpy(lodIndices + 3 * triangleOffset, lod->m_indices, 3 * lod->m_triangleCount * sizeof(int));
+        memcpy(lodMaterials + triangleOffset, lod->m_materialIndices, lod->m_triangleCount * sizeof(int));
+
+        vertexOffset += lod->m_vertexCount;
+        triangleOffset += lod->m_triangleCount;
+    }
+
+    const void *sectionData[MESH_CACHE_SECTION_COUNT] = {
+        mesh->m_vertices,
+        mesh->m_normals,
+        mesh->m_textUVs,
+        mesh->m_tangents,
+        mesh->m_triangles,
+        mesh->m_weldedVertices,
+        mesh->m_indices,
+        materialNames,
+        cacheLods,
+        lodVertices,
+        lodIndices,
+        lodMaterials,
+        mesh->m_meshlets,
+        mesh->m_meshletVertices,
+        mesh->m_meshletTriangles,
+        mesh->m_meshletIndices,
+        mesh->m_bvhNodes,
+        mesh->m_bvhTriangles,
+        mesh->m_occlusion
+    };
+    int sectionCounts[MESH_CACHE_SECTION_COUNT] = {
+        mesh->m_vertexCount,
+        mesh->m_normalCount,
+        mesh->m_textUVCount,
+        mesh->m_tangentCount,
+        mesh->m_triangleCount,
+        mesh->m_weldedCount,
+        3 * mesh->m_triangleCount,
+        mesh->m_materialCount,
+        mesh->m_lodCount,
+        lodVertexCount,
+        3 * lodTriangleCount,
+        lodTriangleCount,
+        mesh->m_meshletCount,
+        mesh->m_meshletVertexCount,
+        mesh->m_meshletTriangles ? mesh->m_triangleCount : 0,
+        mesh->m_meshletIndices ? 3 * mesh->m_triangleCount : 0,
+        mesh->m_bvhNodeCount,
+        mesh->m_bvhTriangles ? mesh->m_triangleCount : 0,
+        mesh->m_occlusion ? mesh->m_weldedCount : 0
+    };
+
+    // Table des sections
+    Uint64 offset =
+        (sizeof(MeshCacheHeader) + MESH_CACHE_ALIGNMENT - 1) & ~(Uint64)(MESH_CACHE_ALIGNMENT - 1);
+    for (int i = 0; i < MESH_CACHE_SECTION_COUNT; ++i)
+    {
+        MeshCacheSection *section = &header.m_sections[i];
+        section->m_offset = offset;
+        section->m_count = (Uint32)sectionCounts[i];
+        section->m_elementSize = g_meshCacheElementSizes[i];
+        section->m_size = (Uint64)section->m_count * section->m_elementSize;
+
+        offset += (section->m_size + MESH_CACHE_ALIGNMENT - 1) & ~(Uint64)(MESH_CACHE_ALIGNMENT - 1);
+    }
+
+    // Écrit dans un fichier temporaire propre à cet appel puis le renomme pour ne jamais
+    // laisser un fichier incomplet dans le cache, même si plusieurs chargements
+    // du même mesh écrivent en même temps
+    fopen_s(&file, tmpPath, "wb");
+    if (!file) goto ERROR_LABEL;
+
+    bool success = MeshCache_WriteSection(file, &header, sizeof(MeshCacheHeader));
+    for (int i = 0; success && i < MESH_CACHE_SECTION_COUNT; ++i)
+    {
+        success = MeshCache_WriteSection(file, sectionData[i], header.m_sections[i].m_size);
+    }
+    success = (fclose(file) == 0) && success;
+    file = NULL;
+
+    if (!success) goto ERROR_LABEL;
+
+    exitStatus = FileMap_Replace(tmpPath, cachePath);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    free(materialNames);
+    free(cacheLods);
+    free(lodVertices);
+    free(lodIndices);
+    free(lodMaterials);
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - MeshCache_Store() %s\n", cachePath);
+    if (file) fclose(file);
+    if (tmpPath[0] != '\0') remove(tmpPath);
+    free(materialNames);
+    free(cacheLods);
+    free(lodVertices);
+    free(lodIndices);
+    free(lodMaterials);
+    return EXIT_FAILURE;
+}
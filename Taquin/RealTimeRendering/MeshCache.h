@@ -0,0 +1,161 @@
+﻿#ifndef _MESH_CACHE_H_
+#define _MESH_CACHE_H_
+
+/// @file MeshCache.h
+/// @defgroup MeshCache
+/// @{
+
+#include "Settings.h"
+#include "Vector.h"
+#include "Mesh.h"
+#include "Material.h"
+
+/// @brief Extension des fichiers du cache, écrits à côté des fichiers obj.
+#define MESH_CACHE_EXTENSION ".rtmesh"
+
+/// @brief Identifiant des fichiers du cache ("RTMS").
+#define MESH_CACHE_MAGIC 0x534D5452
+
+/// @brief Version du format des fichiers du cache.
+/// Elle doit être incrémentée à chaque modification de MeshCacheHeader, des structures
+/// stockées (Triangle, MeshVertex...) ou des calculs effectués au chargement d'un obj.
+#define MESH_CACHE_VERSION 7
+
+/// @brief Alignement (en octets) du début de chaque section d'un fichier du cache.
+#define MESH_CACHE_ALIGNMENT 64
+
+/// @brief Sections d'un fichier du cache.
+typedef enum MeshCacheSectionType_e
+{
+    /// @brief Positions (Vec3).
+    MESH_CACHE_VERTICES,
+
+    /// @brief Normales (Vec3).
+    MESH_CACHE_NORMALS,
+
+    /// @brief Coordonnées uv (Vec2).
+    MESH_CACHE_TEXT_UVS,
+
+    /// @brief Tangentes, une par position (Vec3).
+    MESH_CACHE_TANGENTS,
+
+    /// @brief Triangles (Triangle).
+    MESH_CACHE_TRIANGLES,
+
+    /// @brief Sommets soudés (MeshVertex).
+    MESH_CACHE_WELDED_VERTICES,
+
+    /// @brief Indices des sommets soudés, trois par triangle (int).
+    MESH_CACHE_INDICES,
+
+    /// @brief Noms des matériaux, dans l'ordre du fichier mtl (char[MATERIAL_NAME_SIZE]).
+    MESH_CACHE_MATERIALS,
+
+    /// @brief Description des niveaux de détail simplifiés (MeshCacheLod).
+    MESH_CACHE_LODS,
+
+    /// @brief Sommets soudés utilisés par les niveaux de détail, mis bout à bout (int).
+    MESH_CACHE_LOD_VERTICES,
+
+    /// @brief Indices des triangles des niveaux de détail, mis bout à bout (int).
+    MESH_CACHE_LOD_INDICES,
+
+    /// @brief Matériaux des triangles des niveaux de détail, mis bout à bout (int).
+    MESH_CACHE_LOD_MATERIALS,
+
+    /// @brief Meshlets du mesh complet (Meshlet).
+    MESH_CACHE_MESHLETS,
+
+    /// @brief Sommets soudés des meshlets, mis bout à bout (int).
+    MESH_CACHE_MESHLET_VERTICES,
+
+    /// @brief Triangles des meshlets, mis bout à bout (int).
+    MESH_CACHE_MESHLET_TRIANGLES,
+
+    /// @brief Indices locaux des triangles des meshlets, trois par triangle (Uint8).
+    MESH_CACHE_MESHLET_INDICES,
+
+    /// @brief Noeuds de la BVH des triangles (MeshBvhNode).
+    MESH_CACHE_BVH_NODES,
+
+    /// @brief Triangles des feuilles de la BVH, mis bout à bout (int).
+    MESH_CACHE_BVH_TRIANGLES,
+
+    /// @brief Occlusion ambiante des sommets soudés (float), vide si elle n'a pas été calculée.
+    MESH_CACHE_OCCLUSION,
+
+    MESH_CACHE_SECTION_COUNT
+} MeshCacheSectionType;
+
+/// @brief Entrée de la table des sections d'un fichier du cache.
+typedef struct MeshCacheSection_s
+{
+    /// @brief Position du début de la section dans le fichier (multiple de MESH_CACHE_ALIGNMENT).
+    Uint64 m_offset;
+
+    /// @brief Taille de la section en octets.
+    Uint64 m_size;
+
+    Uint32 m_count;
+    Uint32 m_elementSize;
+} MeshCacheSection;
+
+/// @brief Niveau de détail simplifié stocké dans le cache (voir MeshLod).
+typedef struct MeshCacheLod_s
+{
+    Uint32 m_vertexCount;
+    Uint32 m_triangleCount;
+    float  m_error;
+    Uint32 m_padding;
+} MeshCacheLod;
+
+/// @brief En-tête d'un fichier du cache.
+typedef struct MeshCacheHeader_s
+{
+    Uint32 m_magic;
+    Uint32 m_version;
+    Uint32 m_headerSize;
+    Uint32 m_sectionCount;
+
+    Vec3 m_min;
+    Vec3 m_max;
+    Vec3 m_center;
+
+    /// @brief Nom du fichier mtl (vide si le mesh n'a pas de matériau).
+    char m_materialLib[MESH_NAME_SIZE];
+
+    /// @brief Taille, date de modification et hachage du contenu du fichier obj.
+    /// Le hachage n'est recalculé que si la date ne correspond plus.
+    Uint64 m_sourceSize;
+    Sint64 m_sourceTime;
+    Uint64 m_sourceHash;
+
+    /// @brief Nombre de rayons par sommet utilisés pour l'occlusion ambiante
+    /// (0 si elle n'a pas été calculée). Le cache n'est utilisé que s'il correspond
+    /// au réglage courant (voir MeshOcclusion_SetRayCount()).
+    Uint32 m_occlusionRayCount;
+    Uint32 m_padding;
+
+    MeshCacheSection m_sections[MESH_CACHE_SECTION_COUNT];
+} MeshCacheHeader;
+
+/// @brief Charge un mesh depuis le cache.
+/// Le fichier est projeté en mémoire (copie sur écriture) et ses tableaux sont
+/// utilisés sans copie. Les matériaux sont rechargés depuis le fichier mtl.
+/// @param[in] folderPath le dossier du fichier obj.
+/// @param[in] fileName le nom du fichier obj.
+/// @return Le mesh (tangentes, sommets soudés et niveaux de détail compris), ou NULL s'il n'est pas
+/// dans le cache ou si le cache n'est plus à jour.
+Mesh *MeshCache_Load(char *folderPath, char *fileName);
+
+/// @brief Écrit un mesh dans le cache, à côté de son fichier obj.
+/// Les tangentes, les sommets soudés et les niveaux de détail doivent avoir été calculés.
+/// @param[in] mesh le mesh.
+/// @param[in] folderPath le dossier du fichier obj.
+/// @param[in] fileName le nom du fichier obj.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int MeshCache_Store(Mesh *mesh, char *folderPath, char *fileName);
+
+/// @}
+
+#endif
@@ -0,0 +1,747 @@
+﻿#include "MeshLod.h"
+#include "Tools.h"
+
+#include <limits.h>
+
+/// @brief Quadrique d'erreur : somme pondérée des carrés des distances à des plans.
+/// La matrice symétrique 4x4 est stockée par sa moitié supérieure.
+typedef struct MeshQuadric_s
+{
+    double m_a2, m_ab, m_ac, m_ad;
+    double m_b2, m_bc, m_bd;
+    double m_c2, m_cd;
+    double m_d2;
+
+    /// @brief Somme des poids (aires) des plans.
+    double m_weight;
+} MeshQuadric;
+
+/// @brief Type d'une position, qui détermine les fusions autorisées.
+typedef enum MeshLodKind_e
+{
+    /// @brief Position intérieure, avec un seul sommet soudé : fusion avec n'importe quel voisin.
+    MESH_LOD_MANIFOLD,
+
+    /// @brief Position sur un bord du mesh : fusion uniquement le long du bord.
+    MESH_LOD_BORDER,
+
+    /// @brief Position sur une couture (uv ou arête vive) partagée par deux sommets soudés :
+    /// fusion uniquement le long de la couture, les deux sommets sont déplacés ensemble.
+    MESH_LOD_SEAM,
+
+    /// @brief Position qui ne peut pas être déplacée (coin de couture, changement de matériau...).
+    MESH_LOD_LOCKED
+} MeshLodKind;
+
+/// @brief Fusion d'une arête : le sommet m_from est déplacé sur le sommet m_to.
+typedef struct MeshCollapse_s
+{
+    int   m_from;
+    int   m_to;
+    float m_error;
+} MeshCollapse;
+
+/// @brief Sommet soudé associé à sa position, pour regrouper les sommets d'une même position.
+typedef struct MeshLodPosition_s
+{
+    Vec3 m_position;
+    int  m_vertex;
+} MeshLodPosition;
+
+/// @brief État de la simplification d'un mesh.
+typedef struct MeshSimplifier_s
+{
+    int               m_vertexCount;
+    const MeshVertex *m_vertices;
+
+    /// @brief Position (identifiant) de chaque sommet soudé.
+    int              *m_positionIds;
+
+    /// @brief Sommet soudé suivant de même position (liste circulaire).
+    int              *m_wedges;
+
+    /// @brief Type et quadrique de chaque position.
+    int               m_positionCount;
+    MeshLodKind      *m_kinds;
+    MeshQuadric      *m_quadrics;
+
+    /// @brief Extrémité de l'arête ouverte (sans arête opposée) sortant de chaque sommet
+    /// et origine de celle qui y entre : -1 s'il n'y en a pas, -2 s'il y en a plusieurs.
+    int              *m_openOut;
+    int              *m_openIn;
+
+    /// @brief Sommets modifiés (ou voisins d'un sommet déplacé) pendant la passe courante.
+    bool             *m_touched;
+
+    /// @brief Sommet sur lequel chaque sommet est déplacé pendant la passe courante.
+    int              *m_remap;
+
+    /// @brief Triangles courants (trois indices de sommets soudés par triangle).
+    int               m_triangleCount;
+    int              *m_indices;
+    int              *m_materials;
+
+    /// @brief Arêtes orientées des triangles courants, triées.
+    Uint64           *m_edges;
+    MeshCollapse     *m_collapses;
+
+    /// @brief Triangles contenant chaque sommet (format CSR).
+    int              *m_adjacencyFirst;
+    int              *m_adjacency;
+
+    /// @brief Plus grande erreur (distance quadratique moyenne) des fusions effectuées.
+    float             m_error;
+} MeshSimplifier;
+
+static void MeshQuadric_AddPlane(MeshQuadric *q, Vec3 normal, float distance, double weight)
+{
+    double a = normal.x, b = normal.y, c = normal.z, d = distance;
+
+    q->m_a2 += weight * a * a; q->m_ab += weight * a * b; q->m_ac += weight * a * c; q->m_ad += weight * a * d;
+    q->m_b2 += weight * b * b; q->m_bc += weight * b * c; q->m_bd += weight * b * d;
+    q->m_c2 += weight * c * c; q->m_cd += weight * c * d;
+    q->m_d2 += weight * d * d;
+    q->m_weight += weight;
+}
+
+static void MeshQuadric_Add(MeshQuadric *q, const MeshQuadric *other)
+{
+    q->m_a2 += other->m_a2; q->m_ab += other->m_ab; q->m_ac += other->m_ac; q->m_ad += other->m_ad;
+    q->m_b2 += other->m_b2; q->m_bc += other->m_bc; q->m_bd += other->m_bd;
+    q->m_c2 += other->m_c2; q->m_cd += other->m_cd;
+    q->m_d2 += other->m_d2;
+    q->m_weight += other->m_weight;
+}
+
+/// @brief Renvoie la moyenne (pondérée) des carrés des distances d'un point aux plans.
+static double MeshQuadric_GetError(const MeshQuadric *q, Vec3 point)
+{
+    double x = point.x, y = point.y, z = point.z;
+
+    double error =
+        q->m_a2 * x * x + q->m_b2 * y * y + q->m_c2 * z * z +
+        2.0 * (q->m_ab * x * y + q->m_ac * x * z + q->m_bc * y * z) +
+        2.0 * (q->m_ad * x + q->m_bd * y + q->m_cd * z) +
+        q->m_d2;
+
+    return fabs(error) / fmax(q->m_weight, 1e-30);
+}
+
+static int MeshLod_CompareEdges(const void *a, const void *b)
+{
+    Uint64 edge1 = *(const Uint64 *)a;
+    Uint64 edge2 = *(const Uint64 *)b;
+    return (edge1 > edge2) - (edge1 < edge2);
+}
+
+static int MeshLod_CompareCollapses(const void *a, const void *b)
+{
+    const MeshCollapse *collapse1 = (const MeshCollapse *)a;
+    const MeshCollapse *collapse2 = (const MeshCollapse *)b;
+
+    // Les égalités sont départagées par les indices : le résultat ne dépend pas de qsort
+    if (collapse1->m_error != collapse2->m_error)
+        return collapse1->m_error < collapse2->m_error ? -1 : 1;
+    if (collapse1->m_from != collapse2->m_from)
+        return collapse1->m_from < collapse2->m_from ? -1 : 1;
+    return (collapse1->m_to > collapse2->m_to) - (collapse1->m_to < collapse2->m_to);
+}
+
+static int MeshLod_ComparePositions(const void *a, const void *b)
+{
+    const MeshLodPosition *position1 = (const MeshLodPosition *)a;
+    const MeshLodPosition *position2 = (const MeshLodPosition *)b;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        float value1 = position1->m_position.data[i];
+        float value2 = position2->m_position.data[i];
+        if (value1 != value2)
+            return value1 < value2 ? -1 : 1;
+    }
+    return (position1->m_vertex > position2->m_vertex) - (position1->m_vertex < position2->m_vertex);
+}
+
+/// @brief Code une arête orientée.
+INLINE Uint64 MeshLod_GetEdgeKey(int from, int to)
+{
+    return ((Uint64)(Uint32)from << 32) | (Uint32)to;
+}
+
+/// @brief Indique si une arête orientée appartient aux triangles courants.
+/// Les arêtes doivent avoir été triées avec MeshSimplifier_UpdateEdges().
+static bool MeshSimplifier_HasEdge(MeshSimplifier *simplifier, int from, int to)
+{
+    Uint64 key = MeshLod_GetEdgeKey(from, to);
+    return bsearch(&key, simplifier->m_edges, 3 * simplifier->m_triangleCount,
+        sizeof(Uint64), MeshLod_CompareEdges) != NULL;
+}
+
+/// @brief Trie les arêtes orientées des triangles courants puis recherche les arêtes ouvertes.
+static void MeshSimplifier_UpdateEdges(MeshSimplifier *simplifier)
+{
+    int edgeCount = 3 * simplifier->m_triangleCount;
+    int *indices = simplifier->m_indices;
+    int *openOut = simplifier->m_openOut;
+    int *openIn = simplifier->m_openIn;
+    int i;
+
+    for (i = 0; i < edgeCount; ++i)
+    {
+        int next = (i % 3 == 2) ? i - 2 : i + 1;
+        simplifier->m_edges[i] = MeshLod_GetEdgeKey(indices[i], indices[next]);
+    }
+    qsort(simplifier->m_edges, edgeCount, sizeof(Uint64), MeshLod_CompareEdges);
+
+    for (i = 0; i < simplifier->m_vertexCount; ++i)
+    {
+        openOut[i] = -1;
+        openIn[i] = -1;
+    }
+    for (i = 0; i < edgeCount; ++i)
+    {
+        int from = (int)(simplifier->m_edges[i] >> 32);
+        int to = (int)(simplifier->m_edges[i] & 0xFFFFFFFF);
+        if (MeshSimplifier_HasEdge(simplifier, to, from))
+            continue;
+
+        openOut[from] = (openOut[from] == -1) ? to : -2;
+        openIn[to] = (openIn[to] == -1) ? from : -2;
+    }
+}
+
+/// @brief Regroupe les sommets soudés par position et détermine le type de chaque position.
+static int MeshSimplifier_Classify(MeshSimplifier *simplifier)
+{
+    int vertexCount = simplifier->m_vertexCount;
+    int *positionIds = simplifier->m_positionIds;
+    int *wedges = simplifier->m_wedges;
+    MeshLodPosition *positions = NULL;
+    int *vertexMaterials = NULL;
+    int positionCount = 0;
+
+    positions = (MeshLodPosition *)calloc(Int_Max(vertexCount, 1), sizeof(MeshLodPosition));
+    vertexMaterials = (int *)malloc(Int_Max(vertexCount, 1) * sizeof(int));
+    if (!positions || !vertexMaterials) goto ERROR_LABEL;
+
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        positions[i].m_position = simplifier->m_vertices[i].m_position;
+        positions[i].m_vertex = i;
+    }
+    qsort(positions, vertexCount, sizeof(MeshLodPosition), MeshLod_ComparePositions);
+
+    for (int i = 0; i < vertexCount;)
+    {
+        int j = i + 1;
+        while (j < vertexCount &&
+            memcmp(&positions[i].m_position, &positions[j].m_position, sizeof(Vec3)) == 0)
+        {
+            j++;
+        }
+        for (int k = i; k < j; ++k)
+        {
+            positionIds[positions[k].m_vertex] = positionCount;
+            wedges[positions[k].m_vertex] = positions[(k + 1 < j) ? k + 1 : i].m_vertex;
+        }
+        positionCount++;
+        i = j;
+    }
+    simplifier->m_positionCount = positionCount;
+
+    // Arêtes ouvertes du mesh d'origine
+    MeshSimplifier_UpdateEdges(simplifier);
+
+    int *openOut = simplifier->m_openOut;
+    int *openIn = simplifier->m_openIn;
+    MeshLodKind *kinds = simplifier->m_kinds;
+
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        int id = positionIds[i];
+        int sibling = wedges[i];
+
+        if (sibling == i)
+        {
+            // Un seul sommet soudé
+            if (openOut[i] == -1 && openIn[i] == -1)
+                kinds[id] = MESH_LOD_MANIFOLD;
+            else if (openOut[i] >= 0 && openIn[i] >= 0)
+                kinds[id] = MESH_LOD_BORDER;
+            else
+                kinds[id] = MESH_LOD_LOCKED;
+        }
+        else if (wedges[sibling] == i &&
+            openOut[i] >= 0 && openIn[i] >= 0 && openOut[sibling] >= 0 && openIn[sibling] >= 0 &&
+            positionIds[openOut[i]] == positionIds[openIn[sibling]] &&
+            positionIds[openIn[i]] == positionIds[openOut[sibling]])
+        {
+            // Deux sommets soudés dont les arêtes ouvertes se font face
+            kinds[id] = MESH_LOD_SEAM;
+        }
+        else
+        {
+            kinds[id] = MESH_LOD_LOCKED;
+        }
+    }
+
+    // Un sommet soudé partagé par des triangles de matériaux différents est bloqué
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        vertexMaterials[i] = INT_MIN;
+    }
+    for (int i = 0; i < simplifier->m_triangleCount; ++i)
+    {
+        int material = simplifier->m_materials[i];
+        for (int j = 0; j < 3; ++j)
+        {
+            int vertex = simplifier->m_indices[3 * i + j];
+            if (vertexMaterials[vertex] == INT_MIN)
+                vertexMaterials[vertex] = material;
+            else if (vertexMaterials[vertex] != material)
+                kinds[positionIds[vertex]] = MESH_LOD_LOCKED;
+        }
+    }
+
+    free(positions);
+    free(vertexMaterials);
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - MeshSimplifier_Classify()\n");
+    assert(false);
+    free(positions);
+    free(vertexMaterials);
+    return EXIT_FAILURE;
+}
+
+/// @brief Calcule la quadrique de chaque position à partir des plans de ses triangles.
+/// Les plans sont pondérés par l'aire des triangles.
+static void MeshSimplifier_ComputeQuadrics(MeshSimplifier *simplifier)
+{
+    for (int i = 0; i < simplifier->m_triangleCount; ++i)
+    {
+        int *triangle = simplifier->m_indices + 3 * i;
+        Vec3 p0 = simplifier->m_vertices[triangle[0]].m_position;
+        Vec3 p1 = simplifier->m_vertices[triangle[1]].m_position;
+        Vec3 p2 = simplifier->m_vertices[triangle[2]].m_position;
+
+        Vec3 normal = Vec3_Cross(Vec3_Sub(p1, p0), Vec3_Sub(p2, p0));
+        float length = Vec3_Length(normal);
+        if (length <= 0.0f)
+            continue;
+
+        normal = Vec3_Scale(normal, 1.0f / length);
+        float distance = -Vec3_Dot(normal, p0);
+
+        for (int j = 0; j < 3; ++j)
+        {
+            MeshQuadric *quadric = &simplifier->m_quadrics[simplifier->m_positionIds[triangle[j]]];
+            MeshQuadric_AddPlane(quadric, normal, distance, 0.5 * length);
+        }
+    }
+}
+
+/// @brief Construit la liste des triangles courants contenant chaque sommet.
+static void MeshSimplifier_BuildAdjacency(MeshSimplifier *simplifier)
+{
+    int vertexCount = simplifier->m_vertexCount;
+    int *first = simplifier->m_adjacencyFirst;
+    int *indices = simplifier->m_indices;
+
+    memset(first, 0, (vertexCount + 1) * sizeof(int));
+    for (int i = 0; i < 3 * simplifier->m_triangleCount; ++i)
+    {
+        first[indices[i] + 1]++;
+    }
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        first[i + 1] += first[i];
+    }
+
+    // Remplit en décalant temporairement les débuts de liste
+    for (int i = 0; i < simplifier->m_triangleCount; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            simplifier->m_adjacency[first[indices[3 * i + j]]++] = i;
+        }
+    }
+    for (int i = vertexCount; i > 0; --i)
+    {
+        first[i] = first[i - 1];
+    }
+    first[0] = 0;
+}
+
+/// @brief Indique si le type de la position d'un sommet autorise son déplacement sur un voisin.
+static bool MeshSimplifier_IsAllowed(MeshSimplifier *simplifier, int from, int to)
+{
+    switch (simplifier->m_kinds[simplifier->m_positionIds[from]])
+    {
+    case MESH_LOD_MANIFOLD:
+        return true;
+
+    case MESH_LOD_BORDER:
+    case MESH_LOD_SEAM:
+        // Uniquement le long de l'arête ouverte
+        return simplifier->m_openOut[from] == to || simplifier->m_openIn[from] == to;
+
+    default:
+        return false;
+    }
+}
+
+/// @brief Renvoie le sommet sur lequel est déplacé le second sommet d'une couture
+/// lorsque from est déplacé sur to, ou -1 si la couture n'est plus intacte.
+static int MeshSimplifier_GetSeamTarget(MeshSimplifier *simplifier, int from, int to)
+{
+    int sibling = simplifier->m_wedges[from];
+
+    // Les deux côtés d'une couture sont parcourus en sens opposés
+    int target = (simplifier->m_openOut[from] == to) ?
+        simplifier->m_openIn[sibling] : simplifier->m_openOut[sibling];
+
+    if (target < 0 || simplifier->m_positionIds[target] != simplifier->m_positionIds[to])
+        return -1;
+    return target;
+}
+
+/// @brief Indique si un sommet peut être déplacé sur un autre sans retourner de triangle.
+static bool MeshSimplifier_CanCollapse(MeshSimplifier *simplifier, int from, int to)
+{
+    const MeshVertex *vertices = simplifier->m_vertices;
+    Vec3 target = vertices[to].m_position;
+
+    for (int k = simplifier->m_adjacencyFirst[from]; k < simplifier->m_adjacencyFirst[from + 1]; ++k)
+    {
+        int *triangle = simplifier->m_indices + 3 * simplifier->m_adjacency[k];
+        if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+            continue; // Triangle supprimé par la fusion
+
+        Vec3 before[3], after[3];
+        for (int j = 0; j < 3; ++j)
+        {
+            before[j] = vertices[triangle[j]].m_position;
+            after[j] = (triangle[j] == from) ? target : before[j];
+        }
+
+        Vec3 normalBefore = Vec3_Cross(Vec3_Sub(before[1], before[0]), Vec3_Sub(before[2], before[0]));
+        Vec3 normalAfter = Vec3_Cross(Vec3_Sub(after[1], after[0]), Vec3_Sub(after[2], after[0]));
+
+        // Refuse les triangles qui se retournent ou tournent de plus de 75 degrés environ
+        float dot = Vec3_Dot(normalBefore, normalAfter);
+        if (dot <= 0.25f * Vec3_Length(normalBefore) * Vec3_Length(normalAfter))
+            return false;
+    }
+    return true;
+}
+
+/// @brief Marque les sommets des triangles contenant un sommet.
+static void MeshSimplifier_TouchNeighbors(MeshSimplifier *simplifier, int vertex)
+{
+    int *first = simplifier->m_adjacencyFirst;
+    for (int k = first[vertex]; k < first[vertex + 1]; ++k)
+    {
+        int *triangle = simplifier->m_indices + 3 * simplifier->m_adjacency[k];
+        simplifier->m_touched[triangle[0]] = true;
+        simplifier->m_touched[triangle[1]] = true;
+        simplifier->m_touched[triangle[2]] = true;
+    }
+}
+
+/// @brief Effectue une passe de fusions indépendantes, par ordre d'erreur croissante.
+/// @param[in,out] simplifier l'état de la simplification.
+/// @param[in] targetCount le nombre de triangles visé.
+/// @return Le nombre de fusions effectuées.
+static int MeshSimplifier_Pass(MeshSimplifier *simplifier, int targetCount)
+{
+    const MeshVertex *vertices = simplifier->m_vertices;
+    const int *positionIds = simplifier->m_positionIds;
+    MeshQuadric *quadrics = simplifier->m_quadrics;
+    bool *touched = simplifier->m_touched;
+    int *remap = simplifier->m_remap;
+    int *indices = simplifier->m_indices;
+    int i;
+
+    MeshSimplifier_UpdateEdges(simplifier);
+
+    // Une arête intérieure apparaît dans les deux sens : elle n'est évaluée qu'une fois
+    int edgeCount = 3 * simplifier->m_triangleCount;
+    int candidateCount = 0;
+    for (i = 0; i < edgeCount; ++i)
+    {
+        Uint64 edge = simplifier->m_edges[i];
+        int a = (int)(edge >> 32);
+        int b = (int)(edge & 0xFFFFFFFF);
+        if (i > 0 && edge == simplifier->m_edges[i - 1])
+            continue;
+        if (a > b && MeshSimplifier_HasEdge(simplifier, b, a))
+            continue;
+
+        simplifier->m_collapses[candidateCount].m_from = a;
+        simplifier->m_collapses[candidateCount].m_to = b;
+        candidateCount++;
+    }
+
+    // Coût de chaque arête dans le sens autorisé le moins coûteux
+    #pragma omp parallel for
+    for (i = 0; i < candidateCount; ++i)
+    {
+        MeshCollapse *collapse = &simplifier->m_collapses[i];
+        int a = collapse->m_from;
+        int b = collapse->m_to;
+
+        MeshQuadric quadric = quadrics[positionIds[a]];
+        MeshQuadric_Add(&quadric, &quadrics[positionIds[b]]);
+
+        float errorAB = INFINITY;
+        float errorBA = INFINITY;
+        if (MeshSimplifier_IsAllowed(simplifier, a, b))
+            errorAB = (float)MeshQuadric_GetError(&quadric, vertices[b].m_position);
+        if (MeshSimplifier_IsAllowed(simplifier, b, a))
+            errorBA = (float)MeshQuadric_GetError(&quadric, vertices[a].m_position);
+
+        collapse->m_from = (errorAB <= errorBA) ? a : b;
+        collapse->m_to = (errorAB <= errorBA) ? b : a;
+        collapse->m_error = fminf(errorAB, errorBA);
+    }
+    qsort(simplifier->m_collapses, candidateCount, sizeof(MeshCollapse), MeshLod_CompareCollapses);
+
+    MeshSimplifier_BuildAdjacency(simplifier);
+    for (i = 0; i < simplifier->m_vertexCount; ++i)
+    {
+        touched[i] = false;
+        remap[i] = i;
+    }
+
+    // Chaque fusion supprime en général deux triangles
+    int neededCount = (simplifier->m_triangleCount - targetCount + 1) / 2;
+    int collapseCount = 0;
+    for (i = 0; i < candidateCount && collapseCount < neededCount; ++i)
+    {
+        MeshCollapse collapse = simplifier->m_collapses[i];
+        if (collapse.m_error == INFINITY)
+            break;
+
+        int from = collapse.m_from;
+        int to = collapse.m_to;
+        if (touched[from] || touched[to])
+            continue;
+        if (!MeshSimplifier_CanCollapse(simplifier, from, to))
+            continue;
+
+        // Les deux sommets d'une couture sont déplacés ensemble
+        int sibling = -1;
+        int siblingTo = -1;
+        if (simplifier->m_kinds[positionIds[from]] == MESH_LOD_SEAM)
+        {
+            sibling = simplifier->m_wedges[from];
+            siblingTo = MeshSimplifier_GetSeamTarget(simplifier, from, to);
+            if (siblingTo < 0 || touched[sibling] || touched[siblingTo])
+                continue;
+            if (!MeshSimplifier_CanCollapse(simplifier, sibling, siblingTo))
+                continue;
+
+            remap[sibling] = siblingTo;
+        }
+        remap[from] = to;
+
+        MeshQuadric_Add(&quadrics[positionIds[to]], &quadrics[positionIds[from]]);
+        simplifier->m_error = fmaxf(simplifier->m_error, collapse.m_error);
+        collapseCount++;
+
+        // Les voisins des sommets déplacés ne sont plus modifiés pendant cette passe :
+        // le test de retournement reste valide
+        MeshSimplifier_TouchNeighbors(simplifier, from);
+        if (sibling >= 0)
+        {
+            MeshSimplifier_TouchNeighbors(simplifier, sibling);
+        }
+    }
+
+    // Applique les fusions et supprime les triangles dégénérés
+    int triangleCount = 0;
+    for (i = 0; i < simplifier->m_triangleCount; ++i)
+    {
+        int a = remap[indices[3 * i + 0]];
+        int b = remap[indices[3 * i + 1]];
+        int c = remap[indices[3 * i + 2]];
+        if (a == b || b == c || c == a)
+            continue;
+
+        indices[3 * triangleCount + 0] = a;
+        indices[3 * triangleCount + 1] = b;
+        indices[3 * triangleCount + 2] = c;
+        simplifier->m_materials[triangleCount] = simplifier->m_materials[i];
+        triangleCount++;
+    }
+    simplifier->m_triangleCount = triangleCount;
+
+    return collapseCount;
+}
+
+/// @brief Copie les triangles courants dans un niveau de détail.
+/// Les sommets utilisés sont numérotés dans l'ordre de leur première utilisation.
+static int MeshSimplifier_StoreLod(MeshSimplifier *simplifier, MeshLod *lod)
+{
+    int triangleCount = simplifier->m_triangleCount;
+    int *localIndices = simplifier->m_remap;
+    int vertexCount = 0;
+
+    for (int i = 0; i < simplifier->m_vertexCount; ++i)
+    {
+        localIndices[i] = -1;
+    }
+    for (int i = 0; i < 3 * triangleCount; ++i)
+    {
+        int vertex = simplifier->m_indices[i];
+        if (localIndices[vertex] < 0)
+            localIndices[vertex] = vertexCount++;
+    }
+
+    lod->m_vertices = (int *)calloc(Int_Max(vertexCount, 1), sizeof(int));
+    lod->m_indices = (int *)calloc(Int_Max(3 * triangleCount, 1), sizeof(int));
+    lod->m_materialIndices = (int *)calloc(Int_Max(triangleCount, 1), sizeof(int));
+    if (!lod->m_vertices || !lod->m_indices || !lod->m_materialIndices) goto ERROR_LABEL;
+
+    for (int i = 0; i < 3 * triangleCount; ++i)
+    {
+        int vertex = simplifier->m_indices[i];
+        lod->m_indices[i] = localIndices[vertex];
+        lod->m_vertices[localIndices[vertex]] = vertex;
+    }
+    memcpy(lod->m_materialIndices, simplifier->m_materials, triangleCount * sizeof(int));
+
+    lod->m_vertexCount = vertexCount;
+    lod->m_triangleCount = triangleCount;
+    lod->m_error = sqrtf(simplifier->m_error);
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - MeshSimplifier_StoreLod()\n");
+    assert(false);
+    free(lod->m_vertices);
+    free(lod->m_indices);
+    free(lod->m_materialIndices);
+    memset(lod, 0, sizeof(MeshLod));
+    return EXIT_FAILURE;
+}
+
+/// @brief Libère les tableaux de travail de la simplification.
+static void MeshSimplifier_Free(MeshSimplifier *simplifier)
+{
+    free(simplifier->m_positionIds);
+    free(simplifier->m_wedges);
+    free(simplifier->m_kinds);
+    free(simplifier->m_quadrics);
+    free(simplifier->m_openOut);
+    free(simplifier->m_openIn);
+    free(simplifier->m_touched);
+    free(simplifier->m_remap);
+    free(simplifier->m_indices);
+    free(simplifier->m_materials);
+    free(simplifier->m_edges);
+    free(simplifier->m_collapses);
+    free(simplifier->m_adjacencyFirst);
+    free(simplifier->m_adjacency);
+}
+
+int MeshLod_Build(Mesh *mesh)
+{
+    MeshSimplifier simplifier = { 0 };
+    MeshLod *lods = NULL;
+    int lodCount = 0;
+
+    int vertexCount = mesh->m_weldedCount;
+    int triangleCount = mesh->m_triangleCount;
+
+    assert(mesh->m_weldedVertices && mesh->m_indices);
+
+    simplifier.m_vertexCount = vertexCount;
+    simplifier.m_vertices = mesh->m_weldedVertices;
+    simplifier.m_triangleCount = triangleCount;
+
+    int capacity = Int_Max(vertexCount, 1);
+    int cornerCapacity = Int_Max(3 * triangleCount, 1);
+
+    simplifier.m_positionIds = (int *)calloc(capacity, sizeof(int));
+    simplifier.m_wedges = (int *)calloc(capacity, sizeof(int));
+    simplifier.m_kinds = (MeshLodKind *)calloc(capacity, sizeof(MeshLodKind));
+    simplifier.m_quadrics = (MeshQuadric *)calloc(capacity, sizeof(MeshQuadric));
+    simplifier.m_openOut = (int *)calloc(capacity, sizeof(int));
+    simplifier.m_openIn = (int *)calloc(capacity, sizeof(int));
+    simplifier.m_touched = (bool *)calloc(capacity, sizeof(bool));
+    simplifier.m_remap = (int *)calloc(capacity, sizeof(int));
+    simplifier.m_indices = (int *)calloc(cornerCapacity, sizeof(int));
+    simplifier.m_materials = (int *)calloc(Int_Max(triangleCount, 1), sizeof(int));
+    simplifier.m_edges = (Uint64 *)calloc(cornerCapacity, sizeof(Uint64));
+    simplifier.m_collapses = (MeshCollapse *)calloc(cornerCapacity, sizeof(MeshCollapse));
+    simplifier.m_adjacencyFirst = (int *)calloc(capacity + 1, sizeof(int));
+    simplifier.m_adjacency = (int *)calloc(cornerCapacity, sizeof(int));
+    lods = (MeshLod *)calloc(MESH_MAX_LODS, sizeof(MeshLod));
+
+    if (!simplifier.m_positionIds || !simplifier.m_wedges || !simplifier.m_kinds ||
+        !simplifier.m_quadrics || !simplifier.m_openOut || !simplifier.m_openIn ||
+        !simplifier.m_touched || !simplifier.m_remap || !simplifier.m_indices ||
+        !simplifier.m_materials || !simplifier.m_edges || !simplifier.m_collapses ||
+        !simplifier.m_adjacencyFirst || !simplifier.m_adjacency || !lods)
+    {
+        goto ERROR_LABEL;
+    }
+
+    memcpy(simplifier.m_indices, mesh->m_indices, 3 * triangleCount * sizeof(int));
+    for (int i = 0; i < triangleCount; ++i)
+    {
+        simplifier.m_materials[i] = mesh->m_triangles[i].m_materialIndex;
+    }
+
+    int exitStatus = MeshSimplifier_Classify(&simplifier);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    MeshSimplifier_ComputeQuadrics(&simplifier);
+
+    // Chaque niveau poursuit la simplification du précédent
+    int previousCount = triangleCount;
+    while (lodCount < MESH_MAX_LODS && previousCount > 0)
+    {
+        int targetCount = (int)((float)previousCount * MESH_LOD_REDUCTION);
+        while (simplifier.m_triangleCount > targetCount)
+        {
+            if (MeshSimplifier_Pass(&simplifier, targetCount) == 0)
+                break;
+        }
+
+        if ((float)simplifier.m_triangleCount > (float)previousCount * MESH_LOD_MIN_REDUCTION)
+            break;
+
+        exitStatus = MeshSimplifier_StoreLod(&simplifier, &lods[lodCount]);
+        if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+        previousCount = simplifier.m_triangleCount;
+        lodCount++;
+    }
+
+    MeshSimplifier_Free(&simplifier);
+
+    Mesh_FreeLods(mesh);
+    mesh->m_lods = lods;
+    mesh->m_lodCount = lodCount;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - MeshLod_Build()\n");
+    assert(false);
+    MeshSimplifier_Free(&simplifier);
+    for (int i = 0; i < lodCount; ++i)
+    {
+        free(lods[i].m_vertices);
+        free(lods[i].m_indices);
+        free(lods[i].m_materialIndices);
+    }
+    free(lods);
+    return EXIT_FAILURE;
+}
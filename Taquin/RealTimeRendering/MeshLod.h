@@ -0,0 +1,32 @@
+﻿#ifndef _MESH_LOD_H_
+#define _MESH_LOD_H_
+
+/// @file MeshLod.h
+/// @defgroup MeshLod
+/// @{
+
+#include "Settings.h"
+#include "Mesh.h"
+
+/// @brief Rapport entre le nombre de triangles de deux niveaux de détail successifs.
+#define MESH_LOD_REDUCTION 0.5f
+
+/// @brief Réduction minimale (par rapport au niveau précédent) pour qu'un niveau soit conservé.
+/// Les sommets bloqués (coins de couture, changements de matériau) et ceux qui ne peuvent
+/// glisser que le long d'un bord ou d'une couture limitent la simplification.
+#define MESH_LOD_MIN_REDUCTION 0.9f
+
+/// @brief Construit les niveaux de détail simplifiés d'un mesh (m_lods).
+/// Les arêtes sont fusionnées par ordre d'erreur quadrique croissante (Garland et Heckbert).
+/// Un sommet soudé sur un bord, ou sur une couture (position partagée par deux sommets
+/// soudés), ne peut glisser que le long de son arête ouverte ; les deux sommets d'une couture
+/// sont alors déplacés ensemble. Un sommet entre deux matériaux, ou au coin d'une couture,
+/// n'est jamais déplacé.
+/// Les sommets soudés doivent avoir été calculés (voir Mesh_Weld()).
+/// @param[in,out] mesh le mesh.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int MeshLod_Build(Mesh *mesh);
+
+/// @}
+
+#endif
@@ -0,0 +1,125 @@
+﻿#include "MeshOcclusion.h"
+#include "MeshBvh.h"
+#include "Vector.h"
+#include "Tools.h"
+
+/// @brief Nombre de rayons par sommet utilisé au chargement (0 : désactivé).
+static int g_occlusionRayCount = 0;
+
+void MeshOcclusion_SetRayCount(int rayCount)
+{
+    g_occlusionRayCount = Int_Max(rayCount, 0);
+}
+
+int MeshOcclusion_GetRayCount()
+{
+    return g_occlusionRayCount;
+}
+
+/// @brief Renvoie l'inverse en base 2 d'un entier (suite de Van der Corput) dans [0,1[.
+static float MeshOcclusion_RadicalInverse(Uint32 bits)
+{
+    bits = (bits << 16) | (bits >> 16);
+    bits = ((bits & 0x55555555u) << 1) | ((bits & 0xAAAAAAAAu) >> 1);
+    bits = ((bits & 0x33333333u) << 2) | ((bits & 0xCCCCCCCCu) >> 2);
+    bits = ((bits & 0x0F0F0F0Fu) << 4) | ((bits & 0xF0F0F0F0u) >> 4);
+    bits = ((bits & 0x00FF00FFu) << 8) | ((bits & 0xFF00FF00u) >> 8);
+    return (float)bits * 2.3283064365386963e-10f;
+}
+
+/// @brief Mélange les bits d'un entier (décalage pseudo-aléatoire des rayons d'un sommet).
+static Uint32 MeshOcclusion_Hash(Uint32 value)
+{
+    value ^= value >> 16;
+    value *= 0x7FEB352Du;
+    value ^= value >> 15;
+    value *= 0x846CA68Bu;
+    value ^= value >> 16;
+    return value;
+}
+
+/// @brief Renvoie la partie fractionnaire d'un nombre positif.
+static float MeshOcclusion_Fract(float value)
+{
+    return value - floorf(value);
+}
+
+int MeshOcclusion_Bake(Mesh *mesh, int rayCount)
+{
+    int weldedCount = mesh->m_weldedCount;
+    float *occlusion = NULL;
+    int i;
+
+    assert(mesh->m_weldedVertices && !mesh->m_occlusion && rayCount > 0);
+    assert(mesh->m_bvhNodes || mesh->m_triangleCount == 0);
+
+    occlusion = (float *)calloc(Int_Max(weldedCount, 1), sizeof(float));
+    if (!occlusion) goto ERROR_LABEL;
+
+    float diagonal = Vec3_Length(Vec3_Sub(mesh->m_max, mesh->m_min));
+    float maxDistance = MESH_OCCLUSION_DISTANCE * diagonal;
+    float bias = MESH_OCCLUSION_BIAS * diagonal;
+
+    // Les sommets ont des nombres de triangles proches très différents :
+    // ils sont répartis entre les threads par petits paquets
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (i = 0; i < weldedCount; ++i)
+    {
+        MeshVertex *vertex = &mesh->m_weldedVertices[i];
+        float length = Vec3_Length(vertex->m_normal);
+        if (length <= 0.0f)
+        {
+            occlusion[i] = 1.0f;
+            continue;
+        }
+
+        // Repère orthonormé autour de la normale (Duff et al.)
+        Vec3 n = Vec3_Scale(vertex->m_normal, 1.0f / length);
+        float sign = copysignf(1.0f, n.z);
+        float a = -1.0f / (sign + n.z);
+        float b = n.x * n.y * a;
+        Vec3 t = Vec3_Set(1.0f + sign * n.x * n.x * a, sign * b, -sign * n.x);
+        Vec3 s = Vec3_Set(b, sign + n.y * n.y * a, -n.y);
+
+        Vec3 origin = Vec3_Add(vertex->m_position, Vec3_Scale(n, bias));
+
+        // Suite de Hammersley, décalée différemment pour chaque sommet
+        Uint32 hash = MeshOcclusion_Hash((Uint32)i);
+        float offset1 = (float)(hash & 0xFFFF) / 65536.0f;
+        float offset2 = (float)(hash >> 16) / 65536.0f;
+
+        int visibleCount = 0;
+        for (int k = 0; k < rayCount; ++k)
+        {
+            float u1 = MeshOcclusion_Fract(((float)k + 0.5f) / (float)rayCount + offset1);
+            float u2 = MeshOcclusion_Fract(MeshOcclusion_RadicalInverse((Uint32)k) + offset2);
+
+            // Direction distribuée selon le cosinus de l'angle avec la normale
+            float r = sqrtf(u1);
+            float phi = 2.0f * (float)M_PI * u2;
+            float x = r * cosf(phi);
+            float y = r * sinf(phi);
+            float z = sqrtf(Float_Clamp01(1.0f - u1));
+            Vec3 direction = Vec3_Set(
+                x * t.x + y * s.x + z * n.x,
+                x * t.y + y * s.y + z * n.y,
+                x * t.z + y * s.z + z * n.z);
+
+            if (!MeshBvh_IsOccluded(mesh, origin, direction, maxDistance))
+                visibleCount++;
+        }
+
+        occlusion[i] = (float)visibleCount / (float)rayCount;
+    }
+
+    mesh->m_occlusion = occlusion;
+    mesh->m_occlusionRayCount = rayCount;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - MeshOcclusion_Bake()\n");
+    assert(false);
+    free(occlusion);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,44 @@
+﻿#ifndef _MESH_OCCLUSION_H_
+#define _MESH_OCCLUSION_H_
+
+/// @file MeshOcclusion.h
+/// @defgroup MeshOcclusion
+/// @{
+
+#include "Settings.h"
+#include "Mesh.h"
+
+/// @brief Nombre de rayons par sommet utilisé par défaut par l'option --ao.
+#define MESH_OCCLUSION_DEFAULT_RAY_COUNT 64
+
+/// @brief Longueur des rayons, relative à la diagonale de la boîte englobante du mesh :
+/// seuls les triangles proches assombrissent un sommet.
+#define MESH_OCCLUSION_DISTANCE 0.25f
+
+/// @brief Décalage de l'origine des rayons le long de la normale, relatif à la diagonale
+/// de la boîte englobante (évite que les triangles voisins du sommet ne l'occultent).
+#define MESH_OCCLUSION_BIAS 1e-3f
+
+/// @brief Définit le nombre de rayons par sommet utilisé au chargement des meshs
+/// (voir Mesh_LoadOBJ()). 0 désactive le calcul de l'occlusion ambiante.
+/// @param[in] rayCount le nombre de rayons.
+void MeshOcclusion_SetRayCount(int rayCount);
+
+/// @brief Renvoie le nombre de rayons par sommet utilisé au chargement des meshs.
+/// @return Le nombre de rayons (0 si l'occlusion ambiante n'est pas calculée).
+int MeshOcclusion_GetRayCount();
+
+/// @brief Calcule l'occlusion ambiante de chaque sommet soudé d'un mesh (m_occlusion).
+/// Des rayons sont lancés dans l'hémisphère de la normale du sommet, avec une densité
+/// proportionnelle au cosinus, et testés contre les triangles du mesh (voir MeshBvh_IsOccluded()).
+/// La valeur d'un sommet est la proportion de rayons ne touchant aucun triangle.
+/// Les sommets sont traités en parallèle.
+/// Les sommets soudés et la BVH des triangles doivent avoir été calculés.
+/// @param[in,out] mesh le mesh.
+/// @param[in] rayCount le nombre de rayons par sommet.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int MeshOcclusion_Bake(Mesh *mesh, int rayCount);
+
+/// @}
+
+#endif
@@ -0,0 +1,468 @@
+﻿#include "Meshlet.h"
+#include "Tools.h"
+
+/// @brief État du découpage d'un mesh en meshlets.
+typedef struct MeshletBuilder_s
+{
+    int         m_vertexCount;
+    int         m_positionCount;
+    int         m_triangleCount;
+    const int  *m_indices;
+    Triangle   *m_triangles;
+
+    /// @brief Normale unitaire de chaque triangle (nulle si le triangle est dégénéré).
+    Vec3       *m_normals;
+
+    /// @brief Triangles contenant chaque position (format CSR).
+    /// Les voisinages utilisent les positions et non les sommets soudés
+    /// pour que les meshlets traversent les coutures uv et les arêtes vives.
+    int        *m_adjacencyFirst;
+    int        *m_adjacency;
+
+    /// @brief Indique si chaque triangle appartient déjà à un meshlet.
+    bool       *m_used;
+
+    /// @brief Numéro du dernier meshlet dont chaque triangle a été candidat.
+    int        *m_candidateStamps;
+
+    /// @brief Indice local de chaque sommet dans le meshlet courant (-1 s'il n'y est pas).
+    int        *m_localIndices;
+
+    /// @brief Triangles voisins du meshlet courant.
+    int        *m_candidates;
+    int         m_candidateCount;
+} MeshletBuilder;
+
+/// @brief Construit la liste des triangles contenant chaque position.
+static void MeshletBuilder_BuildAdjacency(MeshletBuilder *builder)
+{
+    int *first = builder->m_adjacencyFirst;
+    Triangle *triangles = builder->m_triangles;
+
+    for (int i = 0; i < builder->m_triangleCount; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+            first[triangles[i].m_vertexIndices[j] + 1]++;
+    }
+    for (int i = 0; i < builder->m_positionCount; ++i)
+    {
+        first[i + 1] += first[i];
+    }
+    for (int i = 0; i < builder->m_triangleCount; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+            builder->m_adjacency[first[triangles[i].m_vertexIndices[j]]++] = i;
+    }
+    for (int i = builder->m_positionCount; i > 0; --i)
+    {
+        first[i] = first[i - 1];
+    }
+    first[0] = 0;
+}
+
+/// @brief Ajoute un triangle au meshlet courant ainsi que ses voisins aux candidats.
+static void MeshletBuilder_AddTriangle(
+    MeshletBuilder *builder, Mesh *mesh, Meshlet *meshlet, int triangle)
+{
+    int meshletIndex = (int)(meshlet - mesh->m_meshlets);
+    int materialIndex = builder->m_triangles[triangle].m_materialIndex;
+
+    builder->m_used[triangle] = true;
+    mesh->m_meshletTriangles[meshlet->m_triangleOffset + meshlet->m_triangleCount] = triangle;
+
+    for (int j = 0; j < 3; ++j)
+    {
+        int vertex = builder->m_indices[3 * triangle + j];
+        if (builder->m_localIndices[vertex] < 0)
+        {
+            builder->m_localIndices[vertex] = meshlet->m_vertexCount;
+            mesh->m_meshletVertices[meshlet->m_vertexOffset + meshlet->m_vertexCount] = vertex;
+            meshlet->m_vertexCount++;
+        }
+
+        int corner = 3 * (meshlet->m_triangleOffset + meshlet->m_triangleCount) + j;
+        mesh->m_meshletIndices[corner] = (Uint8)builder->m_localIndices[vertex];
+
+        int position = builder->m_triangles[triangle].m_vertexIndices[j];
+        for (int k = builder->m_adjacencyFirst[position]; k < builder->m_adjacencyFirst[position + 1]; ++k)
+        {
+            int neighbor = builder->m_adjacency[k];
+            if (builder->m_used[neighbor] || builder->m_candidateStamps[neighbor] == meshletIndex)
+                continue;
+
+            // Un meshlet ne mélange pas les matériaux (voir Mesh_BuildSubmeshes())
+            if (builder->m_triangles[neighbor].m_materialIndex != materialIndex)
+                continue;
+
+            builder->m_candidateStamps[neighbor] = meshletIndex;
+            builder->m_candidates[builder->m_candidateCount++] = neighbor;
+        }
+    }
+    meshlet->m_triangleCount++;
+}
+
+/// @brief Choisit le triangle candidat à ajouter au meshlet courant.
+/// @return Le triangle, ou -1 si aucun candidat ne convient.
+static int MeshletBuilder_SelectTriangle(
+    MeshletBuilder *builder, Meshlet *meshlet, Vec3 normalSum)
+{
+    // Un meshlet formé d'un triangle dégénéré n'accepte aucun voisin
+    float length = Vec3_Length(normalSum);
+    Vec3 axis = (length > 0.0f) ? Vec3_Scale(normalSum, 1.0f / length) : Vec3_Zero;
+    float bestScore = INFINITY;
+    int bestTriangle = -1;
+    int count = 0;
+
+    for (int i = 0; i < builder->m_candidateCount; ++i)
+    {
+        int triangle = builder->m_candidates[i];
+        if (builder->m_used[triangle])
+            continue;
+
+        // Retire les candidats déjà utilisés
+        builder->m_candidates[count++] = triangle;
+
+        int newCount = 0;
+        for (int j = 0; j < 3; ++j)
+        {
+            newCount += (builder->m_localIndices[builder->m_indices[3 * triangle + j]] < 0);
+        }
+        if (meshlet->m_vertexCount + newCount > MESH_MESHLET_MAX_VERTICES)
+            continue;
+
+        float alignment = Vec3_Dot(builder->m_normals[triangle], axis);
+        if (alignment < MESHLET_CONE_MIN_DOT)
+            continue;
+
+        float score = (float)newCount + MESHLET_CONE_WEIGHT * (1.0f - alignment);
+        if (score < bestScore)
+        {
+            bestScore = score;
+            bestTriangle = triangle;
+        }
+    }
+    builder->m_candidateCount = count;
+
+    return bestTriangle;
+}
+
+/// @brief Calcule la sphère englobante et le cône des normales d'un meshlet.
+static void Meshlet_ComputeBounds(Mesh *mesh, MeshletBuilder *builder, Meshlet *meshlet)
+{
+    Vec3 vMin = Vec3_Set(+INFINITY, +INFINITY, +INFINITY);
+    Vec3 vMax = Vec3_Set(-INFINITY, -INFINITY, -INFINITY);
+    int *vertices = mesh->m_meshletVertices + meshlet->m_vertexOffset;
+    int *triangles = mesh->m_meshletTriangles + meshlet->m_triangleOffset;
+
+    for (int i = 0; i < meshlet->m_vertexCount; ++i)
+    {
+        Vec3 position = mesh->m_weldedVertices[vertices[i]].m_position;
+        vMin = Vec3_Min(vMin, position);
+        vMax = Vec3_Max(vMax, position);
+    }
+
+    meshlet->m_center = Vec3_Scale(Vec3_Add(vMin, vMax), 0.5f);
+    meshlet->m_radius = 0.0f;
+    for (int i = 0; i < meshlet->m_vertexCount; ++i)
+    {
+        Vec3 position = mesh->m_weldedVertices[vertices[i]].m_position;
+        meshlet->m_radius = fmaxf(meshlet->m_radius, Vec3_Length(Vec3_Sub(position, meshlet->m_center)));
+    }
+
+    // Cône des normales : axe moyen et plus grand écart à cet axe
+    Vec3 normalSum = Vec3_Zero;
+    for (int i = 0; i < meshlet->m_triangleCount; ++i)
+    {
+        normalSum = Vec3_Add(normalSum, builder->m_normals[triangles[i]]);
+    }
+
+    float length = Vec3_Length(normalSum);
+    Vec3 axis = (length > 0.0f) ? Vec3_Scale(normalSum, 1.0f / length) : Vec3_Zero;
+    float minDot = 1.0f;
+    for (int i = 0; i < meshlet->m_triangleCount; ++i)
+    {
+        Vec3 normal = builder->m_normals[triangles[i]];
+        if (Vec3_Dot(normal, normal) > 0.0f)
+        {
+            minDot = fminf(minDot, Vec3_Dot(normal, axis));
+        }
+    }
+
+    meshlet->m_coneAxis = axis;
+    if (length <= 0.0f || minDot <= 0.0f)
+    {
+        // Cône de plus de 180 degrés : le meshlet n'est jamais entièrement de dos
+        meshlet->m_coneCutoff = 1.0f;
+    }
+    else
+    {
+        // cos(angle + 90 degrés) = -sin(angle)
+        meshlet->m_coneCutoff = sqrtf(1.0f - minDot * minDot);
+    }
+}
+
+int Meshlet_Build(Mesh *mesh)
+{
+    MeshletBuilder builder = { 0 };
+    Meshlet *meshlets = NULL;
+    int *meshletVertices = NULL;
+    int *meshletTriangles = NULL;
+    Uint8 *meshletIndices = NULL;
+
+    int vertexCount = mesh->m_weldedCount;
+    int triangleCount = mesh->m_triangleCount;
+    int i;
+
+    assert(mesh->m_weldedVertices && mesh->m_indices);
+
+    builder.m_vertexCount = vertexCount;
+    builder.m_triangleCount = triangleCount;
+    builder.m_positionCount = mesh->m_vertexCount;
+    builder.m_indices = mesh->m_indices;
+    builder.m_triangles = mesh->m_triangles;
+
+    int capacity = Int_Max(vertexCount, 1);
+    int triangleCapacity = Int_Max(triangleCount, 1);
+
+    // Dans le pire des cas, chaque meshlet ne contient qu'un triangle
+    builder.m_normals = (Vec3 *)calloc(triangleCapacity, sizeof(Vec3));
+    builder.m_adjacencyFirst = (int *)calloc(mesh->m_vertexCount + 1, sizeof(int));
+    builder.m_adjacency = (int *)calloc(3 * triangleCapacity, sizeof(int));
+    builder.m_used = (bool *)calloc(triangleCapacity, sizeof(bool));
+    builder.m_candidateStamps = (int *)calloc(triangleCapacity, sizeof(int));
+    builder.m_localIndices = (int *)calloc(capacity, sizeof(int));
+    builder.m_candidates = (int *)calloc(triangleCapacity, sizeof(int));
+    meshlets = (Meshlet *)calloc(triangleCapacity, sizeof(Meshlet));
+    meshletVertices = (int *)calloc(3 * triangleCapacity, sizeof(int));
+    meshletTriangles = (int *)calloc(triangleCapacity, sizeof(int));
+    meshletIndices = (Uint8 *)calloc(3 * triangleCapacity, sizeof(Uint8));
+
+    if (!builder.m_normals || !builder.m_adjacencyFirst || !builder.m_adjacency ||
+        !builder.m_used || !builder.m_candidateStamps || !builder.m_localIndices ||
+        !builder.m_candidates || !meshlets || !meshletVertices || !meshletTriangles ||
+        !meshletIndices)
+    {
+        goto ERROR_LABEL;
+    }
+
+    #pragma omp parallel for
+    for (i = 0; i < triangleCount; ++i)
+    {
+        const int *triangle = mesh->m_indices + 3 * i;
+        Vec3 p0 = mesh->m_weldedVertices[triangle[0]].m_position;
+        Vec3 p1 = mesh->m_weldedVertices[triangle[1]].m_position;
+        Vec3 p2 = mesh->m_weldedVertices[triangle[2]].m_position;
+
+        // Même orientation que le test d'aire du rendu : la normale pointe vers
+        // la caméra lorsque le triangle est vu de face
+        Vec3 normal = Vec3_Cross(Vec3_Sub(p1, p0), Vec3_Sub(p2, p0));
+        float length = Vec3_Length(normal);
+        builder.m_normals[i] = (length > 0.0f) ? Vec3_Scale(normal, 1.0f / length) : Vec3_Zero;
+    }
+
+    for (i = 0; i < triangleCount; ++i)
+    {
+        builder.m_candidateStamps[i] = -1;
+    }
+    for (i = 0; i < vertexCount; ++i)
+    {
+        builder.m_localIndices[i] = -1;
+    }
+
+    MeshletBuilder_BuildAdjacency(&builder);
+
+    // Les tableaux des meshlets sont remplis pendant la construction
+    mesh->m_meshlets = meshlets;
+    mesh->m_meshletVertices = meshletVertices;
+    mesh->m_meshletTriangles = meshletTriangles;
+    mesh->m_meshletIndices = meshletIndices;
+
+    int meshletCount = 0;
+    int vertexOffset = 0;
+    int triangleOffset = 0;
+    int seed = 0;
+    while (true)
+    {
+        // Premier triangle non utilisé, dans l'ordre du fichier
+        while (seed < triangleCount && builder.m_used[seed])
+            seed++;
+        if (seed >= triangleCount)
+            break;
+
+        Meshlet *meshlet = &meshlets[meshletCount];
+        meshlet->m_vertexOffset = vertexOffset;
+        meshlet->m_triangleOffset = triangleOffset;
+        builder.m_candidateCount = 0;
+
+        Vec3 normalSum = Vec3_Zero;
+        int triangle = seed;
+        while (triangle >= 0)
+        {
+            MeshletBuilder_AddTriangle(&builder, mesh, meshlet, triangle);
+            normalSum = Vec3_Add(normalSum, builder.m_normals[triangle]);
+
+            if (meshlet->m_triangleCount >= MESH_MESHLET_MAX_TRIANGLES)
+                break;
+
+            triangle = MeshletBuilder_SelectTriangle(&builder, meshlet, normalSum);
+        }
+
+        Meshlet_ComputeBounds(mesh, &builder, meshlet);
+
+        for (int j = 0; j < meshlet->m_vertexCount; ++j)
+        {
+            builder.m_localIndices[meshletVertices[vertexOffset + j]] = -1;
+        }
+        vertexOffset += meshlet->m_vertexCount;
+        triangleOffset += meshlet->m_triangleCount;
+        meshletCount++;
+    }
+
+    // Ajuste les tableaux à leur taille réelle
+    Meshlet *newMeshlets = (Meshlet *)realloc(meshlets, Int_Max(meshletCount, 1) * sizeof(Meshlet));
+    if (newMeshlets) meshlets = newMeshlets;
+    int *newVertices = (int *)realloc(meshletVertices, Int_Max(vertexOffset, 1) * sizeof(int));
+    if (newVertices) meshletVertices = newVertices;
+
+    mesh->m_meshletCount = meshletCount;
+    mesh->m_meshlets = meshlets;
+    mesh->m_meshletVertexCount = vertexOffset;
+    mesh->m_meshletVertices = meshletVertices;
+
+    free(builder.m_normals);
+    free(builder.m_adjacencyFirst);
+    free(builder.m_adjacency);
+    free(builder.m_used);
+    free(builder.m_candidateStamps);
+    free(builder.m_localIndices);
+    free(builder.m_candidates);
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - Meshlet_Build()\n");
+    assert(false);
+    free(builder.m_normals);
+    free(builder.m_adjacencyFirst);
+    free(builder.m_adjacency);
+    free(builder.m_used);
+    free(builder.m_candidateStamps);
+    free(builder.m_localIndices);
+    free(builder.m_candidates);
+    free(meshlets);
+    free(meshletVertices);
+    free(meshletTriangles);
+    free(meshletIndices);
+    return EXIT_FAILURE;
+}
+
+/// @brief Clé de tri d'un meshlet pour Meshlet_BuildOrders().
+typedef struct MeshletOrderKey_s
+{
+    float m_depth;
+    int   m_index;
+} MeshletOrderKey;
+
+static int Meshlet_CompareOrderKeys(const void *a, const void *b)
+{
+    const MeshletOrderKey *key1 = (const MeshletOrderKey *)a;
+    const MeshletOrderKey *key2 = (const MeshletOrderKey *)b;
+
+    // Les égalités sont départagées par les indices : le résultat ne dépend pas de qsort
+    if (key1->m_depth != key2->m_depth)
+        return key1->m_depth < key2->m_depth ? -1 : 1;
+    return (key1->m_index > key2->m_index) - (key1->m_index < key2->m_index);
+}
+
+/// @brief Renvoie la direction de vue (non normalisée) associée à un ordre des meshlets.
+static Vec3 Meshlet_GetOrderDirection(int order)
+{
+    // Les 27 points de {-1, 0, 1}^3 privés du centre (indice 13)
+    int code = (order < 13) ? order : order + 1;
+    return Vec3_Set(
+        (float)(code % 3 - 1),
+        (float)(code / 3 % 3 - 1),
+        (float)(code / 9 - 1));
+}
+
+int Meshlet_BuildOrders(Mesh *mesh)
+{
+    int meshletCount = mesh->m_meshletCount;
+    int *orders = NULL;
+    MeshletOrderKey *keys = NULL;
+    int i;
+
+    free(mesh->m_meshletOrders);
+    mesh->m_meshletOrders = NULL;
+
+    if (meshletCount == 0)
+        return EXIT_SUCCESS;
+
+    assert(mesh->m_submeshes);
+
+    orders = (int *)calloc((size_t)MESHLET_ORDER_COUNT * meshletCount, sizeof(int));
+    keys = (MeshletOrderKey *)calloc((size_t)MESHLET_ORDER_COUNT * meshletCount, sizeof(MeshletOrderKey));
+    if (!orders || !keys) goto ERROR_LABEL;
+
+    #pragma omp parallel for
+    for (i = 0; i < MESHLET_ORDER_COUNT; ++i)
+    {
+        Vec3 direction = Vec3_Normalize(Meshlet_GetOrderDirection(i));
+        MeshletOrderKey *orderKeys = keys + (size_t)i * meshletCount;
+        int *order = orders + (size_t)i * meshletCount;
+
+        // Profondeur du point de la sphère englobante le plus proche de la caméra
+        for (int j = 0; j < meshletCount; ++j)
+        {
+            Meshlet *meshlet = &mesh->m_meshlets[j];
+            orderKeys[j].m_depth = Vec3_Dot(meshlet->m_center, direction) - meshlet->m_radius;
+            orderKeys[j].m_index = j;
+        }
+
+        // Les meshlets restent dans leur sous-mesh (voir Mesh_BuildSubmeshes())
+        for (int s = 0; s < mesh->m_submeshCount; ++s)
+        {
+            MeshSubmesh *submesh = &mesh->m_submeshes[s];
+            qsort(orderKeys + submesh->m_meshletOffset, submesh->m_meshletCount,
+                sizeof(MeshletOrderKey), Meshlet_CompareOrderKeys);
+        }
+
+        for (int j = 0; j < meshletCount; ++j)
+        {
+            order[j] = orderKeys[j].m_index;
+        }
+    }
+
+    mesh->m_meshletOrders = orders;
+    free(keys);
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - Meshlet_BuildOrders()\n");
+    assert(false);
+    free(orders);
+    free(keys);
+    return EXIT_FAILURE;
+}
+
+const int *Meshlet_GetOrder(Mesh *mesh, Vec3 viewDirection)
+{
+    if (!mesh->m_meshletOrders)
+        return NULL;
+
+    // Direction précalculée la plus proche (les directions ne sont pas normalisées)
+    int best = 0;
+    float bestCos = -INFINITY;
+    for (int i = 0; i < MESHLET_ORDER_COUNT; ++i)
+    {
+        Vec3 direction = Meshlet_GetOrderDirection(i);
+        float cosine = Vec3_Dot(direction, viewDirection) / Vec3_Length(direction);
+        if (cosine > bestCos)
+        {
+            bestCos = cosine;
+            best = i;
+        }
+    }
+    return mesh->m_meshletOrders + (size_t)best * mesh->m_meshletCount;
+}
@@ -0,0 +1,68 @@
+﻿#ifndef _MESHLET_H_
+#define _MESHLET_H_
+
+/// @file Meshlet.h
+/// @defgroup Meshlet
+/// @{
+
+#include "Settings.h"
+#include "Mesh.h"
+
+/// @brief Poids de l'écart entre la normale d'un triangle et la normale moyenne d'un meshlet
+/// lors du choix du triangle suivant (par rapport au nombre de nouveaux sommets).
+/// Des triangles d'orientations proches donnent des cônes de normales étroits.
+#define MESHLET_CONE_WEIGHT 0.5f
+
+/// @brief Cosinus de l'écart maximal (30 degrés) entre la normale d'un triangle ajouté
+/// et la normale moyenne du meshlet. Les modèles peu détaillés sont très courbés :
+/// sans cette limite, les cônes dépassent 90 degrés et les meshlets ne sont jamais rejetés.
+#define MESHLET_CONE_MIN_DOT 0.866f
+
+/// @brief Découpe le mesh complet en meshlets (m_meshlets) et calcule leurs bornes.
+/// Chaque meshlet est agrandi à partir d'un triangle en ajoutant le triangle voisin
+/// qui ajoute le moins de sommets, jusqu'à MESH_MESHLET_MAX_VERTICES sommets,
+/// MESH_MESHLET_MAX_TRIANGLES triangles ou faute de voisin assez bien orienté
+/// (voir MESHLET_CONE_MIN_DOT). Un meshlet ne contient que des triangles d'un même matériau.
+/// Les sommets soudés doivent avoir été calculés (voir Mesh_Weld()).
+/// @param[in,out] mesh le mesh.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int Meshlet_Build(Mesh *mesh);
+
+/// @brief Nombre de directions de vue pour lesquelles l'ordre des meshlets est précalculé :
+/// les 26 directions du centre d'un cube vers ses faces, ses arêtes et ses coins.
+#define MESHLET_ORDER_COUNT 26
+
+/// @brief Précalcule l'ordre de rendu des meshlets pour chaque direction de vue
+/// (m_meshletOrders). Dans chaque sous-mesh, les meshlets sont rangés du plus proche au plus
+/// éloigné d'une caméra regardant dans cette direction : les pixels des meshlets suivants
+/// sont alors souvent rejetés par le test de profondeur avant le fragment shader.
+/// Les sous-meshes doivent avoir été calculés (voir Mesh_BuildSubmeshes()).
+/// @param[in,out] mesh le mesh.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int Meshlet_BuildOrders(Mesh *mesh);
+
+/// @brief Renvoie l'ordre précalculé des meshlets le plus adapté à une direction de vue.
+/// @param[in] mesh le mesh.
+/// @param[in] viewDirection la direction de la caméra vers l'objet, dans le repère de l'objet
+/// (pas nécessairement unitaire).
+/// @return Les indices des m_meshletCount meshlets dans l'ordre de rendu, ou NULL si le mesh
+/// n'a pas d'ordre précalculé.
+const int *Meshlet_GetOrder(Mesh *mesh, Vec3 viewDirection);
+
+/// @brief Indique si tous les triangles d'un meshlet sont vus de dos.
+/// @param[in] meshlet le meshlet.
+/// @param[in] cameraPos la position de la caméra dans le repère de l'objet.
+/// @return true si le meshlet peut être ignoré.
+INLINE bool Meshlet_IsBackFacing(const Meshlet *meshlet, Vec3 cameraPos)
+{
+    // Cône des normales élargi de 90 degrés : toute la sphère englobante doit
+    // se trouver derrière tous les triangles
+    Vec3 direction = Vec3_Sub(meshlet->m_center, cameraPos);
+    return
+        Vec3_Dot(direction, meshlet->m_coneAxis) >=
+        meshlet->m_coneCutoff * Vec3_Length(direction) + meshlet->m_radius;
+}
+
+/// @}
+
+#endif
@@ -0,0 +1,1030 @@
+﻿#include "ObjParser.h"
+#include "Tools.h"
+
+#include <locale.h>
+
+//-------------------------------------------------------------------------------------------------
+// Tableaux
+
+/// @brief Garantit qu'un tableau peut contenir au moins un élément supplémentaire.
+/// La capacité est doublée si nécessaire.
+static int ObjData_Reserve(void **array, int *capacity, int count, size_t elementSize)
+{
+    if (count < *capacity)
+        return EXIT_SUCCESS;
+
+    int newCapacity = Int_Max(*capacity << 1, 1 << 12);
+    void *newArray = realloc(*array, newCapacity * elementSize);
+    if (!newArray) goto ERROR_LABEL;
+
+    *array = newArray;
+    *capacity = newCapacity;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - ObjData_Reserve()\n");
+    assert(false);
+    return EXIT_FAILURE;
+}
+
+static INLINE int ObjData_AddVertex(ObjData *data, Vec3 vertex)
+{
+    int exitStatus = ObjData_Reserve(
+        (void **)&data->m_vertices, &data->m_vertexCapacity, data->m_vertexCount, sizeof(Vec3));
+    if (exitStatus != EXIT_SUCCESS) return exitStatus;
+
+    data->m_vertices[data->m_vertexCount++] = vertex;
+    return EXIT_SUCCESS;
+}
+
+static INLINE int ObjData_AddNormal(ObjData *data, Vec3 normal)
+{
+    int exitStatus = ObjData_Reserve(
+        (void **)&data->m_normals, &data->m_normalCapacity, data->m_normalCount, sizeof(Vec3));
+    if (exitStatus != EXIT_SUCCESS) return exitStatus;
+
+    data->m_normals[data->m_normalCount++] = normal;
+    return EXIT_SUCCESS;
+}
+
+static INLINE int ObjData_AddTextUV(ObjData *data, Vec2 textUV)
+{
+    int exitStatus = ObjData_Reserve(
+        (void **)&data->m_textUVs, &data->m_textUVCapacity, data->m_textUVCount, sizeof(Vec2));
+    if (exitStatus != EXIT_SUCCESS) return exitStatus;
+
+    data->m_textUVs[data->m_textUVCount++] = textUV;
+    return EXIT_SUCCESS;
+}
+
+/// @brief Découpe une face en triangles (en éventail) et les ajoute.
+static int ObjData_AddFace(
+    ObjData *data, int pointCount,
+    int *vertexIndices, int *normalIndices, int *textUVIndices, int materialIndex)
+{
+    if (pointCount > OBJ_MAX_FACE_POINTS)
+    {
+        printf("WARNING - Mesh_loadObj()\n");
+        printf("          Too much points in one face\n");
+        pointCount = OBJ_MAX_FACE_POINTS;
+    }
+
+    for (int i = 1; i < pointCount - 1; i++)
+    {
+        int exitStatus = ObjData_Reserve(
+            (void **)&data->m_triangles, &data->m_triangleCapacity,
+            data->m_triangleCount, sizeof(Triangle));
+        if (exitStatus != EXIT_SUCCESS) return exitStatus;
+
+        Triangle *triangle = &data->m_triangles[data->m_triangleCount++];
+
+        triangle->m_vertexIndices[0] = vertexIndices[0];
+        triangle->m_vertexIndices[1] = vertexIndices[i];
+        triangle->m_vertexIndices[2] = vertexIndices[i + 1];
+
+        triangle->m_normalIndices[0] = normalIndices[0];
+        triangle->m_normalIndices[1] = normalIndices[i];
+        triangle->m_normalIndices[2] = normalIndices[i + 1];
+
+        triangle->m_textUVIndices[0] = textUVIndices[0];
+        triangle->m_textUVIndices[1] = textUVIndices[i];
+        triangle->m_textUVIndices[2] = textUVIndices[i + 1];
+
+        triangle->m_materialIndex = materialIndex;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/// @brief Renvoie l'indice d'un nom de matériau en l'ajoutant si nécessaire.
+/// @return L'indice du nom ou -1 en cas d'erreur.
+static int ObjData_GetMaterialName(ObjData *data, const char *name, size_t length)
+{
+    if (length >= MATERIAL_NAME_SIZE)
+        length = MATERIAL_NAME_SIZE - 1;
+
+    for (int i = 0; i < data->m_materialNameCount; ++i)
+    {
+        char *materialName = data->m_materialNames[i];
+        if (strncmp(materialName, name, length) == 0 && materialName[length] == '\0')
+            return i;
+    }
+
+    int exitStatus = ObjData_Reserve(
+        (void **)&data->m_materialNames, &data->m_materialNameCapacity,
+        data->m_materialNameCount, MATERIAL_NAME_SIZE);
+    if (exitStatus != EXIT_SUCCESS) return -1;
+
+    char *materialName = data->m_materialNames[data->m_materialNameCount];
+    memcpy(materialName, name, length);
+    materialName[length] = '\0';
+
+    return data->m_materialNameCount++;
+}
+
+static void ObjData_SetMaterialLib(ObjData *data, const char *name, size_t length)
+{
+    if (length >= OBJ_NAME_SIZE)
+        length = OBJ_NAME_SIZE - 1;
+
+    memcpy(data->m_materialLib, name, length);
+    data->m_materialLib[length] = '\0';
+}
+
+void ObjData_Free(ObjData *data)
+{
+    if (!data) return;
+
+    free(data->m_vertices);
+    free(data->m_normals);
+    free(data->m_textUVs);
+    free(data->m_triangles);
+    free(data->m_materialNames);
+
+    memset(data, 0, sizeof(ObjData));
+}
+
+bool ObjData_Equals(ObjData *data0, ObjData *data1)
+{
+    if (data0->m_vertexCount != data1->m_vertexCount ||
+        data0->m_normalCount != data1->m_normalCount ||
+        data0->m_textUVCount != data1->m_textUVCount ||
+        data0->m_triangleCount != data1->m_triangleCount ||
+        data0->m_materialNameCount != data1->m_materialNameCount)
+    {
+        return false;
+    }
+
+    if (memcmp(data0->m_vertices, data1->m_vertices, data0->m_vertexCount * sizeof(Vec3)) ||
+        memcmp(data0->m_normals, data1->m_normals, data0->m_normalCount * sizeof(Vec3)) ||
+        memcmp(data0->m_textUVs, data1->m_textUVs, data0->m_textUVCount * sizeof(Vec2)) ||
+        memcmp(data0->m_triangles, data1->m_triangles, data0->m_triangleCount * sizeof(Triangle)))
+    {
+        return false;
+    }
+
+    for (int i = 0; i < data0->m_materialNameCount; ++i)
+    {
+        if (strcmp(data0->m_materialNames[i], data1->m_materialNames[i]) != 0)
+            return false;
+    }
+
+    return strcmp(data0->m_materialLib, data1->m_materialLib) == 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Analyseur rapide
+
+static INLINE bool ObjParser_IsBlank(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+static INLINE bool ObjParser_IsEndOfLine(char c)
+{
+    return c == '\n' || c == '\r' || c == '\0';
+}
+
+static INLINE bool ObjParser_IsDigit(char c)
+{
+    return (unsigned)(c - '0') < 10;
+}
+
+/// @brief Indique si la position est à la fin d'un mot (blanc, fin de ligne ou fin du buffer).
+static INLINE bool ObjParser_IsSeparator(const char *p, const char *end)
+{
+    return p >= end || ObjParser_IsBlank(*p) || ObjParser_IsEndOfLine(*p);
+}
+
+static INLINE const char *ObjParser_SkipBlanks(const char *p, const char *end)
+{
+    while (p < end && ObjParser_IsBlank(*p))
+        p++;
+    return p;
+}
+
+static INLINE const char *ObjParser_SkipWord(const char *p, const char *end)
+{
+    while (!ObjParser_IsSeparator(p, end))
+        p++;
+    return p;
+}
+
+static INLINE const char *ObjParser_SkipLine(const char *p, const char *end)
+{
+    while (p < end && !ObjParser_IsEndOfLine(*p))
+        p++;
+    return p;
+}
+
+/// @brief Indique si la ligne commence par un mot-clé donné (suivi d'un séparateur).
+static INLINE bool ObjParser_IsKeyword(const char *p, const char *end, const char *keyword)
+{
+    size_t length = strlen(keyword);
+    if ((size_t)(end - p) < length || memcmp(p, keyword, length) != 0)
+        return false;
+    return ObjParser_IsSeparator(p + length, end);
+}
+
+/// @brief Convertit un mot en flottant comme strtod() dans la locale "C", quelle que soit
+/// la locale du programme : le résultat ne dépend pas du séparateur décimal de la locale.
+static float ObjParser_StringToFloat(const char *word)
+{
+    char buffer[64] = { 0 };
+    int length = Int_Min((int)strlen(word), (int)sizeof(buffer) - 1);
+    memcpy(buffer, word, length);
+
+    // strtod() attend le séparateur décimal de la locale courante : celui de la locale
+    // (',' par exemple) termine le nombre, comme dans la locale "C", puis le point du
+    // fichier est remplacé par ce séparateur
+    char decimalPoint = localeconv()->decimal_point[0];
+    if (decimalPoint != '.')
+    {
+        char *separator = strchr(buffer, decimalPoint);
+        if (separator) *separator = '\0';
+
+        for (char *c = buffer; *c != '\0'; ++c)
+        {
+            if (*c == '.') *c = decimalPoint;
+        }
+    }
+
+    return (float)strtod(buffer, NULL);
+}
+
+/// @brief Puissances de 10 représentées exactement par un double.
+static const double g_objPow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+float ObjParser_ParseFloat(const char **cursor, const char *end)
+{
+    const char *start = *cursor;
+    const char *p = start;
+    bool negative = false;
+    Uint64 mantissa = 0;
+    int digitCount = 0;
+    int exponent = 0;
+    bool hasDigit = false;
+
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    // Partie entière puis partie décimale.
+    // Les zéros de tête ne comptent pas dans le nombre de chiffres significatifs.
+    while (p < end && ObjParser_IsDigit(*p))
+    {
+        mantissa = 10 * mantissa + (Uint64)(*p - '0');
+        digitCount += (mantissa != 0);
+        hasDigit = true;
+        p++;
+    }
+    if (p < end && *p == '.')
+    {
+        p++;
+        while (p < end && ObjParser_IsDigit(*p))
+        {
+            mantissa = 10 * mantissa + (Uint64)(*p - '0');
+            digitCount += (mantissa != 0);
+            exponent--;
+            hasDigit = true;
+            p++;
+        }
+    }
+
+    if (hasDigit && p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char *q = p + 1;
+        bool negativeExp = false;
+        int exp = 0;
+        if (q < end && (*q == '-' || *q == '+'))
+        {
+            negativeExp = (*q == '-');
+            q++;
+        }
+        if (q < end && ObjParser_IsDigit(*q))
+        {
+            while (q < end && ObjParser_IsDigit(*q))
+            {
+                if (exp < 10000) exp = 10 * exp + (*q - '0');
+                q++;
+            }
+            exponent += negativeExp ? -exp : exp;
+            p = q;
+        }
+    }
+
+    // Cas rapide (Clinger) : la mantisse et la puissance de 10 sont exactes en double,
+    // le quotient ou le produit est donc correctement arrondi, comme avec atof()
+    // dans la locale "C".
+    if (hasDigit && digitCount <= 19 && mantissa <= (1ULL << 53) &&
+        exponent >= -22 && exponent <= 22 && ObjParser_IsSeparator(p, end))
+    {
+        double value = (double)mantissa;
+        value = (exponent < 0) ? value / g_objPow10[-exponent] : value * g_objPow10[exponent];
+        *cursor = p;
+        return (float)(negative ? -value : value);
+    }
+
+    // Cas général : délègue à strtod() sur une copie du mot, dans la locale "C"
+    // comme le cas rapide
+    char word[64] = { 0 };
+    p = ObjParser_SkipWord(start, end);
+    size_t length = Int_Min((int)(p - start), (int)sizeof(word) - 1);
+    memcpy(word, start, length);
+    *cursor = p;
+
+    return ObjParser_StringToFloat(word);
+}
+
+/// @brief Lit un entier (comme atoi()).
+static INLINE int ObjParser_ParseInt(const char **cursor, const char *end)
+{
+    const char *p = *cursor;
+    bool negative = false;
+    int value = 0;
+
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+    while (p < end && ObjParser_IsDigit(*p))
+    {
+        value = 10 * value + (*p - '0');
+        p++;
+    }
+
+    *cursor = p;
+    return negative ? -value : value;
+}
+
+/// @brief Convertit un indice du fichier obj (à partir de 1, ou négatif) en indice à partir de 0.
+static INLINE int ObjParser_ResolveIndex(int index, int count)
+{
+    return (index < 0) ? count + index : index - 1;
+}
+
+/// @brief Lit au plus trois flottants sur la ligne (les composantes absentes valent 0).
+static const char *ObjParser_ParseVec(const char *p, const char *end, float *values, int size)
+{
+    for (int i = 0; i < size; ++i)
+    {
+        p = ObjParser_SkipBlanks(p, end);
+        if (p >= end || ObjParser_IsEndOfLine(*p))
+        {
+            for (; i < size; ++i)
+                values[i] = 0.0f;
+            break;
+        }
+        values[i] = ObjParser_ParseFloat(&p, end);
+        p = ObjParser_SkipWord(p, end);
+    }
+    return p;
+}
+
+/// @brief Indice de matériau des triangles d'un morceau situés avant son premier usemtl.
+/// Il est remplacé lors de la fusion par le matériau actif à la fin du morceau précédent.
+#define OBJ_INHERITED_MATERIAL (-2)
+
+/// @brief État de l'analyseur pendant la lecture d'un fichier ou d'un morceau de fichier.
+typedef struct ObjParserState_s
+{
+    ObjData *m_data;
+
+    /// @brief Indice (dans m_data->m_materialNames) du matériau actif.
+    int m_materialIndex;
+
+    /// @brief Pour chaque triangle, les indices relatifs (négatifs dans le fichier) à décaler
+    /// lors de la fusion des morceaux : bit 3 * sommet + 0 (position), + 1 (normale), + 2 (uv).
+    /// Vaut NULL pour une analyse séquentielle.
+    Uint16 *m_relativeMasks;
+    int m_relativeMaskCapacity;
+} ObjParserState;
+
+#define OBJ_RELATIVE_VERTEX 1
+#define OBJ_RELATIVE_NORMAL 2
+#define OBJ_RELATIVE_TEXTUV 4
+
+/// @brief Lit une face (v, v/t, v/t/n ou v//n pour chaque sommet) et ajoute ses triangles.
+static int ObjParser_ParseFace(ObjParserState *state, const char **cursor, const char *end)
+{
+    ObjData *data = state->m_data;
+    int vertexIndices[OBJ_MAX_FACE_POINTS];
+    int normalIndices[OBJ_MAX_FACE_POINTS];
+    int textUVIndices[OBJ_MAX_FACE_POINTS];
+    int relativeMasks[OBJ_MAX_FACE_POINTS];
+    int pointCount = 0;
+    const char *p = *cursor;
+
+    while (true)
+    {
+        p = ObjParser_SkipBlanks(p, end);
+        if (p >= end || ObjParser_IsEndOfLine(*p))
+            break;
+
+        int vertex = ObjParser_ParseInt(&p, end);
+        int textUV = 0, normal = 0;
+        bool hasTextUV = false, hasNormal = false;
+        if (p < end && *p == '/')
+        {
+            p++;
+            if (p < end && *p == '/')
+            {
+                p++;
+                normal = ObjParser_ParseInt(&p, end);
+                hasNormal = true;
+            }
+            else
+            {
+                textUV = ObjParser_ParseInt(&p, end);
+                hasTextUV = true;
+                if (p < end && *p == '/')
+                {
+                    p++;
+                    if (!ObjParser_IsSeparator(p, end))
+                    {
+                        normal = ObjParser_ParseInt(&p, end);
+                        hasNormal = true;
+                    }
+                }
+            }
+        }
+        p = ObjParser_SkipWord(p, end);
+
+        if (pointCount < OBJ_MAX_FACE_POINTS)
+        {
+            vertexIndices[pointCount] = ObjParser_ResolveIndex(vertex, data->m_vertexCount);
+            textUVIndices[pointCount] = hasTextUV ?
+                ObjParser_ResolveIndex(textUV, data->m_textUVCount) : -1;
+            normalIndices[pointCount] = hasNormal ?
+                ObjParser_ResolveIndex(normal, data->m_normalCount) : -1;
+            relativeMasks[pointCount] =
+                ((vertex < 0) ? OBJ_RELATIVE_VERTEX : 0) |
+                ((hasNormal && normal < 0) ? OBJ_RELATIVE_NORMAL : 0) |
+                ((hasTextUV && textUV < 0) ? OBJ_RELATIVE_TEXTUV : 0);
+        }
+        pointCount++;
+    }
+
+    *cursor = p;
+
+    int firstTriangle = data->m_triangleCount;
+    int exitStatus = ObjData_AddFace(
+        data, pointCount, vertexIndices, normalIndices, textUVIndices, state->m_materialIndex);
+    if (exitStatus != EXIT_SUCCESS || !state->m_relativeMasks)
+        return exitStatus;
+
+    // Conserve les indices relatifs de chaque triangle (analyse par morceaux)
+    if (data->m_triangleCount > state->m_relativeMaskCapacity)
+    {
+        int capacity = Int_Max(data->m_triangleCapacity, 1 << 12);
+        Uint16 *newMasks = (Uint16 *)realloc(state->m_relativeMasks, capacity * sizeof(Uint16));
+        if (!newMasks) return EXIT_FAILURE;
+
+        state->m_relativeMasks = newMasks;
+        state->m_relativeMaskCapacity = capacity;
+    }
+    for (int i = firstTriangle; i < data->m_triangleCount; ++i)
+    {
+        int k = i - firstTriangle + 1;
+        state->m_relativeMasks[i] = (Uint16)(
+            relativeMasks[0] | (relativeMasks[k] << 3) | (relativeMasks[k + 1] << 6));
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/// @brief Analyse une suite de lignes complètes.
+static int ObjParser_ParseLines(ObjParserState *state, const char *p, const char *end)
+{
+    ObjData *data = state->m_data;
+    int exitStatus = EXIT_SUCCESS;
+
+    while (p < end)
+    {
+        // Passe les caractères blancs et les lignes vides
+        char c = *p;
+        if (ObjParser_IsBlank(c) || ObjParser_IsEndOfLine(c))
+        {
+            p++;
+            continue;
+        }
+
+        switch (c)
+        {
+        case 'v':
+            if (ObjParser_IsSeparator(p + 1, end))
+            {
+                Vec3 vertex;
+                p = ObjParser_ParseVec(p + 1, end, vertex.data, 3);
+                exitStatus = ObjData_AddVertex(data, vertex);
+            }
+            else if (p[1] == 'n' && ObjParser_IsSeparator(p + 2, end))
+            {
+                Vec3 normal;
+                p = ObjParser_ParseVec(p + 2, end, normal.data, 3);
+                exitStatus = ObjData_AddNormal(data, normal);
+            }
+            else if (p[1] == 't' && ObjParser_IsSeparator(p + 2, end))
+            {
+                float values[2];
+                p = ObjParser_ParseVec(p + 2, end, values, 2);
+                exitStatus = ObjData_AddTextUV(data, Vec2_Set(values[0], values[1]));
+            }
+            break;
+
+        case 'f':
+            if (ObjParser_IsSeparator(p + 1, end))
+            {
+                p++;
+                exitStatus = ObjParser_ParseFace(state, &p, end);
+            }
+            break;
+
+        case 'u':
+            if (ObjParser_IsKeyword(p, end, "usemtl"))
+            {
+                const char *name = ObjParser_SkipBlanks(p + 6, end);
+                p = ObjParser_SkipWord(name, end);
+                if (p > name)
+                {
+                    state->m_materialIndex = ObjData_GetMaterialName(data, name, p - name);
+                    if (state->m_materialIndex < 0) exitStatus = EXIT_FAILURE;
+                }
+            }
+            break;
+
+        case 'm':
+            if (ObjParser_IsKeyword(p, end, "mtllib"))
+            {
+                const char *name = ObjParser_SkipBlanks(p + 6, end);
+                p = ObjParser_SkipWord(name, end);
+                if (p > name)
+                {
+                    ObjData_SetMaterialLib(data, name, p - name);
+                }
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        if (exitStatus != EXIT_SUCCESS) return exitStatus;
+
+        p = ObjParser_SkipLine(p, end);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int ObjParser_Parse(const char *buffer, long size, ObjData *data)
+{
+    memset(data, 0, sizeof(ObjData));
+
+    ObjParserState state = { 0 };
+    state.m_data = data;
+    state.m_materialIndex = -1;
+
+    int exitStatus = ObjParser_ParseLines(&state, buffer, buffer + size);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - ObjParser_Parse()\n");
+    assert(false);
+    ObjData_Free(data);
+    return EXIT_FAILURE;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Analyse par morceaux
+
+/// @brief Morceau de fichier analysé indépendamment des autres.
+typedef struct ObjChunk_s
+{
+    const char *m_begin;
+    const char *m_end;
+    ObjData m_data;
+    ObjParserState m_state;
+    int m_exitStatus;
+
+    /// @brief Position des éléments du morceau dans le résultat final.
+    int m_vertexBase;
+    int m_normalBase;
+    int m_textUVBase;
+    int m_triangleBase;
+
+    /// @brief Indice final de chaque nom de matériau du morceau.
+    int *m_materialRemap;
+
+    /// @brief Matériau actif au début du morceau (indice final).
+    int m_inheritedMaterial;
+} ObjChunk;
+
+/// @brief Copie un morceau dans le résultat final en décalant ses indices.
+static void ObjChunk_Merge(ObjChunk *chunk, ObjData *data)
+{
+    ObjData *chunkData = &chunk->m_data;
+
+    memcpy(data->m_vertices + chunk->m_vertexBase,
+        chunkData->m_vertices, chunkData->m_vertexCount * sizeof(Vec3));
+    memcpy(data->m_normals + chunk->m_normalBase,
+        chunkData->m_normals, chunkData->m_normalCount * sizeof(Vec3));
+    memcpy(data->m_textUVs + chunk->m_textUVBase,
+        chunkData->m_textUVs, chunkData->m_textUVCount * sizeof(Vec2));
+
+    for (int i = 0; i < chunkData->m_triangleCount; ++i)
+    {
+        Triangle triangle = chunkData->m_triangles[i];
+        int mask = chunk->m_state.m_relativeMasks[i];
+
+        for (int j = 0; j < 3; ++j, mask >>= 3)
+        {
+            if (mask & OBJ_RELATIVE_VERTEX) triangle.m_vertexIndices[j] += chunk->m_vertexBase;
+            if (mask & OBJ_RELATIVE_NORMAL) triangle.m_normalIndices[j] += chunk->m_normalBase;
+            if (mask & OBJ_RELATIVE_TEXTUV) triangle.m_textUVIndices[j] += chunk->m_textUVBase;
+        }
+
+        triangle.m_materialIndex = (triangle.m_materialIndex == OBJ_INHERITED_MATERIAL) ?
+            chunk->m_inheritedMaterial : chunk->m_materialRemap[triangle.m_materialIndex];
+
+        data->m_triangles[chunk->m_triangleBase + i] = triangle;
+    }
+}
+
+int ObjParser_ParseChunks(const char *buffer, long size, int chunkCount, ObjData *data)
+{
+    ObjChunk *chunks = NULL;
+
+    memset(data, 0, sizeof(ObjData));
+
+    chunkCount = Int_Max(chunkCount, 1);
+    chunks = (ObjChunk *)calloc(chunkCount, sizeof(ObjChunk));
+    if (!chunks) goto ERROR_LABEL;
+
+    // Découpe le buffer au début des lignes
+    const char *end = buffer + size;
+    const char *begin = buffer;
+    for (int i = 0; i < chunkCount; ++i)
+    {
+        const char *chunkEnd = buffer + (long)((double)size * (i + 1) / chunkCount);
+        if (chunkEnd < begin) chunkEnd = begin;
+        while (chunkEnd < end && *chunkEnd != '\n')
+            chunkEnd++;
+        if (chunkEnd < end) chunkEnd++;
+        if (i == chunkCount - 1) chunkEnd = end;
+
+        chunks[i].m_begin = begin;
+        chunks[i].m_end = chunkEnd;
+        begin = chunkEnd;
+    }
+
+    // Analyse les morceaux en parallèle
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < chunkCount; ++i)
+    {
+        ObjChunk *chunk = &chunks[i];
+        chunk->m_state.m_data = &chunk->m_data;
+        chunk->m_state.m_materialIndex = OBJ_INHERITED_MATERIAL;
+        chunk->m_state.m_relativeMasks = (Uint16 *)calloc(1 << 12, sizeof(Uint16));
+        chunk->m_state.m_relativeMaskCapacity = 1 << 12;
+
+        chunk->m_exitStatus = chunk->m_state.m_relativeMasks ?
+            ObjParser_ParseLines(&chunk->m_state, chunk->m_begin, chunk->m_end) : EXIT_FAILURE;
+    }
+
+    // Position de chaque morceau dans le résultat (somme préfixe des tailles),
+    // noms des matériaux dans leur ordre d'apparition et matériau actif au début de chaque morceau
+    int currentMaterial = -1;
+    for (int i = 0; i < chunkCount; ++i)
+    {
+        ObjChunk *chunk = &chunks[i];
+        ObjData *chunkData = &chunk->m_data;
+        if (chunk->m_exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+        chunk->m_vertexBase = data->m_vertexCount;
+        chunk->m_normalBase = data->m_normalCount;
+        chunk->m_textUVBase = data->m_textUVCount;
+        chunk->m_triangleBase = data->m_triangleCount;
+        data->m_vertexCount += chunkData->m_vertexCount;
+        data->m_normalCount += chunkData->m_normalCount;
+        data->m_textUVCount += chunkData->m_textUVCount;
+        data->m_triangleCount += chunkData->m_triangleCount;
+
+        chunk->m_materialRemap = (int *)calloc(Int_Max(chunkData->m_materialNameCount, 1), sizeof(int));
+        if (!chunk->m_materialRemap) goto ERROR_LABEL;
+
+        for (int j = 0; j < chunkData->m_materialNameCount; ++j)
+        {
+            char *name = chunkData->m_materialNames[j];
+            chunk->m_materialRemap[j] = ObjData_GetMaterialName(data, name, strlen(name));
+            if (chunk->m_materialRemap[j] < 0) goto ERROR_LABEL;
+        }
+
+        chunk->m_inheritedMaterial = currentMaterial;
+        if (chunk->m_state.m_materialIndex != OBJ_INHERITED_MATERIAL)
+        {
+            currentMaterial = chunk->m_materialRemap[chunk->m_state.m_materialIndex];
+        }
+
+        if (chunkData->m_materialLib[0] != '\0')
+        {
+            memcpy(data->m_materialLib, chunkData->m_materialLib, OBJ_NAME_SIZE);
+        }
+    }
+
+    data->m_vertexCapacity = data->m_vertexCount;
+    data->m_normalCapacity = data->m_normalCount;
+    data->m_textUVCapacity = data->m_textUVCount;
+    data->m_triangleCapacity = data->m_triangleCount;
+    data->m_vertices = (Vec3 *)malloc(Int_Max(data->m_vertexCount, 1) * sizeof(Vec3));
+    data->m_normals = (Vec3 *)malloc(Int_Max(data->m_normalCount, 1) * sizeof(Vec3));
+    data->m_textUVs = (Vec2 *)malloc(Int_Max(data->m_textUVCount, 1) * sizeof(Vec2));
+    data->m_triangles = (Triangle *)malloc(Int_Max(data->m_triangleCount, 1) * sizeof(Triangle));
+    if (!data->m_vertices || !data->m_normals || !data->m_textUVs || !data->m_triangles)
+        goto ERROR_LABEL;
+
+    // Fusionne les morceaux en parallèle
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < chunkCount; ++i)
+    {
+        ObjChunk_Merge(&chunks[i], data);
+    }
+
+    for (int i = 0; i < chunkCount; ++i)
+    {
+        ObjData_Free(&chunks[i].m_data);
+        free(chunks[i].m_state.m_relativeMasks);
+        free(chunks[i].m_materialRemap);
+    }
+    free(chunks);
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - ObjParser_ParseChunks()\n");
+    assert(false);
+    if (chunks)
+    {
+        for (int i = 0; i < chunkCount; ++i)
+        {
+            ObjData_Free(&chunks[i].m_data);
+            free(chunks[i].m_state.m_relativeMasks);
+            free(chunks[i].m_materialRemap);
+        }
+        free(chunks);
+    }
+    ObjData_Free(data);
+    return EXIT_FAILURE;
+}
+
+int ObjParser_ParseParallel(const char *buffer, long size, ObjData *data)
+{
+    // Un morceau par thread, sans descendre sous une taille minimale
+    int chunkCount = (int)Int_Min(omp_get_max_threads(), (int)(size / OBJ_MIN_CHUNK_SIZE));
+    if (chunkCount <= 1)
+        return ObjParser_Parse(buffer, size, data);
+
+    return ObjParser_ParseChunks(buffer, size, chunkCount, data);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Analyseur de référence
+
+static void ObjParser_FillVec3(Vec3 *v, int n)
+{
+    switch (n)
+    {
+    case 0: v->x = 0.f;
+    case 1: v->y = 0.f;
+    case 2: v->z = 0.f;
+    }
+}
+
+int ObjParser_ParseReference(const char *buffer, long size, ObjData *data)
+{
+    char *curLine = NULL;
+    int lineCapacity = 64;
+    int vertexIndices[OBJ_MAX_FACE_POINTS];
+    int normalIndices[OBJ_MAX_FACE_POINTS];
+    int textUVIndices[OBJ_MAX_FACE_POINTS];
+    int materialIndex = -1;
+
+    memset(data, 0, sizeof(ObjData));
+
+    curLine = (char *)calloc(lineCapacity, sizeof(char));
+    if (!curLine) { assert(false); goto ERROR_LABEL; }
+
+    // Parse le buffer
+    int offset = 0;
+    int lineNb = 0;
+    do
+    {
+        int exitStatus = Buffer_ReadLine(buffer, &offset, size, &curLine, &lineCapacity);
+        if (exitStatus == EXIT_FAILURE) { assert(false); goto ERROR_LABEL; }
+        if (curLine[0] == '\0') continue;
+
+        lineNb++;
+
+        char* context = NULL;
+        char* word = strtok_s(curLine, " ", &context);
+        Vec3 vec;
+
+        if (!word || strlen(word) < 1) continue;
+
+        if (word[0] == 'v')
+        {
+            if (word[1] == '\0')
+            {
+                //---------------------------------------------------------------------------------
+                // Vertex
+
+                int i = 0;
+                while ((word = strtok_s(NULL, " ", &context)) && i < 3)
+                {
+                    vec.data[i++] = ObjParser_StringToFloat(word);
+                }
+                ObjParser_FillVec3(&vec, i);
+
+                exitStatus = ObjData_AddVertex(data, vec);
+                if (exitStatus != EXIT_SUCCESS) { assert(false); goto ERROR_LABEL; }
+            }
+            else if (word[1] == 'n')
+            {
+                if (word[2] != '\0') break;
+
+                //---------------------------------------------------------------------------------
+                // Normale
+
+                int i = 0;
+                while ((word = strtok_s(NULL, " ", &context)) && i < 3)
+                {
+                    vec.data[i++] = ObjParser_StringToFloat(word);
+                }
+                ObjParser_FillVec3(&vec, i);
+
+                exitStatus = ObjData_AddNormal(data, vec);
+                if (exitStatus != EXIT_SUCCESS) { assert(false); goto ERROR_LABEL; }
+            }
+            else if (word[1] == 't')
+            {
+                if (word[2] != '\0') break;
+
+                //---------------------------------------------------------------------------------
+                // Coordonnée de texture
+                Vec2 textUV = { 0 };
+
+                if (word = strtok_s(NULL, " ", &context))
+                {
+                    textUV.x = ObjParser_StringToFloat(word);
+                }
+                if (word = strtok_s(NULL, " ", &context))
+                {
+                    textUV.y = ObjParser_StringToFloat(word);
+                }
+
+                exitStatus = ObjData_AddTextUV(data, textUV);
+                if (exitStatus != EXIT_SUCCESS) { assert(false); goto ERROR_LABEL; }
+            }
+        }
+        else if (word[0] == 'f')
+        {
+            if (word[1] != '\0') break;
+
+            //-------------------------------------------------------------------------------------
+            // Faces
+
+            // Parse la face
+            int nbPoints = 0;
+            while (word = strtok_s(NULL, " ", &context))
+            {
+                int indices[3] = { 0 };
+                if (strstr(word, "//"))
+                {
+                    // Vertex normal (sans texture)
+                    char *contextSlash = NULL;
+                    char* token = strtok_s(word, "/", &contextSlash);
+                    int i = 0;
+                    while (token)
+                    {
+                        if (i < 3)
+                        {
+                            indices[i] = atoi(token) - 1;
+                        }
+                        token = strtok_s(NULL, "/", &contextSlash);
+                        i++;
+                    }
+                    switch (i)
+                    {
+                    case 2:
+                        // [Vertex, normal]
+                        if (nbPoints < OBJ_MAX_FACE_POINTS)
+                        {
+                            vertexIndices[nbPoints] = indices[0];
+                            normalIndices[nbPoints] = indices[1];
+                            textUVIndices[nbPoints] = -1;
+                        }
+                        break;
+                    default:
+                        assert(false);
+                        goto ERROR_LABEL;
+                        break;
+                    }
+                }
+                else
+                {
+                    if (strstr(word, "/"))
+                    {
+                        char *contextSlash = NULL;
+                        char* token = strtok_s(word, "/", &contextSlash);
+                        int i = 0;
+                        while (token)
+                        {
+                            if (i < 3)
+                            {
+                                indices[i] = atoi(token) - 1;
+                            }
+                            token = strtok_s(NULL, "/", &contextSlash);
+                            i++;
+                        }
+                        switch (i)
+                        {
+                        case 2:
+                            // [Vertex, texture]
+                            if (nbPoints < OBJ_MAX_FACE_POINTS)
+                            {
+                                vertexIndices[nbPoints] = indices[0];
+                                textUVIndices[nbPoints] = indices[1];
+                                normalIndices[nbPoints] = -1;
+                            }
+                            break;
+                        case 3:
+                            // [Vertex, texture, normal]
+                            if (nbPoints < OBJ_MAX_FACE_POINTS)
+                            {
+                                vertexIndices[nbPoints] = indices[0];
+                                textUVIndices[nbPoints] = indices[1];
+                                normalIndices[nbPoints] = indices[2];
+                            }
+                            break;
+                        default:
+                            assert(false);
+                            goto ERROR_LABEL;
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        // [Vertex]
+                        if (nbPoints < OBJ_MAX_FACE_POINTS)
+                        {
+                            vertexIndices[nbPoints] = atoi(word) - 1;
+                            textUVIndices[nbPoints] = -1;
+                            normalIndices[nbPoints] = -1;
+                        }
+                    }
+                }
+                nbPoints++;
+            }
+
+            // Crée les triangles
+            exitStatus = ObjData_AddFace(
+                data, nbPoints, vertexIndices, normalIndices, textUVIndices, materialIndex);
+            if (exitStatus != EXIT_SUCCESS) { assert(false); goto ERROR_LABEL; }
+        }
+        else if (strcmp(word, "mtllib") == 0)
+        {
+            word = strtok_s(NULL, " ", &context);
+            if (!word) continue;
+
+            ObjData_SetMaterialLib(data, word, strlen(word));
+        }
+        else if (strcmp(word, "usemtl") == 0)
+        {
+            word = strtok_s(NULL, " ", &context);
+            if (!word) continue;
+
+            materialIndex = ObjData_GetMaterialName(data, word, strlen(word));
+            if (materialIndex < 0) { assert(false); goto ERROR_LABEL; }
+        }
+    } while (offset < size);
+
+    free(curLine);
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - ObjParser_ParseReference()\n");
+    assert(false);
+    free(curLine);
+    ObjData_Free(data);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,108 @@
+﻿#ifndef _OBJ_PARSER_H_
+#define _OBJ_PARSER_H_
+
+/// @file ObjParser.h
+/// @defgroup ObjParser
+/// @{
+
+#include "Settings.h"
+#include "Vector.h"
+#include "Mesh.h"
+#include "Material.h"
+
+/// @brief Nombre maximal de sommets dans une face.
+#define OBJ_MAX_FACE_POINTS 32
+
+/// @brief Taille minimale (en octets) d'un morceau de fichier pour ObjParser_ParseParallel().
+#define OBJ_MIN_CHUNK_SIZE (1 << 20)
+
+/// @brief Taille maximale du nom d'un fichier mtl.
+#define OBJ_NAME_SIZE 256
+
+/// @brief Contenu brut d'un fichier obj.
+/// Les indices des triangles commencent à 0 ; un indice de normale ou de coordonnée
+/// de texture absent vaut -1. L'indice de matériau d'un triangle désigne un nom de
+/// m_materialNames (-1 avant le premier usemtl).
+typedef struct ObjData_s
+{
+    Vec3     *m_vertices;
+    int       m_vertexCount;
+    int       m_vertexCapacity;
+
+    Vec3     *m_normals;
+    int       m_normalCount;
+    int       m_normalCapacity;
+
+    Vec2     *m_textUVs;
+    int       m_textUVCount;
+    int       m_textUVCapacity;
+
+    Triangle *m_triangles;
+    int       m_triangleCount;
+    int       m_triangleCapacity;
+
+    /// @brief Noms des matériaux (usemtl) dans leur ordre d'apparition.
+    char    (*m_materialNames)[MATERIAL_NAME_SIZE];
+    int       m_materialNameCount;
+    int       m_materialNameCapacity;
+
+    /// @brief Nom du fichier mtl (mtllib) ou chaîne vide.
+    char      m_materialLib[OBJ_NAME_SIZE];
+} ObjData;
+
+/// @brief Analyse le contenu d'un fichier obj.
+/// L'analyse se fait directement dans le buffer, en une seule passe, sans copier les lignes.
+/// Les indices négatifs (relatifs au dernier élément lu) sont pris en charge.
+/// @param[in] buffer le contenu du fichier (pas nécessairement terminé par '\0').
+/// @param[in] size la taille du buffer.
+/// @param[out] data le contenu du fichier, à libérer avec ObjData_Free().
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int ObjParser_Parse(const char *buffer, long size, ObjData *data);
+
+/// @brief Analyse le contenu d'un fichier obj en plusieurs morceaux traités en parallèle.
+/// Le buffer est découpé au début des lignes. Chaque morceau est analysé dans ses propres
+/// tableaux, puis les morceaux sont fusionnés : les indices relatifs sont décalés et le
+/// matériau actif (usemtl) est propagé d'un morceau au suivant.
+/// Le résultat est identique au bit près à celui de ObjParser_Parse().
+/// @param[in] buffer le contenu du fichier.
+/// @param[in] size la taille du buffer.
+/// @param[in] chunkCount le nombre de morceaux.
+/// @param[out] data le contenu du fichier, à libérer avec ObjData_Free().
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int ObjParser_ParseChunks(const char *buffer, long size, int chunkCount, ObjData *data);
+
+/// @brief Analyse le contenu d'un fichier obj avec un morceau par thread
+/// (ou avec ObjParser_Parse() si le fichier est petit).
+/// @param[in] buffer le contenu du fichier.
+/// @param[in] size la taille du buffer.
+/// @param[out] data le contenu du fichier, à libérer avec ObjData_Free().
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int ObjParser_ParseParallel(const char *buffer, long size, ObjData *data);
+
+/// @brief Analyse le contenu d'un fichier obj avec l'ancien analyseur
+/// (copie de chaque ligne, strtok_s et atof dans la locale "C").
+/// Il est conservé comme référence pour valider ObjParser_Parse().
+/// @param[in] buffer le contenu du fichier.
+/// @param[in] size la taille du buffer.
+/// @param[out] data le contenu du fichier, à libérer avec ObjData_Free().
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int ObjParser_ParseReference(const char *buffer, long size, ObjData *data);
+
+/// @brief Lit un nombre flottant.
+/// Le résultat est identique à celui de (float)atof() sur le même texte dans la locale "C",
+/// quelle que soit la locale du programme.
+/// @param[in,out] cursor la position dans le buffer, placée en sortie après le nombre.
+/// @param[in] end la fin du buffer.
+/// @return Le nombre lu.
+float ObjParser_ParseFloat(const char **cursor, const char *end);
+
+/// @brief Indique si deux contenus de fichiers obj sont identiques (au bit près).
+bool ObjData_Equals(ObjData *data0, ObjData *data1);
+
+/// @brief Libère les tableaux d'un ObjData.
+/// @param[in,out] data le contenu à libérer.
+void ObjData_Free(ObjData *data);
+
+/// @}
+
+#endif
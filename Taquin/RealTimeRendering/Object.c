@@ -1,4 +1,5 @@
 ﻿#include "Object.h"
+#include "Scene.h"
 #include "Matrix.h"
 #include "Vector.h"
 
@@ -19,19 +20,23 @@ int Object_RemoveChild(Object* object, Object* child);
 int Object_Init(Object *object, Scene *scene, Mat4 localTransform, Object *parent)
 {
     assert(object && scene);
-    int capacity = 2;
 
     object->m_scene = scene;
     object->m_localTransform = localTransform;
     object->m_parent = NULL;
     object->m_mesh = NULL;
+    object->m_lodLevel = 0;
+    object->m_static = false;
+    object->m_worldTransform = localTransform;
+    object->m_bvhLeaf = SCENE_BVH_NULL;
+    object->m_dirtyIndex = -1;
+    object->m_firstChild = NULL;
+    object->m_lastChild = NULL;
+    object->m_prevSibling = NULL;
+    object->m_nextSibling = NULL;
     object->m_childCount = 0;
-    object->m_childCapacity = capacity;
     object->m_vptr = NULL;
 
-    object->m_children = (Object **)calloc(capacity, sizeof(Object *));
-    if (!object->m_children) goto ERROR_LABEL;
-
     if (parent)
     {
         int exitStatus = Object_SetParent(object, parent);
@@ -61,11 +66,6 @@ void Object_Destroy(Object *object)
         Object_RemoveChild(object->m_parent, object);
     }
 
-    if (object->m_children)
-    {
-        free(object->m_children);
-    }
-
     // Met la mémoire à zéro (sécurité)
     memset(object, 0, sizeof(Object));
 }
@@ -75,30 +75,23 @@ int Object_AddChild(Object* object, Object* child)
     if (!object || !child || object == child)
         goto ERROR_LABEL;
 
-    int childCount = object->m_childCount;
+    // Vérification que l'objet n'est pas déjà chaîné à un parent
+    if (child->m_prevSibling || child->m_nextSibling || object->m_firstChild == child)
+        goto ERROR_LABEL;
 
-    // Vérification que l'objet n'est pas déjà parmi les enfants
-    for (int i = 0; i < childCount; i++)
+    // On ajoute child à la fin de la liste des enfants
+    child->m_prevSibling = object->m_lastChild;
+    child->m_nextSibling = NULL;
+    if (object->m_lastChild)
     {
-        if (child == object->m_children[i])
-            goto ERROR_LABEL;
+        object->m_lastChild->m_nextSibling = child;
     }
-
-    // Modification de l'espace nécessaire pour stocker les enfants si nécessaire
-    if (childCount >= object->m_childCapacity)
+    else
     {
-        int capacity = object->m_childCapacity << 1;
-
-        Object **newChildren = (Object **)realloc(object->m_children, capacity * sizeof(Object*));
-        if (!newChildren) goto ERROR_LABEL;
-
-        object->m_children = newChildren;
-        object->m_childCapacity = capacity;
+        object->m_firstChild = child;
     }
-
-    // On ajoute child dans la liste des enfants
-    object->m_children[childCount++] = child;
-    object->m_childCount = childCount;
+    object->m_lastChild = child;
+    object->m_childCount++;
 
     return EXIT_SUCCESS;
 
@@ -113,27 +106,31 @@ int Object_RemoveChild(Object* object, Object* child)
     if (!object || !child)
         goto ERROR_LABEL;
 
-    int childCount = object->m_childCount;
-    bool found = false;
+    // Vérification que child est bien un enfant de object
+    if (child->m_parent != object)
+        goto ERROR_LABEL;
 
-    for (int i = 0; i < childCount; i++)
+    if (child->m_prevSibling)
+    {
+        child->m_prevSibling->m_nextSibling = child->m_nextSibling;
+    }
+    else
     {
-        if (object->m_children[i] == child)
-        {
-            found = true;
-            for (int j = i; j < childCount - 1; j++)
-            {
-                object->m_children[j] = object->m_children[j + 1];
-            }
-            object->m_children[childCount - 1] = NULL;
-            childCount--;
-            break;
-        }
+        object->m_firstChild = child->m_nextSibling;
     }
 
-    if (!found) goto ERROR_LABEL;
+    if (child->m_nextSibling)
+    {
+        child->m_nextSibling->m_prevSibling = child->m_prevSibling;
+    }
+    else
+    {
+        object->m_lastChild = child->m_prevSibling;
+    }
 
-    object->m_childCount = childCount;
+    child->m_prevSibling = NULL;
+    child->m_nextSibling = NULL;
+    object->m_childCount--;
 
     return EXIT_SUCCESS;
 
@@ -167,6 +164,8 @@ int Object_SetParent(Object* object, Object* parent)
     int exitStatus = Object_AddChild(parent, object);
     if (exitStatus == EXIT_FAILURE) goto ERROR_LABEL;
 
+    Object_Invalidate(object);
+
     return EXIT_SUCCESS;
 
 ERROR_LABEL:
@@ -185,7 +184,29 @@ Object* Object_GetParent(Object* object)
 
 void Object_SetMesh(Object* object, Mesh* mesh)
 {
-    object->m_mesh = mesh;
+    SDL_AtomicSetPtr((void **)&object->m_mesh, mesh);
+    Object_Invalidate(object);
+}
+
+void Object_SetStatic(Object *object, bool isStatic)
+{
+    if (object->m_static == isStatic)
+        return;
+
+    // L'objet entre dans les lots de la scène ou en sort
+    object->m_static = isStatic;
+    Scene_InvalidateStaticBatches(object->m_scene);
+    Scene_InvalidateObjectBounds(object->m_scene, object);
+}
+
+void Object_Invalidate(Object *object)
+{
+    Scene_InvalidateObjectBounds(object->m_scene, object);
+
+    if (object->m_static)
+    {
+        Scene_InvalidateStaticBatches(object->m_scene);
+    }
 }
 
 void Object_SetTransform(Object* object, Object* ref, Mat4 transform)
@@ -209,6 +230,7 @@ void Object_SetTransform(Object* object, Object* ref, Mat4 transform)
             transform
         );
     }
+    Object_Invalidate(object);
 }
 
 Mat4 Object_GetTransform(Object* object, Object* ref)
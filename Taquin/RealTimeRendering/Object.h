@@ -11,11 +11,31 @@
 
 typedef struct Scene_s Scene;
 typedef struct Object_s Object;
+typedef struct Renderer_s Renderer;
+
+typedef struct VShaderGlobals_s VShaderGlobals;
+typedef struct VShaderIn_s      VShaderIn;
+typedef struct VShaderOut_s     VShaderOut;
+typedef struct FShaderGlobals_s FShaderGlobals;
+typedef struct FShaderIn_s      FShaderIn;
+
+typedef VShaderOut VertexShader(VShaderIn *in, VShaderGlobals *globals);
+typedef Vec4     FragmentShader(FShaderIn *in, FShaderGlobals *globals);
 
 // Object Virtual Method Table
 typedef struct ObjectVMT_s
 {
     void (*Destroy)(Object *object);
+
+    /// @brief Calcule le rendu de l'objet.
+    /// Vaut NULL pour les objets rendus par Graphics_RenderObject().
+    void (*Render)(Object *object, Renderer *renderer,
+        VertexShader *vertShader, FragmentShader *fragShader);
+
+    /// @brief Calcule la boîte englobante de ce que dessine l'objet, dans son repère.
+    /// Vaut NULL pour les objets dessinant uniquement leur mesh.
+    /// @return false si l'objet ne dessine rien.
+    bool (*GetBounds)(Object *object, Vec3 *min, Vec3 *max);
 } ObjectVMT;
 
 /// @brief Structure modélisant un objet de la scène.
@@ -29,18 +49,38 @@ struct Object_s
     /// @brief Mesh associé à l'objet.
     Mesh    *m_mesh;
 
+    /// @brief Niveau de détail utilisé lors du dernier rendu (0 pour le mesh complet).
+    int      m_lodLevel;
+
+    /// @brief Indique si l'objet est statique (voir Object_SetStatic()).
+    bool     m_static;
+
+    /// @brief Matrice de transformation de l'objet dans le référentiel monde,
+    /// mise à jour par Scene_UpdateBounds().
+    Mat4     m_worldTransform;
+
+    /// @brief Feuille de l'objet dans la BVH de la scène (SCENE_BVH_NULL s'il n'y est pas).
+    int      m_bvhLeaf;
+
+    /// @brief Position de l'objet dans la liste des objets modifiés de la scène
+    /// (-1 s'il n'a pas été modifié depuis la dernière mise à jour).
+    int      m_dirtyIndex;
+
     /// @brief Pointeur vers le parent de l'objet. Vaut NULL pour la racine de la scène.
     Object  *m_parent;
 
-    /// @brief Tableau contenant les pointeurs vers les enfants de l'objet.
-    Object **m_children;
+    /// @brief Premier et dernier enfants de l'objet (NULL s'il n'en a pas).
+    /// Les enfants sont chaînés par m_prevSibling et m_nextSibling, dans leur ordre d'ajout.
+    Object  *m_firstChild;
+    Object  *m_lastChild;
+
+    /// @brief Enfants précédent et suivant du même parent.
+    Object  *m_prevSibling;
+    Object  *m_nextSibling;
 
     /// @brief Nombre d'enfants de l'objet.
     int      m_childCount;
 
-    /// @brief Nombre maximal d'enfants avant une réallocation.
-    int      m_childCapacity;
-
     ObjectVMT *m_vptr;
 };
 
@@ -73,11 +113,53 @@ INLINE Scene *Object_getScene(Object *object)
     return object->m_scene;
 }
 
+/// @brief Définit si un objet est statique.
+/// Les objets statiques partageant le même mesh sont fusionnés par la scène en un seul mesh
+/// exprimé dans le référentiel monde (voir Scene_BuildStaticBatches()), rendu en un appel.
+/// Ils ne bénéficient plus des niveaux de détail.
+/// Modifier le mesh, la transformation ou le parent d'un objet statique reconstruit son lot ;
+/// ses parents ne doivent donc pas être déplacés.
+/// @param object l'objet.
+/// @param isStatic booléen indiquant si l'objet est statique.
+void Object_SetStatic(Object *object, bool isStatic);
+
+/// @brief Renvoie un booléen indiquant si un objet est statique.
+/// @param object l'objet.
+/// @return Un booléen indiquant si l'objet est statique.
+INLINE bool Object_IsStatic(Object *object)
+{
+    return object->m_static;
+}
+
+/// @brief Signale à la scène qu'un objet a été modifié.
+/// Sa boîte englobante et celles de ses descendants seront recalculées dans la BVH de la scène.
+/// Si l'objet est statique, les lots de la scène seront reconstruits avant le prochain rendu.
+/// @param object l'objet modifié.
+void Object_Invalidate(Object *object);
+
 /// @brief Ajoute un mesh à un objet.
 /// @param object l'objet sur lequel on souhaite ajouter le mesh.
 /// @param mesh mesh à ajouter sur l'objet.
+/// Le mesh est publié de façon atomique : il peut être défini depuis un autre thread
+/// pendant le rendu.
 void Object_SetMesh(Object* object, Mesh* mesh);
 
+/// @brief Renvoie le mesh d'un objet.
+/// @param object l'objet.
+/// @return Le mesh de l'objet ou NULL s'il n'en a pas (encore).
+INLINE Mesh *Object_GetMesh(Object *object)
+{
+    return (Mesh *)SDL_AtomicGetPtr((void **)&object->m_mesh);
+}
+
+/// @brief Renvoie le niveau de détail du mesh utilisé lors du dernier rendu de l'objet.
+/// @param object l'objet.
+/// @return Le niveau de détail (0 pour le mesh complet, i pour Mesh::m_lods[i - 1]).
+INLINE int Object_GetLodLevel(Object *object)
+{
+    return object->m_lodLevel;
+}
+
 /// @brief Définit la transformation d'un objet dans un référentiel donné.
 /// @param object l'objet auquel on définit la transformation.
 /// @param ref le référentiel dans lequel on définit la transformation.
@@ -111,6 +193,7 @@ INLINE Mat4 Object_GetLocalTransform(Object *object)
 INLINE void Object_SetLocalTransform(Object *object, Mat4 localTransform)
 {
     object->m_localTransform = localTransform;
+    Object_Invalidate(object);
 }
 
 Vec4 Object_GetPosition(Object *object);
@@ -120,14 +203,18 @@ INLINE int Object_GetChildCount(Object *object)
     return object->m_childCount;
 }
 
-INLINE Object **Object_GetChildren(Object *object)
+INLINE Object *Object_GetFirstChild(Object *object)
 {
-    return object->m_children;
+    return object->m_firstChild;
 }
 
-INLINE Object *Object_GetFirstChild(Object *object)
+/// @brief Renvoie l'enfant suivant du parent d'un objet.
+/// Les enfants d'un objet se parcourent avec Object_GetFirstChild() puis cette fonction.
+/// @param object l'objet.
+/// @return L'enfant suivant ou NULL si object est le dernier enfant.
+INLINE Object *Object_GetNextSibling(Object *object)
 {
-    return (object->m_childCount > 0) ? object->m_children[0] : NULL;
+    return object->m_nextSibling;
 }
 /// @}
 
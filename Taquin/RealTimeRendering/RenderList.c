@@ -0,0 +1,159 @@
+﻿#include "RenderList.h"
+#include "Graphics.h"
+#include "Tools.h"
+
+void RenderList_Free(RenderList *list)
+{
+    free(list->m_objects);
+    free(list->m_meshes);
+    free(list->m_worldTransforms);
+    free(list->m_centers);
+    free(list->m_radii);
+    free(list->m_visible);
+
+    // Met à zéro la mémoire (sécurité)
+    memset(list, 0, sizeof(RenderList));
+}
+
+/// @brief Agrandit les tableaux d'une liste.
+static int RenderList_Grow(RenderList *list)
+{
+    int capacity = Int_Max(list->m_capacity << 1, 32);
+
+    // Chaque tableau est remplacé dès qu'il est réalloué
+    Object **newObjects = (Object **)realloc(list->m_objects, capacity * sizeof(Object *));
+    if (!newObjects) goto ERROR_LABEL;
+    list->m_objects = newObjects;
+
+    Mesh **newMeshes = (Mesh **)realloc(list->m_meshes, capacity * sizeof(Mesh *));
+    if (!newMeshes) goto ERROR_LABEL;
+    list->m_meshes = newMeshes;
+
+    Mat4 *newTransforms = (Mat4 *)realloc(list->m_worldTransforms, capacity * sizeof(Mat4));
+    if (!newTransforms) goto ERROR_LABEL;
+    list->m_worldTransforms = newTransforms;
+
+    Vec3 *newCenters = (Vec3 *)realloc(list->m_centers, capacity * sizeof(Vec3));
+    if (!newCenters) goto ERROR_LABEL;
+    list->m_centers = newCenters;
+
+    float *newRadii = (float *)realloc(list->m_radii, capacity * sizeof(float));
+    if (!newRadii) goto ERROR_LABEL;
+    list->m_radii = newRadii;
+
+    RenderListKey *newVisible = (RenderListKey *)realloc(
+        list->m_visible, capacity * sizeof(RenderListKey));
+    if (!newVisible) goto ERROR_LABEL;
+    list->m_visible = newVisible;
+
+    list->m_capacity = capacity;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - RenderList_Grow()\n");
+    assert(false);
+    return EXIT_FAILURE;
+}
+
+int RenderList_Add(RenderList *list, Object *object, Mesh *mesh, Mat4 worldTransform)
+{
+    if (list->m_count >= list->m_capacity)
+    {
+        int exitStatus = RenderList_Grow(list);
+        if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    }
+
+    int index = list->m_count++;
+    list->m_objects[index] = object;
+    list->m_meshes[index] = mesh;
+    list->m_worldTransforms[index] = worldTransform;
+
+    if (object->m_vptr && object->m_vptr->Render)
+    {
+        // Le mesh ne couvre pas forcément tout ce que l'objet dessine
+        list->m_centers[index] = Vec3_From4(Mat4_MulMV(worldTransform, Vec4_ZeroH));
+        list->m_radii[index] = INFINITY;
+    }
+    else
+    {
+        float radius = Vec3_Length(Vec3_Sub(mesh->m_max, mesh->m_center));
+        list->m_centers[index] = Vec3_From4(
+            Mat4_MulMV(worldTransform, Vec4_From3(mesh->m_center, 1.0f)));
+        list->m_radii[index] = Graphics_GetMaxScale(worldTransform) * radius;
+    }
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - RenderList_Add()\n");
+    assert(false);
+    return EXIT_FAILURE;
+}
+
+/// @brief Compare deux objets visibles selon leur profondeur (pour qsort()).
+static int RenderList_CompareKeys(const void *a, const void *b)
+{
+    const RenderListKey *keyA = (const RenderListKey *)a;
+    const RenderListKey *keyB = (const RenderListKey *)b;
+
+    if (keyA->m_depth != keyB->m_depth)
+        return (keyA->m_depth > keyB->m_depth) - (keyA->m_depth < keyB->m_depth);
+
+    // Ordre d'ajout à profondeur égale
+    return keyA->m_index - keyB->m_index;
+}
+
+void RenderList_Cull(RenderList *list, Camera *camera)
+{
+    GraphicsFrustum frustum = Graphics_GetFrustum(camera);
+    Mat4 worldToView = Mat4_Inv(Object_GetModelMatrix((Object *)camera));
+    int count = list->m_count;
+    int i;
+
+    // Un objet rejeté reçoit une profondeur NaN
+    #pragma omp parallel for if (count >= 256)
+    for (i = 0; i < count; ++i)
+    {
+        Vec3 center = Vec3_From4(Mat4_MulMV(worldToView, Vec4_From3(list->m_centers[i], 1.0f)));
+        bool visible = Graphics_IsSphereVisible(&frustum, center, list->m_radii[i]);
+
+        list->m_visible[i].m_depth = visible ? -center.z : NAN;
+        list->m_visible[i].m_index = i;
+    }
+
+    // Compacte les objets conservés
+    int visibleCount = 0;
+    for (i = 0; i < count; ++i)
+    {
+        if (!isnan(list->m_visible[i].m_depth))
+        {
+            list->m_visible[visibleCount++] = list->m_visible[i];
+        }
+    }
+    list->m_visibleCount = visibleCount;
+
+    qsort(list->m_visible, visibleCount, sizeof(RenderListKey), RenderList_CompareKeys);
+}
+
+void RenderList_Render(
+    RenderList *list, Renderer *renderer,
+    VertexShader *vertShader, FragmentShader *fragShader)
+{
+    for (int i = 0; i < list->m_visibleCount; ++i)
+    {
+        int index = list->m_visible[i].m_index;
+        Object *object = list->m_objects[index];
+
+        if (object->m_vptr && object->m_vptr->Render)
+        {
+            // Rendu propre à la classe fille (InstanceGroup...)
+            object->m_vptr->Render(object, renderer, vertShader, fragShader);
+        }
+        else
+        {
+            Graphics_RenderObjectTransformed(
+                renderer, object, list->m_worldTransforms[index], vertShader, fragShader);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+﻿#ifndef _RENDER_LIST_H_
+#define _RENDER_LIST_H_
+
+/// @file RenderList.h
+/// @defgroup RenderList
+/// @{
+
+#include "Settings.h"
+#include "Object.h"
+#include "Camera.h"
+
+/// @brief Clé de tri d'un objet visible de la liste.
+typedef struct RenderListKey_s
+{
+    /// @brief Distance du centre de l'objet devant la caméra.
+    float m_depth;
+
+    /// @brief Indice de l'objet dans la liste.
+    int   m_index;
+} RenderListKey;
+
+/// @brief Liste plate des objets à rendre, reconstruite à chaque image par Scene_Render()
+/// à partir des objets trouvés dans la BVH de la scène, avec leur matrice monde déjà calculée.
+/// Les données des objets sont rangées dans des tableaux séparés (structure de tableaux),
+/// le rejet et le tri sont donc de simples parcours de tableaux contigus.
+typedef struct RenderList_s
+{
+    /// @brief Nombre d'objets de la liste.
+    int      m_count;
+
+    /// @brief Nombre maximal d'objets avant une réallocation.
+    int      m_capacity;
+
+    /// @brief Objets, dans leur ordre d'ajout.
+    Object **m_objects;
+
+    /// @brief Meshs des objets.
+    Mesh   **m_meshes;
+
+    /// @brief Matrices de transformation des objets dans le référentiel monde.
+    Mat4    *m_worldTransforms;
+
+    /// @brief Centres des sphères englobantes dans le référentiel monde.
+    Vec3    *m_centers;
+
+    /// @brief Rayons des sphères englobantes. Un rayon infini désigne un objet
+    /// ayant son propre rendu (InstanceGroup...), qui n'est jamais rejeté.
+    float   *m_radii;
+
+    /// @brief Objets conservés par RenderList_Cull(), du plus proche au plus éloigné.
+    int            m_visibleCount;
+    RenderListKey *m_visible;
+} RenderList;
+
+/// @brief Détruit les tableaux d'une liste.
+/// @param[in,out] list la liste.
+void RenderList_Free(RenderList *list);
+
+/// @brief Vide une liste sans libérer ses tableaux.
+/// @param[in,out] list la liste.
+INLINE void RenderList_Clear(RenderList *list)
+{
+    list->m_count = 0;
+    list->m_visibleCount = 0;
+}
+
+/// @brief Ajoute un objet à une liste.
+/// @param[in,out] list la liste.
+/// @param[in] object l'objet.
+/// @param[in] mesh le mesh de l'objet.
+/// @param[in] worldTransform la matrice de l'objet dans le référentiel monde.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int RenderList_Add(RenderList *list, Object *object, Mesh *mesh, Mat4 worldTransform);
+
+/// @brief Rejette les objets hors du frustum d'une caméra
+/// puis trie les objets restants du plus proche au plus éloigné.
+/// Le rendu des plus proches en premier évite d'ombrer des pixels ensuite recouverts.
+/// @param[in,out] list la liste.
+/// @param[in] camera la caméra.
+void RenderList_Cull(RenderList *list, Camera *camera);
+
+/// @brief Calcule le rendu des objets conservés par RenderList_Cull().
+/// @param[in] list la liste.
+/// @param[in] renderer le moteur de rendu.
+/// @param[in] vertShader le vertex shader.
+/// @param[in] fragShader le fragment shader.
+void RenderList_Render(
+    RenderList *list, Renderer *renderer,
+    VertexShader *vertShader, FragmentShader *fragShader);
+
+/// @}
+
+#endif
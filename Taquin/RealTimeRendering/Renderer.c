@@ -1,6 +1,7 @@
 #include "Renderer.h"
 #include "camera.h"
 #include "Tools.h"
+#include "Shader.h"
 
 Renderer *Renderer_New(SDL_Renderer *rendererSDL)
 {
@@ -22,6 +23,8 @@ Renderer *Renderer_New(SDL_Renderer *rendererSDL)
     renderer->m_width = width;
     renderer->m_height = height;
     renderer->m_rendererSDL = rendererSDL;
+    renderer->m_depthTest = RENDERER_DEPTH_LESS_EQUAL;
+    renderer->m_depthOnly = false;
 
     renderer->m_zBuffer = (float **)calloc(width, sizeof(float *));
     if (!renderer->m_zBuffer) goto ERROR_LABEL;
@@ -75,6 +78,8 @@ void Renderer_Free(Renderer *renderer)
         free(zBuffer);
     }
     free(renderer->m_pixels);
+    free(renderer->m_vertexOut);
+    free(renderer->m_meshletBuffer);
 
     // Met  zro la mmoire (scurit)
     memset(renderer, 0, sizeof(Renderer));
@@ -82,6 +87,47 @@ void Renderer_Free(Renderer *renderer)
     free(renderer);
 }
 
+VShaderOut *Renderer_GetVertexBuffer(Renderer *renderer, int count)
+{
+    if (count > renderer->m_vertexOutCapacity)
+    {
+        int capacity = Int_Max(count, renderer->m_vertexOutCapacity << 1);
+        VShaderOut *vertexOut = (VShaderOut *)realloc(
+            renderer->m_vertexOut, capacity * sizeof(VShaderOut));
+        if (!vertexOut) goto ERROR_LABEL;
+
+        renderer->m_vertexOut = vertexOut;
+        renderer->m_vertexOutCapacity = capacity;
+    }
+
+    return renderer->m_vertexOut;
+
+ERROR_LABEL:
+    printf("ERROR - Renderer_GetVertexBuffer()\n");
+    assert(false);
+    return NULL;
+}
+
+int *Renderer_GetMeshletBuffer(Renderer *renderer, int count)
+{
+    if (count > renderer->m_meshletBufferCapacity)
+    {
+        int capacity = Int_Max(count, renderer->m_meshletBufferCapacity << 1);
+        int *buffer = (int *)realloc(renderer->m_meshletBuffer, capacity * sizeof(int));
+        if (!buffer) goto ERROR_LABEL;
+
+        renderer->m_meshletBuffer = buffer;
+        renderer->m_meshletBufferCapacity = capacity;
+    }
+
+    return renderer->m_meshletBuffer;
+
+ERROR_LABEL:
+    printf("ERROR - Renderer_GetMeshletBuffer()\n");
+    assert(false);
+    return NULL;
+}
+
 void Renderer_SetPixel(Renderer *renderer, int x, int y, float zValue, Vec4 color, bool zWrite)
 {
     if (x < 0 || x >= renderer->m_width ||
@@ -91,7 +137,10 @@ void Renderer_SetPixel(Renderer *renderer, int x, int y, float zValue, Vec4 colo
     y = renderer->m_height - 1 - y;
 //#pragma omp critical
     {
-        if (zValue <= renderer->m_zBuffer[x][y])
+        float depth = renderer->m_zBuffer[x][y];
+        bool visible = (renderer->m_depthTest == RENDERER_DEPTH_EQUAL) ?
+            (zValue == depth) : (zValue <= depth);
+        if (visible)
         {
             SDL_Renderer *rendererSDL = renderer->m_rendererSDL;
             int r = Int_Clamp((int)(255.f * color.x), 0, 255);
@@ -4,6 +4,20 @@
 #include "Settings.h"
 #include "Vector.h"
 
+typedef struct VShaderOut_s VShaderOut;
+
+/// @brief Test de profondeur appliqu aux fragments.
+typedef enum RendererDepthTest_e
+{
+    /// @brief Le fragment est conserv si sa profondeur est infrieure ou gale
+    ///  celle du z-buffer.
+    RENDERER_DEPTH_LESS_EQUAL,
+
+    /// @brief Le fragment est conserv si sa profondeur est gale  celle du z-buffer
+    /// (passe d'ombrage aprs une pr-passe de profondeur).
+    RENDERER_DEPTH_EQUAL
+} RendererDepthTest;
+
 typedef struct Renderer_s
 {
     /// @protected
@@ -22,6 +36,15 @@ typedef struct Renderer_s
     /// @brief Le z-buffer (buffer de profondeur).
     float **m_zBuffer;
 
+    /// @protected
+    /// @brief Test de profondeur appliqu aux fragments.
+    RendererDepthTest m_depthTest;
+
+    /// @protected
+    /// @brief Indique si seule la profondeur des triangles est crite (pr-passe) :
+    /// ni interpolation des attributs, ni fragment shader, ni criture de couleur.
+    bool m_depthOnly;
+
     /// @protected
     /// @brief Texture en accs streaming dans laquelle copi le rendu.
     SDL_Texture *m_streamTex;
@@ -29,11 +52,44 @@ typedef struct Renderer_s
     /// @protected
     /// @brief Tableau des pixels.
     Uint32 *m_pixels;
+
+    /// @protected
+    /// @brief Sorties du vertex shader pour les sommets de l'objet en cours de rendu.
+    VShaderOut *m_vertexOut;
+
+    /// @protected
+    /// @brief Nombre de sommets pouvant tre stocks dans m_vertexOut.
+    int m_vertexOutCapacity;
+
+    /// @protected
+    /// @brief Meshlets visibles de l'objet en cours de rendu
+    /// et position de leurs sommets dans m_vertexOut.
+    int *m_meshletBuffer;
+
+    /// @protected
+    /// @brief Nombre d'entiers pouvant tre stocks dans m_meshletBuffer.
+    int m_meshletBufferCapacity;
 } Renderer;
 
 Renderer *Renderer_New(SDL_Renderer *rendererSDL);
 void Renderer_Free(Renderer *renderer);
 
+/// @ingroup Renderer
+/// @brief Renvoie un tableau pouvant contenir les sorties du vertex shader
+/// pour un nombre donn de sommets. Le tableau est rutilis d'un objet  l'autre.
+/// @param[in] renderer le moteur de rendu.
+/// @param[in] count le nombre de sommets.
+/// @return Le tableau ou NULL en cas d'erreur.
+VShaderOut *Renderer_GetVertexBuffer(Renderer *renderer, int count);
+
+/// @ingroup Renderer
+/// @brief Renvoie un tableau d'entiers utilis pour trier les meshlets d'un objet.
+/// Le tableau est rutilis d'un objet  l'autre.
+/// @param[in] renderer le moteur de rendu.
+/// @param[in] count le nombre d'entiers.
+/// @return Le tableau ou NULL en cas d'erreur.
+int *Renderer_GetMeshletBuffer(Renderer *renderer, int count);
+
 /// @ingroup Renderer
 /// @brief Renvoie la largeur du moteur de rendu.
 /// @param[in] renderer le moteur de rendu.
@@ -52,11 +108,68 @@ INLINE int Renderer_GetHeight(Renderer *renderer)
     return renderer->m_height;
 }
 
+/// @ingroup Renderer
+/// @brief Dfinit le test de profondeur appliqu aux fragments.
+/// @param[in,out] renderer le moteur de rendu.
+/// @param depthTest le test de profondeur.
+INLINE void Renderer_SetDepthTest(Renderer *renderer, RendererDepthTest depthTest)
+{
+    renderer->m_depthTest = depthTest;
+}
+
+/// @ingroup Renderer
+/// @brief Dfinit si seule la profondeur des triangles est crite (pr-passe de profondeur).
+/// @param[in,out] renderer le moteur de rendu.
+/// @param depthOnly boolen indiquant si seule la profondeur est crite.
+INLINE void Renderer_SetDepthOnly(Renderer *renderer, bool depthOnly)
+{
+    renderer->m_depthOnly = depthOnly;
+}
+
+/// @ingroup Renderer
+/// @brief Renvoie un boolen indiquant si seule la profondeur des triangles est crite.
+/// @param[in] renderer le moteur de rendu.
+/// @return Un boolen indiquant si seule la profondeur est crite.
+INLINE bool Renderer_GetDepthOnly(Renderer *renderer)
+{
+    return renderer->m_depthOnly;
+}
+
+/// @ingroup Renderer
+/// @brief Test de profondeur anticip : indique si un fragment peut encore tre visible,
+/// avant d'excuter le fragment shader. Le test dfinitif a lieu dans Renderer_SetPixel().
+/// @param[in] renderer le moteur de rendu.
+/// @param x l'abscisse du pixel (dans le rendu, comme pour Renderer_SetPixel()).
+/// @param y l'ordonne du pixel.
+/// @param zValue la profondeur du fragment.
+/// @return true si le fragment passe le test de profondeur du moteur de rendu.
+INLINE bool Renderer_TestDepth(Renderer *renderer, int x, int y, float zValue)
+{
+    float depth = renderer->m_zBuffer[x][renderer->m_height - 1 - y];
+    return (renderer->m_depthTest == RENDERER_DEPTH_EQUAL) ? (zValue == depth) : (zValue <= depth);
+}
+
+/// @ingroup Renderer
+/// @brief crit la profondeur d'un fragment dans le z-buffer si elle est infrieure
+///  la valeur prsente, sans modifier la couleur (pr-passe de profondeur).
+/// @param[in,out] renderer le moteur de rendu.
+/// @param x l'abscisse du pixel (dans le rendu, comme pour Renderer_SetPixel()).
+/// @param y l'ordonne du pixel.
+/// @param zValue la profondeur du fragment.
+INLINE void Renderer_WriteDepth(Renderer *renderer, int x, int y, float zValue)
+{
+    float *depth = &renderer->m_zBuffer[x][renderer->m_height - 1 - y];
+    if (zValue < *depth)
+    {
+        *depth = zValue;
+    }
+}
+
 /// @ingroup Renderer
 /// @brief Dfinit la couleur d'un pixel sur le rendu.
 /// La position (x = 0, y = 0) dsigne le point en haut  gauche de l'cran.
-/// Le pixel n'est modifi que si sa profondeur est infrieure  la valeur associ
-/// dans le buffer de profondeur du moteur de rendu.
+/// Le pixel n'est modifi que si sa profondeur passe le test de profondeur du moteur
+/// de rendu (voir Renderer_SetDepthTest()) avec la valeur associe dans son buffer de profondeur.
 /// @param[in,out] renderer le moteur de rendu.
 /// @param pixel position du pixel  dfinir.
 /// @param color la couleur du pixel.
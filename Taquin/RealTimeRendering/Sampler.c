@@ -0,0 +1,493 @@
+﻿#include "Sampler.h"
+#include "Tools.h"
+#include "TextureBlock.h"
+
+#include <emmintrin.h>
+#ifdef __AVX2__
+#  include <immintrin.h>
+#endif
+
+// Les texels sont lus comme des entiers 32 bits : r dans l'octet de poids faible,
+// puis g, b et a (format SDL_PIXELFORMAT_RGBA32 sur une machine little-endian).
+// La conversion en flottants se fait par masques/décalages puis une seule multiplication
+// à la fin du filtrage (aucune division par 255).
+
+/// @brief Plus grand flottant strictement inférieur à 1.
+#define SAMPLER_ONE_MINUS_EPS 0.99999994f
+
+/// @brief Facteurs de conversion des canaux [0,255] vers la plage de sortie.
+static const float g_samplerScale[2] = { 1.0f / 255.0f, 2.0f / 255.0f };
+static const float g_samplerBias[2] = { 0.0f, -1.0f };
+
+/// @brief Borne le lod dans les niveaux disponibles pour le mode trilinéaire.
+/// @param[in] texture la texture.
+/// @param[in] lod le niveau demandé.
+/// @param[out] level0 le niveau le plus fin.
+/// @param[out] level1 le niveau le plus grossier.
+/// @return Le coefficient d'interpolation entre level0 et level1.
+static float Sampler_SplitLod(MeshTexture *texture, float lod, int *level0, int *level1)
+{
+    int maxLevel = texture->m_levelCount - 1;
+    lod = Float_Clamp(lod, 0.0f, (float)maxLevel);
+    *level0 = (int)lod;
+    *level1 = Int_Min(*level0 + 1, maxLevel);
+    return lod - (float)*level0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Version scalaire
+
+static INLINE float Sampler_Wrap(float x)
+{
+    return fminf(x - floorf(x), SAMPLER_ONE_MINUS_EPS);
+}
+
+static INLINE void Sampler_Unpack(Uint32 texel, float *rgb)
+{
+    rgb[0] = (float)((texel >>  0) & 0xFF);
+    rgb[1] = (float)((texel >>  8) & 0xFF);
+    rgb[2] = (float)((texel >> 16) & 0xFF);
+}
+
+/// @brief Lit un texel quel que soit le format de la texture.
+static INLINE Uint32 Sampler_Fetch(MeshTexture *texture, int levelIdx, int x, int y)
+{
+    if (MeshTextureFormat_IsCompressed(texture->m_format))
+    {
+        return TextureBlock_Fetch(texture, levelIdx, x, y);
+    }
+
+    MeshTextureLevel *level = &texture->m_levels[levelIdx];
+    const Uint32 *texels = (const Uint32 *)texture->m_pixels + level->m_offset;
+    return texels[y * level->m_width + x];
+}
+
+static void Sampler_Nearest(MeshTexture *texture, int levelIdx, float u, float v, float *rgb)
+{
+    MeshTextureLevel *level = &texture->m_levels[levelIdx];
+    int w = level->m_width;
+    int h = level->m_height;
+
+    int x = Int_Min((int)(u * w), w - 1);
+    int y = Int_Min((int)((1.0f - v) * h), h - 1);
+
+    Sampler_Unpack(Sampler_Fetch(texture, levelIdx, x, y), rgb);
+}
+
+static void Sampler_Bilinear(MeshTexture *texture, int levelIdx, float u, float v, float *rgb)
+{
+    MeshTextureLevel *level = &texture->m_levels[levelIdx];
+    int w = level->m_width;
+    int h = level->m_height;
+
+    float xf = u * w - 0.5f;
+    float yf = (1.0f - v) * h - 0.5f;
+    float x0f = floorf(xf);
+    float y0f = floorf(yf);
+    float fx = xf - x0f;
+    float fy = yf - y0f;
+
+    // Répétition de la texture sur les bords
+    int x0 = (int)x0f;
+    int y0 = (int)y0f;
+    if (x0 < 0) x0 += w;
+    if (y0 < 0) y0 += h;
+    int x1 = (x0 + 1 == w) ? 0 : x0 + 1;
+    int y1 = (y0 + 1 == h) ? 0 : y0 + 1;
+
+    float c00[3], c01[3], c10[3], c11[3];
+    Sampler_Unpack(Sampler_Fetch(texture, levelIdx, x0, y0), c00);
+    Sampler_Unpack(Sampler_Fetch(texture, levelIdx, x1, y0), c01);
+    Sampler_Unpack(Sampler_Fetch(texture, levelIdx, x0, y1), c10);
+    Sampler_Unpack(Sampler_Fetch(texture, levelIdx, x1, y1), c11);
+
+    for (int c = 0; c < 3; ++c)
+    {
+        float top = c00[c] + fx * (c01[c] - c00[c]);
+        float bottom = c10[c] + fx * (c11[c] - c10[c]);
+        rgb[c] = top + fy * (bottom - top);
+    }
+}
+
+Vec3 Sampler_Sample(
+    MeshTexture *texture, SamplerFilter filter, SamplerChannel channel,
+    Vec2 textUV, float lod)
+{
+    float u = Sampler_Wrap(textUV.x);
+    float v = Sampler_Wrap(textUV.y);
+    float rgb[3] = { 0 };
+
+    switch (filter)
+    {
+    case SAMPLER_NEAREST:
+        Sampler_Nearest(texture, 0, u, v, rgb);
+        break;
+
+    case SAMPLER_BILINEAR:
+        Sampler_Bilinear(texture, 0, u, v, rgb);
+        break;
+
+    case SAMPLER_TRILINEAR:
+    default:
+    {
+        int level0, level1;
+        float t = Sampler_SplitLod(texture, lod, &level0, &level1);
+        float rgb1[3];
+        Sampler_Bilinear(texture, level0, u, v, rgb);
+        Sampler_Bilinear(texture, level1, u, v, rgb1);
+        for (int c = 0; c < 3; ++c)
+        {
+            rgb[c] += t * (rgb1[c] - rgb[c]);
+        }
+        break;
+    }
+    }
+
+    float scale = g_samplerScale[channel];
+    float bias = g_samplerBias[channel];
+    return Vec3_Set(
+        rgb[0] * scale + bias,
+        rgb[1] * scale + bias,
+        rgb[2] * scale + bias);
+}
+
+/// @brief Lit une texture compressée en plusieurs points, un point après l'autre.
+/// Le décodage des blocs domine le coût : il n'y a pas de version vectorielle.
+/// @param[out] out les valeurs filtrées, rangées par canal avec un pas de count.
+static void Sampler_SampleCompressed(
+    MeshTexture *texture, SamplerFilter filter, SamplerChannel channel,
+    const float *u, const float *v, float lod, float *out, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        Vec3 value = Sampler_Sample(texture, filter, channel, Vec2_Set(u[i], v[i]), lod);
+        out[i] = value.x;
+        out[count + i] = value.y;
+        out[2 * count + i] = value.z;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Version SSE (4 échantillons)
+
+typedef struct SamplerRGB4_s
+{
+    __m128 r, g, b;
+} SamplerRGB4;
+
+static INLINE __m128 Sampler_Floor4(__m128 x)
+{
+    // floor() en SSE2 : troncature puis correction des valeurs négatives
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.0f)));
+}
+
+static INLINE __m128 Sampler_Wrap4(__m128 x)
+{
+    x = _mm_sub_ps(x, Sampler_Floor4(x));
+    return _mm_min_ps(x, _mm_set1_ps(SAMPLER_ONE_MINUS_EPS));
+}
+
+static INLINE __m128i Sampler_MulLo4(__m128i a, __m128i b)
+{
+    // _mm_mullo_epi32() n'existe qu'à partir de SSE4.1
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(
+        _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+        _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static INLINE __m128i Sampler_Gather4(const Uint32 *texels, __m128i index)
+{
+    int idx[4];
+    _mm_storeu_si128((__m128i *)idx, index);
+    return _mm_set_epi32(
+        (int)texels[idx[3]], (int)texels[idx[2]], (int)texels[idx[1]], (int)texels[idx[0]]);
+}
+
+static INLINE void Sampler_Unpack4(__m128i texels, SamplerRGB4 *res)
+{
+    __m128i mask = _mm_set1_epi32(0xFF);
+    res->r = _mm_cvtepi32_ps(_mm_and_si128(texels, mask));
+    res->g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, 8), mask));
+    res->b = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, 16), mask));
+}
+
+static INLINE __m128 Sampler_Lerp4(__m128 a, __m128 b, __m128 t)
+{
+    return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+
+static void Sampler_Nearest4(
+    MeshTexture *texture, int levelIdx, __m128 u, __m128 v, SamplerRGB4 *res)
+{
+    MeshTextureLevel *level = &texture->m_levels[levelIdx];
+    const Uint32 *texels = (const Uint32 *)texture->m_pixels + level->m_offset;
+    __m128 w = _mm_set1_ps((float)level->m_width);
+    __m128 h = _mm_set1_ps((float)level->m_height);
+    __m128 one = _mm_set1_ps(1.0f);
+
+    __m128 xf = _mm_min_ps(_mm_mul_ps(u, w), _mm_sub_ps(w, one));
+    __m128 yf = _mm_min_ps(_mm_mul_ps(_mm_sub_ps(one, v), h), _mm_sub_ps(h, one));
+    __m128i x = _mm_cvttps_epi32(xf);
+    __m128i y = _mm_cvttps_epi32(yf);
+
+    __m128i index = _mm_add_epi32(Sampler_MulLo4(y, _mm_set1_epi32(level->m_width)), x);
+    Sampler_Unpack4(Sampler_Gather4(texels, index), res);
+}
+
+static void Sampler_Bilinear4(
+    MeshTexture *texture, int levelIdx, __m128 u, __m128 v, SamplerRGB4 *res)
+{
+    MeshTextureLevel *level = &texture->m_levels[levelIdx];
+    const Uint32 *texels = (const Uint32 *)texture->m_pixels + level->m_offset;
+    __m128 w = _mm_set1_ps((float)level->m_width);
+    __m128 h = _mm_set1_ps((float)level->m_height);
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128i wi = _mm_set1_epi32(level->m_width);
+    __m128i hi = _mm_set1_epi32(level->m_height);
+    __m128i zeroi = _mm_setzero_si128();
+    __m128i onei = _mm_set1_epi32(1);
+
+    __m128 xf = _mm_sub_ps(_mm_mul_ps(u, w), half);
+    __m128 yf = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(one, v), h), half);
+    __m128 x0f = Sampler_Floor4(xf);
+    __m128 y0f = Sampler_Floor4(yf);
+    __m128 fx = _mm_sub_ps(xf, x0f);
+    __m128 fy = _mm_sub_ps(yf, y0f);
+
+    // Répétition de la texture sur les bords
+    __m128i x0 = _mm_cvttps_epi32(x0f);
+    __m128i y0 = _mm_cvttps_epi32(y0f);
+    x0 = _mm_add_epi32(x0, _mm_and_si128(_mm_cmplt_epi32(x0, zeroi), wi));
+    y0 = _mm_add_epi32(y0, _mm_and_si128(_mm_cmplt_epi32(y0, zeroi), hi));
+    __m128i x1 = _mm_add_epi32(x0, onei);
+    __m128i y1 = _mm_add_epi32(y0, onei);
+    x1 = _mm_andnot_si128(_mm_cmpeq_epi32(x1, wi), x1);
+    y1 = _mm_andnot_si128(_mm_cmpeq_epi32(y1, hi), y1);
+
+    __m128i row0 = Sampler_MulLo4(y0, wi);
+    __m128i row1 = Sampler_MulLo4(y1, wi);
+
+    SamplerRGB4 c00, c01, c10, c11;
+    Sampler_Unpack4(Sampler_Gather4(texels, _mm_add_epi32(row0, x0)), &c00);
+    Sampler_Unpack4(Sampler_Gather4(texels, _mm_add_epi32(row0, x1)), &c01);
+    Sampler_Unpack4(Sampler_Gather4(texels, _mm_add_epi32(row1, x0)), &c10);
+    Sampler_Unpack4(Sampler_Gather4(texels, _mm_add_epi32(row1, x1)), &c11);
+
+    res->r = Sampler_Lerp4(Sampler_Lerp4(c00.r, c01.r, fx), Sampler_Lerp4(c10.r, c11.r, fx), fy);
+    res->g = Sampler_Lerp4(Sampler_Lerp4(c00.g, c01.g, fx), Sampler_Lerp4(c10.g, c11.g, fx), fy);
+    res->b = Sampler_Lerp4(Sampler_Lerp4(c00.b, c01.b, fx), Sampler_Lerp4(c10.b, c11.b, fx), fy);
+}
+
+void Sampler_Sample4(
+    MeshTexture *texture, SamplerFilter filter, SamplerChannel channel,
+    const float *u, const float *v, float lod, float out[3][4])
+{
+    if (MeshTextureFormat_IsCompressed(texture->m_format))
+    {
+        Sampler_SampleCompressed(texture, filter, channel, u, v, lod, out[0], 4);
+        return;
+    }
+
+    __m128 u4 = Sampler_Wrap4(_mm_loadu_ps(u));
+    __m128 v4 = Sampler_Wrap4(_mm_loadu_ps(v));
+    SamplerRGB4 res;
+
+    switch (filter)
+    {
+    case SAMPLER_NEAREST:
+        Sampler_Nearest4(texture, 0, u4, v4, &res);
+        break;
+
+    case SAMPLER_BILINEAR:
+        Sampler_Bilinear4(texture, 0, u4, v4, &res);
+        break;
+
+    case SAMPLER_TRILINEAR:
+    default:
+    {
+        int level0, level1;
+        __m128 t = _mm_set1_ps(Sampler_SplitLod(texture, lod, &level0, &level1));
+        SamplerRGB4 res1;
+        Sampler_Bilinear4(texture, level0, u4, v4, &res);
+        Sampler_Bilinear4(texture, level1, u4, v4, &res1);
+        res.r = Sampler_Lerp4(res.r, res1.r, t);
+        res.g = Sampler_Lerp4(res.g, res1.g, t);
+        res.b = Sampler_Lerp4(res.b, res1.b, t);
+        break;
+    }
+    }
+
+    __m128 scale = _mm_set1_ps(g_samplerScale[channel]);
+    __m128 bias = _mm_set1_ps(g_samplerBias[channel]);
+    _mm_storeu_ps(out[0], _mm_add_ps(_mm_mul_ps(res.r, scale), bias));
+    _mm_storeu_ps(out[1], _mm_add_ps(_mm_mul_ps(res.g, scale), bias));
+    _mm_storeu_ps(out[2], _mm_add_ps(_mm_mul_ps(res.b, scale), bias));
+}
+
+//-------------------------------------------------------------------------------------------------
+// Version AVX2 (8 échantillons)
+
+#ifdef __AVX2__
+
+typedef struct SamplerRGB8_s
+{
+    __m256 r, g, b;
+} SamplerRGB8;
+
+static INLINE __m256 Sampler_Wrap8(__m256 x)
+{
+    x = _mm256_sub_ps(x, _mm256_floor_ps(x));
+    return _mm256_min_ps(x, _mm256_set1_ps(SAMPLER_ONE_MINUS_EPS));
+}
+
+static INLINE void Sampler_Unpack8(__m256i texels, SamplerRGB8 *res)
+{
+    __m256i mask = _mm256_set1_epi32(0xFF);
+    res->r = _mm256_cvtepi32_ps(_mm256_and_si256(texels, mask));
+    res->g = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(texels, 8), mask));
+    res->b = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(texels, 16), mask));
+}
+
+static INLINE __m256i Sampler_Gather8(const Uint32 *texels, __m256i index)
+{
+    return _mm256_i32gather_epi32((const int *)texels, index, 4);
+}
+
+static INLINE __m256 Sampler_Lerp8(__m256 a, __m256 b, __m256 t)
+{
+    return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+}
+
+static void Sampler_Nearest8(
+    MeshTexture *texture, int levelIdx, __m256 u, __m256 v, SamplerRGB8 *res)
+{
+    MeshTextureLevel *level = &texture->m_levels[levelIdx];
+    const Uint32 *texels = (const Uint32 *)texture->m_pixels + level->m_offset;
+    __m256 w = _mm256_set1_ps((float)level->m_width);
+    __m256 h = _mm256_set1_ps((float)level->m_height);
+    __m256 one = _mm256_set1_ps(1.0f);
+
+    __m256 xf = _mm256_min_ps(_mm256_mul_ps(u, w), _mm256_sub_ps(w, one));
+    __m256 yf = _mm256_min_ps(_mm256_mul_ps(_mm256_sub_ps(one, v), h), _mm256_sub_ps(h, one));
+    __m256i x = _mm256_cvttps_epi32(xf);
+    __m256i y = _mm256_cvttps_epi32(yf);
+
+    __m256i index = _mm256_add_epi32(
+        _mm256_mullo_epi32(y, _mm256_set1_epi32(level->m_width)), x);
+    Sampler_Unpack8(Sampler_Gather8(texels, index), res);
+}
+
+static void Sampler_Bilinear8(
+    MeshTexture *texture, int levelIdx, __m256 u, __m256 v, SamplerRGB8 *res)
+{
+    MeshTextureLevel *level = &texture->m_levels[levelIdx];
+    const Uint32 *texels = (const Uint32 *)texture->m_pixels + level->m_offset;
+    __m256 w = _mm256_set1_ps((float)level->m_width);
+    __m256 h = _mm256_set1_ps((float)level->m_height);
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 half = _mm256_set1_ps(0.5f);
+    __m256i wi = _mm256_set1_epi32(level->m_width);
+    __m256i hi = _mm256_set1_epi32(level->m_height);
+    __m256i zeroi = _mm256_setzero_si256();
+    __m256i onei = _mm256_set1_epi32(1);
+
+    __m256 xf = _mm256_sub_ps(_mm256_mul_ps(u, w), half);
+    __m256 yf = _mm256_sub_ps(_mm256_mul_ps(_mm256_sub_ps(one, v), h), half);
+    __m256 x0f = _mm256_floor_ps(xf);
+    __m256 y0f = _mm256_floor_ps(yf);
+    __m256 fx = _mm256_sub_ps(xf, x0f);
+    __m256 fy = _mm256_sub_ps(yf, y0f);
+
+    // Répétition de la texture sur les bords
+    __m256i x0 = _mm256_cvttps_epi32(x0f);
+    __m256i y0 = _mm256_cvttps_epi32(y0f);
+    x0 = _mm256_add_epi32(x0, _mm256_and_si256(_mm256_cmpgt_epi32(zeroi, x0), wi));
+    y0 = _mm256_add_epi32(y0, _mm256_and_si256(_mm256_cmpgt_epi32(zeroi, y0), hi));
+    __m256i x1 = _mm256_add_epi32(x0, onei);
+    __m256i y1 = _mm256_add_epi32(y0, onei);
+    x1 = _mm256_andnot_si256(_mm256_cmpeq_epi32(x1, wi), x1);
+    y1 = _mm256_andnot_si256(_mm256_cmpeq_epi32(y1, hi), y1);
+
+    __m256i row0 = _mm256_mullo_epi32(y0, wi);
+    __m256i row1 = _mm256_mullo_epi32(y1, wi);
+
+    SamplerRGB8 c00, c01, c10, c11;
+    Sampler_Unpack8(Sampler_Gather8(texels, _mm256_add_epi32(row0, x0)), &c00);
+    Sampler_Unpack8(Sampler_Gather8(texels, _mm256_add_epi32(row0, x1)), &c01);
+    Sampler_Unpack8(Sampler_Gather8(texels, _mm256_add_epi32(row1, x0)), &c10);
+    Sampler_Unpack8(Sampler_Gather8(texels, _mm256_add_epi32(row1, x1)), &c11);
+
+    res->r = Sampler_Lerp8(Sampler_Lerp8(c00.r, c01.r, fx), Sampler_Lerp8(c10.r, c11.r, fx), fy);
+    res->g = Sampler_Lerp8(Sampler_Lerp8(c00.g, c01.g, fx), Sampler_Lerp8(c10.g, c11.g, fx), fy);
+    res->b = Sampler_Lerp8(Sampler_Lerp8(c00.b, c01.b, fx), Sampler_Lerp8(c10.b, c11.b, fx), fy);
+}
+
+void Sampler_Sample8(
+    MeshTexture *texture, SamplerFilter filter, SamplerChannel channel,
+    const float *u, const float *v, float lod, float out[3][8])
+{
+    if (MeshTextureFormat_IsCompressed(texture->m_format))
+    {
+        Sampler_SampleCompressed(texture, filter, channel, u, v, lod, out[0], 8);
+        return;
+    }
+
+    __m256 u8 = Sampler_Wrap8(_mm256_loadu_ps(u));
+    __m256 v8 = Sampler_Wrap8(_mm256_loadu_ps(v));
+    SamplerRGB8 res;
+
+    switch (filter)
+    {
+    case SAMPLER_NEAREST:
+        Sampler_Nearest8(texture, 0, u8, v8, &res);
+        break;
+
+    case SAMPLER_BILINEAR:
+        Sampler_Bilinear8(texture, 0, u8, v8, &res);
+        break;
+
+    case SAMPLER_TRILINEAR:
+    default:
+    {
+        int level0, level1;
+        __m256 t = _mm256_set1_ps(Sampler_SplitLod(texture, lod, &level0, &level1));
+        SamplerRGB8 res1;
+        Sampler_Bilinear8(texture, level0, u8, v8, &res);
+        Sampler_Bilinear8(texture, level1, u8, v8, &res1);
+        res.r = Sampler_Lerp8(res.r, res1.r, t);
+        res.g = Sampler_Lerp8(res.g, res1.g, t);
+        res.b = Sampler_Lerp8(res.b, res1.b, t);
+        break;
+    }
+    }
+
+    __m256 scale = _mm256_set1_ps(g_samplerScale[channel]);
+    __m256 bias = _mm256_set1_ps(g_samplerBias[channel]);
+    _mm256_storeu_ps(out[0], _mm256_add_ps(_mm256_mul_ps(res.r, scale), bias));
+    _mm256_storeu_ps(out[1], _mm256_add_ps(_mm256_mul_ps(res.g, scale), bias));
+    _mm256_storeu_ps(out[2], _mm256_add_ps(_mm256_mul_ps(res.b, scale), bias));
+}
+
+#else
+
+void Sampler_Sample8(
+    MeshTexture *texture, SamplerFilter filter, SamplerChannel channel,
+    const float *u, const float *v, float lod, float out[3][8])
+{
+    // Sans AVX2, deux appels SSE
+    float half[3][4];
+    for (int i = 0; i < 2; ++i)
+    {
+        Sampler_Sample4(texture, filter, channel, u + 4 * i, v + 4 * i, lod, half);
+        for (int c = 0; c < 3; ++c)
+        {
+            memcpy(out[c] + 4 * i, half[c], 4 * sizeof(float));
+        }
+    }
+}
+
+#endif
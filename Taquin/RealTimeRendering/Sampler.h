@@ -0,0 +1,88 @@
+﻿#ifndef _SAMPLER_H_
+#define _SAMPLER_H_
+
+/// @file Sampler.h
+/// @defgroup Sampler
+/// @{
+
+#include "Settings.h"
+#include "Vector.h"
+#include "Material.h"
+
+/// @brief Nombre d'échantillons traités par un appel à Sampler_Sample8().
+#define SAMPLER_BATCH_SIZE 8
+
+/// @brief Mode de filtrage utilisé pour lire une texture.
+typedef enum SamplerFilter_e
+{
+    /// @brief Texel le plus proche dans le niveau 0.
+    SAMPLER_NEAREST,
+
+    /// @brief Interpolation bilinéaire des quatre texels voisins dans le niveau 0.
+    SAMPLER_BILINEAR,
+
+    /// @brief Interpolation bilinéaire dans les deux niveaux de mipmap encadrant le lod,
+    /// puis interpolation linéaire entre ces deux niveaux.
+    SAMPLER_TRILINEAR,
+
+    SAMPLER_FILTER_COUNT
+} SamplerFilter;
+
+/// @brief Interprétation des canaux lus dans la texture.
+typedef enum SamplerChannel_e
+{
+    /// @brief Couleur (rgb) dans [0,1].
+    SAMPLER_ALBEDO,
+
+    /// @brief Normale dans l'espace tangent, les canaux sont ramenés dans [-1,1].
+    SAMPLER_NORMAL
+} SamplerChannel;
+
+/// @brief Calcule le niveau de mipmap à utiliser pour une texture.
+/// @param[in] texture la texture.
+/// @param[in] uvLod logarithme en base 2 de la taille (dans l'espace uv) couverte par un pixel.
+/// @return Le niveau de mipmap (non borné) correspondant pour cette texture.
+INLINE float Sampler_GetLod(MeshTexture *texture, float uvLod)
+{
+    return uvLod + texture->m_lodBias;
+}
+
+/// @brief Lit une texture en un point.
+/// @param[in] texture la texture.
+/// @param[in] filter le mode de filtrage.
+/// @param[in] channel l'interprétation des canaux.
+/// @param[in] textUV les coordonnées uv (répétées en dehors de [0,1]).
+/// @param[in] lod le niveau de mipmap (utilisé uniquement en mode trilinéaire).
+/// @return La valeur filtrée.
+Vec3 Sampler_Sample(
+    MeshTexture *texture, SamplerFilter filter, SamplerChannel channel,
+    Vec2 textUV, float lod);
+
+/// @brief Lit une texture en quatre points (SSE).
+/// Les sorties sont rangées par canal : out[0] contient les quatre rouges (ou x), etc.
+/// @param[in] texture la texture.
+/// @param[in] filter le mode de filtrage.
+/// @param[in] channel l'interprétation des canaux.
+/// @param[in] u les quatre coordonnées u.
+/// @param[in] v les quatre coordonnées v.
+/// @param[in] lod le niveau de mipmap commun aux quatre points.
+/// @param[out] out les valeurs filtrées.
+void Sampler_Sample4(
+    MeshTexture *texture, SamplerFilter filter, SamplerChannel channel,
+    const float *u, const float *v, float lod, float out[3][4]);
+
+/// @brief Lit une texture en huit points (AVX2 si disponible, deux appels SSE sinon).
+/// @param[in] texture la texture.
+/// @param[in] filter le mode de filtrage.
+/// @param[in] channel l'interprétation des canaux.
+/// @param[in] u les huit coordonnées u.
+/// @param[in] v les huit coordonnées v.
+/// @param[in] lod le niveau de mipmap commun aux huit points.
+/// @param[out] out les valeurs filtrées.
+void Sampler_Sample8(
+    MeshTexture *texture, SamplerFilter filter, SamplerChannel channel,
+    const float *u, const float *v, float lod, float out[3][8]);
+
+/// @}
+
+#endif
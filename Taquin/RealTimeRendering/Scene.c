@@ -5,6 +5,7 @@
 #include "Object.h"
 #include "Graphics.h"
 #include "Shader.h"
+#include "MeshCache.h"
 
 Scene *Scene_New(Window *window)
 {
@@ -23,6 +24,14 @@ Scene *Scene_New(Window *window)
     scene->m_meshCount = 0;
     scene->m_meshCapacity = meshCapacity;
 
+    SceneBvh_Init(&scene->m_bvh);
+
+    // Classes de taille des objets
+    for (int i = 0; i < SCENE_OBJECT_POOL_COUNT; ++i)
+    {
+        MemoryPool_Init(
+            &scene->m_objectPools[i], SCENE_OBJECT_MIN_SIZE << i, SCENE_OBJECTS_PER_SLAB);
+    }
 
     // Crée la racine
     Object *root = Scene_CreateObject(scene, sizeof(Object));
@@ -51,6 +60,12 @@ Scene *Scene_New(Window *window)
     // Définit les shaders par défaut
     scene->m_defaultVShader = VertexShader_Base;
     scene->m_defaultFShader = FragmentShader_Base;
+    scene->m_textureFilter = SAMPLER_NEAREST;
+    scene->m_lodPixelError = 1.0f;
+    scene->m_meshletCulling = true;
+    scene->m_ambientOcclusion = true;
+    scene->m_submeshSorting = true;
+    scene->m_depthPrepass = false;
 
     return scene;
 
@@ -61,12 +76,42 @@ ERROR_LABEL:
     return NULL;
 }
 
+/// @brief Détruit les lots d'objets statiques et leurs meshs fusionnés.
+static void Scene_FreeStaticBatches(Scene *scene)
+{
+    for (int i = 0; i < scene->m_staticBatchCount; ++i)
+    {
+        Object *batch = scene->m_staticBatches[i];
+        Mesh *mesh = Object_GetMesh(batch);
+
+        Scene_RemoveObject(scene, batch);
+        Mesh_Free(mesh);
+    }
+    free(scene->m_staticBatches);
+
+    scene->m_staticBatches = NULL;
+    scene->m_staticBatchCount = 0;
+}
+
 void Scene_Free(Scene *scene)
 {
     if (!scene) return;
 
+    // Attend la fin des chargements en cours : leurs meshs sont libérés avec les autres,
+    // après les objets et les lots statiques qui les utilisent
+    for (int i = 0; i < scene->m_loadCount; ++i)
+    {
+        SDL_WaitThread(scene->m_loads[i]->m_thread, NULL);
+    }
+
     // Supprime l'ensemble des objets
     Scene_RemoveObject(scene, scene->m_root);
+    Scene_FreeStaticBatches(scene);
+    RenderList_Free(&scene->m_renderList);
+
+    assert(scene->m_dirtyCount == 0 && SceneBvh_GetLeafCount(&scene->m_bvh) == 0);
+    SceneBvh_Free(&scene->m_bvh);
+    free(scene->m_dirtyObjects);
 
     // Supprime les meshes
     int meshCount = scene->m_meshCount;
@@ -76,6 +121,20 @@ void Scene_Free(Scene *scene)
     }
     free(scene->m_meshes);
 
+    for (int i = 0; i < scene->m_loadCount; ++i)
+    {
+        Mesh_Free(scene->m_loads[i]->m_mesh);
+        free(scene->m_loads[i]);
+    }
+    free(scene->m_loads);
+
+    // Tous les objets ont été rendus à leur pool
+    for (int i = 0; i < SCENE_OBJECT_POOL_COUNT; ++i)
+    {
+        assert(MemoryPool_GetUsedCount(&scene->m_objectPools[i]) == 0);
+        MemoryPool_Free(&scene->m_objectPools[i]);
+    }
+
     // Met à zéro la mémoire (sécurité)
     memset(scene, 0, sizeof(Scene));
 
@@ -88,7 +147,15 @@ Object *Scene_CreateObject(Scene *scene, int size)
 
     assert(size >= sizeof(Object));
 
-    object = (Object *)calloc(1, size);
+    // Plus petite classe de taille pouvant contenir l'objet
+    int poolIndex = 0;
+    while (poolIndex < SCENE_OBJECT_POOL_COUNT && (SCENE_OBJECT_MIN_SIZE << poolIndex) < size)
+    {
+        poolIndex++;
+    }
+    if (poolIndex >= SCENE_OBJECT_POOL_COUNT) goto ERROR_LABEL;
+
+    object = (Object *)MemoryPool_Alloc(&scene->m_objectPools[poolIndex]);
     if (!object) goto ERROR_LABEL;
 
     return object;
@@ -99,6 +166,21 @@ ERROR_LABEL:
     return NULL;
 }
 
+/// @brief Retire un objet de la liste des objets modifiés. Le verrou doit être pris.
+static void Scene_RemoveDirtyObject(Scene *scene, Object *object)
+{
+    int index = object->m_dirtyIndex;
+    assert(0 <= index && index < scene->m_dirtyCount);
+    assert(scene->m_dirtyObjects[index] == object);
+
+    // Le dernier objet de la liste prend sa place
+    Object *last = scene->m_dirtyObjects[--scene->m_dirtyCount];
+    scene->m_dirtyObjects[index] = last;
+    last->m_dirtyIndex = index;
+
+    object->m_dirtyIndex = -1;
+}
+
 void Scene_RemoveObject(Scene *scene, Object *object)
 {
     assert(scene && object);
@@ -109,8 +191,28 @@ void Scene_RemoveObject(Scene *scene, Object *object)
         Scene_RemoveObject(scene, child);
     }
 
+    // Un objet statique supprimé doit disparaître de son lot
+    if (Object_IsStatic(object))
+    {
+        Scene_InvalidateStaticBatches(scene);
+    }
+
+    // L'objet quitte la BVH et la liste des objets modifiés
+    SDL_AtomicLock(&scene->m_dirtyLock);
+    if (object->m_dirtyIndex >= 0)
+    {
+        Scene_RemoveDirtyObject(scene, object);
+    }
+    SDL_AtomicUnlock(&scene->m_dirtyLock);
+
+    if (object->m_bvhLeaf != SCENE_BVH_NULL)
+    {
+        SceneBvh_Remove(&scene->m_bvh, object->m_bvhLeaf);
+        object->m_bvhLeaf = SCENE_BVH_NULL;
+    }
+
     Object_Destroy(object);
-    free(object);
+    MemoryPool_Release(object);
 }
 
 static int Scene_EnsureMeshCapacity(Scene *scene, int meshCount)
@@ -136,24 +238,56 @@ ERROR_LABEL:
     return EXIT_FAILURE;
 }
 
+/// @brief Charge un mesh et ses matériaux, sans décoder les textures.
+/// Cette fonction peut être appelée depuis un thread de travail.
+static Mesh *Scene_LoadMesh(char *folderPath, char *fileName)
+{
+    // Utilise le fichier .rtmesh s'il est à jour
+    Mesh *mesh = MeshCache_Load(folderPath, fileName);
+    if (!mesh)
+    {
+        // Les erreurs sont signalées par Mesh_LoadOBJ(), un fichier vide n'en est pas une
+        mesh = Mesh_LoadOBJ(folderPath, fileName);
+        if (!mesh) return NULL;
+
+        // Le mesh reste utilisable même si le cache ne peut pas être écrit
+        MeshCache_Store(mesh, folderPath, fileName);
+    }
+
+    // Les sommets en flottants 32 bits sont remplacés par les sommets compressés
+    // après l'écriture du cache, qui les conserve (voir Mesh_SetQuantization())
+    if (Mesh_GetQuantization())
+    {
+        int exitStatus = Mesh_Quantize(mesh);
+        if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    }
+
+    return mesh;
+
+ERROR_LABEL:
+    printf("ERROR - Scene_LoadMesh()\n");
+    assert(false);
+    Mesh_Free(mesh);
+    return NULL;
+}
+
 Mesh *Scene_CreateMeshFromOBJ(Scene *scene, char *folderPath, char *fileName)
 {
     Mesh *mesh = NULL;
     int meshCount = scene->m_meshCount;
-    int meshCapacity = scene->m_meshCapacity;
 
     int exitStatus = Scene_EnsureMeshCapacity(scene, meshCount + 1);
     if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
 
-    mesh = Mesh_LoadOBJ(folderPath, fileName);
-    if (!mesh) goto ERROR_LABEL;
-
-    exitStatus = Mesh_ComputeTangents(mesh);
-    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    mesh = Scene_LoadMesh(folderPath, fileName);
+    if (!mesh) return NULL;
 
     scene->m_meshes[meshCount] = mesh;
     scene->m_meshCount = meshCount + 1;
 
+    exitStatus = Material_LoadTextures(mesh->m_materials, mesh->m_materialCount);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
     return mesh;
 
 ERROR_LABEL:
@@ -162,6 +296,66 @@ ERROR_LABEL:
     return NULL;
 }
 
+/// @brief Fonction exécutée par le thread d'un chargement asynchrone.
+static int Scene_LoadMeshThread(void *data)
+{
+    MeshLoad *load = (MeshLoad *)data;
+
+    Mesh *mesh = Scene_LoadMesh(load->m_folderPath, load->m_fileName);
+    if (!mesh)
+    {
+        SDL_AtomicSet(&load->m_state, MESH_LOAD_FAILED);
+        return EXIT_FAILURE;
+    }
+
+    // Publie le mesh : le rendu l'utilise sans textures en attendant la suite
+    SDL_AtomicSetPtr((void **)&load->m_mesh, mesh);
+    SDL_AtomicSet(&load->m_state, MESH_LOAD_TEXTURES);
+
+    // Les textures sont attachées une à une dès qu'elles sont décodées
+    int exitStatus = Material_LoadTextures(mesh->m_materials, mesh->m_materialCount);
+
+    SDL_AtomicSet(&load->m_state, MESH_LOAD_DONE);
+
+    return exitStatus;
+}
+
+MeshLoad *Scene_LoadMeshAsync(Scene *scene, char *folderPath, char *fileName)
+{
+    MeshLoad *load = NULL;
+
+    if (scene->m_loadCount >= scene->m_loadCapacity)
+    {
+        int loadCapacity = Int_Max(scene->m_loadCapacity << 1, 4);
+        MeshLoad **newLoads = (MeshLoad **)realloc(
+            scene->m_loads, loadCapacity * sizeof(MeshLoad *));
+        if (!newLoads) goto ERROR_LABEL;
+
+        scene->m_loads = newLoads;
+        scene->m_loadCapacity = loadCapacity;
+    }
+
+    load = (MeshLoad *)calloc(1, sizeof(MeshLoad));
+    if (!load) goto ERROR_LABEL;
+
+    strcpy_s(load->m_folderPath, MESH_NAME_SIZE, folderPath);
+    strcpy_s(load->m_fileName, MESH_NAME_SIZE, fileName);
+    SDL_AtomicSet(&load->m_state, MESH_LOAD_PENDING);
+
+    load->m_thread = SDL_CreateThread(Scene_LoadMeshThread, "MeshLoad", load);
+    if (!load->m_thread) goto ERROR_LABEL;
+
+    scene->m_loads[scene->m_loadCount++] = load;
+
+    return load;
+
+ERROR_LABEL:
+    printf("ERROR - Scene_LoadMeshAsync()\n");
+    assert(false);
+    free(load);
+    return NULL;
+}
+
 Object *Scene_GetRoot(Scene *scene)
 {
     return scene->m_root;
@@ -173,20 +367,310 @@ Camera *Scene_GetCamera(Scene *scene)
 }
 
 
-void Scene_RenderObjectRec(Scene *scene, Object *object)
+/// @brief Objet statique collecté par Scene_BuildStaticBatches().
+typedef struct SceneStaticEntry_s
 {
-    int childCount = Object_GetChildCount(object);
-    Object **children = Object_GetChildren(object);
-    for (int i = 0; i < childCount; ++i)
+    Mesh *m_mesh;
+    Mat4  m_transform;
+} SceneStaticEntry;
+
+/// @brief Ajoute récursivement les objets statiques d'un sous-arbre à un tableau.
+static int Scene_CollectStaticObjects(
+    Object *object, Mat4 parentTransform,
+    SceneStaticEntry **entries, int *count, int *capacity)
+{
+    Mat4 transform = Mat4_MulMM(parentTransform, Object_GetLocalTransform(object));
+
+    if (Scene_IsObjectBatched(object))
     {
-        Scene_RenderObjectRec(scene, children[i]);
+        if (*count >= *capacity)
+        {
+            int newCapacity = Int_Max(*capacity << 1, 16);
+            SceneStaticEntry *newEntries = (SceneStaticEntry *)realloc(
+                *entries, newCapacity * sizeof(SceneStaticEntry));
+            if (!newEntries) goto ERROR_LABEL;
+
+            *entries = newEntries;
+            *capacity = newCapacity;
+        }
+
+        SceneStaticEntry *entry = &(*entries)[(*count)++];
+        entry->m_mesh = Object_GetMesh(object);
+        entry->m_transform = transform;
     }
 
-    Renderer *renderer = scene->m_renderer;
-    VertexShader *vertShader = scene->m_defaultVShader;
-    FragmentShader *fragShader = scene->m_defaultFShader;
+    Object *child = Object_GetFirstChild(object);
+    for (; child; child = Object_GetNextSibling(child))
+    {
+        int exitStatus = Scene_CollectStaticObjects(
+            child, transform, entries, count, capacity);
+        if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    }
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - Scene_CollectStaticObjects()\n");
+    assert(false);
+    return EXIT_FAILURE;
+}
 
-    Graphics_RenderObject(renderer, object, vertShader, fragShader);
+/// @brief Compare deux objets statiques selon leur mesh (pour qsort()).
+static int Scene_CompareStaticEntries(const void *a, const void *b)
+{
+    uintptr_t meshA = (uintptr_t)((const SceneStaticEntry *)a)->m_mesh;
+    uintptr_t meshB = (uintptr_t)((const SceneStaticEntry *)b)->m_mesh;
+
+    return (meshA > meshB) - (meshA < meshB);
+}
+
+int Scene_BuildStaticBatches(Scene *scene)
+{
+    SceneStaticEntry *entries = NULL;
+    Mat4 *transforms = NULL;
+    Object **batches = NULL;
+    Object *batch = NULL;
+    Mesh *mesh = NULL;
+    int entryCount = 0;
+    int entryCapacity = 0;
+    int batchCount = 0;
+    int exitStatus;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    Scene_FreeStaticBatches(scene);
+    scene->m_staticBatchesDirty = false;
+
+    exitStatus = Scene_CollectStaticObjects(
+        scene->m_root, Mat4_Identity, &entries, &entryCount, &entryCapacity);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    if (entryCount == 0)
+    {
+        free(entries);
+        return EXIT_SUCCESS;
+    }
+
+    // Les objets partageant un mesh (et donc ses matériaux) deviennent consécutifs
+    qsort(entries, entryCount, sizeof(SceneStaticEntry), Scene_CompareStaticEntries);
+
+    transforms = (Mat4 *)calloc(entryCount, sizeof(Mat4));
+    batches = (Object **)calloc(entryCount, sizeof(Object *));
+    if (!transforms || !batches) goto ERROR_LABEL;
+
+    int first = 0;
+    while (first < entryCount)
+    {
+        Mesh *source = entries[first].m_mesh;
+        int last = first;
+        while (last < entryCount && entries[last].m_mesh == source)
+        {
+            transforms[last - first] = entries[last].m_transform;
+            last++;
+        }
+
+        mesh = Mesh_CreateMerged(source, transforms, last - first);
+        if (!mesh) goto ERROR_LABEL;
+
+        // Le lot est un objet hors de l'arbre, placé à l'origine du monde
+        batch = Scene_CreateObject(scene, sizeof(Object));
+        if (!batch) goto ERROR_LABEL;
+
+        exitStatus = Object_Init(batch, scene, Mat4_Identity, NULL);
+        if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+        Object_SetMesh(batch, mesh);
+        batches[batchCount++] = batch;
+        batch = NULL;
+        mesh = NULL;
+
+        first = last;
+    }
+
+    scene->m_staticBatches = batches;
+    scene->m_staticBatchCount = batchCount;
+
+    double elapsed = 1000.0 * (double)(SDL_GetPerformanceCounter() - start)
+        / (double)SDL_GetPerformanceFrequency();
+    printf("Objets statiques : %d objets en %d lots (%.1f ms)\n",
+        entryCount, batchCount, elapsed);
+
+    free(entries);
+    free(transforms);
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - Scene_BuildStaticBatches()\n");
+    assert(false);
+    if (batch)
+    {
+        Scene_RemoveObject(scene, batch);
+    }
+    Mesh_Free(mesh);
+    scene->m_staticBatches = batches;
+    scene->m_staticBatchCount = batchCount;
+    Scene_FreeStaticBatches(scene);
+    free(entries);
+    free(transforms);
+    return EXIT_FAILURE;
+}
+
+void Scene_InvalidateObjectBounds(Scene *scene, Object *object)
+{
+    SDL_AtomicLock(&scene->m_dirtyLock);
+
+    if (object->m_dirtyIndex < 0)
+    {
+        if (scene->m_dirtyCount >= scene->m_dirtyCapacity)
+        {
+            int capacity = Int_Max(scene->m_dirtyCapacity << 1, 64);
+            Object **newObjects = (Object **)realloc(
+                scene->m_dirtyObjects, capacity * sizeof(Object *));
+            if (!newObjects) goto ERROR_LABEL;
+
+            scene->m_dirtyObjects = newObjects;
+            scene->m_dirtyCapacity = capacity;
+        }
+
+        object->m_dirtyIndex = scene->m_dirtyCount;
+        scene->m_dirtyObjects[scene->m_dirtyCount++] = object;
+    }
+
+    SDL_AtomicUnlock(&scene->m_dirtyLock);
+    return;
+
+ERROR_LABEL:
+    SDL_AtomicUnlock(&scene->m_dirtyLock);
+    printf("ERROR - Scene_InvalidateObjectBounds()\n");
+    assert(false);
+}
+
+/// @brief Calcule la boîte englobante d'un objet dans le référentiel monde.
+/// @return false si l'objet ne doit pas figurer dans la BVH.
+static bool Scene_GetObjectBounds(Object *object, Vec3 *min, Vec3 *max)
+{
+    Mesh *mesh = Object_GetMesh(object);
+    if (!mesh || Scene_IsObjectBatched(object))
+        return false;
+
+    if (object->m_vptr && object->m_vptr->GetBounds)
+    {
+        // Classe fille dessinant plus que son mesh (InstanceGroup...)
+        if (!object->m_vptr->GetBounds(object, min, max))
+            return false;
+    }
+    else
+    {
+        *min = mesh->m_min;
+        *max = mesh->m_max;
+    }
+
+    Mat4_TransformBox(object->m_worldTransform, min, max);
+    return true;
+}
+
+/// @brief Met à jour la matrice monde et la feuille des objets d'un sous-arbre.
+static void Scene_UpdateSubtreeBounds(Scene *scene, Object *object, Mat4 parentTransform)
+{
+    object->m_worldTransform = Mat4_MulMM(parentTransform, object->m_localTransform);
+
+    // Un descendant modifié est mis à jour en même temps que son ancêtre
+    if (object->m_dirtyIndex >= 0)
+    {
+        Scene_RemoveDirtyObject(scene, object);
+    }
+
+    Vec3 min, max;
+    if (Scene_GetObjectBounds(object, &min, &max))
+    {
+        if (object->m_bvhLeaf == SCENE_BVH_NULL)
+        {
+            object->m_bvhLeaf = SceneBvh_Insert(&scene->m_bvh, object, min, max);
+        }
+        else
+        {
+            SceneBvh_Move(&scene->m_bvh, object->m_bvhLeaf, min, max);
+        }
+    }
+    else if (object->m_bvhLeaf != SCENE_BVH_NULL)
+    {
+        SceneBvh_Remove(&scene->m_bvh, object->m_bvhLeaf);
+        object->m_bvhLeaf = SCENE_BVH_NULL;
+    }
+
+    Object *child = Object_GetFirstChild(object);
+    for (; child; child = Object_GetNextSibling(child))
+    {
+        Scene_UpdateSubtreeBounds(scene, child, object->m_worldTransform);
+    }
+}
+
+void Scene_UpdateBounds(Scene *scene)
+{
+    SDL_AtomicLock(&scene->m_dirtyLock);
+
+    // Les objets sont retirés de la fin de la liste, ce qui permet à
+    // Scene_UpdateSubtreeBounds() d'en retirer les descendants déjà traités
+    while (scene->m_dirtyCount > 0)
+    {
+        Object *object = scene->m_dirtyObjects[scene->m_dirtyCount - 1];
+        Object *parent = Object_GetParent(object);
+
+        Scene_UpdateSubtreeBounds(
+            scene, object, parent ? parent->m_worldTransform : Mat4_Identity);
+    }
+
+    SDL_AtomicUnlock(&scene->m_dirtyLock);
+}
+
+int Scene_QueryBox(Scene *scene, Vec3 min, Vec3 max)
+{
+    Scene_UpdateBounds(scene);
+    return SceneBvh_QueryBox(&scene->m_bvh, min, max);
+}
+
+int Scene_QueryRay(Scene *scene, Vec3 origin, Vec3 direction, float maxDistance)
+{
+    Scene_UpdateBounds(scene);
+    return SceneBvh_QueryRay(&scene->m_bvh, origin, direction, maxDistance);
+}
+
+Object *Scene_Pick(Scene *scene, Vec3 origin, Vec3 direction, MeshRayHit *hit)
+{
+    Object *picked = NULL;
+    float maxDistance = INFINITY;
+
+    int count = Scene_QueryRay(scene, origin, direction, maxDistance);
+    for (int i = 0; i < count; ++i)
+    {
+        // Les boîtes suivantes commencent après le triangle le plus proche trouvé
+        if (SceneBvh_GetResultDistance(&scene->m_bvh, i) > maxDistance)
+            break;
+
+        Object *object = Scene_GetQueryResult(scene, i);
+        Mesh *mesh = Object_GetMesh(object);
+        if (!mesh || (object->m_vptr && object->m_vptr->Render))
+            continue;
+
+        // Rayon dans le repère du mesh : la direction n'est pas normalisée
+        // pour conserver les distances
+        Mat4 worldToObject = Mat4_Inv(object->m_worldTransform);
+        Vec3 localOrigin = Vec3_From4(Mat4_MulMV(worldToObject, Vec4_From3(origin, 1.0f)));
+        Vec4 localDirection = Mat4_MulMV(worldToObject, Vec4_From3(direction, 0.0f));
+
+        MeshRayHit objectHit;
+        if (MeshBvh_RayCast(
+            mesh, localOrigin, Vec3_Set(localDirection.x, localDirection.y, localDirection.z),
+            maxDistance, &objectHit))
+        {
+            maxDistance = objectHit.m_distance;
+            *hit = objectHit;
+            picked = object;
+        }
+    }
+
+    return picked;
 }
 
 void Scene_Render(Scene *scene, float randR, float randG, float randB, float randA)
@@ -194,5 +678,49 @@ void Scene_Render(Scene *scene, float randR, float randG, float randB, float ran
     Vec4 backgroundColor = Vec4_Set(randR, randG, randB, randA);
     Renderer_ResetDepthBuffer(scene->m_renderer);
     Renderer_Fill(scene->m_renderer, backgroundColor);
-    Scene_RenderObjectRec(scene, Scene_GetRoot(scene));
+
+    // Lots d'objets statiques, reconstruits seulement après une modification
+    if (scene->m_staticBatchesDirty)
+    {
+        Scene_BuildStaticBatches(scene);
+    }
+
+    // Objets coupant le frustum, trouvés dans la BVH
+    Camera *camera = Scene_GetCamera(scene);
+    Vec4 planes[GRAPHICS_FRUSTUM_PLANE_COUNT];
+    Graphics_GetWorldFrustumPlanes(camera, planes);
+
+    Scene_UpdateBounds(scene);
+    int count = SceneBvh_QueryPlanes(&scene->m_bvh, planes, GRAPHICS_FRUSTUM_PLANE_COUNT);
+
+    // Liste des objets à rendre
+    RenderList *list = &scene->m_renderList;
+    RenderList_Clear(list);
+    for (int i = 0; i < count; ++i)
+    {
+        Object *object = SceneBvh_GetResult(&scene->m_bvh, i);
+        int exitStatus = RenderList_Add(
+            list, object, Object_GetMesh(object), object->m_worldTransform);
+        if (exitStatus != EXIT_SUCCESS) return;
+    }
+
+    RenderList_Cull(list, camera);
+
+    Renderer *renderer = scene->m_renderer;
+    if (scene->m_depthPrepass && !Scene_GetWireframe(scene))
+    {
+        // Pré-passe : profondeur seule, sans interpolation ni fragment shader
+        Renderer_SetDepthOnly(renderer, true);
+        RenderList_Render(list, renderer, scene->m_defaultVShader, scene->m_defaultFShader);
+        Renderer_SetDepthOnly(renderer, false);
+
+        // Passe d'ombrage : seul le fragment visible de chaque pixel passe le test d'égalité
+        Renderer_SetDepthTest(renderer, RENDERER_DEPTH_EQUAL);
+        RenderList_Render(list, renderer, scene->m_defaultVShader, scene->m_defaultFShader);
+        Renderer_SetDepthTest(renderer, RENDERER_DEPTH_LESS_EQUAL);
+    }
+    else
+    {
+        RenderList_Render(list, renderer, scene->m_defaultVShader, scene->m_defaultFShader);
+    }
 }
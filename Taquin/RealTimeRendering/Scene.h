@@ -14,6 +14,52 @@
 #include "Object.h"
 #include "Graphics.h"
 #include "Shader.h"
+#include "Sampler.h"
+#include "RenderList.h"
+#include "MemoryPool.h"
+#include "SceneBvh.h"
+#include "MeshBvh.h"
+
+/// @brief Nombre de classes de taille des objets d'une scène (voir Scene_CreateObject()).
+#define SCENE_OBJECT_POOL_COUNT 3
+
+/// @brief Taille (en octets) de la plus petite classe. Chaque classe double la précédente,
+/// un objet ne peut donc pas dépasser SCENE_OBJECT_MIN_SIZE << (SCENE_OBJECT_POOL_COUNT - 1).
+#define SCENE_OBJECT_MIN_SIZE 128
+
+/// @brief Nombre d'objets alloués d'un coup par chaque classe.
+#define SCENE_OBJECTS_PER_SLAB 256
+
+/// @brief État d'un chargement asynchrone de mesh.
+typedef enum MeshLoadState_e
+{
+    /// @brief Lecture du fichier obj (ou du fichier .rtmesh) en cours.
+    MESH_LOAD_PENDING,
+
+    /// @brief Mesh disponible, décodage des textures en cours.
+    MESH_LOAD_TEXTURES,
+
+    /// @brief Mesh et textures chargés.
+    MESH_LOAD_DONE,
+
+    /// @brief Le mesh n'a pas pu être chargé (fichier vide ou erreur).
+    MESH_LOAD_FAILED
+} MeshLoadState;
+
+/// @brief Chargement d'un mesh par un thread de travail (voir Scene_LoadMeshAsync()).
+typedef struct MeshLoad_s
+{
+    char m_folderPath[MESH_NAME_SIZE];
+    char m_fileName[MESH_NAME_SIZE];
+
+    SDL_Thread *m_thread;
+
+    /// @brief État du chargement (MeshLoadState).
+    SDL_atomic_t m_state;
+
+    /// @brief Mesh publié par le thread de travail (NULL tant qu'il n'est pas prêt).
+    Mesh *m_mesh;
+} MeshLoad;
 
 /// @brief Structure représentant une scène 3D.
 /// Contient la racine de l'arbre de scène ainsi qu'une caméra par laquelle la scène sera rendue.
@@ -27,6 +73,12 @@ typedef struct Scene_s
     int m_meshCount;
     int m_meshCapacity;
 
+    /// @brief Chargements asynchrones lancés par Scene_LoadMeshAsync().
+    /// Leurs meshs appartiennent à la scène.
+    MeshLoad **m_loads;
+    int m_loadCount;
+    int m_loadCapacity;
+
     Vec3 m_lightDirection;
     Vec3 m_lightColor;
     Vec3 m_ambiantColor;
@@ -36,6 +88,52 @@ typedef struct Scene_s
 
     bool m_wireframe;
     bool m_normalMapOnOff;
+
+    SamplerFilter m_textureFilter;
+
+    /// @brief Erreur maximale (en pixels) tolérée lors du choix du niveau de détail d'un mesh.
+    float m_lodPixelError;
+
+    /// @brief Indique si les meshlets vus de dos ou hors du frustum sont rejetés.
+    bool m_meshletCulling;
+
+    /// @brief Indique si l'occlusion ambiante précalculée des meshs est utilisée.
+    bool m_ambientOcclusion;
+
+    /// @brief Indique si les sous-meshes d'un objet sont dessinés du plus proche
+    /// au plus éloigné de la caméra.
+    bool m_submeshSorting;
+
+    /// @brief Indique si le rendu commence par une pré-passe de profondeur.
+    bool m_depthPrepass;
+
+    /// @brief Lots d'objets statiques (voir Scene_BuildStaticBatches()).
+    /// Ces objets n'appartiennent pas à l'arbre de scène et portent chacun un mesh fusionné.
+    Object **m_staticBatches;
+    int m_staticBatchCount;
+
+    /// @brief Indique si les lots doivent être reconstruits avant le prochain rendu.
+    bool m_staticBatchesDirty;
+
+    /// @brief Objets à rendre, reconstruits à chaque image.
+    RenderList m_renderList;
+
+    /// @brief Hiérarchie de boîtes englobantes des objets ayant un mesh
+    /// (voir Scene_UpdateBounds()).
+    SceneBvh m_bvh;
+
+    /// @brief Objets modifiés depuis la dernière mise à jour de la BVH.
+    /// Leurs descendants sont mis à jour avec eux.
+    Object **m_dirtyObjects;
+    int m_dirtyCount;
+    int m_dirtyCapacity;
+
+    /// @brief Verrou protégeant la liste des objets modifiés
+    /// (un mesh peut être défini depuis un autre thread).
+    SDL_SpinLock m_dirtyLock;
+
+    /// @brief Blocs dans lesquels sont alloués les objets, par classe de taille.
+    MemoryPool m_objectPools[SCENE_OBJECT_POOL_COUNT];
 } Scene;
 
 //-------------------------------------------------------------------------------------------------
@@ -47,6 +145,7 @@ typedef struct Scene_s
 Scene *Scene_New(Window *window);
 
 /// @brief Détruit une scène.
+/// Attend la fin des chargements asynchrones.
 /// Les objets présents dans l'arbre de scène sont supprimés récursivement.
 /// Attention, cette fonction ne libère pas les meshs associés puisqu'un mesh peut être
 /// associé à plusieurs objets.
@@ -55,6 +154,8 @@ void Scene_Free(Scene *scene);
 
 /// @brief Alloue un objet.
 /// L'objet doit ensuite être initialiser.
+/// Il est pris dans les blocs de la scène correspondant à sa taille (voir MemoryPool) :
+/// créer et supprimer de nombreux objets ne sollicite pas malloc().
 /// @param scene la scène.
 /// @param size la taille de l'objet en octets.
 /// @return Un pointeur vers l'objet alloué.
@@ -71,9 +172,36 @@ void Scene_RemoveObject(Scene *scene, Object *object);
 /// @param scene la scène
 /// @param folderPath le chemin du dossier contenant le fichier OBJ.
 /// @param fileName le nom du fichier OBJ.
-/// @return Un pointeur vers le mesh créé ou NULL en cas d'erreur.
+/// @return Un pointeur vers le mesh créé ou NULL si le fichier est vide ou en cas d'erreur.
 Mesh* Scene_CreateMeshFromOBJ(Scene *scene, char *folderPath, char *fileName);
 
+/// @brief Lance le chargement d'un mesh (et de ses matériaux) dans un thread de travail.
+/// La fonction rend la main immédiatement. Le mesh est publié dès qu'il est prêt,
+/// sans ses textures : elles sont attachées aux matériaux au fur et à mesure de leur
+/// décodage, pendant que la boucle de rendu continue.
+/// @param scene la scène.
+/// @param folderPath le chemin du dossier contenant le fichier OBJ.
+/// @param fileName le nom du fichier OBJ.
+/// @return Le chargement en cours ou NULL en cas d'erreur.
+MeshLoad *Scene_LoadMeshAsync(Scene *scene, char *folderPath, char *fileName);
+
+/// @brief Renvoie l'état d'un chargement asynchrone.
+/// @param load le chargement.
+/// @return L'état du chargement.
+INLINE MeshLoadState MeshLoad_GetState(MeshLoad *load)
+{
+    return (MeshLoadState)SDL_AtomicGet(&load->m_state);
+}
+
+/// @brief Renvoie le mesh d'un chargement asynchrone.
+/// Ses textures peuvent être encore en cours de décodage.
+/// @param load le chargement.
+/// @return Le mesh ou NULL s'il n'est pas encore prêt.
+INLINE Mesh *MeshLoad_GetMesh(MeshLoad *load)
+{
+    return (Mesh *)SDL_AtomicGetPtr((void **)&load->m_mesh);
+}
+
 /// @brief Renvoie la racine de l'arbre d'une scène.
 /// @param scene la scène.
 /// @return L'objet à la racine de la scène.
@@ -121,7 +249,219 @@ INLINE bool Scene_GetWireframe(Scene *scene)
     return scene->m_wireframe;
 }
 
+/// @brief Définit le mode de filtrage utilisé pour lire les textures des matériaux.
+/// @param[in,out] scene la scène.
+/// @param filter le mode de filtrage.
+INLINE void Scene_SetTextureFilter(Scene *scene, SamplerFilter filter)
+{
+    scene->m_textureFilter = filter;
+}
+
+/// @brief Renvoie le mode de filtrage utilisé pour lire les textures des matériaux.
+/// @param[in] scene la scène.
+/// @return Le mode de filtrage.
+INLINE SamplerFilter Scene_GetTextureFilter(Scene *scene)
+{
+    return scene->m_textureFilter;
+}
+
+/// @brief Définit l'erreur maximale tolérée lors du choix du niveau de détail des meshs.
+/// Chaque objet est rendu avec le niveau le plus simplifié dont l'erreur géométrique,
+/// projetée à la distance de sa sphère englobante, ne dépasse pas ce seuil.
+/// @param[in,out] scene la scène.
+/// @param pixelError l'erreur en pixels (0 pour toujours utiliser les meshs complets).
+INLINE void Scene_SetLodPixelError(Scene *scene, float pixelError)
+{
+    scene->m_lodPixelError = pixelError;
+}
+
+/// @brief Renvoie l'erreur maximale tolérée lors du choix du niveau de détail des meshs.
+/// @param[in] scene la scène.
+/// @return L'erreur en pixels.
+INLINE float Scene_GetLodPixelError(Scene *scene)
+{
+    return scene->m_lodPixelError;
+}
+
+/// @brief Définit si les meshlets (voir Meshlet_Build()) entièrement vus de dos
+/// ou hors du frustum sont rejetés avant le vertex shader.
+/// @param[in,out] scene la scène.
+/// @param culling booléen indiquant si les meshlets sont rejetés.
+INLINE void Scene_SetMeshletCulling(Scene *scene, bool culling)
+{
+    scene->m_meshletCulling = culling;
+}
+
+/// @brief Renvoie un booléen indiquant si les meshlets invisibles sont rejetés.
+/// @param[in] scene la scène.
+/// @return Un booléen indiquant si les meshlets sont rejetés.
+INLINE bool Scene_GetMeshletCulling(Scene *scene)
+{
+    return scene->m_meshletCulling;
+}
+
+/// @brief Définit si l'occlusion ambiante précalculée des meshs (voir MeshOcclusion_Bake())
+/// assombrit la lumière ambiante. Les meshs sans occlusion ne sont pas concernés.
+/// @param[in,out] scene la scène.
+/// @param enabled booléen indiquant si l'occlusion ambiante est utilisée.
+INLINE void Scene_SetAmbientOcclusion(Scene *scene, bool enabled)
+{
+    scene->m_ambientOcclusion = enabled;
+}
+
+/// @brief Renvoie un booléen indiquant si l'occlusion ambiante précalculée est utilisée.
+/// @param[in] scene la scène.
+/// @return Un booléen indiquant si l'occlusion ambiante est utilisée.
+INLINE bool Scene_GetAmbientOcclusion(Scene *scene)
+{
+    return scene->m_ambientOcclusion;
+}
+
+/// @brief Définit si les sous-meshes (un par matériau) de chaque objet sont dessinés
+/// du plus proche au plus éloigné de la caméra, ou dans l'ordre de leur table.
+/// @param[in,out] scene la scène.
+/// @param enabled booléen indiquant si les sous-meshes sont triés.
+INLINE void Scene_SetSubmeshSorting(Scene *scene, bool enabled)
+{
+    scene->m_submeshSorting = enabled;
+}
+
+/// @brief Renvoie un booléen indiquant si les sous-meshes sont triés par distance à la caméra.
+/// @param[in] scene la scène.
+/// @return Un booléen indiquant si les sous-meshes sont triés.
+INLINE bool Scene_GetSubmeshSorting(Scene *scene)
+{
+    return scene->m_submeshSorting;
+}
+
+/// @brief Définit si le rendu se fait en deux passes. La pré-passe écrit seulement la
+/// profondeur des objets visibles, puis la passe d'ombrage ne shade que les fragments dont
+/// la profondeur est égale à celle du z-buffer : chaque pixel visible est shadé une seule fois,
+/// au prix d'une seconde transformation et rastérisation de la géométrie.
+/// Les deux passes refont entièrement l'ombrage des sommets, le choix du niveau de détail
+/// et l'élimination des meshlets : le mode est en général plus lent et ne sert qu'au
+/// débogage et à la comparaison avec le rendu en une passe.
+/// L'option est lue à chaque image et ignorée en vue en arêtes.
+/// @param[in,out] scene la scène.
+/// @param enabled booléen indiquant si la pré-passe de profondeur est utilisée.
+INLINE void Scene_SetDepthPrepass(Scene *scene, bool enabled)
+{
+    scene->m_depthPrepass = enabled;
+}
+
+/// @brief Renvoie un booléen indiquant si le rendu commence par une pré-passe de profondeur.
+/// @param[in] scene la scène.
+/// @return Un booléen indiquant si la pré-passe de profondeur est utilisée.
+INLINE bool Scene_GetDepthPrepass(Scene *scene)
+{
+    return scene->m_depthPrepass;
+}
+
+/// @brief Regroupe les objets statiques (voir Object_SetStatic()) en lots.
+/// Les objets statiques partageant le même mesh, et donc les mêmes matériaux, sont fusionnés
+/// en un mesh exprimé dans le référentiel monde, avec sa boîte englobante et ses meshlets
+/// (voir Mesh_CreateMerged()). Chaque lot est ensuite rendu en un seul appel à
+/// Graphics_RenderObject() au lieu d'un appel par objet.
+/// Cette fonction peut être appelée une fois la scène construite ; sinon, les lots sont
+/// reconstruits par Scene_Render() lorsqu'un objet statique a été modifié.
+/// @param[in,out] scene la scène.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int Scene_BuildStaticBatches(Scene *scene);
+
+/// @brief Indique si un objet est rendu dans un lot d'objets statiques
+/// plutôt qu'individuellement.
+/// @param[in] object l'objet.
+/// @return true si l'objet appartient à un lot.
+INLINE bool Scene_IsObjectBatched(Object *object)
+{
+    // Les classes filles ayant leur propre rendu ne sont pas fusionnées
+    return Object_IsStatic(object) && Object_GetMesh(object) &&
+        !(object->m_vptr && object->m_vptr->Render);
+}
+
+/// @brief Demande la reconstruction des lots d'objets statiques avant le prochain rendu.
+/// @param[in,out] scene la scène.
+INLINE void Scene_InvalidateStaticBatches(Scene *scene)
+{
+    scene->m_staticBatchesDirty = true;
+}
+
+/// @brief Renvoie le nombre de lots d'objets statiques.
+/// @param[in] scene la scène.
+/// @return Le nombre de lots.
+INLINE int Scene_GetStaticBatchCount(Scene *scene)
+{
+    return scene->m_staticBatchCount;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Requêtes spatiales
+
+/// @brief Signale qu'un objet a été modifié : sa boîte englobante et celles de ses
+/// descendants seront recalculées par Scene_UpdateBounds().
+/// Cette fonction est appelée par Object_Invalidate().
+/// @param[in,out] scene la scène.
+/// @param[in,out] object l'objet modifié.
+void Scene_InvalidateObjectBounds(Scene *scene, Object *object);
+
+/// @brief Met à jour la BVH de la scène.
+/// Seuls les objets modifiés depuis le dernier appel (et leurs descendants) sont parcourus :
+/// leur matrice dans le référentiel monde est recalculée et leur feuille n'est déplacée que
+/// si l'objet sort de sa boîte élargie (voir SceneBvh_Move()).
+/// Cette fonction est appelée par Scene_Render() et par les requêtes.
+/// @param[in,out] scene la scène.
+void Scene_UpdateBounds(Scene *scene);
+
+/// @brief Recherche les objets dont la boîte englobante coupe une boîte.
+/// Les objets trouvés sont lus avec Scene_GetQueryResult().
+/// @param[in,out] scene la scène.
+/// @param[in] min le coin minimal de la boîte dans le référentiel monde.
+/// @param[in] max le coin maximal de la boîte dans le référentiel monde.
+/// @return Le nombre d'objets trouvés.
+int Scene_QueryBox(Scene *scene, Vec3 min, Vec3 max);
+
+/// @brief Recherche les objets dont la boîte englobante est traversée par un rayon,
+/// du plus proche au plus éloigné (voir SceneBvh_QueryRay()).
+/// Les objets trouvés sont lus avec Scene_GetQueryResult().
+/// @param[in,out] scene la scène.
+/// @param[in] origin l'origine du rayon dans le référentiel monde.
+/// @param[in] direction la direction du rayon.
+/// @param[in] maxDistance la distance maximale, en multiples de direction.
+/// @return Le nombre d'objets trouvés.
+int Scene_QueryRay(Scene *scene, Vec3 origin, Vec3 direction, float maxDistance);
+
+/// @brief Renvoie un objet trouvé par la dernière requête de la scène.
+/// Les requêtes utilisent aussi la BVH pendant Scene_Render() :
+/// les résultats doivent être lus avant le rendu suivant.
+/// @param[in] scene la scène.
+/// @param[in] index l'indice du résultat.
+/// @return L'objet.
+INLINE Object *Scene_GetQueryResult(Scene *scene, int index)
+{
+    return SceneBvh_GetResult(&scene->m_bvh, index);
+}
+
+/// @brief Recherche l'objet dont un triangle est touché en premier par un rayon
+/// (sélection à la souris).
+/// Les objets sont parcourus du plus proche au plus éloigné selon leur boîte englobante,
+/// puis le rayon est lancé dans la BVH des triangles de leur mesh (voir MeshBvh_RayCast()).
+/// Les objets ayant leur propre rendu (InstanceGroup) sont ignorés.
+/// @param[in,out] scene la scène.
+/// @param[in] origin l'origine du rayon dans le référentiel monde.
+/// @param[in] direction la direction du rayon.
+/// @param[out] hit l'intersection trouvée, la distance étant exprimée dans le référentiel monde
+/// (en multiples de direction).
+/// @return L'objet touché ou NULL si le rayon ne touche aucun objet.
+Object *Scene_Pick(Scene *scene, Vec3 origin, Vec3 direction, MeshRayHit *hit);
+
+//-------------------------------------------------------------------------------------------------
+// Rendu
+
 /// @brief Calcul le rendu de la scène vue par sa caméra.
+/// La BVH de la scène est mise à jour puis parcourue pour trouver les objets coupant
+/// le frustum de la caméra, lots d'objets statiques compris. Ces objets sont rangés dans
+/// une liste plate (voir RenderList) et rendus du plus proche au plus éloigné,
+/// éventuellement en deux passes (voir Scene_SetDepthPrepass()).
 /// @param scene la scène dont il faut calculer le rendu.
 /// MODIFICATION DES PARAMETRES POUR Y INCLURE DES RAND EN ENTREE
 void Scene_Render(Scene *scene, float randR, float randG, float randB, float randA);
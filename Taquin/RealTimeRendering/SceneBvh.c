@@ -0,0 +1,587 @@
+﻿#include "SceneBvh.h"
+#include "Tools.h"
+
+void SceneBvh_Init(SceneBvh *bvh)
+{
+    memset(bvh, 0, sizeof(SceneBvh));
+    bvh->m_root = SCENE_BVH_NULL;
+    bvh->m_freeList = SCENE_BVH_NULL;
+}
+
+void SceneBvh_Free(SceneBvh *bvh)
+{
+    free(bvh->m_nodes);
+    free(bvh->m_stack);
+    free(bvh->m_results);
+    free(bvh->m_resultDistances);
+
+    SceneBvh_Init(bvh);
+}
+
+/// @brief Renvoie la demi-surface d'une boîte (coût d'un noeud).
+static float SceneBvh_GetArea(Vec3 min, Vec3 max)
+{
+    float dx = max.x - min.x;
+    float dy = max.y - min.y;
+    float dz = max.z - min.z;
+    return dx * dy + dy * dz + dz * dx;
+}
+
+/// @brief Indique si la boîte (outMin, outMax) contient la boîte (min, max).
+static bool SceneBvh_Contains(Vec3 outMin, Vec3 outMax, Vec3 min, Vec3 max)
+{
+    return outMin.x <= min.x && outMin.y <= min.y && outMin.z <= min.z
+        && max.x <= outMax.x && max.y <= outMax.y && max.z <= outMax.z;
+}
+
+/// @brief Élargit une boîte d'une marge proportionnelle à sa plus grande dimension.
+static void SceneBvh_Enlarge(Vec3 *min, Vec3 *max, float ratio)
+{
+    Vec3 size = Vec3_Sub(*max, *min);
+    float margin = ratio * fmaxf(size.x, fmaxf(size.y, size.z));
+    Vec3 offset = Vec3_Set(margin, margin, margin);
+
+    *min = Vec3_Sub(*min, offset);
+    *max = Vec3_Add(*max, offset);
+}
+
+/// @brief Garantit que count noeuds libres sont disponibles sans réallocation.
+static int SceneBvh_Reserve(SceneBvh *bvh, int count)
+{
+    if (bvh->m_nodeCount + count <= bvh->m_nodeCapacity)
+        return EXIT_SUCCESS;
+
+    int capacity = Int_Max(bvh->m_nodeCapacity << 1, Int_Max(bvh->m_nodeCount + count, 64));
+
+    SceneBvhNode *newNodes = (SceneBvhNode *)realloc(
+        bvh->m_nodes, capacity * sizeof(SceneBvhNode));
+    if (!newNodes) goto ERROR_LABEL;
+    bvh->m_nodes = newNodes;
+
+    // La pile d'un parcours ne contient jamais plus d'éléments que l'arbre
+    int *newStack = (int *)realloc(bvh->m_stack, capacity * sizeof(int));
+    if (!newStack) goto ERROR_LABEL;
+    bvh->m_stack = newStack;
+
+    // Chaîne les nouveaux noeuds dans la liste des noeuds libres
+    for (int i = capacity - 1; i >= bvh->m_nodeCapacity; --i)
+    {
+        bvh->m_nodes[i].m_parent = bvh->m_freeList;
+        bvh->m_nodes[i].m_height = -1;
+        bvh->m_freeList = i;
+    }
+    bvh->m_nodeCapacity = capacity;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - SceneBvh_Reserve()\n");
+    assert(false);
+    return EXIT_FAILURE;
+}
+
+/// @brief Prend un noeud dans la liste des noeuds libres (voir SceneBvh_Reserve()).
+static int SceneBvh_AllocateNode(SceneBvh *bvh)
+{
+    int index = bvh->m_freeList;
+    assert(index != SCENE_BVH_NULL);
+
+    SceneBvhNode *node = &bvh->m_nodes[index];
+    bvh->m_freeList = node->m_parent;
+
+    node->m_object = NULL;
+    node->m_parent = SCENE_BVH_NULL;
+    node->m_child1 = SCENE_BVH_NULL;
+    node->m_child2 = SCENE_BVH_NULL;
+    node->m_height = 0;
+    bvh->m_nodeCount++;
+
+    return index;
+}
+
+/// @brief Rend un noeud à la liste des noeuds libres.
+static void SceneBvh_FreeNode(SceneBvh *bvh, int index)
+{
+    SceneBvhNode *node = &bvh->m_nodes[index];
+
+    node->m_object = NULL;
+    node->m_parent = bvh->m_freeList;
+    node->m_height = -1;
+    bvh->m_freeList = index;
+    bvh->m_nodeCount--;
+}
+
+/// @brief Recalcule la boîte et la hauteur d'un noeud interne à partir de ses enfants.
+static void SceneBvh_UpdateNode(SceneBvh *bvh, int index)
+{
+    SceneBvhNode *node = &bvh->m_nodes[index];
+    SceneBvhNode *child1 = &bvh->m_nodes[node->m_child1];
+    SceneBvhNode *child2 = &bvh->m_nodes[node->m_child2];
+
+    node->m_min = Vec3_Min(child1->m_min, child2->m_min);
+    node->m_max = Vec3_Max(child1->m_max, child2->m_max);
+    node->m_height = 1 + Int_Max(child1->m_height, child2->m_height);
+}
+
+/// @brief Remplace un enfant d'un noeud (ou la racine si parent vaut SCENE_BVH_NULL).
+static void SceneBvh_ReplaceChild(SceneBvh *bvh, int parent, int oldChild, int newChild)
+{
+    if (parent == SCENE_BVH_NULL)
+    {
+        bvh->m_root = newChild;
+    }
+    else if (bvh->m_nodes[parent].m_child1 == oldChild)
+    {
+        bvh->m_nodes[parent].m_child1 = newChild;
+    }
+    else
+    {
+        assert(bvh->m_nodes[parent].m_child2 == oldChild);
+        bvh->m_nodes[parent].m_child2 = newChild;
+    }
+}
+
+/// @brief Remonte l'enfant iC du noeud iA à sa place (rotation).
+/// iA devient l'enfant de iC et récupère le plus petit des deux enfants de iC.
+/// @return Le nouveau sommet du sous-arbre (iC).
+static int SceneBvh_Rotate(SceneBvh *bvh, int iA, int iC)
+{
+    SceneBvhNode *nodes = bvh->m_nodes;
+    SceneBvhNode *A = &nodes[iA];
+    SceneBvhNode *C = &nodes[iC];
+    int iF = C->m_child1;
+    int iG = C->m_child2;
+
+    // C prend la place de A
+    C->m_parent = A->m_parent;
+    SceneBvh_ReplaceChild(bvh, C->m_parent, iA, iC);
+    A->m_parent = iC;
+    C->m_child1 = iA;
+
+    // Le plus haut des enfants de C reste sous C, l'autre passe sous A
+    int iKept = (nodes[iF].m_height > nodes[iG].m_height) ? iF : iG;
+    int iMoved = (iKept == iF) ? iG : iF;
+
+    C->m_child2 = iKept;
+    if (A->m_child1 == iC)
+    {
+        A->m_child1 = iMoved;
+    }
+    else
+    {
+        A->m_child2 = iMoved;
+    }
+    nodes[iMoved].m_parent = iA;
+
+    SceneBvh_UpdateNode(bvh, iA);
+    SceneBvh_UpdateNode(bvh, iC);
+
+    return iC;
+}
+
+/// @brief Rééquilibre le sous-arbre de sommet iA si ses enfants ont des hauteurs
+/// trop différentes.
+/// @return Le nouveau sommet du sous-arbre.
+static int SceneBvh_Balance(SceneBvh *bvh, int iA)
+{
+    SceneBvhNode *A = &bvh->m_nodes[iA];
+    if (A->m_child1 == SCENE_BVH_NULL || A->m_height < 2)
+        return iA;
+
+    int iB = A->m_child1;
+    int iC = A->m_child2;
+    int balance = bvh->m_nodes[iC].m_height - bvh->m_nodes[iB].m_height;
+
+    if (balance > 1)
+        return SceneBvh_Rotate(bvh, iA, iC);
+    if (balance < -1)
+        return SceneBvh_Rotate(bvh, iA, iB);
+
+    return iA;
+}
+
+/// @brief Recalcule les boîtes des ancêtres d'un noeud en rééquilibrant l'arbre.
+static void SceneBvh_Refit(SceneBvh *bvh, int index)
+{
+    while (index != SCENE_BVH_NULL)
+    {
+        index = SceneBvh_Balance(bvh, index);
+        SceneBvh_UpdateNode(bvh, index);
+        index = bvh->m_nodes[index].m_parent;
+    }
+}
+
+/// @brief Place une feuille dans l'arbre.
+/// Un noeud libre doit être disponible (voir SceneBvh_Reserve()).
+static void SceneBvh_InsertLeaf(SceneBvh *bvh, int leaf)
+{
+    SceneBvhNode *nodes = bvh->m_nodes;
+
+    if (bvh->m_root == SCENE_BVH_NULL)
+    {
+        bvh->m_root = leaf;
+        nodes[leaf].m_parent = SCENE_BVH_NULL;
+        return;
+    }
+
+    // Descend vers le frère de coût minimal : la surface ajoutée à chaque ancêtre
+    // est payée quel que soit le chemin choisi
+    Vec3 leafMin = nodes[leaf].m_min;
+    Vec3 leafMax = nodes[leaf].m_max;
+    int index = bvh->m_root;
+    while (nodes[index].m_child1 != SCENE_BVH_NULL)
+    {
+        SceneBvhNode *node = &nodes[index];
+        float area = SceneBvh_GetArea(node->m_min, node->m_max);
+        float combinedArea = SceneBvh_GetArea(
+            Vec3_Min(node->m_min, leafMin), Vec3_Max(node->m_max, leafMax));
+
+        // Coût d'un nouveau parent pour ce noeud et la feuille
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        // Coût de la descente dans chacun des enfants
+        float childCosts[2] = { 0 };
+        int children[2] = { node->m_child1, node->m_child2 };
+        for (int i = 0; i < 2; ++i)
+        {
+            SceneBvhNode *child = &nodes[children[i]];
+            childCosts[i] = SceneBvh_GetArea(
+                Vec3_Min(child->m_min, leafMin), Vec3_Max(child->m_max, leafMax));
+            if (child->m_child1 != SCENE_BVH_NULL)
+            {
+                childCosts[i] -= SceneBvh_GetArea(child->m_min, child->m_max);
+            }
+            childCosts[i] += inheritanceCost;
+        }
+
+        if (cost < childCosts[0] && cost < childCosts[1])
+            break;
+
+        index = (childCosts[0] < childCosts[1]) ? children[0] : children[1];
+    }
+
+    // Crée un parent commun à la feuille et à son frère
+    int sibling = index;
+    int oldParent = nodes[sibling].m_parent;
+    int newParent = SceneBvh_AllocateNode(bvh);
+
+    nodes[newParent].m_parent = oldParent;
+    nodes[newParent].m_child1 = sibling;
+    nodes[newParent].m_child2 = leaf;
+    nodes[sibling].m_parent = newParent;
+    nodes[leaf].m_parent = newParent;
+    SceneBvh_ReplaceChild(bvh, oldParent, sibling, newParent);
+
+    SceneBvh_Refit(bvh, newParent);
+}
+
+/// @brief Détache une feuille de l'arbre sans libérer son noeud.
+static void SceneBvh_RemoveLeaf(SceneBvh *bvh, int leaf)
+{
+    SceneBvhNode *nodes = bvh->m_nodes;
+
+    if (leaf == bvh->m_root)
+    {
+        bvh->m_root = SCENE_BVH_NULL;
+        return;
+    }
+
+    // Le frère de la feuille remplace leur parent
+    int parent = nodes[leaf].m_parent;
+    int grandParent = nodes[parent].m_parent;
+    int sibling = (nodes[parent].m_child1 == leaf)
+        ? nodes[parent].m_child2 : nodes[parent].m_child1;
+
+    SceneBvh_ReplaceChild(bvh, grandParent, parent, sibling);
+    nodes[sibling].m_parent = grandParent;
+    SceneBvh_FreeNode(bvh, parent);
+
+    SceneBvh_Refit(bvh, grandParent);
+}
+
+int SceneBvh_Insert(SceneBvh *bvh, Object *object, Vec3 min, Vec3 max)
+{
+    // La feuille et son futur parent
+    int exitStatus = SceneBvh_Reserve(bvh, 2);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    int leaf = SceneBvh_AllocateNode(bvh);
+    SceneBvhNode *node = &bvh->m_nodes[leaf];
+
+    SceneBvh_Enlarge(&min, &max, SCENE_BVH_MARGIN);
+    node->m_min = min;
+    node->m_max = max;
+    node->m_object = object;
+
+    SceneBvh_InsertLeaf(bvh, leaf);
+    bvh->m_leafCount++;
+
+    return leaf;
+
+ERROR_LABEL:
+    printf("ERROR - SceneBvh_Insert()\n");
+    assert(false);
+    return SCENE_BVH_NULL;
+}
+
+void SceneBvh_Remove(SceneBvh *bvh, int leaf)
+{
+    assert(0 <= leaf && leaf < bvh->m_nodeCapacity);
+    assert(bvh->m_nodes[leaf].m_height == 0);
+
+    SceneBvh_RemoveLeaf(bvh, leaf);
+    SceneBvh_FreeNode(bvh, leaf);
+    bvh->m_leafCount--;
+}
+
+bool SceneBvh_Move(SceneBvh *bvh, int leaf, Vec3 min, Vec3 max)
+{
+    assert(0 <= leaf && leaf < bvh->m_nodeCapacity);
+    assert(bvh->m_nodes[leaf].m_height == 0);
+
+    SceneBvhNode *node = &bvh->m_nodes[leaf];
+    Vec3 fatMin = min, fatMax = max;
+    SceneBvh_Enlarge(&fatMin, &fatMax, SCENE_BVH_MARGIN);
+
+    if (SceneBvh_Contains(node->m_min, node->m_max, min, max))
+    {
+        // La boîte élargie est conservée tant qu'elle n'est pas beaucoup trop grande
+        // (objet rétréci ou revenu en arrière)
+        Vec3 hugeMin = min, hugeMax = max;
+        SceneBvh_Enlarge(&hugeMin, &hugeMax, 5.0f * SCENE_BVH_MARGIN);
+
+        if (SceneBvh_Contains(hugeMin, hugeMax, node->m_min, node->m_max))
+            return false;
+    }
+
+    // Le noeud parent libéré par le retrait est réutilisé par l'insertion
+    SceneBvh_RemoveLeaf(bvh, leaf);
+    node->m_min = fatMin;
+    node->m_max = fatMax;
+    SceneBvh_InsertLeaf(bvh, leaf);
+
+    return true;
+}
+
+/// @brief Prépare les tableaux de résultats d'une requête.
+static int SceneBvh_BeginQuery(SceneBvh *bvh)
+{
+    bvh->m_resultCount = 0;
+
+    if (bvh->m_resultCapacity >= bvh->m_leafCount)
+        return EXIT_SUCCESS;
+
+    int capacity = Int_Max(bvh->m_resultCapacity << 1, Int_Max(bvh->m_leafCount, 32));
+
+    Object **newResults = (Object **)realloc(bvh->m_results, capacity * sizeof(Object *));
+    if (!newResults) goto ERROR_LABEL;
+    bvh->m_results = newResults;
+
+    float *newDistances = (float *)realloc(bvh->m_resultDistances, capacity * sizeof(float));
+    if (!newDistances) goto ERROR_LABEL;
+    bvh->m_resultDistances = newDistances;
+
+    bvh->m_resultCapacity = capacity;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - SceneBvh_BeginQuery()\n");
+    assert(false);
+    return EXIT_FAILURE;
+}
+
+/// @brief Ajoute un objet aux résultats de la requête en cours.
+static void SceneBvh_AddResult(SceneBvh *bvh, Object *object, float distance)
+{
+    int index = bvh->m_resultCount++;
+    bvh->m_results[index] = object;
+    bvh->m_resultDistances[index] = distance;
+}
+
+int SceneBvh_QueryPlanes(SceneBvh *bvh, const Vec4 *planes, int planeCount)
+{
+    int exitStatus = SceneBvh_BeginQuery(bvh);
+    if (exitStatus != EXIT_SUCCESS) return 0;
+
+    if (bvh->m_root == SCENE_BVH_NULL)
+        return 0;
+
+    SceneBvhNode *nodes = bvh->m_nodes;
+    int *stack = bvh->m_stack;
+    int stackSize = 0;
+
+    // Un noeud entièrement dans le volume est empilé sous la forme ~index :
+    // ses descendants n'ont plus besoin d'être testés
+    stack[stackSize++] = bvh->m_root;
+    while (stackSize > 0)
+    {
+        int index = stack[--stackSize];
+        bool inside = (index < 0);
+        if (inside)
+        {
+            index = ~index;
+        }
+        SceneBvhNode *node = &nodes[index];
+
+        if (!inside)
+        {
+            float cx = 0.5f * (node->m_min.x + node->m_max.x);
+            float cy = 0.5f * (node->m_min.y + node->m_max.y);
+            float cz = 0.5f * (node->m_min.z + node->m_max.z);
+            float ex = 0.5f * (node->m_max.x - node->m_min.x);
+            float ey = 0.5f * (node->m_max.y - node->m_min.y);
+            float ez = 0.5f * (node->m_max.z - node->m_min.z);
+
+            bool outside = false;
+            inside = true;
+            for (int i = 0; i < planeCount; ++i)
+            {
+                Vec4 plane = planes[i];
+                float distance = plane.x * cx + plane.y * cy + plane.z * cz + plane.w;
+                float radius = fabsf(plane.x) * ex + fabsf(plane.y) * ey + fabsf(plane.z) * ez;
+
+                if (distance + radius < 0.0f)
+                {
+                    outside = true;
+                    break;
+                }
+                if (distance - radius < 0.0f)
+                {
+                    inside = false;
+                }
+            }
+            if (outside)
+                continue;
+        }
+
+        if (node->m_child1 == SCENE_BVH_NULL)
+        {
+            SceneBvh_AddResult(bvh, node->m_object, 0.0f);
+        }
+        else
+        {
+            stack[stackSize++] = inside ? ~node->m_child2 : node->m_child2;
+            stack[stackSize++] = inside ? ~node->m_child1 : node->m_child1;
+        }
+    }
+
+    return bvh->m_resultCount;
+}
+
+int SceneBvh_QueryBox(SceneBvh *bvh, Vec3 min, Vec3 max)
+{
+    int exitStatus = SceneBvh_BeginQuery(bvh);
+    if (exitStatus != EXIT_SUCCESS) return 0;
+
+    if (bvh->m_root == SCENE_BVH_NULL)
+        return 0;
+
+    SceneBvhNode *nodes = bvh->m_nodes;
+    int *stack = bvh->m_stack;
+    int stackSize = 0;
+
+    stack[stackSize++] = bvh->m_root;
+    while (stackSize > 0)
+    {
+        SceneBvhNode *node = &nodes[stack[--stackSize]];
+
+        if (node->m_max.x < min.x || node->m_max.y < min.y || node->m_max.z < min.z ||
+            max.x < node->m_min.x || max.y < node->m_min.y || max.z < node->m_min.z)
+        {
+            continue;
+        }
+
+        if (node->m_child1 == SCENE_BVH_NULL)
+        {
+            SceneBvh_AddResult(bvh, node->m_object, 0.0f);
+        }
+        else
+        {
+            stack[stackSize++] = node->m_child2;
+            stack[stackSize++] = node->m_child1;
+        }
+    }
+
+    return bvh->m_resultCount;
+}
+
+/// @brief Calcule la distance d'entrée d'un rayon dans une boîte (méthode des tranches).
+/// @return true si le rayon coupe la boîte avant maxDistance.
+static bool SceneBvh_IntersectRay(
+    const SceneBvhNode *node, Vec3 origin, Vec3 invDirection,
+    float maxDistance, float *distance)
+{
+    float tMin = 0.0f;
+    float tMax = maxDistance;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        float t1 = (node->m_min.data[i] - origin.data[i]) * invDirection.data[i];
+        float t2 = (node->m_max.data[i] - origin.data[i]) * invDirection.data[i];
+
+        // fminf() et fmaxf() ignorent les NaN (rayon parallèle à une face de la boîte)
+        tMin = fmaxf(tMin, fminf(t1, t2));
+        tMax = fminf(tMax, fmaxf(t1, t2));
+    }
+
+    *distance = tMin;
+    return tMin <= tMax;
+}
+
+int SceneBvh_QueryRay(SceneBvh *bvh, Vec3 origin, Vec3 direction, float maxDistance)
+{
+    int exitStatus = SceneBvh_BeginQuery(bvh);
+    if (exitStatus != EXIT_SUCCESS) return 0;
+
+    if (bvh->m_root == SCENE_BVH_NULL)
+        return 0;
+
+    // Une composante nulle donne un inverse infini
+    Vec3 invDirection = Vec3_Set(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+    SceneBvhNode *nodes = bvh->m_nodes;
+    int *stack = bvh->m_stack;
+    int stackSize = 0;
+
+    stack[stackSize++] = bvh->m_root;
+    while (stackSize > 0)
+    {
+        SceneBvhNode *node = &nodes[stack[--stackSize]];
+
+        float distance;
+        if (!SceneBvh_IntersectRay(node, origin, invDirection, maxDistance, &distance))
+            continue;
+
+        if (node->m_child1 == SCENE_BVH_NULL)
+        {
+            SceneBvh_AddResult(bvh, node->m_object, distance);
+        }
+        else
+        {
+            stack[stackSize++] = node->m_child2;
+            stack[stackSize++] = node->m_child1;
+        }
+    }
+
+    // Tri par insertion : un rayon ne traverse en général que peu d'objets
+    Object **results = bvh->m_results;
+    float *distances = bvh->m_resultDistances;
+    for (int i = 1; i < bvh->m_resultCount; ++i)
+    {
+        Object *object = results[i];
+        float distance = distances[i];
+        int j = i - 1;
+        while (j >= 0 && distances[j] > distance)
+        {
+            results[j + 1] = results[j];
+            distances[j + 1] = distances[j];
+            j--;
+        }
+        results[j + 1] = object;
+        distances[j + 1] = distance;
+    }
+
+    return bvh->m_resultCount;
+}
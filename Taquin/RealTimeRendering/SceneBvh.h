@@ -0,0 +1,171 @@
+﻿#ifndef _SCENE_BVH_H_
+#define _SCENE_BVH_H_
+
+/// @file SceneBvh.h
+/// @defgroup SceneBvh
+/// @{
+
+#include "Settings.h"
+#include "Vector.h"
+
+typedef struct Object_s Object;
+
+/// @brief Indice désignant l'absence de noeud.
+#define SCENE_BVH_NULL (-1)
+
+/// @brief Marge ajoutée autour de la boîte d'une feuille, relativement à sa plus grande
+/// dimension. Un objet qui se déplace sans sortir de sa boîte élargie ne modifie pas l'arbre.
+#define SCENE_BVH_MARGIN 0.1f
+
+/// @brief Noeud d'une SceneBvh.
+typedef struct SceneBvhNode_s
+{
+    /// @brief Boîte englobante du noeud dans le référentiel monde
+    /// (élargie de la marge pour une feuille).
+    Vec3    m_min;
+    Vec3    m_max;
+
+    /// @brief Objet d'une feuille (NULL pour un noeud interne).
+    Object *m_object;
+
+    /// @brief Parent du noeud, ou noeud libre suivant si le noeud n'est pas utilisé.
+    int     m_parent;
+
+    /// @brief Enfants d'un noeud interne (SCENE_BVH_NULL pour une feuille).
+    int     m_child1;
+    int     m_child2;
+
+    /// @brief Hauteur du sous-arbre : 0 pour une feuille, -1 pour un noeud libre.
+    int     m_height;
+} SceneBvhNode;
+
+/// @brief Hiérarchie dynamique de boîtes englobantes sur les objets d'une scène.
+/// Chaque feuille contient un objet ; un objet déplacé est retiré puis réinséré
+/// uniquement s'il sort de sa boîte élargie, et l'arbre est rééquilibré par rotations
+/// à chaque insertion. Les requêtes (frustum, boîte, rayon) ne parcourent donc
+/// qu'un nombre de noeuds logarithmique en le nombre d'objets.
+/// Les résultats d'une requête sont valables jusqu'à la requête suivante.
+typedef struct SceneBvh_s
+{
+    /// @brief Noeuds de l'arbre (utilisés et libres).
+    SceneBvhNode *m_nodes;
+    int           m_nodeCount;
+    int           m_nodeCapacity;
+
+    /// @brief Racine de l'arbre et premier noeud libre.
+    int           m_root;
+    int           m_freeList;
+
+    /// @brief Nombre d'objets de l'arbre.
+    int           m_leafCount;
+
+    /// @brief Pile de parcours des requêtes.
+    int          *m_stack;
+    int           m_stackCapacity;
+
+    /// @brief Objets trouvés par la dernière requête.
+    Object      **m_results;
+
+    /// @brief Distances d'entrée dans la boîte des objets trouvés par SceneBvh_QueryRay().
+    float        *m_resultDistances;
+    int           m_resultCount;
+    int           m_resultCapacity;
+} SceneBvh;
+
+/// @brief Initialise un arbre vide.
+/// @param[out] bvh l'arbre.
+void SceneBvh_Init(SceneBvh *bvh);
+
+/// @brief Détruit les tableaux d'un arbre.
+/// @param[in,out] bvh l'arbre.
+void SceneBvh_Free(SceneBvh *bvh);
+
+/// @brief Ajoute un objet à un arbre.
+/// @param[in,out] bvh l'arbre.
+/// @param[in] object l'objet.
+/// @param[in] min le coin minimal de la boîte de l'objet dans le référentiel monde.
+/// @param[in] max le coin maximal de la boîte de l'objet dans le référentiel monde.
+/// @return L'indice de la feuille créée ou SCENE_BVH_NULL en cas d'erreur.
+int SceneBvh_Insert(SceneBvh *bvh, Object *object, Vec3 min, Vec3 max);
+
+/// @brief Retire une feuille d'un arbre.
+/// @param[in,out] bvh l'arbre.
+/// @param[in] leaf l'indice de la feuille.
+void SceneBvh_Remove(SceneBvh *bvh, int leaf);
+
+/// @brief Met à jour la boîte d'une feuille après un déplacement de son objet.
+/// La feuille n'est réinsérée que si la nouvelle boîte sort de sa boîte élargie,
+/// ou si celle-ci est devenue beaucoup trop grande. Son indice ne change pas.
+/// @param[in,out] bvh l'arbre.
+/// @param[in] leaf l'indice de la feuille.
+/// @param[in] min le nouveau coin minimal de la boîte de l'objet.
+/// @param[in] max le nouveau coin maximal de la boîte de l'objet.
+/// @return true si la feuille a été réinsérée.
+bool SceneBvh_Move(SceneBvh *bvh, int leaf, Vec3 min, Vec3 max);
+
+/// @brief Recherche les objets dont la boîte coupe un volume convexe.
+/// Un sous-arbre entièrement à l'intérieur du volume est ajouté sans autre test.
+/// @param[in,out] bvh l'arbre.
+/// @param[in] planes les plans délimitant le volume dans le référentiel monde ;
+/// un point p est à l'intérieur si dot(plane.xyz, p) + plane.w >= 0 pour chaque plan.
+/// @param[in] planeCount le nombre de plans.
+/// @return Le nombre d'objets trouvés (voir SceneBvh_GetResult()).
+int SceneBvh_QueryPlanes(SceneBvh *bvh, const Vec4 *planes, int planeCount);
+
+/// @brief Recherche les objets dont la boîte coupe une boîte alignée sur les axes.
+/// @param[in,out] bvh l'arbre.
+/// @param[in] min le coin minimal de la boîte dans le référentiel monde.
+/// @param[in] max le coin maximal de la boîte dans le référentiel monde.
+/// @return Le nombre d'objets trouvés (voir SceneBvh_GetResult()).
+int SceneBvh_QueryBox(SceneBvh *bvh, Vec3 min, Vec3 max);
+
+/// @brief Recherche les objets dont la boîte est traversée par un rayon.
+/// Les objets trouvés sont triés par distance d'entrée dans leur boîte croissante :
+/// un test plus précis (triangles...) peut s'arrêter dès qu'un objet commence
+/// au-delà de l'intersection la plus proche déjà trouvée.
+/// @param[in,out] bvh l'arbre.
+/// @param[in] origin l'origine du rayon dans le référentiel monde.
+/// @param[in] direction la direction du rayon (pas nécessairement normalisée).
+/// @param[in] maxDistance la distance maximale, en multiples de direction.
+/// @return Le nombre d'objets trouvés (voir SceneBvh_GetResult()).
+int SceneBvh_QueryRay(SceneBvh *bvh, Vec3 origin, Vec3 direction, float maxDistance);
+
+/// @brief Renvoie un objet trouvé par la dernière requête.
+/// @param[in] bvh l'arbre.
+/// @param[in] index l'indice du résultat.
+/// @return L'objet.
+INLINE Object *SceneBvh_GetResult(SceneBvh *bvh, int index)
+{
+    assert(0 <= index && index < bvh->m_resultCount);
+    return bvh->m_results[index];
+}
+
+/// @brief Renvoie la distance d'entrée dans la boîte d'un objet trouvé par SceneBvh_QueryRay().
+/// @param[in] bvh l'arbre.
+/// @param[in] index l'indice du résultat.
+/// @return La distance, en multiples de la direction du rayon.
+INLINE float SceneBvh_GetResultDistance(SceneBvh *bvh, int index)
+{
+    assert(0 <= index && index < bvh->m_resultCount);
+    return bvh->m_resultDistances[index];
+}
+
+/// @brief Renvoie le nombre d'objets d'un arbre.
+/// @param[in] bvh l'arbre.
+/// @return Le nombre de feuilles.
+INLINE int SceneBvh_GetLeafCount(SceneBvh *bvh)
+{
+    return bvh->m_leafCount;
+}
+
+/// @brief Renvoie la hauteur d'un arbre.
+/// @param[in] bvh l'arbre.
+/// @return La hauteur (0 pour un arbre vide ou réduit à une feuille).
+INLINE int SceneBvh_GetHeight(SceneBvh *bvh)
+{
+    return (bvh->m_root == SCENE_BVH_NULL) ? 0 : bvh->m_nodes[bvh->m_root].m_height;
+}
+
+/// @}
+
+#endif
@@ -19,6 +19,13 @@
 
 #define INLINE inline
 
+/// @brief Variable globale dont chaque thread a sa propre copie.
+#ifdef _MSC_VER
+#  define THREAD_LOCAL __declspec(thread)
+#else
+#  define THREAD_LOCAL _Thread_local
+#endif
+
 /// @brief Initialise la SDL.
 /// @return EXIT_SUCCESS ou EXIT_FAILURE.
 int Settings_InitSDL();
@@ -39,6 +39,7 @@ VShaderOut VertexShader_Base(VShaderIn *in, VShaderGlobals *globals)
     out.normal = Vec3_Normalize(Vec3_From4(normal));
     out.textUV = in->textUV;
     out.tangent = Vec3_Normalize(Vec3_From4(tangent));
+    out.occlusion = in->occlusion;
     return out;
 }
 
@@ -60,13 +61,10 @@ Vec4 FragmentShader_Base(FShaderIn *in, FShaderGlobals *globals)
     Material* material = globals->material;
     assert(material);
 
-    // Rcupration de la texture (albedo) associe au pixel
-    MeshTexture* albedoTex = Material_GetAlbedo(material);
-    assert(albedoTex);
-
-    MeshTexture* normalTex = Material_GetNormalMap(material);
-    if (normalTex)
-        assert(normalTex);
+    // Rcupration de la texture (albedo) associe au pixel.
+    // Elle vaut NULL tant qu'elle est en cours de chargement.
+    MeshTexture* albedoTex = globals->albedoMap;
+    MeshTexture* normalTex = globals->normalMap;
 
 
     // Rcupration des coordonnes (u,v) associe au pixel.
@@ -79,7 +77,16 @@ Vec4 FragmentShader_Base(FShaderIn *in, FShaderGlobals *globals)
     float v = in->textUV.y;
 
     // Recupration de la couleur du pixel dans la texture
-    Vec3 albedo = MeshTexture_GetColorVec3(albedoTex, Vec2_Set(u, v));
+    // (dj lue par le rasteriseur dans le cas d'un rendu par lots)
+    // (couleur uniforme tant que la texture n'est pas charge)
+    Vec3 albedo = Vec3_Set(0.7f, 0.7f, 0.7f);
+    if (albedoTex)
+    {
+        albedo = globals->texturesSampled ? in->albedo :
+            Sampler_Sample(albedoTex, globals->filter, SAMPLER_ALBEDO, Vec2_Set(u, v),
+                Sampler_GetLod(albedoTex, globals->uvLod));
+    }
+    albedo = Vec3_Mul(albedo, globals->tint);
 
 
 #if 1
@@ -88,6 +95,9 @@ Vec4 FragmentShader_Base(FShaderIn *in, FShaderGlobals *globals)
     Vec3 lightColor = Scene_GetLightColor(globals->scene);
     Vec3 ambiant = Scene_GetAmbiantColor(globals->scene);
 
+    // La lumire ambiante n'atteint pas les creux du mesh (occlusion prcalcule par sommet)
+    ambiant = Vec3_Scale(ambiant, in->occlusion);
+
     // Rcupre la normale interpole (non normalise)
     Vec3 normal = in->normal;
     Vec3 view = { 0 };
@@ -100,7 +110,9 @@ Vec4 FragmentShader_Base(FShaderIn *in, FShaderGlobals *globals)
     normal = Vec3_Normalize(normal);
 
     if (normalTex && globals->scene->m_normalMapOnOff) {
-        tangentSpaceNormal = MeshTexture_GetColorVec3(normalTex, Vec2_Set(u, v));
+        tangentSpaceNormal = globals->texturesSampled ? in->normalSample :
+            Sampler_Sample(normalTex, globals->filter, SAMPLER_NORMAL, Vec2_Set(u, v),
+                Sampler_GetLod(normalTex, globals->uvLod));
         bitangent = Vec3_Cross(normal, tangent);
         bitangent = Vec3_Normalize(bitangent);
 
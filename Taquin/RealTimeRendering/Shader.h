@@ -6,6 +6,7 @@
 #include "Matrix.h"
 #include "Mesh.h"
 #include "Material.h"
+#include "Sampler.h"
 
 typedef struct Scene_s Scene;
 
@@ -33,6 +34,9 @@ typedef struct VShaderIn_s
 
     /// @brief Coordonnes uv associes au sommet.
     Vec2 textUV;
+
+    /// @brief Occlusion ambiante du sommet dans [0,1] (1 si elle n'est pas utilise).
+    float occlusion;
 } VShaderIn;
 
 /// @brief Structure reprsentant la sortie du vertex shader
@@ -60,6 +64,9 @@ typedef struct VShaderOut_s
     /// @brief Tangente associe au sommet exprime dans le rfrentiel monde.
     Vec3  tangent;
 
+    /// @brief Occlusion ambiante du sommet dans [0,1].
+    float occlusion;
+
 } VShaderOut;
 
 /// @brief Structure reprsentant les donnes globales fournies au fragment shader.
@@ -71,8 +78,28 @@ typedef struct FShaderGlobals_s
     /// @brief Matriau utilis pour le triangle.
     Material *material;
 
+    /// @brief Textures du matriau, lues une seule fois par triangle
+    /// (elles peuvent tre attaches au matriau pendant le rendu).
+    /// Elles valent NULL tant qu'elles ne sont pas charges.
+    MeshTexture *albedoMap;
+    MeshTexture *normalMap;
+
     /// @brief Position de la camra.
     Vec3 cameraPos;
+
+    /// @brief Mode de filtrage des textures.
+    SamplerFilter filter;
+
+    /// @brief Logarithme en base 2 de la taille (dans l'espace uv) couverte par un pixel
+    /// du triangle. Voir Sampler_GetLod().
+    float uvLod;
+
+    /// @brief Teinte multiplie  l'albedo (blanc par dfaut, voir InstanceGroup_AddInstance()).
+    Vec3 tint;
+
+    /// @brief Indique si le rasteriseur a dj lu les textures du matriau
+    /// (champs albedo et normalSample de FShaderIn).
+    bool texturesSampled;
 } FShaderGlobals;
 
 /// @brief Structure reprsentant les donnes associe  un pixel (fragment)
@@ -99,6 +126,18 @@ typedef struct FShaderIn_s
     /// Le vecteur est obtenu par interpolation, donc n'est pas ncessairement unitaire
     /// ou perpendiculaire  la normale.
     Vec3 tangent;
+
+    /// @brief Occlusion ambiante associe au pixel dans [0,1] (1 : non occult),
+    /// obtenue par interpolation de celle des sommets.
+    float occlusion;
+
+    /// @brief Couleur de la texture albedo au pixel, lue par lots par le rasteriseur
+    /// lorsque FShaderGlobals::texturesSampled est vrai.
+    Vec3 albedo;
+
+    /// @brief Normale de la "normal map" au pixel (espace tangent, dans [-1,1]),
+    /// lue par lots par le rasteriseur lorsque FShaderGlobals::texturesSampled est vrai.
+    Vec3 normalSample;
 } FShaderIn;
 
 typedef VShaderOut VertexShader(VShaderIn *in, VShaderGlobals *globals);
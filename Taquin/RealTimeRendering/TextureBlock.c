@@ -0,0 +1,459 @@
+﻿#include "TextureBlock.h"
+#include "Tools.h"
+
+#include <limits.h>
+
+// Formats BC1, BC3 et BC5 (DXT1, DXT5 et ATI2/3Dc).
+// L'encodeur utilise les bornes de la boîte englobante des couleurs du bloc,
+// légèrement resserrées, plutôt qu'une recherche exhaustive des extrémités :
+// la qualité est un peu moindre mais l'encodage reste rapide au chargement.
+
+//-------------------------------------------------------------------------------------------------
+// Palettes (communes à l'encodeur et au décodeur)
+
+static INLINE Uint16 TextureBlock_To565(const int *rgb)
+{
+    int r = (rgb[0] * 31 + 127) / 255;
+    int g = (rgb[1] * 63 + 127) / 255;
+    int b = (rgb[2] * 31 + 127) / 255;
+    return (Uint16)((r << 11) | (g << 5) | b);
+}
+
+static INLINE void TextureBlock_From565(Uint16 color, int *rgb)
+{
+    int r = (color >> 11) & 31;
+    int g = (color >> 5) & 63;
+    int b = color & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+/// @brief Calcule les quatre couleurs (rgba) d'un bloc couleur.
+/// @param[in] opaque vaut true pour BC3 (toujours quatre couleurs), false pour BC1.
+static void TextureBlock_ColorPalette(Uint16 c0, Uint16 c1, bool opaque, int palette[4][4])
+{
+    TextureBlock_From565(c0, palette[0]);
+    TextureBlock_From565(c1, palette[1]);
+    palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+
+    if (c0 > c1 || opaque)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+    }
+    else
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+        palette[3][3] = 0;
+    }
+}
+
+/// @brief Calcule les huit valeurs d'un bloc alpha (BC3) ou d'un canal (BC5).
+static void TextureBlock_AlphaPalette(int a0, int a1, int palette[8])
+{
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1)
+    {
+        for (int i = 1; i < 7; ++i)
+        {
+            palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+        }
+    }
+    else
+    {
+        for (int i = 1; i < 5; ++i)
+        {
+            palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Décodage
+
+static void TextureBlock_DecodeColor(const Uint8 *block, bool opaque, Uint32 *texels)
+{
+    Uint16 c0 = (Uint16)(block[0] | (block[1] << 8));
+    Uint16 c1 = (Uint16)(block[2] | (block[3] << 8));
+    Uint32 indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((Uint32)block[7] << 24);
+
+    int palette[4][4];
+    TextureBlock_ColorPalette(c0, c1, opaque, palette);
+
+    Uint32 colors[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        colors[i] =
+            (Uint32)palette[i][0] | ((Uint32)palette[i][1] << 8) |
+            ((Uint32)palette[i][2] << 16) | ((Uint32)palette[i][3] << 24);
+    }
+    for (int i = 0; i < 16; ++i)
+    {
+        texels[i] = colors[(indices >> (2 * i)) & 3];
+    }
+}
+
+static void TextureBlock_DecodeAlpha(const Uint8 *block, Uint8 *values)
+{
+    int palette[8];
+    TextureBlock_AlphaPalette(block[0], block[1], palette);
+
+    Uint64 indices = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        indices |= (Uint64)block[2 + i] << (8 * i);
+    }
+    for (int i = 0; i < 16; ++i)
+    {
+        values[i] = (Uint8)palette[(indices >> (3 * i)) & 7];
+    }
+}
+
+void TextureBlock_Decode(MeshTextureFormat format, const Uint8 *block, Uint32 *texels)
+{
+    Uint8 alpha[16], red[16], green[16];
+
+    switch (format)
+    {
+    case MESH_TEXTURE_BC1:
+        TextureBlock_DecodeColor(block, false, texels);
+        break;
+
+    case MESH_TEXTURE_BC3:
+        TextureBlock_DecodeAlpha(block, alpha);
+        TextureBlock_DecodeColor(block + 8, true, texels);
+        for (int i = 0; i < 16; ++i)
+        {
+            texels[i] = (texels[i] & 0x00FFFFFF) | ((Uint32)alpha[i] << 24);
+        }
+        break;
+
+    case MESH_TEXTURE_BC5:
+        TextureBlock_DecodeAlpha(block, red);
+        TextureBlock_DecodeAlpha(block + 8, green);
+        for (int i = 0; i < 16; ++i)
+        {
+            // Reconstruit la composante z de la normale (toujours positive)
+            float x = red[i] * (2.0f / 255.0f) - 1.0f;
+            float y = green[i] * (2.0f / 255.0f) - 1.0f;
+            float z = sqrtf(fmaxf(0.0f, 1.0f - x * x - y * y));
+            Uint32 blue = (Uint32)((z * 0.5f + 0.5f) * 255.0f + 0.5f);
+            texels[i] = red[i] | ((Uint32)green[i] << 8) | (blue << 16) | 0xFF000000;
+        }
+        break;
+
+    case MESH_TEXTURE_RGBA8:
+    default:
+        assert(false);
+        break;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Encodage
+
+static INLINE int TextureBlock_Distance(const int *a, const Uint8 *b)
+{
+    int dr = a[0] - b[0];
+    int dg = a[1] - b[1];
+    int db = a[2] - b[2];
+    return dr * dr + dg * dg + db * db;
+}
+
+static void TextureBlock_EncodeColor(const Color *texels, Uint8 *block)
+{
+    int minC[3] = { 255, 255, 255 };
+    int maxC[3] = { 0, 0, 0 };
+    int mean[3] = { 0 };
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            minC[c] = Int_Min(minC[c], texels[i].data[c]);
+            maxC[c] = Int_Max(maxC[c], texels[i].data[c]);
+            mean[c] += texels[i].data[c];
+        }
+    }
+
+    // Choisit la diagonale de la boîte englobante la plus proche de l'axe principal
+    int covRG = 0, covBG = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        int r = 16 * texels[i].r - mean[0];
+        int g = 16 * texels[i].g - mean[1];
+        int b = 16 * texels[i].b - mean[2];
+        covRG += r * g;
+        covBG += b * g;
+    }
+    if (covRG < 0) { int t = minC[0]; minC[0] = maxC[0]; maxC[0] = t; }
+    if (covBG < 0) { int t = minC[2]; minC[2] = maxC[2]; maxC[2] = t; }
+
+    // Resserre les bornes pour réduire l'erreur moyenne
+    for (int c = 0; c < 3; ++c)
+    {
+        int inset = (maxC[c] - minC[c]) / 16;
+        maxC[c] -= inset;
+        minC[c] += inset;
+    }
+
+    Uint16 c0 = TextureBlock_To565(maxC);
+    Uint16 c1 = TextureBlock_To565(minC);
+    if (c0 < c1)
+    {
+        Uint16 t = c0; c0 = c1; c1 = t;
+    }
+
+    int palette[4][4];
+    TextureBlock_ColorPalette(c0, c1, true, palette);
+
+    Uint32 indices = 0;
+    if (c0 != c1)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            int best = 0;
+            int bestDist = INT_MAX;
+            for (int p = 0; p < 4; ++p)
+            {
+                int dist = TextureBlock_Distance(palette[p], texels[i].data);
+                if (dist < bestDist)
+                {
+                    bestDist = dist;
+                    best = p;
+                }
+            }
+            indices |= (Uint32)best << (2 * i);
+        }
+    }
+
+    block[0] = (Uint8)(c0 & 0xFF);
+    block[1] = (Uint8)(c0 >> 8);
+    block[2] = (Uint8)(c1 & 0xFF);
+    block[3] = (Uint8)(c1 >> 8);
+    for (int i = 0; i < 4; ++i)
+    {
+        block[4 + i] = (Uint8)(indices >> (8 * i));
+    }
+}
+
+/// @brief Encode un canal d'un bloc sur 8 octets (alpha de BC3 ou canaux de BC5).
+/// @param[in] texels les 16 texels.
+/// @param[in] channel l'indice du canal dans les Color.
+static void TextureBlock_EncodeAlpha(const Color *texels, int channel, Uint8 *block)
+{
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i)
+    {
+        a0 = Int_Max(a0, texels[i].data[channel]);
+        a1 = Int_Min(a1, texels[i].data[channel]);
+    }
+
+    int palette[8];
+    TextureBlock_AlphaPalette(a0, a1, palette);
+
+    Uint64 indices = 0;
+    if (a0 != a1)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            int value = texels[i].data[channel];
+            int best = 0;
+            int bestDist = INT_MAX;
+            for (int p = 0; p < 8; ++p)
+            {
+                int dist = abs(palette[p] - value);
+                if (dist < bestDist)
+                {
+                    bestDist = dist;
+                    best = p;
+                }
+            }
+            indices |= (Uint64)best << (3 * i);
+        }
+    }
+
+    block[0] = (Uint8)a0;
+    block[1] = (Uint8)a1;
+    for (int i = 0; i < 6; ++i)
+    {
+        block[2 + i] = (Uint8)(indices >> (8 * i));
+    }
+}
+
+static void TextureBlock_EncodeBlock(MeshTextureFormat format, const Color *texels, Uint8 *block)
+{
+    switch (format)
+    {
+    case MESH_TEXTURE_BC1:
+        TextureBlock_EncodeColor(texels, block);
+        break;
+
+    case MESH_TEXTURE_BC3:
+        TextureBlock_EncodeAlpha(texels, 3, block);
+        TextureBlock_EncodeColor(texels, block + 8);
+        break;
+
+    case MESH_TEXTURE_BC5:
+        TextureBlock_EncodeAlpha(texels, 0, block);
+        TextureBlock_EncodeAlpha(texels, 1, block + 8);
+        break;
+
+    case MESH_TEXTURE_RGBA8:
+    default:
+        assert(false);
+        break;
+    }
+}
+
+/// @brief Calcule le PSNR du niveau 0 d'une texture compressée.
+static float TextureBlock_ComputePSNR(
+    MeshTextureFormat format, const Color *pixels, int width, int height, const Uint8 *blocks)
+{
+    int unitSize = MeshTextureFormat_GetUnitSize(format);
+    int blocksPerRow = (width + 3) >> 2;
+    int channelCount = (format == MESH_TEXTURE_BC5) ? 2 : ((format == MESH_TEXTURE_BC3) ? 4 : 3);
+    double error = 0.0;
+    Uint32 decoded[16];
+
+    for (int by = 0; by < (height + 3) >> 2; ++by)
+    {
+        for (int bx = 0; bx < blocksPerRow; ++bx)
+        {
+            TextureBlock_Decode(format, blocks + ((size_t)by * blocksPerRow + bx) * unitSize, decoded);
+            for (int y = 4 * by; y < Int_Min(4 * by + 4, height); ++y)
+            {
+                for (int x = 4 * bx; x < Int_Min(4 * bx + 4, width); ++x)
+                {
+                    Color src = pixels[y * width + x];
+                    Uint32 dst = decoded[((y & 3) << 2) | (x & 3)];
+                    for (int c = 0; c < channelCount; ++c)
+                    {
+                        double diff = (double)src.data[c] - (double)((dst >> (8 * c)) & 0xFF);
+                        error += diff * diff;
+                    }
+                }
+            }
+        }
+    }
+
+    double mse = error / ((double)width * height * channelCount);
+    if (mse <= 0.0) return INFINITY;
+    return (float)(10.0 * log10(255.0 * 255.0 / mse));
+}
+
+int TextureBlock_Compress(MeshTexture *texture, MeshTextureFormat format, float *psnr)
+{
+    MeshTextureLevel levels[MESH_TEXTURE_MAX_LEVELS] = { 0 };
+    Uint8 *blocks = NULL;
+
+    assert(texture->m_format == MESH_TEXTURE_RGBA8 && !texture->m_fileMap);
+    assert(MeshTextureFormat_IsCompressed(format));
+
+    // Position des niveaux en blocs
+    int blockCount = 0;
+    for (int i = 0; i < texture->m_levelCount; ++i)
+    {
+        levels[i].m_offset = blockCount;
+        levels[i].m_width = texture->m_levels[i].m_width;
+        levels[i].m_height = texture->m_levels[i].m_height;
+        blockCount += ((levels[i].m_width + 3) >> 2) * ((levels[i].m_height + 3) >> 2);
+    }
+
+    int unitSize = MeshTextureFormat_GetUnitSize(format);
+    blocks = (Uint8 *)calloc(blockCount, unitSize);
+    if (!blocks) goto ERROR_LABEL;
+
+    for (int i = 0; i < texture->m_levelCount; ++i)
+    {
+        const Color *pixels = texture->m_pixels + texture->m_levels[i].m_offset;
+        int w = levels[i].m_width;
+        int h = levels[i].m_height;
+        int blocksPerRow = (w + 3) >> 2;
+
+        for (int by = 0; by < (h + 3) >> 2; ++by)
+        {
+            for (int bx = 0; bx < blocksPerRow; ++bx)
+            {
+                // Les texels en dehors de l'image répètent le bord
+                Color texels[16];
+                for (int j = 0; j < 16; ++j)
+                {
+                    int x = Int_Min(4 * bx + (j & 3), w - 1);
+                    int y = Int_Min(4 * by + (j >> 2), h - 1);
+                    texels[j] = pixels[y * w + x];
+                }
+
+                Uint8 *block = blocks +
+                    ((size_t)levels[i].m_offset + (size_t)by * blocksPerRow + bx) * unitSize;
+                TextureBlock_EncodeBlock(format, texels, block);
+            }
+        }
+    }
+
+    *psnr = TextureBlock_ComputePSNR(
+        format, texture->m_pixels, texture->m_width, texture->m_height, blocks);
+
+    free(texture->m_pixels);
+    texture->m_blocks = blocks;
+    texture->m_format = format;
+    memcpy(texture->m_levels, levels, sizeof(levels));
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - TextureBlock_Compress()\n");
+    assert(false);
+    return EXIT_FAILURE;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Lecture avec cache
+
+/// @brief Bloc décodé conservé dans le cache d'un thread.
+typedef struct TextureBlockCacheEntry_s
+{
+    /// @brief Identifiant de la texture (0 pour une entrée vide).
+    Uint32 m_uid;
+
+    /// @brief Indice du bloc dans les données de la texture.
+    int m_blockIdx;
+
+    Uint32 m_texels[16];
+} TextureBlockCacheEntry;
+
+static THREAD_LOCAL TextureBlockCacheEntry g_blockCache[TEXTURE_BLOCK_CACHE_SIZE];
+
+Uint32 TextureBlock_Fetch(MeshTexture *texture, int levelIdx, int x, int y)
+{
+    MeshTextureLevel *level = &texture->m_levels[levelIdx];
+    int bx = x >> 2;
+    int by = y >> 2;
+    int blocksPerRow = (level->m_width + 3) >> 2;
+    int blockIdx = level->m_offset + by * blocksPerRow + bx;
+
+    // Les blocs voisins (4x4 blocs) occupent des entrées différentes
+    int slot = ((bx & 3) | ((by & 3) << 2)) & (TEXTURE_BLOCK_CACHE_SIZE - 1);
+    TextureBlockCacheEntry *entry = &g_blockCache[slot];
+
+    if (entry->m_uid != texture->m_uid || entry->m_blockIdx != blockIdx)
+    {
+        const Uint8 *block = texture->m_blocks +
+            (size_t)blockIdx * MeshTextureFormat_GetUnitSize(texture->m_format);
+        TextureBlock_Decode(texture->m_format, block, entry->m_texels);
+        entry->m_uid = texture->m_uid;
+        entry->m_blockIdx = blockIdx;
+    }
+
+    return entry->m_texels[((y & 3) << 2) | (x & 3)];
+}
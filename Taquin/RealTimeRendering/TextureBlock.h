@@ -0,0 +1,41 @@
+﻿#ifndef _TEXTURE_BLOCK_H_
+#define _TEXTURE_BLOCK_H_
+
+/// @file TextureBlock.h
+/// @defgroup TextureBlock
+/// @{
+
+#include "Settings.h"
+#include "Material.h"
+
+/// @brief Nombre de blocs décodés conservés par thread.
+/// Doit être une puissance de 2 (les blocs sont rangés selon leur position modulo 4x4).
+#define TEXTURE_BLOCK_CACHE_SIZE 16
+
+/// @brief Compresse une texture RGBA8 (tous ses niveaux) dans un format par blocs.
+/// Les texels d'origine sont libérés.
+/// @param[in,out] texture la texture, au format MESH_TEXTURE_RGBA8.
+/// @param[in] format le format compressé (BC1, BC3 ou BC5).
+/// @param[out] psnr le PSNR (en dB) du niveau 0 compressé par rapport à l'original.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int TextureBlock_Compress(MeshTexture *texture, MeshTextureFormat format, float *psnr);
+
+/// @brief Décode un bloc de 4x4 texels.
+/// @param[in] format le format du bloc.
+/// @param[in] block le bloc.
+/// @param[out] texels les 16 texels (rangés ligne par ligne) au format des Color.
+void TextureBlock_Decode(MeshTextureFormat format, const Uint8 *block, Uint32 *texels);
+
+/// @brief Lit un texel d'une texture compressée.
+/// Les derniers blocs décodés sont conservés dans un cache propre au thread appelant,
+/// un filtrage bilinéaire ne décode donc en général qu'un seul bloc pour quatre lectures.
+/// @param[in] texture la texture compressée.
+/// @param[in] levelIdx le niveau de mipmap.
+/// @param[in] x l'abscisse du texel dans le niveau.
+/// @param[in] y l'ordonnée du texel dans le niveau.
+/// @return Le texel au format des Color.
+Uint32 TextureBlock_Fetch(MeshTexture *texture, int levelIdx, int x, int y);
+
+/// @}
+
+#endif
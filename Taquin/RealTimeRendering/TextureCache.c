@@ -0,0 +1,181 @@
+﻿#include "TextureCache.h"
+#include "TextureRegistry.h"
+#include "FileMap.h"
+#include "Tools.h"
+
+/// @brief Calcule le hachage identifiant une image et ses options de décodage.
+static Uint64 TextureCache_GetKey(char *canonicalPath, int flags)
+{
+    Uint64 hash = Hash_FNV1a(canonicalPath, strlen(canonicalPath), HASH_FNV1A_SEED);
+    return Hash_FNV1a(&flags, sizeof(flags), hash);
+}
+
+/// @brief Construit le chemin du fichier du cache associé à une clé.
+static void TextureCache_GetPath(Uint64 key, char *cachePath, int size)
+{
+    snprintf(
+        cachePath, size, "%s/%016llx.rttx",
+        TEXTURE_CACHE_DIRECTORY, (unsigned long long)key);
+}
+
+/// @brief Vérifie la cohérence d'un en-tête lu dans le cache.
+static bool TextureCache_IsValid(
+    TextureCacheHeader *header, Uint64 fileSize, int flags,
+    FileInfo *sourceInfo, Uint64 sourceKey)
+{
+    if (header->m_magic != TEXTURE_CACHE_MAGIC) return false;
+    if (header->m_version != TEXTURE_CACHE_VERSION) return false;
+    if (header->m_format > MESH_TEXTURE_BC5) return false;
+    if (header->m_flags != (Uint32)flags) return false;
+    if (header->m_sourceSize != sourceInfo->m_size) return false;
+    if (header->m_sourceKey != sourceKey) return false;
+
+    if (header->m_width <= 0 || header->m_height <= 0) return false;
+    if (header->m_levelCount <= 0 || header->m_levelCount > MESH_TEXTURE_MAX_LEVELS) return false;
+    if (header->m_levels[0].m_width != header->m_width) return false;
+    if (header->m_levels[0].m_height != header->m_height) return false;
+    if (header->m_dataOffset % TEXTURE_CACHE_ALIGNMENT != 0) return false;
+    if (header->m_dataOffset < sizeof(TextureCacheHeader)) return false;
+
+    Uint64 dataSize = MeshTexture_GetDataSize(
+        (MeshTextureFormat)header->m_format, header->m_levels, header->m_levelCount);
+    if (header->m_dataSize != dataSize) return false;
+    if ((Uint64)header->m_dataOffset + header->m_dataSize > fileSize) return false;
+
+    return true;
+}
+
+MeshTexture *TextureCache_Load(char *path, int flags)
+{
+    char canonicalPath[TEXTURE_PATH_SIZE] = { 0 };
+    char cachePath[TEXTURE_PATH_SIZE] = { 0 };
+    FileInfo sourceInfo = { 0 };
+    FileMap *map = NULL;
+    MeshTexture *texture = NULL;
+
+    int exitStatus = TextureRegistry_GetCanonicalPath(path, canonicalPath);
+    if (exitStatus != EXIT_SUCCESS) return NULL;
+
+    exitStatus = FileMap_GetInfo(canonicalPath, &sourceInfo);
+    if (exitStatus != EXIT_SUCCESS) return NULL;
+
+    Uint64 key = TextureCache_GetKey(canonicalPath, flags);
+    TextureCache_GetPath(key, cachePath, TEXTURE_PATH_SIZE);
+
+    map = FileMap_Open(cachePath, FILEMAP_ACCESS_DEFAULT);
+    if (!map) return NULL;
+
+    Uint64 fileSize = FileMap_GetSize(map);
+    TextureCacheHeader *header = (TextureCacheHeader *)FileMap_GetData(map);
+    if (fileSize < sizeof(TextureCacheHeader) ||
+        !TextureCache_IsValid(header, fileSize, flags, &sourceInfo, key))
+    {
+        FileMap_Close(map);
+        return NULL;
+    }
+
+    if (header->m_sourceTime != sourceInfo.m_modifiedTime)
+    {
+        // Image modifiée, copiée ou extraite de nouveau : compare son contenu
+        Uint64 sourceHash = 0;
+        exitStatus = FileMap_HashFile(canonicalPath, &sourceHash);
+        if (exitStatus != EXIT_SUCCESS || sourceHash != header->m_sourceHash)
+        {
+            FileMap_Close(map);
+            return NULL;
+        }
+    }
+
+    texture = (MeshTexture *)calloc(1, sizeof(MeshTexture));
+    if (!texture) goto ERROR_LABEL;
+
+    texture->m_format = (MeshTextureFormat)header->m_format;
+    texture->m_width = header->m_width;
+    texture->m_height = header->m_height;
+    texture->m_levelCount = header->m_levelCount;
+    memcpy(texture->m_levels, header->m_levels, sizeof(texture->m_levels));
+    texture->m_lodBias = 0.5f * log2f((float)texture->m_width * (float)texture->m_height);
+    texture->m_blocks = (Uint8 *)FileMap_GetData(map) + header->m_dataOffset;
+    texture->m_fileMap = map;
+
+    return texture;
+
+ERROR_LABEL:
+    printf("ERROR - TextureCache_Load()\n");
+    assert(false);
+    FileMap_Close(map);
+    return NULL;
+}
+
+int TextureCache_Store(char *path, int flags, MeshTexture *texture)
+{
+    char canonicalPath[TEXTURE_PATH_SIZE] = { 0 };
+    char cachePath[TEXTURE_PATH_SIZE] = { 0 };
+    char tmpPath[TEXTURE_PATH_SIZE] = { 0 };
+    FileInfo sourceInfo = { 0 };
+    FILE *file = NULL;
+
+    int exitStatus = TextureRegistry_GetCanonicalPath(path, canonicalPath);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    exitStatus = FileMap_GetInfo(canonicalPath, &sourceInfo);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    exitStatus = FileMap_CreateDirectory(TEXTURE_CACHE_DIRECTORY);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    Uint64 key = TextureCache_GetKey(canonicalPath, flags);
+    TextureCache_GetPath(key, cachePath, TEXTURE_PATH_SIZE);
+    FileMap_GetTempPath(cachePath, tmpPath, TEXTURE_PATH_SIZE);
+
+    TextureCacheHeader header = { 0 };
+    header.m_magic = TEXTURE_CACHE_MAGIC;
+    header.m_version = TEXTURE_CACHE_VERSION;
+    header.m_format = (Uint32)texture->m_format;
+    header.m_flags = (Uint32)flags;
+    header.m_width = texture->m_width;
+    header.m_height = texture->m_height;
+    header.m_levelCount = texture->m_levelCount;
+    memcpy(header.m_levels, texture->m_levels, sizeof(header.m_levels));
+    header.m_sourceKey = key;
+    header.m_sourceSize = sourceInfo.m_size;
+    header.m_sourceTime = sourceInfo.m_modifiedTime;
+
+    exitStatus = FileMap_HashFile(canonicalPath, &header.m_sourceHash);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    header.m_dataSize = MeshTexture_GetDataSize(
+        texture->m_format, texture->m_levels, texture->m_levelCount);
+    header.m_dataOffset =
+        (sizeof(TextureCacheHeader) + TEXTURE_CACHE_ALIGNMENT - 1) &
+        ~(TEXTURE_CACHE_ALIGNMENT - 1);
+
+    // Écrit dans un fichier temporaire propre à cet appel puis le renomme pour ne jamais
+    // laisser un fichier incomplet dans le cache, même si plusieurs chargements
+    // décodent la même image en même temps
+    fopen_s(&file, tmpPath, "wb");
+    if (!file) goto ERROR_LABEL;
+
+    Uint8 padding[TEXTURE_CACHE_ALIGNMENT] = { 0 };
+    size_t paddingSize = header.m_dataOffset - sizeof(TextureCacheHeader);
+
+    bool success = true;
+    success = success && fwrite(&header, sizeof(TextureCacheHeader), 1, file) == 1;
+    success = success && fwrite(padding, 1, paddingSize, file) == paddingSize;
+    success = success && fwrite(texture->m_blocks, 1, (size_t)header.m_dataSize, file) == header.m_dataSize;
+    success = (fclose(file) == 0) && success;
+    file = NULL;
+
+    if (!success) goto ERROR_LABEL;
+
+    exitStatus = FileMap_Replace(tmpPath, cachePath);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - TextureCache_Store() %s\n", path);
+    if (file) fclose(file);
+    if (tmpPath[0] != '\0') remove(tmpPath);
+    return EXIT_FAILURE;
+}
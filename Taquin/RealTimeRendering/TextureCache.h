@@ -0,0 +1,70 @@
+﻿#ifndef _TEXTURE_CACHE_H_
+#define _TEXTURE_CACHE_H_
+
+/// @file TextureCache.h
+/// @defgroup TextureCache
+/// @{
+
+#include "Settings.h"
+#include "Material.h"
+
+/// @brief Dossier contenant les textures décodées (relatif au dossier d'exécution).
+#define TEXTURE_CACHE_DIRECTORY "../Cache/Textures"
+
+/// @brief Identifiant des fichiers du cache ("RTTX").
+#define TEXTURE_CACHE_MAGIC 0x58545452
+
+/// @brief Version du format des fichiers du cache.
+/// Elle doit être incrémentée à chaque modification de TextureCacheHeader ou du
+/// contenu des textures (filtrage des mipmaps...).
+#define TEXTURE_CACHE_VERSION 2
+
+/// @brief Alignement (en octets) du début des texels dans un fichier du cache.
+#define TEXTURE_CACHE_ALIGNMENT 64
+
+/// @brief En-tête d'un fichier du cache.
+/// Le fichier contient ensuite les texels de tous les niveaux, à partir de m_dataOffset,
+/// dans la disposition de MeshTexture::m_pixels.
+typedef struct TextureCacheHeader_s
+{
+    Uint32 m_magic;
+    Uint32 m_version;
+    Uint32 m_format;
+    Uint32 m_flags;
+
+    Sint32 m_width;
+    Sint32 m_height;
+    Sint32 m_levelCount;
+    Uint32 m_dataOffset;
+    Uint64 m_dataSize;
+
+    MeshTextureLevel m_levels[MESH_TEXTURE_MAX_LEVELS];
+
+    /// @brief Clé du fichier du cache : hachage du chemin de l'image source et des options
+    /// de décodage. Elle distingue deux images dont les clés donnent le même nom de fichier.
+    Uint64 m_sourceKey;
+
+    /// @brief Taille, date de modification et hachage du contenu de l'image source.
+    /// Le hachage n'est recalculé que si la date ne correspond plus.
+    Uint64 m_sourceSize;
+    Sint64 m_sourceTime;
+    Uint64 m_sourceHash;
+} TextureCacheHeader;
+
+/// @brief Charge une texture depuis le cache.
+/// Le fichier est projeté en mémoire : les texels ne sont ni copiés ni décodés.
+/// @param[in] path le chemin de l'image source.
+/// @param[in] flags les options de décodage (MeshTextureFlags).
+/// @return La texture, ou NULL si elle n'est pas dans le cache ou si elle n'est plus à jour.
+MeshTexture *TextureCache_Load(char *path, int flags);
+
+/// @brief Écrit une texture décodée dans le cache.
+/// @param[in] path le chemin de l'image source.
+/// @param[in] flags les options de décodage (MeshTextureFlags).
+/// @param[in] texture la texture.
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int TextureCache_Store(char *path, int flags, MeshTexture *texture);
+
+/// @}
+
+#endif
@@ -0,0 +1,228 @@
+﻿#include "TextureRegistry.h"
+#include "Tools.h"
+
+#include <ctype.h>
+#ifndef _WIN32
+#  include <limits.h>
+#endif
+
+/// @brief Entrée du registre : une image décodée avec des options données.
+typedef struct TextureEntry_s
+{
+    Uint64       m_hash;
+    int          m_flags;
+    int          m_refCount;
+    char        *m_path;
+    MeshTexture *m_texture;
+} TextureEntry;
+
+static TextureEntry *g_textureEntries = NULL;
+static int g_textureCount = 0;
+static int g_textureCapacity = 0;
+
+/// @brief Verrou protégeant le registre.
+/// Il n'est jamais conservé pendant le décodage d'une image.
+static SDL_SpinLock g_textureLock = 0;
+
+/// @brief Options ajoutées à chaque texture acquise.
+static int g_textureDefaultFlags = MESH_TEXTURE_DEFAULT;
+
+void TextureRegistry_SetDefaultFlags(int flags)
+{
+    g_textureDefaultFlags = flags;
+}
+
+int TextureRegistry_GetCanonicalPath(char *path, char *canonicalPath)
+{
+#ifdef _WIN32
+    if (!_fullpath(canonicalPath, path, TEXTURE_PATH_SIZE)) goto ERROR_LABEL;
+
+    // Le système de fichiers ne distingue pas la casse
+    for (char *c = canonicalPath; *c; ++c)
+    {
+        *c = (*c == '/') ? '\\' : (char)tolower((unsigned char)*c);
+    }
+#else
+    char buffer[PATH_MAX];
+    if (!realpath(path, buffer)) goto ERROR_LABEL;
+    if (strlen(buffer) >= TEXTURE_PATH_SIZE) goto ERROR_LABEL;
+    strcpy(canonicalPath, buffer);
+#endif
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - TextureRegistry_GetCanonicalPath() %s\n", path);
+    return EXIT_FAILURE;
+}
+
+/// @brief Recherche une entrée dans le registre. Le verrou doit être pris.
+static TextureEntry *TextureRegistry_Find(char *canonicalPath, Uint64 hash, int flags)
+{
+    for (int i = 0; i < g_textureCount; ++i)
+    {
+        TextureEntry *entry = &g_textureEntries[i];
+        if (entry->m_hash == hash && entry->m_flags == flags &&
+            strcmp(entry->m_path, canonicalPath) == 0)
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/// @brief Ajoute une entrée au registre. Le verrou doit être pris.
+static int TextureRegistry_Insert(
+    char *canonicalPath, Uint64 hash, int flags, MeshTexture *texture)
+{
+    char *path = NULL;
+
+    if (g_textureCount >= g_textureCapacity)
+    {
+        int capacity = Int_Max(g_textureCapacity << 1, 16);
+        TextureEntry *newEntries = (TextureEntry *)realloc(
+            g_textureEntries, capacity * sizeof(TextureEntry));
+        if (!newEntries) goto ERROR_LABEL;
+
+        g_textureEntries = newEntries;
+        g_textureCapacity = capacity;
+    }
+
+    size_t length = strlen(canonicalPath);
+    path = (char *)calloc(length + 1, sizeof(char));
+    if (!path) goto ERROR_LABEL;
+    memcpy(path, canonicalPath, length);
+
+    TextureEntry *entry = &g_textureEntries[g_textureCount++];
+    entry->m_hash = hash;
+    entry->m_flags = flags;
+    entry->m_refCount = 1;
+    entry->m_path = path;
+    entry->m_texture = texture;
+
+    return EXIT_SUCCESS;
+
+ERROR_LABEL:
+    printf("ERROR - TextureRegistry_Insert()\n");
+    assert(false);
+    free(path);
+    return EXIT_FAILURE;
+}
+
+MeshTexture *TextureRegistry_Acquire(char *path, int flags)
+{
+    char canonicalPath[TEXTURE_PATH_SIZE] = { 0 };
+    MeshTexture *texture = NULL;
+    MeshTexture *newTexture = NULL;
+
+    int exitStatus = TextureRegistry_GetCanonicalPath(path, canonicalPath);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+    flags |= g_textureDefaultFlags;
+    Uint64 hash = Hash_FNV1a(canonicalPath, strlen(canonicalPath), HASH_FNV1A_SEED);
+
+    // Texture déjà présente
+    SDL_AtomicLock(&g_textureLock);
+    TextureEntry *entry = TextureRegistry_Find(canonicalPath, hash, flags);
+    if (entry)
+    {
+        entry->m_refCount++;
+        texture = entry->m_texture;
+    }
+    SDL_AtomicUnlock(&g_textureLock);
+
+    if (texture) return texture;
+
+    // Décode l'image en dehors du verrou
+    newTexture = MeshTexture_Load(canonicalPath, flags);
+    if (!newTexture) goto ERROR_LABEL;
+
+    SDL_AtomicLock(&g_textureLock);
+    entry = TextureRegistry_Find(canonicalPath, hash, flags);
+    if (entry)
+    {
+        // Un autre thread a chargé la même image entre temps
+        entry->m_refCount++;
+        texture = entry->m_texture;
+    }
+    else
+    {
+        exitStatus = TextureRegistry_Insert(canonicalPath, hash, flags, newTexture);
+        if (exitStatus == EXIT_SUCCESS)
+        {
+            texture = newTexture;
+            newTexture = NULL;
+        }
+    }
+    SDL_AtomicUnlock(&g_textureLock);
+
+    MeshTexture_Free(newTexture);
+    if (!texture) goto ERROR_LABEL;
+
+    return texture;
+
+ERROR_LABEL:
+    printf("ERROR - TextureRegistry_Acquire()\n");
+    assert(false);
+    return NULL;
+}
+
+void TextureRegistry_Retain(MeshTexture *texture)
+{
+    bool found = false;
+
+    SDL_AtomicLock(&g_textureLock);
+    for (int i = 0; i < g_textureCount; ++i)
+    {
+        if (g_textureEntries[i].m_texture == texture)
+        {
+            g_textureEntries[i].m_refCount++;
+            found = true;
+            break;
+        }
+    }
+    SDL_AtomicUnlock(&g_textureLock);
+
+    assert(found);
+}
+
+void TextureRegistry_Release(MeshTexture *texture)
+{
+    if (!texture) return;
+
+    MeshTexture *unused = NULL;
+    char *unusedPath = NULL;
+    bool found = false;
+
+    SDL_AtomicLock(&g_textureLock);
+    for (int i = 0; i < g_textureCount; ++i)
+    {
+        TextureEntry *entry = &g_textureEntries[i];
+        if (entry->m_texture != texture)
+            continue;
+
+        found = true;
+        if (--entry->m_refCount == 0)
+        {
+            unused = entry->m_texture;
+            unusedPath = entry->m_path;
+            g_textureEntries[i] = g_textureEntries[--g_textureCount];
+        }
+        break;
+    }
+    SDL_AtomicUnlock(&g_textureLock);
+
+    assert(found);
+
+    MeshTexture_Free(unused);
+    free(unusedPath);
+}
+
+int TextureRegistry_GetCount()
+{
+    SDL_AtomicLock(&g_textureLock);
+    int count = g_textureCount;
+    SDL_AtomicUnlock(&g_textureLock);
+
+    return count;
+}
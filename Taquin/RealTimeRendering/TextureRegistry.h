@@ -0,0 +1,51 @@
+﻿#ifndef _TEXTURE_REGISTRY_H_
+#define _TEXTURE_REGISTRY_H_
+
+/// @file TextureRegistry.h
+/// @defgroup TextureRegistry
+/// @{
+
+#include "Settings.h"
+#include "Material.h"
+
+/// @brief Taille maximale d'un chemin de texture.
+#define TEXTURE_PATH_SIZE 1024
+
+/// @brief Renvoie la texture associée à une image en la décodant seulement si nécessaire.
+/// Le registre est global au programme : une image référencée par plusieurs matériaux,
+/// ou par plusieurs modèles, n'est décodée et stockée qu'une seule fois.
+/// Chaque appel réussi doit être associé à un appel à TextureRegistry_Release().
+/// Cette fonction peut être appelée depuis plusieurs threads.
+/// @param[in] path le chemin de l'image.
+/// @param[in] flags les options de décodage (MeshTextureFlags).
+/// @return La texture partagée ou NULL en cas d'erreur.
+MeshTexture *TextureRegistry_Acquire(char *path, int flags);
+
+/// @brief Ajoute une référence à une texture obtenue avec TextureRegistry_Acquire().
+/// Chaque appel doit aussi être associé à un appel à TextureRegistry_Release().
+/// @param[in] texture la texture.
+void TextureRegistry_Retain(MeshTexture *texture);
+
+/// @brief Rend une texture obtenue avec TextureRegistry_Acquire().
+/// La texture est détruite lorsque plus aucun matériau ne la référence.
+/// @param[in] texture la texture (peut valoir NULL).
+void TextureRegistry_Release(MeshTexture *texture);
+
+/// @brief Définit les options ajoutées à toutes les textures chargées par la suite
+/// (par exemple MESH_TEXTURE_COMPRESSED).
+/// @param[in] flags les options (MeshTextureFlags).
+void TextureRegistry_SetDefaultFlags(int flags);
+
+/// @brief Renvoie le nombre de textures distinctes actuellement chargées.
+/// @return Le nombre de textures dans le registre.
+int TextureRegistry_GetCount();
+
+/// @brief Calcule le chemin absolu et normalisé d'un fichier.
+/// @param[in] path le chemin.
+/// @param[out] canonicalPath le chemin normalisé (TEXTURE_PATH_SIZE caractères).
+/// @return EXIT_SUCCESS ou EXIT_FAILURE.
+int TextureRegistry_GetCanonicalPath(char *path, char *canonicalPath);
+
+/// @}
+
+#endif
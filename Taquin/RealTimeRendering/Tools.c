@@ -49,3 +49,91 @@ Vec3 Vec3_Abs(Vec3 v)
     v.z = fabsf(v.z);
     return v;
 }
+
+Uint16 Float_ToHalf(float value)
+{
+    Uint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    Uint16 sign = (Uint16)((bits >> 16) & 0x8000);
+    Uint32 absBits = bits & 0x7FFFFFFF;
+
+    if (absBits >= 0x7F800000)
+    {
+        // Infini ou NaN
+        return sign | 0x7C00 | (absBits > 0x7F800000 ? 0x200 : 0);
+    }
+    if (absBits >= 0x477FF000)
+    {
+        // Au-del de 65520, l'arrondi donne l'infini
+        return sign | 0x7C00;
+    }
+    if (absBits < 0x38800000)
+    {
+        // Moins de 2^-14 : dnormalis, la mantisse vaut value * 2^24
+        float absValue;
+        memcpy(&absValue, &absBits, sizeof(absValue));
+        return sign | (Uint16)lrintf(absValue * 16777216.0f);
+    }
+
+    // Change le biais de l'exposant et arrondit la mantisse au plus proche (pair)
+    Uint32 half = (absBits - 0x38000000) >> 13;
+    Uint32 rest = absBits & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+    {
+        half++;
+    }
+    return sign | (Uint16)half;
+}
+
+void Vec3_EncodeOctahedral(Vec3 direction, Sint16 out[2])
+{
+    float sum = fabsf(direction.x) + fabsf(direction.y) + fabsf(direction.z);
+    if (sum < 1e-20f)
+    {
+        out[0] = out[1] = 0;
+        return;
+    }
+
+    float x = direction.x / sum;
+    float y = direction.y / sum;
+    if (direction.z < 0.0f)
+    {
+        // Replie la moiti z < 0
+        float foldedX = (1.0f - fabsf(y)) * Float_Sign(x);
+        float foldedY = (1.0f - fabsf(x)) * Float_Sign(y);
+        x = foldedX;
+        y = foldedY;
+    }
+
+    Vec3 target = Vec3_Normalize(direction);
+    float baseX = floorf(Float_Clamp(x, -1.0f, 1.0f) * 32767.0f);
+    float baseY = floorf(Float_Clamp(y, -1.0f, 1.0f) * 32767.0f);
+    float bestDot = -2.0f;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        Sint16 candidate[2];
+        candidate[0] = (Sint16)Float_Clamp(baseX + (float)(i & 1), -32767.0f, 32767.0f);
+        candidate[1] = (Sint16)Float_Clamp(baseY + (float)(i >> 1), -32767.0f, 32767.0f);
+
+        float dot = Vec3_Dot(Vec3_DecodeOctahedral(candidate), target);
+        if (dot > bestDot)
+        {
+            bestDot = dot;
+            out[0] = candidate[0];
+            out[1] = candidate[1];
+        }
+    }
+}
+
+Uint64 Hash_FNV1a(const void *data, size_t size, Uint64 hash)
+{
+    const Uint8 *bytes = (const Uint8 *)data;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
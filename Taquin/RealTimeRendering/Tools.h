@@ -1,4 +1,4 @@
-#ifndef _TOOLS_H_
+﻿#ifndef _TOOLS_H_
 #define _TOOLS_H_
 
 #include "Settings.h"
@@ -69,4 +69,76 @@ Vec3 Vec3_Clamp01(Vec3 v);
 Vec3 Vec3_Frac(Vec3 v);
 Vec3 Vec3_Abs(Vec3 v);
 
+/// @brief Convertit un flottant en demi-flottant (IEEE 754 sur 16 bits).
+/// La valeur est arrondie au plus proche, les valeurs trop grandes deviennent infinies.
+/// @param[in] value le flottant.
+/// @return Les 16 bits du demi-flottant.
+Uint16 Float_ToHalf(float value);
+
+/// @brief Convertit un demi-flottant (IEEE 754 sur 16 bits) en flottant.
+/// @param[in] half les 16 bits du demi-flottant.
+/// @return Le flottant (la conversion est exacte).
+INLINE float Half_ToFloat(Uint16 half)
+{
+    Uint32 sign = (Uint32)(half & 0x8000) << 16;
+    Uint32 exponent = (half >> 10) & 0x1F;
+    Uint32 mantissa = half & 0x3FF;
+    Uint32 bits;
+
+    if (exponent == 0)
+    {
+        // Zéro ou dénormalisé : mantissa * 2^-24
+        float value = (float)mantissa * (1.0f / 16777216.0f);
+        return sign ? -value : value;
+    }
+    else if (exponent == 0x1F)
+    {
+        // Infini ou NaN
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    }
+    else
+    {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/// @brief Encode une direction en coordonnées octaédriques sur 2 x 16 bits.
+/// La direction est projetée sur l'octaèdre |x| + |y| + |z| = 1, dont la moitié z < 0
+/// est repliée sur le carré [-1,1]². Parmi les arrondis voisins, celui qui est décodé
+/// le plus près de la direction est conservé.
+/// @param[in] direction la direction (non nécessairement normalisée).
+/// @param[out] out les deux coordonnées.
+void Vec3_EncodeOctahedral(Vec3 direction, Sint16 out[2]);
+
+/// @brief Décode une direction encodée avec Vec3_EncodeOctahedral().
+/// @param[in] in les deux coordonnées.
+/// @return La direction normalisée.
+INLINE Vec3 Vec3_DecodeOctahedral(const Sint16 in[2])
+{
+    float x = (float)in[0] * (1.0f / 32767.0f);
+    float y = (float)in[1] * (1.0f / 32767.0f);
+    float z = 1.0f - fabsf(x) - fabsf(y);
+
+    // Déplie la moitié z < 0
+    float t = fmaxf(-z, 0.0f);
+    x += (x >= 0.0f) ? -t : t;
+    y += (y >= 0.0f) ? -t : t;
+
+    return Vec3_Normalize(Vec3_Set(x, y, z));
+}
+
+/// @brief Valeur initiale du hachage FNV-1a (64 bits).
+#define HASH_FNV1A_SEED 14695981039346656037ULL
+
+/// @brief Hache un bloc mémoire avec FNV-1a (64 bits).
+/// @param[in] data les données.
+/// @param[in] size la taille des données en octets.
+/// @param[in] hash le hachage précédent (HASH_FNV1A_SEED pour commencer).
+/// @return Le hachage mis à jour.
+Uint64 Hash_FNV1a(const void *data, size_t size, Uint64 hash);
+
 #endif
\ No newline at end of file
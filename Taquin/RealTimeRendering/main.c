@@ -10,8 +10,32 @@
 #include "Tools.h"
 #include "Mesh.h"
 #include "Material.h"
+#include "TextureRegistry.h"
+#include "InstanceGroup.h"
+#include "MeshOcclusion.h"
 #include <stdio.h>
 
+/// @brief Nombre de personnages par côté de la foule (touche G).
+#define CROWD_SIZE 7
+
+/// @brief Distance entre deux personnages de la foule.
+#define CROWD_SPACING 4.0f
+
+/// @brief Nombre de personnages statiques du décor (touche H).
+#define DECOR_SIZE 24
+
+/// @brief Rayon du cercle sur lequel est disposé le décor.
+#define DECOR_RADIUS 20.0f
+
+/// @brief Modèles fournis avec le programme (dossier, fichier obj).
+static char *g_objModels[][2] = {
+    { "../Obj/Bob",         "spongebob.obj"   },
+    { "../Obj/CaptainToad", "CaptainToad.obj" },
+    { "../Obj/Jaxy",        "Jaxy.obj"        },
+    { "../Obj/Trump",       "Trump.obj"       },
+    { "../Obj/Shrek",       "shrek.obj"       },
+};
+
 int main(int argc, char *argv[])
 {
     srand(time(NULL));
@@ -22,6 +46,43 @@ int main(int argc, char *argv[])
     bool MeGaBaCkFliPdElAmOrTqUiTuE = 0;
     int numPerso = 1;
 
+    // Options de la ligne de commande
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--bc") == 0)
+        {
+            // Textures compressées par blocs (BC1/BC3, BC5 pour les normal maps)
+            TextureRegistry_SetDefaultFlags(MESH_TEXTURE_COMPRESSED);
+        }
+        else if (strcmp(argv[i], "--quantize") == 0)
+        {
+            // Sommets compressés au chargement, les sommets en flottants 32 bits sont libérés
+            Mesh_SetQuantization(true);
+        }
+        else if (strcmp(argv[i], "--ao") == 0)
+        {
+            // Occlusion ambiante calculée au chargement, suivie éventuellement du nombre de rayons
+            int rayCount = MESH_OCCLUSION_DEFAULT_RAY_COUNT;
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0)
+            {
+                rayCount = atoi(argv[++i]);
+            }
+            MeshOcclusion_SetRayCount(rayCount);
+        }
+        else if (strcmp(argv[i], "--bench-obj") == 0)
+        {
+            // Compare les analyseurs obj sur tous les modèles puis quitte
+            int benchStatus = EXIT_SUCCESS;
+            int modelCount = sizeof(g_objModels) / sizeof(g_objModels[0]);
+            for (int j = 0; j < modelCount; ++j)
+            {
+                if (Mesh_BenchmarkOBJ(g_objModels[j][0], g_objModels[j][1]) != EXIT_SUCCESS)
+                    benchStatus = EXIT_FAILURE;
+            }
+            return benchStatus;
+        }
+    }
+
     //Choix du personnage
     printf("=========================================================================\n=                         CHOIX DU PERSONNAGE                           =\n=========================================================================\n");
     printf("1 - Bob l'Eponge\n2 - CaptainToad\n3 - Jaxy\n4 - Donald Trump (pas de normal map)\n5 - Shrek\n");
@@ -32,7 +93,9 @@ int main(int argc, char *argv[])
     Window *window = NULL;
     Renderer *renderer = NULL;
     Scene *scene = NULL;
-    Mesh *mesh = NULL;
+    MeshLoad *meshLoad = NULL;
+    Uint64 loadStart = SDL_GetPerformanceCounter();
+    double frequency = (double)SDL_GetPerformanceFrequency();
 
     // Initialise la SDL et crée la fenêtre
     int exitStatus = Settings_InitSDL();
@@ -50,34 +113,12 @@ int main(int argc, char *argv[])
     scene = Scene_New(window);
     if (!scene) goto ERROR_LABEL;
 
-    switch(numPerso)//charge l'obj correspondant au choix réalisé plus haut
-    {
-        case(1):
-        mesh = Scene_CreateMeshFromOBJ(scene, "../Obj/Bob", "spongebob.obj");
-        break;
-
-        case(2):
-        mesh = Scene_CreateMeshFromOBJ(scene, "../Obj/CaptainToad", "CaptainToad.obj");
-        break;
-
-        case(3):
-        mesh = Scene_CreateMeshFromOBJ(scene, "../Obj/Jaxy", "Jaxy.obj");
-        break;
-
-        case(4):
-        mesh = Scene_CreateMeshFromOBJ(scene, "../Obj/Trump", "Trump.obj");
-        break;
-
-        case(5):
-        mesh = Scene_CreateMeshFromOBJ(scene, "../Obj/Shrek", "shrek.obj");
-        break;
-
-        default:
-        mesh = Scene_CreateMeshFromOBJ(scene, "../Obj/Bob", "spongebob.obj");
-        break;
-    }
-    //mesh = Scene_CreateMeshFromOBJ(scene, "../Obj/CaptainToad", "CaptainToad.obj");
-    if (!mesh) goto ERROR_LABEL;
+    // Charge l'obj correspondant au choix réalisé plus haut, en arrière-plan :
+    // la boucle de rendu démarre sans attendre le mesh ni ses textures
+    int modelCount = sizeof(g_objModels) / sizeof(g_objModels[0]);
+    int modelIndex = (numPerso >= 1 && numPerso <= modelCount) ? numPerso - 1 : 0;
+    meshLoad = Scene_LoadMeshAsync(scene, g_objModels[modelIndex][0], g_objModels[modelIndex][1]);
+    if (!meshLoad) goto ERROR_LABEL;
 
     // Arbre de scène
     Object *root   = Scene_GetRoot(scene);
@@ -90,23 +131,26 @@ int main(int argc, char *argv[])
     exitStatus = Object_Init(object, scene, Mat4_Identity, root);
     if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
 
-    Object_SetMesh(object, mesh);
+    // Crée la foule : des copies teintées du personnage autour de lui
+    InstanceGroup *crowd = (InstanceGroup *)Scene_CreateObject(scene, sizeof(InstanceGroup));
+    if (!crowd) goto ERROR_LABEL;
+
+    exitStatus = InstanceGroup_Init(crowd, scene, Mat4_Identity, root);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    bool crowdOnOff = false;
+
+    // Crée le décor : des copies statiques du personnage disposées en cercle,
+    // fusionnées par la scène en un seul mesh
+    Object *decor = Scene_CreateObject(scene, sizeof(Object));
+    if (!decor) goto ERROR_LABEL;
 
-    // Calcule une échelle normalisée pour l'objet
-    Vec3 meshCenter = mesh->m_center;
-    Vec3 meshMin = mesh->m_min;
-    Vec3 meshMax = mesh->m_max;
-    float xSize = fabsf(meshMax.x - meshMin.x);
-    float ySize = fabsf(meshMax.y - meshMin.y);
-    float zSize = fabsf(meshMax.z - meshMin.z);
-    float objectSize = fmaxf(xSize, fmaxf(ySize, zSize));
-    float scale = 3.0f / objectSize;
+    exitStatus = Object_Init(decor, scene, Mat4_Identity, root);
+    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+    bool decorOnOff = false;
 
-    // Centre l'objet en (0,0,0) et applique l'échelle
-    Mat4 objectTransform = Mat4_Identity;
-    objectTransform = Mat4_GetTranslationMatrix(Vec3_Neg(mesh->m_center));
-    objectTransform = Mat4_MulMM(Mat4_GetScaleMatrix(scale), objectTransform);
-    Object_SetLocalTransform(object, objectTransform);
+    MeshLoadState loadState = MESH_LOAD_PENDING;
+    bool firstFrame = true;
+    int lodLevel = 0;
 
     // Lancement du temps global
     Timer_Start(g_time);
@@ -130,6 +174,83 @@ int main(int argc, char *argv[])
         // Met à jour le temps global
         Timer_Update(g_time);
 
+        // Suit le chargement du personnage
+        MeshLoadState newLoadState = MeshLoad_GetState(meshLoad);
+
+        if (newLoadState != loadState)
+        {
+            double loadTime = 1000.0 * (double)(SDL_GetPerformanceCounter() - loadStart) / frequency;
+            Mesh *mesh = MeshLoad_GetMesh(meshLoad);
+
+            if (mesh && !Object_GetMesh(object))
+            {
+                // Calcule une échelle normalisée pour l'objet
+                Vec3 meshMin = mesh->m_min;
+                Vec3 meshMax = mesh->m_max;
+                float xSize = fabsf(meshMax.x - meshMin.x);
+                float ySize = fabsf(meshMax.y - meshMin.y);
+                float zSize = fabsf(meshMax.z - meshMin.z);
+                float objectSize = fmaxf(xSize, fmaxf(ySize, zSize));
+                float scale = 3.0f / objectSize;
+
+                // Centre l'objet en (0,0,0) et applique l'échelle
+                Mat4 objectTransform = Mat4_Identity;
+                objectTransform = Mat4_GetTranslationMatrix(Vec3_Neg(mesh->m_center));
+                objectTransform = Mat4_MulMM(Mat4_GetScaleMatrix(scale), objectTransform);
+                Object_SetLocalTransform(object, objectTransform);
+
+                // Place les copies sur une grille centrée sur le personnage
+                for (int i = 0; i < CROWD_SIZE * CROWD_SIZE; ++i)
+                {
+                    float x = CROWD_SPACING * (float)(i % CROWD_SIZE - CROWD_SIZE / 2);
+                    float z = CROWD_SPACING * (float)(i / CROWD_SIZE - CROWD_SIZE / 2);
+                    if (x == 0.0f && z == 0.0f)
+                        continue;
+
+                    Vec3 tint = Vec3_Set(
+                        0.5f + 0.5f * (float)rand() / (float)RAND_MAX,
+                        0.5f + 0.5f * (float)rand() / (float)RAND_MAX,
+                        0.5f + 0.5f * (float)rand() / (float)RAND_MAX);
+                    Mat4 instanceTransform = Mat4_MulMM(
+                        Mat4_GetTranslationMatrix(Vec3_Set(x, 0.0f, z)), objectTransform);
+                    if (InstanceGroup_AddInstance(crowd, instanceTransform, tint) < 0) goto ERROR_LABEL;
+                }
+
+                // Place le décor, tourné vers le centre (sans mesh tant qu'il est masqué)
+                for (int i = 0; i < DECOR_SIZE; ++i)
+                {
+                    float angle = 360.0f * (float)i / (float)DECOR_SIZE;
+                    Mat4 decorTransform = Mat4_MulMM(
+                        Mat4_GetYRotationMatrix(angle),
+                        Mat4_MulMM(
+                            Mat4_GetTranslationMatrix(Vec3_Set(0.0f, 0.0f, -DECOR_RADIUS)),
+                            objectTransform));
+
+                    Object *decorObject = Scene_CreateObject(scene, sizeof(Object));
+                    if (!decorObject) goto ERROR_LABEL;
+
+                    exitStatus = Object_Init(decorObject, scene, decorTransform, decor);
+                    if (exitStatus != EXIT_SUCCESS) goto ERROR_LABEL;
+
+                    Object_SetStatic(decorObject, true);
+                }
+
+                // Le mesh est affiché sans textures jusqu'à la fin de leur décodage
+                Object_SetMesh(object, mesh);
+                printf("Mesh pret apres %.1f ms\n", loadTime);
+            }
+            if (newLoadState == MESH_LOAD_DONE)
+            {
+                printf("Textures pretes apres %.1f ms\n", loadTime);
+            }
+            if (newLoadState == MESH_LOAD_FAILED)
+            {
+                // Fichier vide ou illisible : la scène reste vide, comme pendant le chargement
+                printf("Mesh non charge apres %.1f ms\n", loadTime);
+            }
+            loadState = newLoadState;
+        }
+
         SDL_SetWindowGrab(window, 0);
 
         while (SDL_PollEvent(&evt))
@@ -161,6 +282,28 @@ int main(int argc, char *argv[])
                 case SDL_BUTTON_RIGHT://Active ou non la vue en arêtes
                     Scene_SetWireframe(scene, !Scene_GetWireframe(scene));
                     break;
+                case SDL_BUTTON_MIDDLE://Sélectionne l'objet sous le curseur
+                {
+                    Vec3 rayOrigin, rayDirection;
+                    MeshRayHit hit;
+                    Camera_GetRay(camera,
+                        2.0f * ((float)evt.button.x + 0.5f) / (float)WINDOW_WIDTH - 1.0f,
+                        1.0f - 2.0f * ((float)evt.button.y + 0.5f) / (float)WINDOW_HEIGHT,
+                        &rayOrigin, &rayDirection);
+
+                    Object *picked = Scene_Pick(scene, rayOrigin, rayDirection, &hit);
+                    if (picked)
+                    {
+                        printf("Objet sous le curseur : %s, triangle %d a %.2f\n",
+                            (picked == object) ? "personnage" : "decor",
+                            hit.m_triangle, hit.m_distance);
+                    }
+                    else
+                    {
+                        printf("Aucun objet sous le curseur\n");
+                    }
+                    break;
+                }
                 default:
                 break;
                 }
@@ -204,6 +347,65 @@ int main(int argc, char *argv[])
                 case SDL_SCANCODE_SPACE://On/Off du mode MegaBackFlipDeLaMortQuiTue
                     MeGaBaCkFliPdElAmOrTqUiTuE = !MeGaBaCkFliPdElAmOrTqUiTuE;
                     break;
+                case SDL_SCANCODE_F://change le filtrage des textures
+                {
+                    static const char *filterNames[SAMPLER_FILTER_COUNT] = {
+                        "plus proche", "bilineaire", "trilineaire"
+                    };
+                    SamplerFilter filter = (Scene_GetTextureFilter(scene) + 1) % SAMPLER_FILTER_COUNT;
+                    Scene_SetTextureFilter(scene, filter);
+                    printf("Filtrage des textures : %s\n", filterNames[filter]);
+                    break;
+                }
+                case SDL_SCANCODE_L://change l'erreur tolérée pour le choix des niveaux de détail
+                {
+                    // 1, 2, 4, 8, 16 pixels puis désactivé
+                    float pixelError = Scene_GetLodPixelError(scene);
+                    pixelError = (pixelError <= 0.0f) ? 1.0f : (pixelError >= 16.0f) ? 0.0f : 2.0f * pixelError;
+                    Scene_SetLodPixelError(scene, pixelError);
+                    if (pixelError > 0.0f)
+                        printf("Erreur des niveaux de detail : %.0f pixels\n", pixelError);
+                    else
+                        printf("Niveaux de detail desactives\n");
+                    break;
+                }
+                case SDL_SCANCODE_G://On/Off de la foule
+                    crowdOnOff = !crowdOnOff;
+                    Object_SetMesh((Object *)crowd, crowdOnOff ? Object_GetMesh(object) : NULL);
+                    printf("Foule : %d personnages\n",
+                        crowdOnOff ? InstanceGroup_GetInstanceCount(crowd) + 1 : 1);
+                    break;
+                case SDL_SCANCODE_H://On/Off du décor statique
+                {
+                    decorOnOff = !decorOnOff;
+                    Object *decorObject = Object_GetFirstChild(decor);
+                    for (; decorObject; decorObject = Object_GetNextSibling(decorObject))
+                    {
+                        Object_SetMesh(decorObject, decorOnOff ? Object_GetMesh(object) : NULL);
+                    }
+                    printf("Decor statique : %s\n", decorOnOff ? "oui" : "non");
+                    break;
+                }
+                case SDL_SCANCODE_B://On/Off du rejet des meshlets invisibles
+                    Scene_SetMeshletCulling(scene, !Scene_GetMeshletCulling(scene));
+                    printf("Rejet des meshlets : %s\n",
+                        Scene_GetMeshletCulling(scene) ? "oui" : "non");
+                    break;
+                case SDL_SCANCODE_O://On/Off de l'occlusion ambiante précalculée
+                    Scene_SetAmbientOcclusion(scene, !Scene_GetAmbientOcclusion(scene));
+                    printf("Occlusion ambiante : %s\n",
+                        Scene_GetAmbientOcclusion(scene) ? "oui" : "non");
+                    break;
+                case SDL_SCANCODE_D://On/Off de la pré-passe de profondeur
+                    Scene_SetDepthPrepass(scene, !Scene_GetDepthPrepass(scene));
+                    printf("Pre-passe de profondeur : %s\n",
+                        Scene_GetDepthPrepass(scene) ? "oui" : "non");
+                    break;
+                case SDL_SCANCODE_T://On/Off du tri des sous-meshes du plus proche au plus éloigné
+                    Scene_SetSubmeshSorting(scene, !Scene_GetSubmeshSorting(scene));
+                    printf("Tri des sous-meshes : %s\n",
+                        Scene_GetSubmeshSorting(scene) ? "oui" : "non");
+                    break;
                 default:
                     break;
             }
@@ -256,12 +458,30 @@ int main(int argc, char *argv[])
         // Met à jour le rendu (affiche le buffer précédent)
         Renderer_Update(renderer);
 
+        // Affiche le niveau de détail du personnage lorsqu'il change
+        Mesh *renderedMesh = Object_GetMesh(object);
+        if (renderedMesh && Object_GetLodLevel(object) != lodLevel)
+        {
+            lodLevel = Object_GetLodLevel(object);
+            int triangleCount = (lodLevel > 0) ?
+                renderedMesh->m_lods[lodLevel - 1].m_triangleCount : renderedMesh->m_triangleCount;
+            printf("Niveau de detail %d : %d triangles\n", lodLevel, triangleCount);
+        }
+
+        if (firstFrame)
+        {
+            printf("Premiere image apres %.1f ms\n",
+                1000.0 * (double)(SDL_GetPerformanceCounter() - loadStart) / frequency);
+            firstFrame = false;
+        }
+
         // Calcule les FPS
         fpsAccu += Timer_GetDelta(g_time);
         frameCount++;
         if (fpsAccu > 1.0f)
         {
-            printf("FPS = %.1f\n", (float)frameCount / fpsAccu);
+            printf("FPS = %.1f%s\n", (float)frameCount / fpsAccu,
+                Scene_GetDepthPrepass(scene) ? " (pre-passe de profondeur)" : "");
             fpsAccu = 0.0f;
             frameCount = 0;
 